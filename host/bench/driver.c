@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Measures the drivers running against the emulator. Latency is the
+// emulated time from an HX711 signalling a conversion is ready (DOUT
+// going low) to the value being returned by the driver. Host time is
+// how long the host took to emulate each value, which is only useful
+// for comparing changes to the drivers and emulator against each
+// other.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hostemu.h"
+#include "pico/time.h"
+#include "../../include/common.h"
+
+#define CLOCK_PIN       0
+#define DATA_PIN_BASE   1
+#define MAX_CHIPS       29
+#define SAMPLES         UINT32_C(50)
+
+static hostemu_hx711_t devs[MAX_CHIPS];
+
+static int32_t source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        (void)gainPulses;
+        return (int32_t)((uintptr_t)ctx * 1000 + index);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void attach_devices(const size_t len) {
+
+    hostemu_hx711_config_t cfg;
+    hostemu_hx711_default_config(&cfg);
+
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.source = source;
+
+    for(size_t i = 0; i < len; ++i) {
+        cfg.data_pin = DATA_PIN_BASE + i;
+        cfg.ctx = (void*)(uintptr_t)i;
+        hostemu_hx711_attach(&devs[i], &cfg);
+    }
+
+}
+
+static double latency_us(void) {
+    const hostemu_hx711_read_t* const r = hostemu_hx711_get_read(&devs[0], 0);
+    return (double)(hostemu_cycles() - r->ready_cycle) / HOSTEMU_CYCLES_PER_US;
+}
+
+static int bench_single(void) {
+
+    hx711_t hx = {0};
+    hx711_config_t cfg;
+    int failures = 0;
+    double total = 0;
+
+    hostemu_reset();
+    attach_devices(1);
+
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN_BASE;
+
+    hx711_init(&hx, &cfg);
+    hx711_power_up(&hx, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    //empty the RX FIFO so each value is waited for
+    for(uint i = 0; i < 8; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    const double start = now_ns();
+
+    for(uint32_t i = 0; i < SAMPLES; ++i) {
+        const int32_t val = hx711_get_value(&hx);
+        total += latency_us();
+        failures += val != hostemu_hx711_get_read(&devs[0], 0)->value;
+    }
+
+    const double host = (now_ns() - start) / 1e3 / SAMPLES;
+
+    hx711_close(&hx);
+
+    printf("%-10s %6u %14.1f %14.1f\n", "hx711", 1u, total / SAMPLES, host);
+
+    return failures;
+
+}
+
+static int bench_multi(
+    const size_t len,
+    const bool pack) {
+
+        hx711_multi_t hxm = {0};
+        hx711_multi_config_t cfg;
+        int32_t values[MAX_CHIPS];
+        int failures = 0;
+        double total = 0;
+
+        hostemu_reset();
+        attach_devices(len);
+
+        hx711_multi_get_default_config(&cfg);
+        cfg.clock_pin = CLOCK_PIN;
+        cfg.data_pin_base = DATA_PIN_BASE;
+        cfg.chips_len = len;
+        cfg.pack_pinvals = pack;
+
+        hx711_multi_init(&hxm, &cfg);
+        hx711_multi_power_up(&hxm, hx711_gain_128);
+        hx711_wait_settle(hx711_rate_80);
+
+        const double start = now_ns();
+
+        for(uint32_t i = 0; i < SAMPLES; ++i) {
+            hx711_multi_get_values(&hxm, values);
+            total += latency_us();
+            for(size_t j = 0; j < len; ++j) {
+                failures += values[j] != hostemu_hx711_get_read(&devs[j], 0)->value;
+            }
+        }
+
+        const double host = (now_ns() - start) / 1e3 / SAMPLES;
+
+        hx711_multi_close(&hxm);
+
+        printf("%-10s %6zu %14.1f %14.1f\n", pack ? "multi-pack" : "multi", len, total / SAMPLES, host);
+
+        return failures;
+
+}
+
+int main(void) {
+
+    static const size_t lens[] = { 1, 4, 8, 16, 29 };
+    int failures = 0;
+
+    printf("%-10s %6s %14s %14s\n", "driver", "chips", "latency us", "host us/value");
+
+    failures += bench_single();
+
+    for(size_t i = 0; i < count_of(lens); ++i) {
+        failures += bench_multi(lens[i], false);
+        failures += bench_multi(lens[i], true);
+    }
+
+    if(failures != 0) {
+        fprintf(stderr, "%d values did not match the emulated HX711s\n", failures);
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
@@ -0,0 +1,215 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compares filtering every chip of an hx711_multi_t with a
+// hx711_filter_stage_t for each chip against a hx711_filter_bank_t,
+// first for correctness and then for speed, for each number of chips
+// from 1 to 32. Both are built with the same flags as the host tests,
+// including asserts.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pico/types.h"
+#include "../../include/hx711.h"
+#include "../../include/hx711_filter.h"
+
+#define MAX_CHIPS       HX711_FILTER_BANK_MAX_CHANNELS
+#define WINDOW_LEN      8
+#define FRAMES          UINT32_C(64)
+#define ITERATIONS      UINT32_C(2000)
+
+typedef enum {
+    BENCH_MOVING_AVERAGE = 0,
+    BENCH_IIR
+} bench_type_t;
+
+static uint32_t rng_state = 0x2545f491;
+
+static uint32_t rng_next(void) {
+    //xorshift32
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int32_t stage_windows[MAX_CHIPS][WINDOW_LEN];
+static int32_t bank_window[WINDOW_LEN * MAX_CHIPS];
+
+static void init_stages(
+    hx711_filter_stage_t* const stages,
+    const bench_type_t type,
+    const size_t len) {
+
+        for(size_t i = 0; i < len; ++i) {
+            if(type == BENCH_MOVING_AVERAGE) {
+                hx711_filter_moving_average_init(&stages[i], stage_windows[i], WINDOW_LEN);
+            }
+            else {
+                hx711_filter_iir_init(&stages[i], HX711_FILTER_IIR_COEFF(0.1));
+            }
+        }
+
+}
+
+static void init_bank(
+    hx711_filter_bank_t* const bank,
+    const bench_type_t type,
+    const size_t len) {
+
+        if(type == BENCH_MOVING_AVERAGE) {
+            hx711_filter_bank_moving_average_init(bank, len, bank_window, WINDOW_LEN);
+        }
+        else {
+            hx711_filter_bank_iir_init(bank, len, HX711_FILTER_IIR_COEFF(0.1));
+        }
+
+}
+
+static int check(
+    int32_t frames[FRAMES][MAX_CHIPS],
+    const bench_type_t type,
+    const size_t len) {
+
+        hx711_filter_stage_t stages[MAX_CHIPS];
+        hx711_filter_bank_t bank;
+        int32_t out[MAX_CHIPS];
+        int failures = 0;
+
+        init_stages(stages, type, len);
+        init_bank(&bank, type, len);
+
+        for(uint32_t f = 0; f < FRAMES; ++f) {
+
+            hx711_filter_bank_apply(&bank, frames[f], out);
+
+            for(size_t i = 0; i < len; ++i) {
+                const int32_t expected = hx711_filter_stage_apply(&stages[i], frames[f][i]);
+                if(out[i] != expected) {
+                    fprintf(stderr, "mismatch: type %d chips %zu frame %u chip %zu: %ld != %ld\n",
+                        (int)type, len, (uint)f, i, (long)out[i], (long)expected);
+                    ++failures;
+                }
+            }
+
+        }
+
+        return failures;
+
+}
+
+static double time_stages(
+    int32_t frames[FRAMES][MAX_CHIPS],
+    const bench_type_t type,
+    const size_t len) {
+
+        hx711_filter_stage_t stages[MAX_CHIPS];
+        volatile int32_t sink = 0;
+
+        init_stages(stages, type, len);
+
+        const double start = now_ns();
+
+        for(uint32_t n = 0; n < ITERATIONS; ++n) {
+            for(uint32_t f = 0; f < FRAMES; ++f) {
+                for(size_t i = 0; i < len; ++i) {
+                    sink += hx711_filter_stage_apply(&stages[i], frames[f][i]);
+                }
+            }
+        }
+
+        (void)sink;
+
+        return (now_ns() - start) / ((double)ITERATIONS * FRAMES);
+
+}
+
+static double time_bank(
+    int32_t frames[FRAMES][MAX_CHIPS],
+    const bench_type_t type,
+    const size_t len) {
+
+        hx711_filter_bank_t bank;
+        int32_t out[MAX_CHIPS];
+        volatile int32_t sink = 0;
+
+        init_bank(&bank, type, len);
+
+        const double start = now_ns();
+
+        for(uint32_t n = 0; n < ITERATIONS; ++n) {
+            for(uint32_t f = 0; f < FRAMES; ++f) {
+                hx711_filter_bank_apply(&bank, frames[f], out);
+                sink += out[len - 1];
+            }
+        }
+
+        (void)sink;
+
+        return (now_ns() - start) / ((double)ITERATIONS * FRAMES);
+
+}
+
+int main(void) {
+
+    static int32_t frames[FRAMES][MAX_CHIPS];
+    int failures = 0;
+
+    for(uint32_t f = 0; f < FRAMES; ++f) {
+        for(size_t i = 0; i < MAX_CHIPS; ++i) {
+            //first two frames are the extremes
+            frames[f][i] = f == 0 ? HX711_MIN_VALUE : f == 1 ? HX711_MAX_VALUE :
+                (int32_t)(rng_next() % 0x1000000u) + HX711_MIN_VALUE;
+        }
+    }
+
+    static const char* const names[] = { "moving average", "iir" };
+
+    for(int type = BENCH_MOVING_AVERAGE; type <= BENCH_IIR; ++type) {
+
+        printf("%s\n%6s %16s %16s %8s\n", names[type],
+            "chips", "stage ns/frame", "bank ns/frame", "speedup");
+
+        for(size_t len = 1; len <= MAX_CHIPS; ++len) {
+
+            failures += check(frames, (bench_type_t)type, len);
+
+            const double stages = time_stages(frames, (bench_type_t)type, len);
+            const double bank = time_bank(frames, (bench_type_t)type, len);
+
+            printf("%6zu %16.1f %16.1f %7.1fx\n", len, stages, bank, stages / bank);
+
+        }
+
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
@@ -0,0 +1,176 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compares hx711_multi_transpose against the original bit by bit
+// conversion of pinvals, first for correctness and then for speed,
+// for each number of chips from 1 to 32. hx711_multi_transpose_cols
+// is also compared with the chips spread across all 32 columns, as
+// when there are gaps between the data pins.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pico/types.h"
+#include "../../include/hx711_multi_transpose.h"
+
+#define READ_BITS       HX711_MULTI_TRANSPOSE_ROWS
+#define MAX_CHIPS       HX711_MULTI_TRANSPOSE_COLS
+#define FRAMES          UINT32_C(64)
+#define ITERATIONS      UINT32_C(4000)
+
+// the conversion hx711_multi_pinvals_to_values used before the
+// transpose, including hx711_get_twos_comp
+static void reference_pinvals_to_values(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const size_t len) {
+
+        for(size_t chipNum = 0; chipNum < len; ++chipNum) {
+
+            uint32_t rawVal = 0;
+
+            for(size_t bitPos = 0; bitPos < READ_BITS; ++bitPos) {
+                const uint shift = READ_BITS - bitPos - 1;
+                const uint32_t bit = (pinvals[bitPos] >> chipNum) & 1;
+                rawVal |= bit << shift;
+            }
+
+            values[chipNum] =
+                (int32_t)(-(rawVal & 0x800000)) +
+                (int32_t)(rawVal & 0x7fffff);
+
+        }
+
+}
+
+static uint32_t rng_state = 0x2545f491;
+
+static uint32_t rng_next(void) {
+    //xorshift32
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+typedef void (*convert_t)(const uint32_t* const, int32_t* const, const size_t);
+
+// columns of the chips when spread as far apart as possible
+static uint8_t spread_cols[MAX_CHIPS];
+
+static void spread_transpose(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const size_t len) {
+        hx711_multi_transpose_cols(pinvals, values, spread_cols, len);
+}
+
+static double time_convert(
+    const convert_t fn,
+    uint32_t pinvals[FRAMES][READ_BITS],
+    const size_t len) {
+
+        int32_t values[MAX_CHIPS];
+        volatile int32_t sink = 0;
+
+        const double start = now_ns();
+
+        for(uint32_t i = 0; i < ITERATIONS; ++i) {
+            for(uint32_t f = 0; f < FRAMES; ++f) {
+                fn(pinvals[f], values, len);
+                sink += values[len - 1];
+            }
+        }
+
+        (void)sink;
+
+        return (now_ns() - start) / ((double)ITERATIONS * FRAMES);
+
+}
+
+int main(void) {
+
+    static uint32_t pinvals[FRAMES][READ_BITS];
+    int32_t expected[MAX_CHIPS];
+    int32_t all[MAX_CHIPS];
+    int32_t actual[MAX_CHIPS];
+    int failures = 0;
+
+    for(uint32_t f = 0; f < FRAMES; ++f) {
+        for(uint i = 0; i < READ_BITS; ++i) {
+            //first two frames are all low and all high
+            pinvals[f][i] = f == 0 ? 0 : f == 1 ? UINT32_MAX : rng_next();
+        }
+    }
+
+    printf("%6s %14s %14s %8s %14s\n", "chips", "loop ns/frame", "swar ns/frame", "speedup", "cols ns/frame");
+
+    for(size_t len = 1; len <= MAX_CHIPS; ++len) {
+
+        for(size_t i = 0; i < len; ++i) {
+            spread_cols[i] = (uint8_t)(len == 1 ? MAX_CHIPS - 1 : i * (MAX_CHIPS - 1) / (len - 1));
+        }
+
+        for(uint32_t f = 0; f < FRAMES; ++f) {
+
+            reference_pinvals_to_values(pinvals[f], all, MAX_CHIPS);
+            spread_transpose(pinvals[f], actual, len);
+
+            for(size_t i = 0; i < len; ++i) {
+                if(actual[i] != all[spread_cols[i]]) {
+                    fprintf(stderr, "mismatch: spread chips %zu frame %u chip %zu: %ld != %ld\n",
+                        len, (uint)f, i, (long)actual[i], (long)all[spread_cols[i]]);
+                    ++failures;
+                }
+            }
+
+            reference_pinvals_to_values(pinvals[f], expected, len);
+            hx711_multi_transpose(pinvals[f], actual, len);
+
+            for(size_t i = 0; i < len; ++i) {
+                if(actual[i] != expected[i]) {
+                    fprintf(stderr, "mismatch: chips %zu frame %u chip %zu: %ld != %ld\n",
+                        len, (uint)f, i, (long)actual[i], (long)expected[i]);
+                    ++failures;
+                }
+            }
+
+        }
+
+        const double ref = time_convert(reference_pinvals_to_values, pinvals, len);
+        const double swar = time_convert(hx711_multi_transpose, pinvals, len);
+        const double cols = time_convert(spread_transpose, pinvals, len);
+
+        printf("%6zu %14.1f %14.1f %7.1fx %14.1f\n", len, ref, swar, ref / swar, cols);
+
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
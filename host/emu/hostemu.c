@@ -0,0 +1,677 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/mutex.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hostemu.h"
+#include "hostemu_internal.h"
+
+/**
+ * Number of times an interrupt may be re-entered without any emulated
+ * time passing before it is considered to be stuck asserted.
+ */
+#define HOSTEMU_IRQ_STORM_LIMIT 100000u
+
+uint64_t hostemu__now;
+uint64_t hostemu__epoch;
+uint hostemu__core_num;
+
+timer_hw_t hostemu_timer_hw;
+
+typedef struct {
+    irq_handler_t exclusive;
+    irq_handler_t shared[PICO_MAX_SHARED_IRQ_HANDLERS];
+    uint8_t shared_order[PICO_MAX_SHARED_IRQ_HANDLERS];
+    uint shared_len;
+    uint8_t priority;
+    uint32_t count;
+} hostemu_irq_t;
+
+typedef struct {
+    uint32_t enabled;
+    bool primask;
+    bool event;
+} hostemu_core_t;
+
+static struct {
+    uint64_t time_limit;
+    hostemu_irq_t irqs[NUM_IRQS];
+    hostemu_core_t cores[NUM_CORES];
+    uint32_t pending;
+    bool in_handler;
+    uint current_irq;
+    uint64_t storm_cycle;
+    uint32_t storm_count;
+    hostemu_device_t* devices[HOSTEMU_MAX_DEVICES];
+    uint devices_len;
+    uint64_t next_device_event;
+    uint64_t poll_cycles;
+} hostemu__state;
+
+void panic(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fputs("\n*** PANIC ***\n", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    abort();
+}
+
+void panic_unsupported(void) {
+    panic("not supported");
+}
+
+void hostemu_reset(void) {
+    memset(&hostemu__state, 0, sizeof(hostemu__state));
+    hostemu__state.time_limit = hostemu_us_to_cycles(
+        HOSTEMU_DEFAULT_TIME_LIMIT_US);
+    hostemu__state.next_device_event = HOSTEMU_NO_EVENT;
+    for(uint i = 0; i < NUM_IRQS; ++i) {
+        hostemu__state.irqs[i].priority = PICO_DEFAULT_IRQ_PRIORITY;
+    }
+    memset((void*)&hostemu_timer_hw, 0, sizeof(hostemu_timer_hw));
+    hostemu__now = 0;
+    hostemu__epoch = 0;
+    hostemu__core_num = 0;
+    hostemu__multicore_reset();
+    hostemu__gpio_reset();
+    hostemu__pio_reset();
+    hostemu__dma_reset();
+}
+
+void hostemu_set_time_limit_us(const uint64_t us) {
+    hostemu__state.time_limit = hostemu_us_to_cycles(us);
+}
+
+uint64_t hostemu_cycles(void) {
+    return hostemu__now;
+}
+
+uint32_t hostemu_irq_count(const uint irq_num) {
+    assert(irq_num < NUM_IRQS);
+    return hostemu__state.irqs[irq_num].count;
+}
+
+#define HOSTEMU__CORE (&hostemu__state.cores[hostemu__core_num])
+
+/**
+ * Interrupts which are enabled on a core which can take them. An
+ * interrupt enabled on both cores is taken by core 0.
+ */
+static uint32_t hostemu__irq_unmasked(void) {
+    uint32_t mask = 0;
+    for(uint i = 0; i < NUM_CORES; ++i) {
+        if(!hostemu__state.cores[i].primask) {
+            mask |= hostemu__state.cores[i].enabled;
+        }
+    }
+    return mask;
+}
+
+static bool hostemu__irq_takeable(void) {
+    return !hostemu__state.in_handler &&
+        ((hostemu__state.pending |
+            hostemu__pio_irq_lines() |
+            hostemu__dma_irq_lines()) & hostemu__irq_unmasked()) != 0;
+}
+
+static void hostemu__events_set(void) {
+    for(uint i = 0; i < NUM_CORES; ++i) {
+        hostemu__state.cores[i].event = true;
+    }
+}
+
+static void hostemu__irq_call(const uint num) {
+
+    hostemu_irq_t* const irq = &hostemu__state.irqs[num];
+
+    if(irq->exclusive != NULL) {
+        irq->exclusive();
+        return;
+    }
+
+    if(irq->shared_len == 0) {
+        panic("unhandled irq %u", num);
+    }
+
+    for(uint i = 0; i < irq->shared_len; ++i) {
+        irq->shared[i]();
+    }
+
+}
+
+void hostemu__irq_sync(void) {
+
+    hostemu__state.pending |=
+        hostemu__pio_irq_lines() | hostemu__dma_irq_lines();
+
+    while(!hostemu__state.in_handler) {
+
+        uint32_t candidates = hostemu__state.pending & hostemu__irq_unmasked();
+
+        if(candidates == 0) {
+            break;
+        }
+
+        //highest priority (lowest value) first, then lowest number
+        uint num = NUM_IRQS;
+
+        while(candidates != 0) {
+            const uint i = (uint)__builtin_ctz(candidates);
+            candidates &= candidates - 1;
+            if(num == NUM_IRQS ||
+                hostemu__state.irqs[i].priority < hostemu__state.irqs[num].priority) {
+                    num = i;
+            }
+        }
+
+        if(hostemu__state.storm_cycle == hostemu__now) {
+            if(++hostemu__state.storm_count > HOSTEMU_IRQ_STORM_LIMIT) {
+                panic("irq %u is stuck asserted", num);
+            }
+        }
+        else {
+            hostemu__state.storm_cycle = hostemu__now;
+            hostemu__state.storm_count = 0;
+        }
+
+        //the handler runs as the core which took the interrupt
+        const uint core = hostemu__core_num;
+        hostemu__core_num =
+            (hostemu__state.cores[0].enabled & (1u << num)) != 0 &&
+            !hostemu__state.cores[0].primask ? 0 : 1;
+
+        hostemu__state.pending &= ~(1u << num);
+        hostemu__state.in_handler = true;
+        hostemu__state.current_irq = num;
+        HOSTEMU__CORE->event = true;
+        ++hostemu__state.irqs[num].count;
+
+        hostemu__irq_call(num);
+
+        hostemu__state.in_handler = false;
+        HOSTEMU__CORE->event = true;
+        hostemu__core_num = core;
+        hostemu__state.pending |=
+            hostemu__pio_irq_lines() | hostemu__dma_irq_lines();
+
+    }
+
+}
+
+static void hostemu__step(void) {
+    if(hostemu__now >= hostemu__state.next_device_event) {
+        hostemu__devices_run_due();
+    }
+    hostemu__pio_tick();
+    hostemu__dma_tick();
+    ++hostemu__now;
+    hostemu__irq_sync();
+}
+
+void hostemu__run_until(
+    const uint64_t cycle,
+    const bool stop_on_event) {
+
+        while(hostemu__now < cycle) {
+
+            //core 1 runs whenever core 0 waits
+            if(hostemu__core_num == 0 &&
+                !hostemu__state.in_handler &&
+                hostemu__core1_runnable()) {
+                    hostemu__core1_resume();
+                    continue;
+            }
+
+            if(stop_on_event && HOSTEMU__CORE->event) {
+                return;
+            }
+
+            if(hostemu__now >= hostemu__state.time_limit) {
+                panic("emulated time limit of %llu us reached",
+                    (unsigned long long)(hostemu__state.time_limit / HOSTEMU_CYCLES_PER_US));
+            }
+
+            if(!hostemu__irq_takeable() &&
+                hostemu__pio_quiescent() &&
+                hostemu__dma_quiescent()) {
+
+                    uint64_t next = MIN(cycle, hostemu__state.next_device_event);
+                    next = MIN(next, hostemu__state.time_limit);
+
+                    if(hostemu__core_num == 0) {
+                        next = MIN(next, hostemu__core1_wake_cycle());
+                    }
+
+                    if(next > hostemu__now) {
+                        hostemu__now = next;
+                        hostemu__pio_skipped();
+                        continue;
+                    }
+
+            }
+
+            hostemu__step();
+
+        }
+
+}
+
+void hostemu_run_cycles(const uint64_t cycles) {
+    hostemu__run_until(hostemu__now + cycles, false);
+}
+
+void hostemu_poll(void) {
+    hostemu__state.poll_cycles += HOSTEMU_POLL_CYCLES;
+    hostemu_run_cycles(HOSTEMU_POLL_CYCLES);
+}
+
+uint64_t hostemu_poll_cycles(void) {
+    return hostemu__state.poll_cycles;
+}
+
+void hostemu__devices_reset(void) {
+    hostemu__state.devices_len = 0;
+    hostemu__state.next_device_event = HOSTEMU_NO_EVENT;
+}
+
+static void hostemu__devices_update_next(void) {
+    uint64_t next = HOSTEMU_NO_EVENT;
+    for(uint i = 0; i < hostemu__state.devices_len; ++i) {
+        next = MIN(next, hostemu__state.devices[i]->next_event);
+    }
+    hostemu__state.next_device_event = next;
+}
+
+uint64_t hostemu__devices_next_event(void) {
+    return hostemu__state.next_device_event;
+}
+
+void hostemu__devices_run_due(void) {
+
+    bool ran;
+
+    do {
+        ran = false;
+        for(uint i = 0; i < hostemu__state.devices_len; ++i) {
+            hostemu_device_t* const dev = hostemu__state.devices[i];
+            if(dev->next_event <= hostemu__now) {
+                dev->next_event = HOSTEMU_NO_EVENT;
+                dev->event(dev);
+                ran = true;
+            }
+        }
+    } while(ran);
+
+    hostemu__devices_update_next();
+
+}
+
+void hostemu__devices_pin_changed(
+    const uint32_t changed,
+    const uint32_t levels) {
+
+        for(uint i = 0; i < hostemu__state.devices_len; ++i) {
+
+            hostemu_device_t* const dev = hostemu__state.devices[i];
+            uint32_t mask = changed & dev->watch_mask;
+
+            while(mask != 0) {
+                const uint gpio = (uint)__builtin_ctz(mask);
+                mask &= mask - 1;
+                dev->pin_changed(dev, gpio, (levels >> gpio) & 1u);
+            }
+
+        }
+
+}
+
+void hostemu_device_attach(hostemu_device_t* const dev) {
+    assert(dev != NULL);
+    assert(hostemu__state.devices_len < HOSTEMU_MAX_DEVICES);
+    hostemu__state.devices[hostemu__state.devices_len++] = dev;
+    hostemu__devices_update_next();
+}
+
+void hostemu_device_schedule(
+    hostemu_device_t* const dev,
+    const uint64_t cycle) {
+        assert(dev != NULL);
+        dev->next_event = cycle;
+        hostemu__devices_update_next();
+}
+
+uint32_t clock_get_hz(const enum clock_index clk_index) {
+    switch(clk_index) {
+        case clk_sys:
+        case clk_peri:
+            return HOSTEMU_CLK_SYS_HZ;
+        case clk_ref:
+            return 12000000u;
+        case clk_usb:
+        case clk_adc:
+            return 48000000u;
+        default:
+            return 0;
+    }
+}
+
+void tight_loop_contents(void) {
+    hostemu_poll();
+}
+
+uint __get_current_exception(void) {
+    return hostemu__state.in_handler
+        ? VTABLE_FIRST_IRQ + hostemu__state.current_irq
+        : 0;
+}
+
+uint get_core_num(void) {
+    return hostemu__core_num;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    const uint32_t status = HOSTEMU__CORE->primask ? 1u : 0u;
+    HOSTEMU__CORE->primask = true;
+    return status;
+}
+
+void restore_interrupts(const uint32_t status) {
+    HOSTEMU__CORE->primask = (status & 1u) != 0;
+    hostemu__irq_sync();
+}
+
+bool hostemu__event_get(const uint core) {
+    assert(core < NUM_CORES);
+    return hostemu__state.cores[core].event;
+}
+
+/**
+ * Waits as the current core until an event or the given cycle. Core 1
+ * waits by handing control back to core 0 until either happens.
+ */
+static void hostemu__wait_event(const uint64_t cycle) {
+    if(HOSTEMU__CORE->event) {
+        return;
+    }
+    if(hostemu__core_num == 1) {
+        hostemu__core1_yield(cycle);
+    }
+    else {
+        hostemu__run_until(cycle, true);
+    }
+}
+
+void __wfe(void) {
+    hostemu__wait_event(UINT64_MAX);
+    HOSTEMU__CORE->event = false;
+}
+
+void __wfi(void) {
+    //unlike wfe, a previously latched event does not wake wfi
+    const bool latched = HOSTEMU__CORE->event;
+    HOSTEMU__CORE->event = false;
+    hostemu__wait_event(UINT64_MAX);
+    HOSTEMU__CORE->event = latched;
+}
+
+void __sev(void) {
+    hostemu__events_set();
+}
+
+void irq_set_priority(const uint num, const uint8_t hardware_priority) {
+    assert(num < NUM_IRQS);
+    hostemu__state.irqs[num].priority = hardware_priority;
+}
+
+uint irq_get_priority(const uint num) {
+    assert(num < NUM_IRQS);
+    return hostemu__state.irqs[num].priority;
+}
+
+void irq_set_mask_enabled(const uint32_t mask, const bool enabled) {
+    if(enabled) {
+        //enabling clears any stale pending state, as the SDK does
+        hostemu__state.pending &= ~mask;
+        HOSTEMU__CORE->enabled |= mask;
+    }
+    else {
+        HOSTEMU__CORE->enabled &= ~mask;
+    }
+    hostemu__irq_sync();
+}
+
+void irq_set_enabled(const uint num, const bool enabled) {
+    assert(num < NUM_IRQS);
+    irq_set_mask_enabled(1u << num, enabled);
+}
+
+bool irq_is_enabled(const uint num) {
+    assert(num < NUM_IRQS);
+    return (HOSTEMU__CORE->enabled & (1u << num)) != 0;
+}
+
+void irq_set_exclusive_handler(const uint num, const irq_handler_t handler) {
+    assert(num < NUM_IRQS);
+    assert(handler != NULL);
+    hostemu_irq_t* const irq = &hostemu__state.irqs[num];
+    if(irq->shared_len != 0 ||
+        (irq->exclusive != NULL && irq->exclusive != handler)) {
+            panic("irq %u already has a handler", num);
+    }
+    irq->exclusive = handler;
+}
+
+irq_handler_t irq_get_exclusive_handler(const uint num) {
+    assert(num < NUM_IRQS);
+    return hostemu__state.irqs[num].exclusive;
+}
+
+irq_handler_t irq_get_vtable_handler(const uint num) {
+    assert(num < NUM_IRQS);
+    const hostemu_irq_t* const irq = &hostemu__state.irqs[num];
+    if(irq->exclusive != NULL) {
+        return irq->exclusive;
+    }
+    return irq->shared_len != 0 ? irq->shared[0] : NULL;
+}
+
+bool irq_has_shared_handler(const uint num) {
+    assert(num < NUM_IRQS);
+    return hostemu__state.irqs[num].shared_len != 0;
+}
+
+void irq_add_shared_handler(
+    const uint num,
+    const irq_handler_t handler,
+    const uint8_t order_priority) {
+
+        assert(num < NUM_IRQS);
+        assert(handler != NULL);
+
+        hostemu_irq_t* const irq = &hostemu__state.irqs[num];
+
+        if(irq->exclusive != NULL) {
+            panic("irq %u already has an exclusive handler", num);
+        }
+
+        if(irq->shared_len == PICO_MAX_SHARED_IRQ_HANDLERS) {
+            panic("too many shared handlers for irq %u", num);
+        }
+
+        //higher order priorities are called first
+        uint i = irq->shared_len;
+
+        while(i > 0 && irq->shared_order[i - 1] < order_priority) {
+            irq->shared[i] = irq->shared[i - 1];
+            irq->shared_order[i] = irq->shared_order[i - 1];
+            --i;
+        }
+
+        irq->shared[i] = handler;
+        irq->shared_order[i] = order_priority;
+        ++irq->shared_len;
+
+}
+
+void irq_remove_handler(const uint num, const irq_handler_t handler) {
+
+    assert(num < NUM_IRQS);
+
+    hostemu_irq_t* const irq = &hostemu__state.irqs[num];
+
+    if(irq->exclusive == handler) {
+        irq->exclusive = NULL;
+        return;
+    }
+
+    for(uint i = 0; i < irq->shared_len; ++i) {
+        if(irq->shared[i] == handler) {
+            for(uint j = i + 1; j < irq->shared_len; ++j) {
+                irq->shared[j - 1] = irq->shared[j];
+                irq->shared_order[j - 1] = irq->shared_order[j];
+            }
+            --irq->shared_len;
+            return;
+        }
+    }
+
+}
+
+void irq_clear(const uint int_num) {
+    assert(int_num < NUM_IRQS);
+    hostemu__state.pending &= ~(1u << int_num);
+    hostemu__irq_sync();
+}
+
+void irq_set_pending(const uint num) {
+    assert(num < NUM_IRQS);
+    hostemu__state.pending |= 1u << num;
+    hostemu__irq_sync();
+}
+
+void mutex_init(mutex_t* const mtx) {
+    assert(mtx != NULL);
+    mtx->core.spin_lock = mtx;
+    mtx->owner = LOCK_INVALID_OWNER_ID;
+}
+
+void mutex_enter_blocking(mutex_t* const mtx) {
+    assert(mutex_is_initialized(mtx));
+    while(mtx->owner != LOCK_INVALID_OWNER_ID) {
+        hostemu_poll();
+    }
+    mtx->owner = (lock_owner_id_t)get_core_num();
+}
+
+bool mutex_try_enter(mutex_t* const mtx, uint32_t* const owner_out) {
+    assert(mutex_is_initialized(mtx));
+    if(mtx->owner == LOCK_INVALID_OWNER_ID) {
+        mtx->owner = (lock_owner_id_t)get_core_num();
+        return true;
+    }
+    if(owner_out != NULL) {
+        *owner_out = (uint32_t)mtx->owner;
+    }
+    return false;
+}
+
+void mutex_exit(mutex_t* const mtx) {
+    assert(mutex_is_initialized(mtx));
+    assert(mtx->owner != LOCK_INVALID_OWNER_ID);
+    mtx->owner = LOCK_INVALID_OWNER_ID;
+    __sev();
+}
+
+static uint64_t hostemu__time_us(void) {
+    return hostemu__now / HOSTEMU_CYCLES_PER_US;
+}
+
+uint64_t time_us_64(void) {
+    hostemu_poll();
+    return hostemu__time_us();
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+void busy_wait_until(const absolute_time_t t) {
+    const uint64_t us = to_us_since_boot(t);
+    if(us >= UINT64_MAX / HOSTEMU_CYCLES_PER_US) {
+        hostemu__run_until(UINT64_MAX, false);
+    }
+    hostemu__run_until(hostemu_us_to_cycles(us), false);
+}
+
+void busy_wait_us(const uint64_t delay_us) {
+    hostemu__run_until(hostemu__now + hostemu_us_to_cycles(delay_us), false);
+}
+
+void busy_wait_us_32(const uint32_t delay_us) {
+    busy_wait_us(delay_us);
+}
+
+void busy_wait_ms(const uint32_t delay_ms) {
+    busy_wait_us((uint64_t)delay_ms * 1000);
+}
+
+bool time_reached(const absolute_time_t t) {
+    hostemu_poll();
+    return hostemu__time_us() >= to_us_since_boot(t);
+}
+
+void sleep_until(const absolute_time_t target) {
+    busy_wait_until(target);
+}
+
+void sleep_us(const uint64_t us) {
+    busy_wait_us(us);
+}
+
+void sleep_ms(const uint32_t ms) {
+    busy_wait_ms(ms);
+}
+
+bool best_effort_wfe_or_timeout(const absolute_time_t timeout_timestamp) {
+
+    const uint64_t us = to_us_since_boot(timeout_timestamp);
+    const uint64_t cycle = us >= UINT64_MAX / HOSTEMU_CYCLES_PER_US
+        ? UINT64_MAX
+        : hostemu_us_to_cycles(us);
+
+    hostemu__wait_event(cycle);
+    HOSTEMU__CORE->event = false;
+
+    return hostemu__now >= cycle;
+
+}
@@ -0,0 +1,270 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HOSTEMU_H_6BE7FA54_9B2F_4673_A040_BFD009FB25D6
+#define HOSTEMU_H_6BE7FA54_9B2F_4673_A040_BFD009FB25D6
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+
+/**
+ * Host emulation of the parts of the RP2040 used by this library:
+ * PIO state machines, DMA, NVIC, GPIO, the timer and the mutex/time
+ * APIs of the pico-sdk, along with a model of the HX711 itself.
+ *
+ * Emulated time only passes when the code under test waits on the
+ * hardware (eg. by polling a FIFO or the timer), so runs are fully
+ * deterministic. Periods in which nothing can change are skipped.
+ */
+
+#define HOSTEMU_CLK_SYS_HZ          125000000u
+#define HOSTEMU_CYCLES_PER_US       (HOSTEMU_CLK_SYS_HZ / 1000000u)
+
+/**
+ * Number of clk_sys cycles which pass each time the code under test
+ * polls the hardware.
+ */
+#define HOSTEMU_POLL_CYCLES         16u
+
+/**
+ * Default limit on emulated time. Exceeding it is treated as a hang.
+ */
+#define HOSTEMU_DEFAULT_TIME_LIMIT_US   (600ull * 1000000ull)
+
+#define HOSTEMU_MAX_DEVICES         32u
+
+/**
+ * @brief Resets all emulated peripherals, time and attached devices.
+ */
+void hostemu_reset(void);
+
+/**
+ * @brief Sets the amount of emulated time after which the emulator
+ * panics.
+ *
+ * @param us
+ */
+void hostemu_set_time_limit_us(uint64_t us);
+
+/**
+ * @brief Returns the number of clk_sys cycles since reset.
+ *
+ * @return uint64_t
+ */
+uint64_t hostemu_cycles(void);
+
+static inline uint64_t hostemu_us_to_cycles(const uint64_t us) {
+    return us * HOSTEMU_CYCLES_PER_US;
+}
+
+/**
+ * @brief Lets emulated time pass. Interrupts are dispatched as they
+ * would be on the RP2040.
+ *
+ * @param cycles
+ */
+void hostemu_run_cycles(uint64_t cycles);
+
+static inline void hostemu_run_us(const uint64_t us) {
+    hostemu_run_cycles(hostemu_us_to_cycles(us));
+}
+
+/**
+ * @brief Lets HOSTEMU_POLL_CYCLES cycles pass.
+ */
+void hostemu_poll(void);
+
+/**
+ * @brief Returns the number of cycles which have passed in
+ * hostemu_poll since reset, ie. while the code under test was
+ * busy polling the hardware. Time spent asleep in __wfe or
+ * __wfi is not included.
+ *
+ * @return uint64_t
+ */
+uint64_t hostemu_poll_cycles(void);
+
+/**
+ * @brief Drives a pin from outside the RP2040.
+ *
+ * @param gpio
+ * @param level 0 or 1 to drive the pin, -1 to release it
+ */
+void hostemu_gpio_drive(uint gpio, int level);
+
+/**
+ * @brief Returns the current level of a pin.
+ *
+ * @param gpio
+ * @return true
+ * @return false
+ */
+bool hostemu_gpio_level(uint gpio);
+
+/**
+ * @brief Returns the number of times an interrupt handler has been
+ * entered for the given irq since reset.
+ *
+ * @param irq_num
+ * @return uint32_t
+ */
+uint32_t hostemu_irq_count(uint irq_num);
+
+typedef struct hostemu_device hostemu_device_t;
+
+/**
+ * A device attached to the RP2040's pins. pin_changed is called when
+ * a watched pin changes level, and event is called once emulated time
+ * reaches next_event.
+ */
+struct hostemu_device {
+    uint32_t watch_mask;
+    void (*pin_changed)(hostemu_device_t* dev, uint gpio, bool level);
+    void (*event)(hostemu_device_t* dev);
+    uint64_t next_event;
+};
+
+#define HOSTEMU_NO_EVENT UINT64_MAX
+
+void hostemu_device_attach(hostemu_device_t* dev);
+
+void hostemu_device_schedule(
+    hostemu_device_t* dev,
+    uint64_t cycle);
+
+/**
+ * HX711 model.
+ *
+ * Conversions complete every 1/rate seconds (adjusted by ppm). DOUT
+ * goes low when one is ready; each rising edge of PD_SCK then shifts
+ * out the next bit, MSB first. 25, 26 or 27 pulses in total select the
+ * gain for the next conversion (128, 32 or 64). Holding PD_SCK high
+ * for more than 60us powers the chip down, and it powers up again
+ * (resetting to a gain of 128) when PD_SCK returns low.
+ */
+
+#define HOSTEMU_HX711_POWER_DOWN_US         60u
+#define HOSTEMU_HX711_DEFAULT_DOUT_DELAY_NS 50u
+#define HOSTEMU_HX711_HISTORY_LEN           64u
+
+/**
+ * @brief Produces the raw value of a conversion.
+ *
+ * @param ctx user context
+ * @param index conversion index since power up
+ * @param gain_pulses 25, 26 or 27
+ * @return int32_t value, clamped to 24 bits by the model
+ */
+typedef int32_t (*hostemu_hx711_source_t)(
+    void* ctx,
+    uint32_t index,
+    uint8_t gain_pulses);
+
+/**
+ * @brief Optionally overrides the time between conversions.
+ *
+ * @param ctx user context
+ * @param index index of the conversion about to be scheduled
+ * @return uint64_t cycles until that conversion is ready
+ */
+typedef uint64_t (*hostemu_hx711_interval_t)(
+    void* ctx,
+    uint32_t index);
+
+typedef struct {
+    uint clock_pin;
+    uint data_pin;
+    uint32_t rate;
+    int32_t ppm;
+    uint32_t first_ready_us;
+    uint32_t dout_delay_ns;
+    hostemu_hx711_source_t source;
+    hostemu_hx711_interval_t interval;
+    void* ctx;
+} hostemu_hx711_config_t;
+
+typedef struct {
+    int32_t value;
+    uint32_t index;
+    uint8_t converted_gain_pulses;
+    uint8_t pulses;
+    uint64_t ready_cycle;
+    uint64_t read_cycle;
+} hostemu_hx711_read_t;
+
+typedef struct {
+    uint32_t conversions;
+    uint32_t reads;
+    uint32_t missed;
+    uint32_t aborted;
+    uint32_t power_downs;
+    uint32_t stray_pulses;
+} hostemu_hx711_stats_t;
+
+typedef struct {
+    hostemu_device_t dev;
+    hostemu_hx711_config_t cfg;
+    uint64_t period;
+    bool powered;
+    bool sck;
+    bool ready;
+    uint8_t pulses;
+    uint8_t gain_pulses;
+    uint8_t converted_gain_pulses;
+    int32_t latched;
+    uint32_t index;
+    uint64_t ready_cycle;
+    uint64_t next_conversion;
+    uint64_t power_down_at;
+    uint64_t dout_at;
+    int dout_next;
+    hostemu_hx711_stats_t stats;
+    hostemu_hx711_read_t history[HOSTEMU_HX711_HISTORY_LEN];
+    uint32_t history_len;
+} hostemu_hx711_t;
+
+void hostemu_hx711_default_config(hostemu_hx711_config_t* cfg);
+
+/**
+ * @brief Attaches an HX711 model to the emulated pins. The chip starts
+ * powered up.
+ *
+ * @param hx
+ * @param cfg
+ */
+void hostemu_hx711_attach(
+    hostemu_hx711_t* hx,
+    const hostemu_hx711_config_t* cfg);
+
+/**
+ * @brief Returns one of the most recent complete reads.
+ *
+ * @param hx
+ * @param back 0 for the latest read, 1 for the one before, ...
+ * @return const hostemu_hx711_read_t* NULL if there is no such read
+ */
+const hostemu_hx711_read_t* hostemu_hx711_get_read(
+    const hostemu_hx711_t* hx,
+    uint32_t back);
+
+#endif
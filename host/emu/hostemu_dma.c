@@ -0,0 +1,423 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+#include "pico/platform.h"
+#include "hostemu.h"
+#include "hostemu_internal.h"
+
+dma_hw_t hostemu_dma_hw;
+
+static struct {
+    uint32_t claimed;
+    uint32_t busy;
+    uint32_t reload[NUM_DMA_CHANNELS];
+    uint32_t irq_lines;
+} hostemu__dma;
+
+static void hostemu__dma_sync(void) {
+
+    dma_hw_t* const hw = &hostemu_dma_hw;
+
+    for(uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if(hostemu__dma.busy & (1u << ch)) {
+            hw->ch[ch].ctrl_trig |= DMA_CH0_CTRL_TRIG_BUSY_BITS;
+        }
+        else {
+            hw->ch[ch].ctrl_trig &= ~DMA_CH0_CTRL_TRIG_BUSY_BITS;
+        }
+    }
+
+    hw->ints0 = (hw->intr & hw->inte0) | hw->intf0;
+    hw->ints1 = (hw->intr & hw->inte1) | hw->intf1;
+
+    hostemu__dma.irq_lines =
+        (hw->ints0 != 0 ? 1u << DMA_IRQ_0 : 0u) |
+        (hw->ints1 != 0 ? 1u << DMA_IRQ_1 : 0u);
+
+}
+
+static void hostemu__dma_cpu_done(void) {
+    hostemu__touch();
+    hostemu__dma_sync();
+    hostemu__irq_sync();
+}
+
+void hostemu__dma_reset(void) {
+    memset(&hostemu__dma, 0, sizeof(hostemu__dma));
+    memset((void*)&hostemu_dma_hw, 0, sizeof(hostemu_dma_hw));
+    hostemu__dma_sync();
+}
+
+uint32_t hostemu__dma_irq_lines(void) {
+    return hostemu__dma.irq_lines;
+}
+
+static void hostemu__dma_trigger(const uint ch) {
+
+    dma_channel_hw_t* const regs = &hostemu_dma_hw.ch[ch];
+
+    if((regs->ctrl_trig & DMA_CH0_CTRL_TRIG_EN_BITS) == 0) {
+        return;
+    }
+
+    if(hostemu__dma.busy & (1u << ch)) {
+        return;
+    }
+
+    regs->transfer_count = hostemu__dma.reload[ch];
+
+    if(regs->transfer_count == 0) {
+        return;
+    }
+
+    hostemu__dma.busy |= 1u << ch;
+    hostemu__touch();
+
+}
+
+static bool hostemu__dma_ready(const uint ch) {
+    const uint dreq = (hostemu_dma_hw.ch[ch].ctrl_trig & DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) >>
+        DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB;
+    if(dreq == DREQ_FORCE) {
+        return true;
+    }
+    if(dreq <= DREQ_PIO1_RX3) {
+        return hostemu__pio_dreq(dreq);
+    }
+    panic("DREQ %u is not emulated", dreq);
+}
+
+static uint32_t hostemu__dma_read(const uintptr_t addr, const uint size) {
+
+    uint32_t data;
+
+    if(hostemu__pio_fifo_access(addr, false, &data)) {
+        return data;
+    }
+
+    if(addr == (uintptr_t)&timer_hw->timerawl) {
+        return (uint32_t)(hostemu__now / HOSTEMU_CYCLES_PER_US);
+    }
+
+    if(addr == (uintptr_t)&timer_hw->timerawh) {
+        return (uint32_t)((hostemu__now / HOSTEMU_CYCLES_PER_US) >> 32);
+    }
+
+    switch(size) {
+        case 1:
+            return *(volatile const uint8_t*)addr;
+        case 2:
+            return *(volatile const uint16_t*)addr;
+        default:
+            return *(volatile const uint32_t*)addr;
+    }
+
+}
+
+static void hostemu__dma_write(
+    const uintptr_t addr,
+    const uint size,
+    uint32_t data) {
+
+        if(hostemu__pio_fifo_access(addr, true, &data)) {
+            return;
+        }
+
+        switch(size) {
+            case 1:
+                *(volatile uint8_t*)addr = (uint8_t)data;
+                break;
+            case 2:
+                *(volatile uint16_t*)addr = (uint16_t)data;
+                break;
+            default:
+                *(volatile uint32_t*)addr = data;
+                break;
+        }
+
+}
+
+static uintptr_t hostemu__dma_advance(
+    const uintptr_t addr,
+    const uint size,
+    const uint ring_bits) {
+        if(ring_bits == 0) {
+            return addr + size;
+        }
+        const uintptr_t mask = ((uintptr_t)1 << ring_bits) - 1;
+        return (addr & ~mask) | ((addr + size) & mask);
+}
+
+void hostemu__dma_tick(void) {
+
+    uint32_t busy = hostemu__dma.busy;
+    bool changed = false;
+
+    while(busy != 0) {
+
+        const uint ch = (uint)__builtin_ctz(busy);
+        busy &= busy - 1;
+
+        if(!hostemu__dma_ready(ch)) {
+            continue;
+        }
+
+        dma_channel_hw_t* const regs = &hostemu_dma_hw.ch[ch];
+        const uint32_t ctrl = regs->ctrl_trig;
+        const uint size = 1u << ((ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+        const uint ring_bits = (ctrl & DMA_CH0_CTRL_TRIG_RING_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_RING_SIZE_LSB;
+        const bool ring_write = (ctrl & DMA_CH0_CTRL_TRIG_RING_SEL_BITS) != 0;
+
+        uint32_t data = hostemu__dma_read(regs->read_addr, size);
+
+        if(ctrl & DMA_CH0_CTRL_TRIG_BSWAP_BITS) {
+            if(size == 4) {
+                data = __builtin_bswap32(data);
+            }
+            else if(size == 2) {
+                data = __builtin_bswap16((uint16_t)data);
+            }
+        }
+
+        hostemu__dma_write(regs->write_addr, size, data);
+
+        if(ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_BITS) {
+            regs->read_addr = hostemu__dma_advance(
+                regs->read_addr, size, ring_write ? 0 : ring_bits);
+        }
+
+        if(ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS) {
+            regs->write_addr = hostemu__dma_advance(
+                regs->write_addr, size, ring_write ? ring_bits : 0);
+        }
+
+        changed = true;
+
+        if(--regs->transfer_count != 0) {
+            continue;
+        }
+
+        hostemu__dma.busy &= ~(1u << ch);
+
+        if((ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS) == 0) {
+            hostemu_dma_hw.intr |= 1u << ch;
+        }
+
+        const uint chain_to = (ctrl & DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) >>
+            DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB;
+
+        if(chain_to != ch) {
+            hostemu__dma_trigger(chain_to);
+        }
+
+    }
+
+    if(changed) {
+        hostemu__touch();
+        hostemu__dma_sync();
+    }
+
+}
+
+bool hostemu__dma_quiescent(void) {
+    uint32_t busy = hostemu__dma.busy;
+    while(busy != 0) {
+        const uint ch = (uint)__builtin_ctz(busy);
+        busy &= busy - 1;
+        if(hostemu__dma_ready(ch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void dma_channel_claim(const uint channel) {
+    check_dma_channel_param(channel);
+    dma_claim_mask(1u << channel);
+}
+
+void dma_claim_mask(const uint32_t channel_mask) {
+    if(hostemu__dma.claimed & channel_mask) {
+        panic("DMA channel already claimed");
+    }
+    hostemu__dma.claimed |= channel_mask;
+}
+
+void dma_channel_unclaim(const uint channel) {
+    check_dma_channel_param(channel);
+    hostemu__dma.claimed &= ~(1u << channel);
+}
+
+void dma_unclaim_mask(const uint32_t channel_mask) {
+    hostemu__dma.claimed &= ~channel_mask;
+}
+
+int dma_claim_unused_channel(const bool required) {
+    for(uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if((hostemu__dma.claimed & (1u << ch)) == 0) {
+            hostemu__dma.claimed |= 1u << ch;
+            return (int)ch;
+        }
+    }
+    if(required) {
+        panic("No DMA channels are available");
+    }
+    return -1;
+}
+
+bool dma_channel_is_claimed(const uint channel) {
+    check_dma_channel_param(channel);
+    return (hostemu__dma.claimed & (1u << channel)) != 0;
+}
+
+dma_channel_config dma_get_channel_config(const uint channel) {
+    check_dma_channel_param(channel);
+    dma_channel_config c;
+    c.ctrl = hostemu_dma_hw.ch[channel].ctrl_trig & ~DMA_CH0_CTRL_TRIG_BUSY_BITS;
+    return c;
+}
+
+void dma_channel_set_config(
+    const uint channel,
+    const dma_channel_config* const config,
+    const bool trigger) {
+        check_dma_channel_param(channel);
+        hostemu_dma_hw.ch[channel].ctrl_trig =
+            (config->ctrl & ~DMA_CH0_CTRL_TRIG_BUSY_BITS) |
+            (hostemu_dma_hw.ch[channel].ctrl_trig & DMA_CH0_CTRL_TRIG_BUSY_BITS);
+        if(trigger) {
+            hostemu__dma_trigger(channel);
+        }
+        hostemu__dma_cpu_done();
+}
+
+void dma_channel_set_read_addr(
+    const uint channel,
+    const volatile void* const read_addr,
+    const bool trigger) {
+        check_dma_channel_param(channel);
+        hostemu_dma_hw.ch[channel].read_addr = (uintptr_t)read_addr;
+        if(trigger) {
+            hostemu__dma_trigger(channel);
+        }
+        hostemu__dma_cpu_done();
+}
+
+void dma_channel_set_write_addr(
+    const uint channel,
+    volatile void* const write_addr,
+    const bool trigger) {
+        check_dma_channel_param(channel);
+        hostemu_dma_hw.ch[channel].write_addr = (uintptr_t)write_addr;
+        if(trigger) {
+            hostemu__dma_trigger(channel);
+        }
+        hostemu__dma_cpu_done();
+}
+
+void dma_channel_set_trans_count(
+    const uint channel,
+    const uint32_t trans_count,
+    const bool trigger) {
+        check_dma_channel_param(channel);
+        hostemu__dma.reload[channel] = trans_count;
+        if(trigger) {
+            hostemu__dma_trigger(channel);
+        }
+        hostemu__dma_cpu_done();
+}
+
+void dma_channel_configure(
+    const uint channel,
+    const dma_channel_config* const config,
+    volatile void* const write_addr,
+    const volatile void* const read_addr,
+    const uint transfer_count,
+    const bool trigger) {
+        dma_channel_set_read_addr(channel, read_addr, false);
+        dma_channel_set_write_addr(channel, write_addr, false);
+        dma_channel_set_trans_count(channel, transfer_count, false);
+        dma_channel_set_config(channel, config, trigger);
+}
+
+void dma_start_channel_mask(uint32_t chan_mask) {
+    while(chan_mask != 0) {
+        const uint ch = (uint)__builtin_ctz(chan_mask);
+        chan_mask &= chan_mask - 1;
+        check_dma_channel_param(ch);
+        hostemu__dma_trigger(ch);
+    }
+    hostemu__dma_cpu_done();
+}
+
+void dma_channel_abort(const uint channel) {
+    check_dma_channel_param(channel);
+    hostemu__dma.busy &= ~(1u << channel);
+    hostemu__dma_cpu_done();
+}
+
+void dma_irqn_set_channel_mask_enabled(
+    const uint irq_index,
+    const uint32_t channel_mask,
+    const bool enabled) {
+        assert(irq_index <= 1);
+        volatile uint32_t* const inte = irq_index
+            ? &hostemu_dma_hw.inte1
+            : &hostemu_dma_hw.inte0;
+        if(enabled) {
+            *inte |= channel_mask;
+        }
+        else {
+            *inte &= ~channel_mask;
+        }
+        hostemu__dma_cpu_done();
+}
+
+bool dma_irqn_get_channel_status(const uint irq_index, const uint channel) {
+    assert(irq_index <= 1);
+    check_dma_channel_param(channel);
+    const uint32_t ints = irq_index ? hostemu_dma_hw.ints1 : hostemu_dma_hw.ints0;
+    return (ints & (1u << channel)) != 0;
+}
+
+void dma_irqn_acknowledge_channel(const uint irq_index, const uint channel) {
+    assert(irq_index <= 1);
+    check_dma_channel_param(channel);
+    hostemu_dma_hw.intr &= ~(1u << channel);
+    hostemu__dma_cpu_done();
+}
+
+bool dma_channel_is_busy(const uint channel) {
+    check_dma_channel_param(channel);
+    hostemu_poll();
+    return (hostemu__dma.busy & (1u << channel)) != 0;
+}
+
+void dma_channel_wait_for_finish_blocking(const uint channel) {
+    while(dma_channel_is_busy(channel)) {
+        //wait
+    }
+}
@@ -0,0 +1,218 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+#include "hardware/gpio.h"
+#include "pico/platform.h"
+#include "hostemu.h"
+#include "hostemu_internal.h"
+
+#define HOSTEMU_GPIO_MASK ((1u << NUM_BANK0_GPIOS) - 1u)
+
+static struct {
+    uint8_t func[NUM_BANK0_GPIOS];
+    uint32_t sio_out;
+    uint32_t sio_oe;
+    uint32_t ext_mask;
+    uint32_t ext_levels;
+    uint32_t pull_up;
+    uint32_t pull_down;
+    uint32_t input_enabled;
+    uint32_t levels;
+} hostemu__gpio;
+
+void hostemu__gpio_reset(void) {
+    memset(&hostemu__gpio, 0, sizeof(hostemu__gpio));
+    for(uint i = 0; i < NUM_BANK0_GPIOS; ++i) {
+        hostemu__gpio.func[i] = GPIO_FUNC_NULL;
+    }
+    //pads reset with pull downs and inputs enabled
+    hostemu__gpio.pull_down = HOSTEMU_GPIO_MASK;
+    hostemu__gpio.input_enabled = HOSTEMU_GPIO_MASK;
+    hostemu__devices_reset();
+}
+
+uint32_t hostemu__gpio_inputs(void) {
+    return hostemu__gpio.levels & hostemu__gpio.input_enabled;
+}
+
+void hostemu__gpio_update(uint32_t mask) {
+
+    uint32_t pio_out[NUM_PIOS];
+    uint32_t pio_oe[NUM_PIOS];
+
+    for(uint i = 0; i < NUM_PIOS; ++i) {
+        hostemu__pio_pads(i, &pio_out[i], &pio_oe[i]);
+    }
+
+    uint32_t levels = hostemu__gpio.levels;
+    const uint32_t prev = levels;
+
+    mask &= HOSTEMU_GPIO_MASK;
+
+    while(mask != 0) {
+
+        const uint gpio = (uint)__builtin_ctz(mask);
+        const uint32_t bit = 1u << gpio;
+        int level = -1;
+
+        mask &= mask - 1;
+
+        switch(hostemu__gpio.func[gpio]) {
+            case GPIO_FUNC_SIO:
+                if(hostemu__gpio.sio_oe & bit) {
+                    level = (hostemu__gpio.sio_out & bit) != 0;
+                }
+                break;
+            case GPIO_FUNC_PIO0:
+            case GPIO_FUNC_PIO1: {
+                const uint idx = hostemu__gpio.func[gpio] - GPIO_FUNC_PIO0;
+                if(pio_oe[idx] & bit) {
+                    level = (pio_out[idx] & bit) != 0;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        if(level < 0 && (hostemu__gpio.ext_mask & bit)) {
+            level = (hostemu__gpio.ext_levels & bit) != 0;
+        }
+
+        if(level < 0) {
+            if(hostemu__gpio.pull_up & bit) {
+                level = 1;
+            }
+            else if(hostemu__gpio.pull_down & bit) {
+                level = 0;
+            }
+            else {
+                //floating; the bus keeper holds the last level
+                level = (levels & bit) != 0;
+            }
+        }
+
+        levels = level ? (levels | bit) : (levels & ~bit);
+
+    }
+
+    if(levels != prev) {
+        hostemu__gpio.levels = levels;
+        hostemu__touch();
+        hostemu__devices_pin_changed(levels ^ prev, levels);
+    }
+
+}
+
+void hostemu_gpio_drive(const uint gpio, const int level) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    const uint32_t bit = 1u << gpio;
+    if(level < 0) {
+        hostemu__gpio.ext_mask &= ~bit;
+    }
+    else {
+        hostemu__gpio.ext_mask |= bit;
+        hostemu__gpio.ext_levels = level
+            ? (hostemu__gpio.ext_levels | bit)
+            : (hostemu__gpio.ext_levels & ~bit);
+    }
+    hostemu__gpio_update(bit);
+}
+
+bool hostemu_gpio_level(const uint gpio) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    return (hostemu__gpio.levels >> gpio) & 1u;
+}
+
+void gpio_set_function(const uint gpio, const enum gpio_function fn) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    hostemu__gpio.func[gpio] = (uint8_t)fn;
+    //selecting a function also enables the input and output of the pad
+    hostemu__gpio.input_enabled |= 1u << gpio;
+    hostemu__gpio_update(1u << gpio);
+}
+
+enum gpio_function gpio_get_function(const uint gpio) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    return (enum gpio_function)hostemu__gpio.func[gpio];
+}
+
+void gpio_init(const uint gpio) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    hostemu__gpio.sio_oe &= ~(1u << gpio);
+    hostemu__gpio.sio_out &= ~(1u << gpio);
+    gpio_set_function(gpio, GPIO_FUNC_SIO);
+}
+
+void gpio_deinit(const uint gpio) {
+    gpio_set_function(gpio, GPIO_FUNC_NULL);
+}
+
+void gpio_init_mask(uint gpio_mask) {
+    while(gpio_mask != 0) {
+        gpio_init((uint)__builtin_ctz(gpio_mask));
+        gpio_mask &= gpio_mask - 1;
+    }
+}
+
+void gpio_set_pulls(const uint gpio, const bool up, const bool down) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    const uint32_t bit = 1u << gpio;
+    hostemu__gpio.pull_up = up
+        ? (hostemu__gpio.pull_up | bit)
+        : (hostemu__gpio.pull_up & ~bit);
+    hostemu__gpio.pull_down = down
+        ? (hostemu__gpio.pull_down | bit)
+        : (hostemu__gpio.pull_down & ~bit);
+    hostemu__gpio_update(bit);
+}
+
+void gpio_set_input_enabled(const uint gpio, const bool enabled) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    const uint32_t bit = 1u << gpio;
+    hostemu__gpio.input_enabled = enabled
+        ? (hostemu__gpio.input_enabled | bit)
+        : (hostemu__gpio.input_enabled & ~bit);
+    hostemu__touch();
+}
+
+bool gpio_get(const uint gpio) {
+    assert(gpio < NUM_BANK0_GPIOS);
+    hostemu_poll();
+    return (hostemu__gpio_inputs() >> gpio) & 1u;
+}
+
+uint32_t gpio_get_all(void) {
+    hostemu_poll();
+    return hostemu__gpio_inputs();
+}
+
+void gpio_put_masked(const uint32_t mask, const uint32_t value) {
+    hostemu__gpio.sio_out = (hostemu__gpio.sio_out & ~mask) | (value & mask);
+    hostemu__gpio_update(mask);
+}
+
+void gpio_set_dir_masked(const uint32_t mask, const uint32_t value) {
+    hostemu__gpio.sio_oe = (hostemu__gpio.sio_oe & ~mask) | (value & mask);
+    hostemu__gpio_update(mask);
+}
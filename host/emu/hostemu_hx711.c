@@ -0,0 +1,305 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stddef.h>
+#include <string.h>
+#include "pico/platform.h"
+#include "hostemu.h"
+#include "hostemu_internal.h"
+
+/**
+ * Number of conversion periods before the first conversion after
+ * power up is ready, ie. the settling time (400ms at 10SPS, 50ms at
+ * 80SPS).
+ */
+#define HOSTEMU_HX711_SETTLING_PERIODS 4u
+
+#define HOSTEMU_HX711_MIN_VALUE (-0x800000)
+#define HOSTEMU_HX711_MAX_VALUE 0x7fffff
+
+typedef enum {
+    HOSTEMU_HX711_IDLE = 0,
+    HOSTEMU_HX711_READY,
+    HOSTEMU_HX711_READING,
+    HOSTEMU_HX711_GAIN
+} hostemu_hx711_state_t;
+
+static hostemu_hx711_state_t hostemu__hx711_state(const hostemu_hx711_t* const hx) {
+    if(hx->ready) {
+        return hx->pulses == 0 ? HOSTEMU_HX711_READY : HOSTEMU_HX711_READING;
+    }
+    return hx->pulses >= 24 ? HOSTEMU_HX711_GAIN : HOSTEMU_HX711_IDLE;
+}
+
+static uint64_t hostemu__hx711_interval(
+    const hostemu_hx711_t* const hx,
+    const uint32_t index) {
+        if(hx->cfg.interval != NULL) {
+            return hx->cfg.interval(hx->cfg.ctx, index);
+        }
+        return hx->period;
+}
+
+static void hostemu__hx711_schedule(hostemu_hx711_t* const hx) {
+    uint64_t next = MIN(hx->power_down_at, hx->dout_at);
+    if(hx->powered) {
+        next = MIN(next, hx->next_conversion);
+    }
+    hostemu_device_schedule(&hx->dev, next);
+}
+
+static void hostemu__hx711_dout(
+    hostemu_hx711_t* const hx,
+    const int level,
+    const bool delayed) {
+        if(delayed) {
+            hx->dout_next = level;
+            hx->dout_at = hostemu__now +
+                ((uint64_t)hx->cfg.dout_delay_ns * HOSTEMU_CYCLES_PER_US + 999) / 1000;
+        }
+        else {
+            hx->dout_at = HOSTEMU_NO_EVENT;
+            hostemu_gpio_drive(hx->cfg.data_pin, level);
+        }
+}
+
+static hostemu_hx711_read_t* hostemu__hx711_history_push(hostemu_hx711_t* const hx) {
+    hostemu_hx711_read_t* const r =
+        &hx->history[hx->history_len % HOSTEMU_HX711_HISTORY_LEN];
+    ++hx->history_len;
+    memset(r, 0, sizeof(*r));
+    return r;
+}
+
+static hostemu_hx711_read_t* hostemu__hx711_history_last(hostemu_hx711_t* const hx) {
+    assert(hx->history_len > 0);
+    return &hx->history[(hx->history_len - 1) % HOSTEMU_HX711_HISTORY_LEN];
+}
+
+static void hostemu__hx711_convert(hostemu_hx711_t* const hx) {
+
+    const uint32_t index = hx->index++;
+    int32_t value = 0;
+
+    if(hx->cfg.source != NULL) {
+        value = hx->cfg.source(hx->cfg.ctx, index, hx->gain_pulses);
+    }
+
+    value = MAX(HOSTEMU_HX711_MIN_VALUE, MIN(HOSTEMU_HX711_MAX_VALUE, value));
+
+    ++hx->stats.conversions;
+    hx->next_conversion += hostemu__hx711_interval(hx, hx->index);
+
+    switch(hostemu__hx711_state(hx)) {
+        case HOSTEMU_HX711_READING:
+            //the output register is not updated mid-read
+            ++hx->stats.missed;
+            return;
+        case HOSTEMU_HX711_READY:
+            ++hx->stats.missed;
+            break;
+        default:
+            break;
+    }
+
+    hx->latched = value;
+    hx->converted_gain_pulses = hx->gain_pulses;
+    hx->ready_cycle = hostemu__now;
+    hx->ready = true;
+    hx->pulses = 0;
+    hostemu__hx711_dout(hx, 0, false);
+
+}
+
+static void hostemu__hx711_event(hostemu_device_t* const dev) {
+
+    hostemu_hx711_t* const hx = (hostemu_hx711_t*)dev;
+
+    if(hx->dout_at <= hostemu__now) {
+        hostemu__hx711_dout(hx, hx->dout_next, false);
+    }
+
+    if(hx->power_down_at <= hostemu__now) {
+        hx->power_down_at = HOSTEMU_NO_EVENT;
+        if(hx->powered && hx->sck) {
+            if(hostemu__hx711_state(hx) == HOSTEMU_HX711_READING) {
+                ++hx->stats.aborted;
+            }
+            hx->powered = false;
+            hx->ready = false;
+            hx->pulses = 0;
+            ++hx->stats.power_downs;
+            hostemu__hx711_dout(hx, 1, false);
+        }
+    }
+
+    while(hx->powered && hx->next_conversion <= hostemu__now) {
+        hostemu__hx711_convert(hx);
+    }
+
+    hostemu__hx711_schedule(hx);
+
+}
+
+static void hostemu__hx711_rising(hostemu_hx711_t* const hx) {
+
+    if(!hx->powered) {
+        return;
+    }
+
+    hx->power_down_at = hostemu__now +
+        hostemu_us_to_cycles(HOSTEMU_HX711_POWER_DOWN_US);
+
+    switch(hostemu__hx711_state(hx)) {
+
+        case HOSTEMU_HX711_READY:
+        case HOSTEMU_HX711_READING: {
+            ++hx->pulses;
+            const int bit = ((uint32_t)hx->latched >> (24 - hx->pulses)) & 1u;
+            hostemu__hx711_dout(hx, bit, true);
+            if(hx->pulses == 24) {
+                hostemu_hx711_read_t* const r = hostemu__hx711_history_push(hx);
+                r->value = hx->latched;
+                r->index = hx->index - 1;
+                r->converted_gain_pulses = hx->converted_gain_pulses;
+                r->pulses = 24;
+                r->ready_cycle = hx->ready_cycle;
+                r->read_cycle = hostemu__now;
+                hx->ready = false;
+                ++hx->stats.reads;
+            }
+            break;
+        }
+
+        case HOSTEMU_HX711_GAIN:
+            if(hx->pulses >= 27) {
+                ++hx->stats.stray_pulses;
+                break;
+            }
+            ++hx->pulses;
+            hx->gain_pulses = hx->pulses;
+            hostemu__hx711_history_last(hx)->pulses = hx->pulses;
+            if(hx->pulses == 25) {
+                hostemu__hx711_dout(hx, 1, true);
+            }
+            break;
+
+        default:
+            ++hx->stats.stray_pulses;
+            break;
+
+    }
+
+}
+
+static void hostemu__hx711_falling(hostemu_hx711_t* const hx) {
+
+    hx->power_down_at = HOSTEMU_NO_EVENT;
+
+    if(hx->powered) {
+        return;
+    }
+
+    //power up; the gain resets to 128
+    hx->powered = true;
+    hx->ready = false;
+    hx->pulses = 0;
+    hx->gain_pulses = 25;
+    hx->next_conversion = hostemu__now +
+        HOSTEMU_HX711_SETTLING_PERIODS * hostemu__hx711_interval(hx, hx->index);
+
+}
+
+static void hostemu__hx711_pin_changed(
+    hostemu_device_t* const dev,
+    const uint gpio,
+    const bool level) {
+
+        hostemu_hx711_t* const hx = (hostemu_hx711_t*)dev;
+
+        if(gpio != hx->cfg.clock_pin || level == hx->sck) {
+            return;
+        }
+
+        hx->sck = level;
+
+        if(level) {
+            hostemu__hx711_rising(hx);
+        }
+        else {
+            hostemu__hx711_falling(hx);
+        }
+
+        hostemu__hx711_schedule(hx);
+
+}
+
+void hostemu_hx711_default_config(hostemu_hx711_config_t* const cfg) {
+    assert(cfg != NULL);
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->rate = 80;
+    cfg->dout_delay_ns = HOSTEMU_HX711_DEFAULT_DOUT_DELAY_NS;
+}
+
+void hostemu_hx711_attach(
+    hostemu_hx711_t* const hx,
+    const hostemu_hx711_config_t* const cfg) {
+
+        assert(hx != NULL);
+        assert(cfg != NULL);
+        assert(cfg->rate > 0);
+        assert(cfg->clock_pin != cfg->data_pin);
+
+        memset(hx, 0, sizeof(*hx));
+
+        hx->cfg = *cfg;
+        hx->period = (uint64_t)((double)HOSTEMU_CLK_SYS_HZ / cfg->rate *
+            (1.0 + (double)cfg->ppm / 1e6));
+        hx->dev.watch_mask = 1u << cfg->clock_pin;
+        hx->dev.pin_changed = hostemu__hx711_pin_changed;
+        hx->dev.event = hostemu__hx711_event;
+        hx->dev.next_event = HOSTEMU_NO_EVENT;
+        hx->powered = true;
+        hx->sck = hostemu_gpio_level(cfg->clock_pin);
+        hx->gain_pulses = 25;
+        hx->converted_gain_pulses = 25;
+        hx->power_down_at = HOSTEMU_NO_EVENT;
+        hx->dout_at = HOSTEMU_NO_EVENT;
+        hx->next_conversion = hostemu__now + (cfg->first_ready_us != 0
+            ? hostemu_us_to_cycles(cfg->first_ready_us)
+            : hostemu__hx711_interval(hx, 0));
+
+        hostemu_device_attach(&hx->dev);
+        hostemu__hx711_dout(hx, 1, false);
+        hostemu__hx711_schedule(hx);
+
+}
+
+const hostemu_hx711_read_t* hostemu_hx711_get_read(
+    const hostemu_hx711_t* const hx,
+    const uint32_t back) {
+        assert(hx != NULL);
+        if(back >= hx->history_len || back >= HOSTEMU_HX711_HISTORY_LEN) {
+            return NULL;
+        }
+        return &hx->history[(hx->history_len - 1 - back) % HOSTEMU_HX711_HISTORY_LEN];
+}
@@ -0,0 +1,135 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HOSTEMU_INTERNAL_H_CC83C7C5_348A_46F6_896B_6F6DC684778C
+#define HOSTEMU_INTERNAL_H_CC83C7C5_348A_46F6_896B_6F6DC684778C
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hostemu.h"
+
+/**
+ * State shared between the emulator's translation units. Not for use
+ * by tests.
+ */
+
+extern uint64_t hostemu__now;
+
+/**
+ * Incremented whenever something a state machine or DMA channel could
+ * observe changes. Used to detect when nothing can happen until the
+ * next device event, so that time can be skipped.
+ */
+extern uint64_t hostemu__epoch;
+
+/**
+ * The core running the code under test: 0, or 1 while the entry
+ * function given to multicore_launch_core1 is running (see
+ * hostemu_multicore.c).
+ */
+extern uint hostemu__core_num;
+
+static inline void hostemu__touch(void) {
+    ++hostemu__epoch;
+}
+
+/**
+ * Recomputes interrupt lines and dispatches any pending, enabled
+ * interrupt if the CPU can take it.
+ */
+void hostemu__irq_sync(void);
+
+/**
+ * Lets emulated time pass until the given cycle, or, if stop_on_event,
+ * until an event is signalled (see __wfe()).
+ */
+void hostemu__run_until(uint64_t cycle, bool stop_on_event);
+
+/**
+ * Returns whether a core's event flag is set.
+ */
+bool hostemu__event_get(uint core);
+
+void hostemu__multicore_reset(void);
+
+/**
+ * Returns whether core 1 can continue, ie. it has been launched and
+ * is not waiting, or its event flag is set or its wait timed out.
+ */
+bool hostemu__core1_runnable(void);
+
+/**
+ * Returns the cycle at which a waiting core 1 times out.
+ */
+uint64_t hostemu__core1_wake_cycle(void);
+
+/**
+ * Called as core 0. Runs core 1 until it waits or returns.
+ */
+void hostemu__core1_resume(void);
+
+/**
+ * Called as core 1. Hands control back to core 0 until core 1 is
+ * runnable again, ie. until an event or the given cycle.
+ */
+void hostemu__core1_yield(uint64_t cycle);
+
+void hostemu__gpio_reset(void);
+
+uint32_t hostemu__gpio_inputs(void);
+
+void hostemu__gpio_update(uint32_t mask);
+
+void hostemu__devices_reset(void);
+
+uint64_t hostemu__devices_next_event(void);
+
+void hostemu__devices_run_due(void);
+
+void hostemu__devices_pin_changed(uint32_t changed, uint32_t levels);
+
+void hostemu__pio_reset(void);
+
+void hostemu__pio_tick(void);
+
+bool hostemu__pio_quiescent(void);
+
+void hostemu__pio_skipped(void);
+
+uint32_t hostemu__pio_irq_lines(void);
+
+void hostemu__pio_pads(uint pio_index, uint32_t* out, uint32_t* oe);
+
+bool hostemu__pio_dreq(uint dreq);
+
+bool hostemu__pio_fifo_access(uintptr_t addr, bool write, uint32_t* data);
+
+void hostemu__dma_reset(void);
+
+void hostemu__dma_tick(void);
+
+bool hostemu__dma_quiescent(void);
+
+uint32_t hostemu__dma_irq_lines(void);
+
+#endif
@@ -0,0 +1,221 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stddef.h>
+#include <string.h>
+#include <ucontext.h>
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hostemu.h"
+#include "hostemu_internal.h"
+
+#define HOSTEMU_CORE1_STACK_SIZE (256u * 1024u)
+
+typedef enum {
+    HOSTEMU_CORE1_RESET = 0,
+    HOSTEMU_CORE1_RUNNING,
+    HOSTEMU_CORE1_WAITING,
+    HOSTEMU_CORE1_RETURNED
+} hostemu_core1_state_t;
+
+typedef struct {
+    uint32_t words[SIO_FIFO_DEPTH];
+    uint head;
+    uint len;
+} hostemu_fifo_t;
+
+static struct {
+    hostemu_core1_state_t state;
+    void (*entry)(void);
+    uint64_t wake_cycle;
+    ucontext_t core0_ctx;
+    ucontext_t core1_ctx;
+    //fifos[n] is read by core n and written by the other core
+    hostemu_fifo_t fifos[NUM_CORES];
+} hostemu__mc;
+
+static uint8_t hostemu__core1_stack[HOSTEMU_CORE1_STACK_SIZE];
+
+void hostemu__multicore_reset(void) {
+    memset(&hostemu__mc, 0, sizeof(hostemu__mc));
+    hostemu__mc.wake_cycle = HOSTEMU_NO_EVENT;
+}
+
+static void hostemu__core1_trampoline(void) {
+    hostemu__mc.entry();
+    //on the RP2040, core 1 returns to the bootrom
+    hostemu__mc.state = HOSTEMU_CORE1_RETURNED;
+    hostemu__core_num = 0;
+    swapcontext(&hostemu__mc.core1_ctx, &hostemu__mc.core0_ctx);
+    panic("core 1 resumed after returning");
+}
+
+bool hostemu__core1_runnable(void) {
+    switch(hostemu__mc.state) {
+        case HOSTEMU_CORE1_RUNNING:
+            return true;
+        case HOSTEMU_CORE1_WAITING:
+            return hostemu__event_get(1) ||
+                hostemu__now >= hostemu__mc.wake_cycle;
+        default:
+            return false;
+    }
+}
+
+uint64_t hostemu__core1_wake_cycle(void) {
+    return hostemu__mc.state == HOSTEMU_CORE1_WAITING
+        ? hostemu__mc.wake_cycle
+        : HOSTEMU_NO_EVENT;
+}
+
+void hostemu__core1_resume(void) {
+    assert(hostemu__core_num == 0);
+    assert(hostemu__core1_runnable());
+    hostemu__mc.state = HOSTEMU_CORE1_RUNNING;
+    hostemu__mc.wake_cycle = HOSTEMU_NO_EVENT;
+    hostemu__core_num = 1;
+    swapcontext(&hostemu__mc.core0_ctx, &hostemu__mc.core1_ctx);
+    assert(hostemu__core_num == 0);
+}
+
+void hostemu__core1_yield(const uint64_t cycle) {
+    assert(hostemu__core_num == 1);
+    hostemu__mc.state = HOSTEMU_CORE1_WAITING;
+    hostemu__mc.wake_cycle = cycle;
+    hostemu__core_num = 0;
+    swapcontext(&hostemu__mc.core1_ctx, &hostemu__mc.core0_ctx);
+    assert(hostemu__core_num == 1);
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+
+    assert(entry != NULL);
+    assert(hostemu__core_num == 0);
+
+    if(hostemu__mc.state == HOSTEMU_CORE1_RUNNING ||
+        hostemu__mc.state == HOSTEMU_CORE1_WAITING) {
+            panic("core 1 is already running");
+    }
+
+    getcontext(&hostemu__mc.core1_ctx);
+    hostemu__mc.core1_ctx.uc_stack.ss_sp = hostemu__core1_stack;
+    hostemu__mc.core1_ctx.uc_stack.ss_size = sizeof(hostemu__core1_stack);
+    hostemu__mc.core1_ctx.uc_link = NULL;
+    makecontext(&hostemu__mc.core1_ctx, hostemu__core1_trampoline, 0);
+
+    hostemu__mc.entry = entry;
+    hostemu__mc.state = HOSTEMU_CORE1_RUNNING;
+    memset(hostemu__mc.fifos, 0, sizeof(hostemu__mc.fifos));
+
+    //let it start
+    hostemu_poll();
+
+}
+
+void multicore_reset_core1(void) {
+    assert(hostemu__core_num == 0);
+    hostemu__mc.state = HOSTEMU_CORE1_RESET;
+    hostemu__mc.wake_cycle = HOSTEMU_NO_EVENT;
+}
+
+bool multicore_fifo_rvalid(void) {
+    hostemu_poll();
+    return hostemu__mc.fifos[hostemu__core_num].len > 0;
+}
+
+bool multicore_fifo_wready(void) {
+    hostemu_poll();
+    return hostemu__mc.fifos[hostemu__core_num ^ 1].len < SIO_FIFO_DEPTH;
+}
+
+static void hostemu__fifo_push(const uint32_t data) {
+    hostemu_fifo_t* const f = &hostemu__mc.fifos[hostemu__core_num ^ 1];
+    assert(f->len < SIO_FIFO_DEPTH);
+    f->words[(f->head + f->len++) % SIO_FIFO_DEPTH] = data;
+    //as in the SDK, signal the other core
+    __sev();
+}
+
+static uint32_t hostemu__fifo_pop(void) {
+    hostemu_fifo_t* const f = &hostemu__mc.fifos[hostemu__core_num];
+    assert(f->len > 0);
+    const uint32_t data = f->words[f->head];
+    f->head = (f->head + 1) % SIO_FIFO_DEPTH;
+    --f->len;
+    return data;
+}
+
+void multicore_fifo_push_blocking(const uint32_t data) {
+    while(!multicore_fifo_wready()) {
+        __wfe();
+    }
+    hostemu__fifo_push(data);
+}
+
+bool multicore_fifo_push_timeout_us(
+    const uint32_t data,
+    const uint64_t timeout_us) {
+
+        const absolute_time_t end = make_timeout_time_us(timeout_us);
+
+        while(!multicore_fifo_wready()) {
+            if(best_effort_wfe_or_timeout(end)) {
+                return false;
+            }
+        }
+
+        hostemu__fifo_push(data);
+        return true;
+
+}
+
+uint32_t multicore_fifo_pop_blocking(void) {
+    while(!multicore_fifo_rvalid()) {
+        __wfe();
+    }
+    return hostemu__fifo_pop();
+}
+
+bool multicore_fifo_pop_timeout_us(
+    const uint64_t timeout_us,
+    uint32_t* const out) {
+
+        assert(out != NULL);
+
+        const absolute_time_t end = make_timeout_time_us(timeout_us);
+
+        while(!multicore_fifo_rvalid()) {
+            if(best_effort_wfe_or_timeout(end)) {
+                return false;
+            }
+        }
+
+        *out = hostemu__fifo_pop();
+        return true;
+
+}
+
+void multicore_fifo_drain(void) {
+    hostemu__mc.fifos[hostemu__core_num].len = 0;
+}
@@ -0,0 +1,1452 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "pico/platform.h"
+#include "hostemu.h"
+#include "hostemu_internal.h"
+
+#define REG(r) (*(volatile uint32_t*)&(r))
+
+typedef enum {
+    HOSTEMU__PIO_NEXT,
+    HOSTEMU__PIO_JUMP,
+    HOSTEMU__PIO_EXEC,
+    HOSTEMU__PIO_STALL
+} hostemu__pio_result_t;
+
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+    uint32_t isr;
+    uint32_t osr;
+    uint8_t isr_count;
+    uint8_t osr_count;
+    uint8_t pc;
+    uint8_t delay;
+    uint32_t rx[8];
+    uint8_t rx_head;
+    uint8_t rx_level;
+    uint32_t tx[8];
+    uint8_t tx_head;
+    uint8_t tx_level;
+    bool stalled;
+    bool stalled_exec;
+    uint16_t stalled_instr;
+    bool irq_wait_armed;
+    bool autopush_pending;
+    bool exec_pending;
+    uint16_t exec_instr;
+    uint64_t next_tick;
+    uint64_t stall_epoch;
+    bool steady;
+    uint64_t snap_epoch;
+    uint32_t snap[8];
+} hostemu__sm_t;
+
+typedef struct {
+    hostemu__sm_t sm[NUM_PIO_STATE_MACHINES];
+    uint32_t used_instr;
+    uint8_t claimed;
+    uint8_t enabled;
+    uint8_t irq_flags;
+    uint32_t fdebug;
+    uint32_t pad_out;
+    uint32_t pad_oe;
+    uint32_t irq_lines;
+    bool dirty;
+} hostemu__pio_t;
+
+pio_hw_t hostemu_pio_hw[NUM_PIOS];
+
+static hostemu__pio_t hostemu__pios[NUM_PIOS];
+
+static inline uint hostemu__pio_idx(const PIO pio) {
+    check_pio_param(pio);
+    return pio == pio1 ? 1u : 0u;
+}
+
+static inline uint hostemu__rx_cap(const uint32_t shiftctrl) {
+    if(shiftctrl & PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS) {
+        return 8;
+    }
+    return (shiftctrl & PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS) ? 0 : 4;
+}
+
+static inline uint hostemu__tx_cap(const uint32_t shiftctrl) {
+    if(shiftctrl & PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS) {
+        return 8;
+    }
+    return (shiftctrl & PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS) ? 0 : 4;
+}
+
+static inline uint hostemu__push_thresh(const uint32_t shiftctrl) {
+    const uint t = (shiftctrl & PIO_SM0_SHIFTCTRL_PUSH_THRESH_BITS) >>
+        PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB;
+    return t == 0 ? 32 : t;
+}
+
+static inline uint hostemu__pull_thresh(const uint32_t shiftctrl) {
+    const uint t = (shiftctrl & PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS) >>
+        PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB;
+    return t == 0 ? 32 : t;
+}
+
+static inline uint64_t hostemu__div256(const uint32_t clkdiv) {
+    uint64_t i = clkdiv >> PIO_SM0_CLKDIV_INT_LSB;
+    const uint64_t f = (clkdiv & PIO_SM0_CLKDIV_FRAC_BITS) >> PIO_SM0_CLKDIV_FRAC_LSB;
+    if(i == 0) {
+        i = 65536;
+    }
+    return (i << 8) + f;
+}
+
+static void hostemu__pio_sync(const uint p) {
+
+    hostemu__pio_t* const hp = &hostemu__pios[p];
+    pio_hw_t* const hw = &hostemu_pio_hw[p];
+
+    uint32_t fstat = 0;
+    uint32_t flevel = 0;
+    uint32_t intr = 0;
+
+    for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+        const hostemu__sm_t* const sm = &hp->sm[s];
+        const uint32_t shiftctrl = hw->sm[s].shiftctrl;
+        const uint rx_cap = hostemu__rx_cap(shiftctrl);
+        const uint tx_cap = hostemu__tx_cap(shiftctrl);
+        fstat |= (sm->rx_level == rx_cap ? 1u : 0u) << (PIO_FSTAT_RXFULL_LSB + s);
+        fstat |= (sm->rx_level == 0 ? 1u : 0u) << (PIO_FSTAT_RXEMPTY_LSB + s);
+        fstat |= (sm->tx_level == tx_cap ? 1u : 0u) << (PIO_FSTAT_TXFULL_LSB + s);
+        fstat |= (sm->tx_level == 0 ? 1u : 0u) << (PIO_FSTAT_TXEMPTY_LSB + s);
+        flevel |= ((uint32_t)sm->tx_level & 0xfu) << (8 * s);
+        flevel |= ((uint32_t)sm->rx_level & 0xfu) << (8 * s + 4);
+        intr |= (sm->rx_level != 0 ? 1u : 0u) << (PIO_INTR_SM0_RXNEMPTY_LSB + s);
+        intr |= (sm->tx_level < tx_cap ? 1u : 0u) << (PIO_INTR_SM0_TXNFULL_LSB + s);
+        REG(hw->sm[s].addr) = sm->pc;
+    }
+
+    intr |= (uint32_t)(hp->irq_flags & 0xfu) << PIO_INTR_SM0_LSB;
+
+    REG(hw->ctrl) = hp->enabled;
+    REG(hw->fstat) = fstat;
+    REG(hw->fdebug) = hp->fdebug;
+    REG(hw->flevel) = flevel;
+    REG(hw->irq) = hp->irq_flags;
+    REG(hw->intr) = intr;
+    REG(hw->ints0) = (intr & hw->inte0) | hw->intf0;
+    REG(hw->ints1) = (intr & hw->inte1) | hw->intf1;
+    REG(hw->dbg_padout) = hp->pad_out;
+    REG(hw->dbg_padoe) = hp->pad_oe;
+
+    hp->irq_lines =
+        (hw->ints0 != 0 ? 1u << (PIO0_IRQ_0 + 2 * p) : 0u) |
+        (hw->ints1 != 0 ? 1u << (PIO0_IRQ_1 + 2 * p) : 0u);
+
+    hp->dirty = false;
+
+}
+
+static void hostemu__pio_changed(const uint p) {
+    hostemu__touch();
+    hostemu__pios[p].dirty = true;
+}
+
+/**
+ * Called at the end of every SDK function which changes PIO state
+ * from the CPU.
+ */
+static void hostemu__pio_cpu_done(const uint p) {
+    hostemu__pio_changed(p);
+    hostemu__pio_sync(p);
+    hostemu__irq_sync();
+}
+
+static void hostemu__sm_reset(hostemu__sm_t* const sm) {
+    memset(sm, 0, sizeof(*sm));
+    sm->osr_count = 32;
+}
+
+void hostemu__pio_reset(void) {
+    memset(hostemu__pios, 0, sizeof(hostemu__pios));
+    memset((void*)hostemu_pio_hw, 0, sizeof(hostemu_pio_hw));
+    for(uint p = 0; p < NUM_PIOS; ++p) {
+        for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+            hostemu__sm_reset(&hostemu__pios[p].sm[s]);
+            hostemu_pio_hw[p].sm[s].clkdiv = 1u << PIO_SM0_CLKDIV_INT_LSB;
+            hostemu_pio_hw[p].sm[s].execctrl = 31u << PIO_SM0_EXECCTRL_WRAP_TOP_LSB;
+            hostemu_pio_hw[p].sm[s].shiftctrl =
+                PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_BITS | PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS;
+            hostemu_pio_hw[p].sm[s].pinctrl = 5u << PIO_SM0_PINCTRL_SET_COUNT_LSB;
+        }
+        hostemu__pio_sync(p);
+    }
+}
+
+void hostemu__pio_pads(
+    const uint pio_index,
+    uint32_t* const out,
+    uint32_t* const oe) {
+        *out = hostemu__pios[pio_index].pad_out;
+        *oe = hostemu__pios[pio_index].pad_oe;
+}
+
+uint32_t hostemu__pio_irq_lines(void) {
+    return hostemu__pios[0].irq_lines | hostemu__pios[1].irq_lines;
+}
+
+static void hostemu__pio_write_pads(
+    const uint p,
+    const uint base,
+    const uint count,
+    const uint32_t values,
+    const bool dirs) {
+
+        hostemu__pio_t* const hp = &hostemu__pios[p];
+        uint32_t mask = 0;
+        uint32_t vals = 0;
+
+        for(uint i = 0; i < count; ++i) {
+            const uint pin = (base + i) & 31u;
+            mask |= 1u << pin;
+            vals |= ((values >> i) & 1u) << pin;
+        }
+
+        uint32_t* const target = dirs ? &hp->pad_oe : &hp->pad_out;
+        const uint32_t next = (*target & ~mask) | vals;
+
+        if(next != *target) {
+            *target = next;
+            hostemu__pio_changed(p);
+            hostemu__gpio_update(mask);
+        }
+
+}
+
+static inline uint32_t hostemu__pio_in_pins(const uint base) {
+    const uint32_t v = hostemu__gpio_inputs();
+    return base == 0 ? v : (v >> base) | (v << (32 - base));
+}
+
+static inline uint hostemu__pio_irq_index(const uint s, const uint idx) {
+    if(idx & 0x10u) {
+        return (idx & 0x4u) | ((idx + s) & 0x3u);
+    }
+    return idx & 0x7u;
+}
+
+static void hostemu__pio_set_irq_flag(
+    const uint p,
+    const uint flag,
+    const bool set) {
+
+        hostemu__pio_t* const hp = &hostemu__pios[p];
+        const uint8_t next = set
+            ? (uint8_t)(hp->irq_flags | (1u << flag))
+            : (uint8_t)(hp->irq_flags & ~(1u << flag));
+
+        if(next != hp->irq_flags) {
+            hp->irq_flags = next;
+            hostemu__pio_changed(p);
+        }
+
+}
+
+static bool hostemu__rx_push(const uint p, const uint s, const uint32_t v) {
+    hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+    if(sm->rx_level >= hostemu__rx_cap(hostemu_pio_hw[p].sm[s].shiftctrl)) {
+        return false;
+    }
+    sm->rx[(sm->rx_head + sm->rx_level) & 7u] = v;
+    ++sm->rx_level;
+    hostemu__pio_changed(p);
+    return true;
+}
+
+static bool hostemu__rx_pop(const uint p, const uint s, uint32_t* const v) {
+    hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+    if(sm->rx_level == 0) {
+        return false;
+    }
+    *v = sm->rx[sm->rx_head];
+    sm->rx_head = (sm->rx_head + 1) & 7u;
+    --sm->rx_level;
+    hostemu__pio_changed(p);
+    return true;
+}
+
+static bool hostemu__tx_push(const uint p, const uint s, const uint32_t v) {
+    hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+    if(sm->tx_level >= hostemu__tx_cap(hostemu_pio_hw[p].sm[s].shiftctrl)) {
+        return false;
+    }
+    sm->tx[(sm->tx_head + sm->tx_level) & 7u] = v;
+    ++sm->tx_level;
+    hostemu__pio_changed(p);
+    return true;
+}
+
+static bool hostemu__tx_pop(const uint p, const uint s, uint32_t* const v) {
+    hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+    if(sm->tx_level == 0) {
+        return false;
+    }
+    *v = sm->tx[sm->tx_head];
+    sm->tx_head = (sm->tx_head + 1) & 7u;
+    --sm->tx_level;
+    hostemu__pio_changed(p);
+    return true;
+}
+
+static void hostemu__fifos_flush(const uint p, const uint s) {
+    hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+    sm->rx_head = sm->rx_level = 0;
+    sm->tx_head = sm->tx_level = 0;
+    hostemu__pio_changed(p);
+}
+
+static uint32_t hostemu__mov_src(
+    const uint p,
+    const uint s,
+    const uint src) {
+
+        const hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+        const pio_sm_hw_t* const regs = &hostemu_pio_hw[p].sm[s];
+
+        switch(src) {
+            case 0:
+                return hostemu__pio_in_pins(
+                    (regs->pinctrl & PIO_SM0_PINCTRL_IN_BASE_BITS) >> PIO_SM0_PINCTRL_IN_BASE_LSB);
+            case 1:
+                return sm->x;
+            case 2:
+                return sm->y;
+            case 5: {
+                const uint n = regs->execctrl & PIO_SM0_EXECCTRL_STATUS_N_BITS;
+                const uint level = (regs->execctrl & PIO_SM0_EXECCTRL_STATUS_SEL_BITS)
+                    ? sm->rx_level
+                    : sm->tx_level;
+                return level < n ? 0xffffffffu : 0u;
+            }
+            case 6:
+                return sm->isr;
+            case 7:
+                return sm->osr;
+            default:
+                return 0;
+        }
+
+}
+
+static hostemu__pio_result_t hostemu__sm_op(
+    const uint p,
+    const uint s,
+    const uint16_t instr) {
+
+        hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+        const pio_sm_hw_t* const regs = &hostemu_pio_hw[p].sm[s];
+        const uint32_t pinctrl = regs->pinctrl;
+        const uint32_t execctrl = regs->execctrl;
+        const uint32_t shiftctrl = regs->shiftctrl;
+        const uint op = (instr >> 13) & 7u;
+        const uint arg = (instr >> 5) & 7u;
+        const uint idx = instr & 0x1fu;
+
+        switch(op) {
+
+            case 0: { //jmp
+                bool take;
+                switch(arg) {
+                    case 0: take = true; break;
+                    case 1: take = sm->x == 0; break;
+                    case 2: take = sm->x != 0; --sm->x; break;
+                    case 3: take = sm->y == 0; break;
+                    case 4: take = sm->y != 0; --sm->y; break;
+                    case 5: take = sm->x != sm->y; break;
+                    case 6:
+                        take = (hostemu__gpio_inputs() >>
+                            ((execctrl & PIO_SM0_EXECCTRL_JMP_PIN_BITS) >> PIO_SM0_EXECCTRL_JMP_PIN_LSB)) & 1u;
+                        break;
+                    default:
+                        take = sm->osr_count < hostemu__pull_thresh(shiftctrl);
+                        break;
+                }
+                if(take) {
+                    sm->pc = (uint8_t)idx;
+                    return HOSTEMU__PIO_JUMP;
+                }
+                return HOSTEMU__PIO_NEXT;
+            }
+
+            case 1: { //wait
+                const uint pol = (instr >> 7) & 1u;
+                const uint src = (instr >> 5) & 3u;
+                uint level;
+                switch(src) {
+                    case 0:
+                        level = (hostemu__gpio_inputs() >> idx) & 1u;
+                        break;
+                    case 1:
+                        level = hostemu__pio_in_pins(
+                            (pinctrl & PIO_SM0_PINCTRL_IN_BASE_BITS) >> PIO_SM0_PINCTRL_IN_BASE_LSB) >> idx & 1u;
+                        break;
+                    case 2: {
+                        const uint flag = hostemu__pio_irq_index(s, idx);
+                        level = (hostemu__pios[p].irq_flags >> flag) & 1u;
+                        if(level == pol && pol) {
+                            hostemu__pio_set_irq_flag(p, flag, false);
+                        }
+                        break;
+                    }
+                    default:
+                        return HOSTEMU__PIO_NEXT;
+                }
+                return level == pol ? HOSTEMU__PIO_NEXT : HOSTEMU__PIO_STALL;
+            }
+
+            case 2: { //in
+                const uint thresh = hostemu__push_thresh(shiftctrl);
+                const bool autopush = (shiftctrl & PIO_SM0_SHIFTCTRL_AUTOPUSH_BITS) != 0;
+                if(!sm->autopush_pending) {
+                    const uint n = idx == 0 ? 32 : idx;
+                    uint32_t data;
+                    switch(arg) {
+                        case 3:
+                        case 4:
+                        case 5:
+                            data = 0;
+                            break;
+                        default:
+                            data = hostemu__mov_src(p, s, arg);
+                            break;
+                    }
+                    if(n == 32) {
+                        sm->isr = data;
+                    }
+                    else {
+                        data &= (1u << n) - 1;
+                        if(shiftctrl & PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_BITS) {
+                            sm->isr = (sm->isr >> n) | (data << (32 - n));
+                        }
+                        else {
+                            sm->isr = (sm->isr << n) | data;
+                        }
+                    }
+                    sm->isr_count = (uint8_t)MIN(32u, (uint)sm->isr_count + n);
+                    if(!autopush || sm->isr_count < thresh) {
+                        return HOSTEMU__PIO_NEXT;
+                    }
+                }
+                if(!hostemu__rx_push(p, s, sm->isr)) {
+                    sm->autopush_pending = true;
+                    hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_RXSTALL_LSB + s);
+                    return HOSTEMU__PIO_STALL;
+                }
+                sm->autopush_pending = false;
+                sm->isr = 0;
+                sm->isr_count = 0;
+                return HOSTEMU__PIO_NEXT;
+            }
+
+            case 3: { //out
+                const uint n = idx == 0 ? 32 : idx;
+                const uint thresh = hostemu__pull_thresh(shiftctrl);
+                const bool autopull = (shiftctrl & PIO_SM0_SHIFTCTRL_AUTOPULL_BITS) != 0;
+                if(autopull && sm->osr_count >= thresh) {
+                    uint32_t v;
+                    if(!hostemu__tx_pop(p, s, &v)) {
+                        hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_TXSTALL_LSB + s);
+                        return HOSTEMU__PIO_STALL;
+                    }
+                    sm->osr = v;
+                    sm->osr_count = 0;
+                }
+                uint32_t data;
+                if(n == 32) {
+                    data = sm->osr;
+                    sm->osr = 0;
+                }
+                else if(shiftctrl & PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS) {
+                    data = sm->osr & ((1u << n) - 1);
+                    sm->osr >>= n;
+                }
+                else {
+                    data = sm->osr >> (32 - n);
+                    sm->osr <<= n;
+                }
+                sm->osr_count = (uint8_t)MIN(32u, (uint)sm->osr_count + n);
+                if(autopull && sm->osr_count >= thresh) {
+                    uint32_t v;
+                    if(hostemu__tx_pop(p, s, &v)) {
+                        sm->osr = v;
+                        sm->osr_count = 0;
+                    }
+                }
+                switch(arg) {
+                    case 0:
+                    case 4:
+                        hostemu__pio_write_pads(
+                            p,
+                            (pinctrl & PIO_SM0_PINCTRL_OUT_BASE_BITS) >> PIO_SM0_PINCTRL_OUT_BASE_LSB,
+                            (pinctrl & PIO_SM0_PINCTRL_OUT_COUNT_BITS) >> PIO_SM0_PINCTRL_OUT_COUNT_LSB,
+                            data,
+                            arg == 4);
+                        return HOSTEMU__PIO_NEXT;
+                    case 1:
+                        sm->x = data;
+                        return HOSTEMU__PIO_NEXT;
+                    case 2:
+                        sm->y = data;
+                        return HOSTEMU__PIO_NEXT;
+                    case 5:
+                        sm->pc = (uint8_t)(data & 0x1fu);
+                        return HOSTEMU__PIO_JUMP;
+                    case 6:
+                        sm->isr = data;
+                        sm->isr_count = (uint8_t)n;
+                        return HOSTEMU__PIO_NEXT;
+                    case 7:
+                        sm->exec_pending = true;
+                        sm->exec_instr = (uint16_t)data;
+                        return HOSTEMU__PIO_EXEC;
+                    default:
+                        return HOSTEMU__PIO_NEXT;
+                }
+            }
+
+            case 4: {
+                const bool cond = (instr >> 6) & 1u;
+                const bool block = (instr >> 5) & 1u;
+                if((instr & 0x80u) == 0) { //push
+                    if(cond && sm->isr_count < hostemu__push_thresh(shiftctrl)) {
+                        return HOSTEMU__PIO_NEXT;
+                    }
+                    if(!hostemu__rx_push(p, s, sm->isr)) {
+                        hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_RXSTALL_LSB + s);
+                        if(block) {
+                            return HOSTEMU__PIO_STALL;
+                        }
+                    }
+                    sm->isr = 0;
+                    sm->isr_count = 0;
+                    return HOSTEMU__PIO_NEXT;
+                }
+                else { //pull
+                    if(cond && sm->osr_count < hostemu__pull_thresh(shiftctrl)) {
+                        return HOSTEMU__PIO_NEXT;
+                    }
+                    uint32_t v;
+                    if(!hostemu__tx_pop(p, s, &v)) {
+                        if(block) {
+                            hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_TXSTALL_LSB + s);
+                            return HOSTEMU__PIO_STALL;
+                        }
+                        v = sm->x;
+                    }
+                    sm->osr = v;
+                    sm->osr_count = 0;
+                    return HOSTEMU__PIO_NEXT;
+                }
+            }
+
+            case 5: { //mov
+                const uint mop = (instr >> 3) & 3u;
+                uint32_t data = hostemu__mov_src(p, s, instr & 7u);
+                if(mop == 1) {
+                    data = ~data;
+                }
+                else if(mop == 2) {
+                    uint32_t r = 0;
+                    for(uint i = 0; i < 32; ++i) {
+                        r |= ((data >> i) & 1u) << (31 - i);
+                    }
+                    data = r;
+                }
+                switch(arg) {
+                    case 0:
+                        hostemu__pio_write_pads(
+                            p,
+                            (pinctrl & PIO_SM0_PINCTRL_OUT_BASE_BITS) >> PIO_SM0_PINCTRL_OUT_BASE_LSB,
+                            (pinctrl & PIO_SM0_PINCTRL_OUT_COUNT_BITS) >> PIO_SM0_PINCTRL_OUT_COUNT_LSB,
+                            data,
+                            false);
+                        return HOSTEMU__PIO_NEXT;
+                    case 1:
+                        sm->x = data;
+                        return HOSTEMU__PIO_NEXT;
+                    case 2:
+                        sm->y = data;
+                        return HOSTEMU__PIO_NEXT;
+                    case 4:
+                        sm->exec_pending = true;
+                        sm->exec_instr = (uint16_t)data;
+                        return HOSTEMU__PIO_EXEC;
+                    case 5:
+                        sm->pc = (uint8_t)(data & 0x1fu);
+                        return HOSTEMU__PIO_JUMP;
+                    case 6:
+                        sm->isr = data;
+                        sm->isr_count = 0;
+                        return HOSTEMU__PIO_NEXT;
+                    case 7:
+                        sm->osr = data;
+                        sm->osr_count = 0;
+                        return HOSTEMU__PIO_NEXT;
+                    default:
+                        return HOSTEMU__PIO_NEXT;
+                }
+            }
+
+            case 6: { //irq
+                const uint flag = hostemu__pio_irq_index(s, idx);
+                if(instr & 0x40u) {
+                    hostemu__pio_set_irq_flag(p, flag, false);
+                    return HOSTEMU__PIO_NEXT;
+                }
+                if(instr & 0x20u) {
+                    if(!sm->irq_wait_armed) {
+                        hostemu__pio_set_irq_flag(p, flag, true);
+                        sm->irq_wait_armed = true;
+                    }
+                    if((hostemu__pios[p].irq_flags >> flag) & 1u) {
+                        return HOSTEMU__PIO_STALL;
+                    }
+                    sm->irq_wait_armed = false;
+                    return HOSTEMU__PIO_NEXT;
+                }
+                hostemu__pio_set_irq_flag(p, flag, true);
+                return HOSTEMU__PIO_NEXT;
+            }
+
+            default: { //set
+                switch(arg) {
+                    case 0:
+                    case 4:
+                        hostemu__pio_write_pads(
+                            p,
+                            (pinctrl & PIO_SM0_PINCTRL_SET_BASE_BITS) >> PIO_SM0_PINCTRL_SET_BASE_LSB,
+                            (pinctrl & PIO_SM0_PINCTRL_SET_COUNT_BITS) >> PIO_SM0_PINCTRL_SET_COUNT_LSB,
+                            idx,
+                            arg == 4);
+                        break;
+                    case 1:
+                        sm->x = idx;
+                        break;
+                    case 2:
+                        sm->y = idx;
+                        break;
+                    default:
+                        break;
+                }
+                return HOSTEMU__PIO_NEXT;
+            }
+
+        }
+
+}
+
+static void hostemu__sm_execute(
+    const uint p,
+    const uint s,
+    const uint16_t instr,
+    const bool is_exec) {
+
+        hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+        const pio_sm_hw_t* const regs = &hostemu_pio_hw[p].sm[s];
+        const uint32_t pinctrl = regs->pinctrl;
+        const uint32_t execctrl = regs->execctrl;
+        const uint ss_count = (pinctrl & PIO_SM0_PINCTRL_SIDESET_COUNT_BITS) >>
+            PIO_SM0_PINCTRL_SIDESET_COUNT_LSB;
+        const uint field = (instr >> 8) & 0x1fu;
+        const uint delay_bits = 5 - ss_count;
+        const uint delay = field & ((1u << delay_bits) - 1);
+
+        if(ss_count > 0) {
+            uint ss = field >> delay_bits;
+            uint nbits = ss_count;
+            bool enabled = true;
+            if(execctrl & PIO_SM0_EXECCTRL_SIDE_EN_BITS) {
+                --nbits;
+                enabled = (ss >> nbits) & 1u;
+                ss &= (1u << nbits) - 1;
+            }
+            if(enabled && nbits > 0) {
+                hostemu__pio_write_pads(
+                    p,
+                    (pinctrl & PIO_SM0_PINCTRL_SIDESET_BASE_BITS) >> PIO_SM0_PINCTRL_SIDESET_BASE_LSB,
+                    nbits,
+                    ss,
+                    (execctrl & PIO_SM0_EXECCTRL_SIDE_PINDIR_BITS) != 0);
+            }
+        }
+
+        const hostemu__pio_result_t result = hostemu__sm_op(p, s, instr);
+
+        if(result == HOSTEMU__PIO_STALL) {
+            sm->stalled = true;
+            sm->stalled_instr = instr;
+            sm->stalled_exec = is_exec;
+            sm->stall_epoch = hostemu__epoch;
+            return;
+        }
+
+        sm->stalled = false;
+        sm->delay = result == HOSTEMU__PIO_EXEC ? 0 : (uint8_t)delay;
+
+        if(result != HOSTEMU__PIO_JUMP && !is_exec) {
+            const uint top = (execctrl & PIO_SM0_EXECCTRL_WRAP_TOP_BITS) >>
+                PIO_SM0_EXECCTRL_WRAP_TOP_LSB;
+            const uint bottom = (execctrl & PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS) >>
+                PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB;
+            sm->pc = sm->pc == top ? (uint8_t)bottom : (uint8_t)((sm->pc + 1) & 0x1fu);
+        }
+
+        //detect loops which repeat without any observable effect
+        const uint bottom = (execctrl & PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS) >>
+            PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB;
+
+        if(sm->pc == bottom && !sm->exec_pending) {
+            const uint32_t snap[8] = {
+                sm->x, sm->y, sm->isr, sm->osr,
+                sm->isr_count, sm->osr_count, sm->delay,
+                (uint32_t)(hostemu__epoch & 0xffffffffu)
+            };
+            sm->steady = sm->snap_epoch == hostemu__epoch &&
+                memcmp(snap, sm->snap, sizeof(snap)) == 0;
+            memcpy(sm->snap, snap, sizeof(snap));
+            sm->snap_epoch = hostemu__epoch;
+        }
+
+}
+
+static void hostemu__sm_cycle(const uint p, const uint s) {
+
+    hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+
+    if(sm->stalled) {
+        hostemu__sm_execute(p, s, sm->stalled_instr, sm->stalled_exec);
+        return;
+    }
+
+    if(sm->delay > 0) {
+        --sm->delay;
+        return;
+    }
+
+    if(sm->exec_pending) {
+        sm->exec_pending = false;
+        hostemu__sm_execute(p, s, sm->exec_instr, true);
+        return;
+    }
+
+    hostemu__sm_execute(
+        p,
+        s,
+        (uint16_t)hostemu_pio_hw[p].instr_mem[sm->pc],
+        false);
+
+}
+
+void hostemu__pio_tick(void) {
+
+    const uint64_t now256 = hostemu__now << 8;
+
+    for(uint p = 0; p < NUM_PIOS; ++p) {
+
+        hostemu__pio_t* const hp = &hostemu__pios[p];
+
+        if(hp->enabled == 0) {
+            continue;
+        }
+
+        for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+            if((hp->enabled & (1u << s)) == 0) {
+                continue;
+            }
+            hostemu__sm_t* const sm = &hp->sm[s];
+            if(now256 < sm->next_tick) {
+                continue;
+            }
+            sm->next_tick += hostemu__div256(hostemu_pio_hw[p].sm[s].clkdiv);
+            if(sm->next_tick <= now256) {
+                sm->next_tick = now256 + 256;
+            }
+            hostemu__sm_cycle(p, s);
+        }
+
+        if(hp->dirty) {
+            hostemu__pio_sync(p);
+        }
+
+    }
+
+}
+
+bool hostemu__pio_quiescent(void) {
+
+    for(uint p = 0; p < NUM_PIOS; ++p) {
+
+        const hostemu__pio_t* const hp = &hostemu__pios[p];
+
+        for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+
+            if((hp->enabled & (1u << s)) == 0) {
+                continue;
+            }
+
+            const hostemu__sm_t* const sm = &hp->sm[s];
+
+            if(sm->stalled) {
+                if(sm->stall_epoch != hostemu__epoch) {
+                    return false;
+                }
+            }
+            else if(!sm->steady || sm->snap_epoch != hostemu__epoch) {
+                return false;
+            }
+
+        }
+
+    }
+
+    return true;
+
+}
+
+void hostemu__pio_skipped(void) {
+    const uint64_t now256 = hostemu__now << 8;
+    for(uint p = 0; p < NUM_PIOS; ++p) {
+        for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+            hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+            if(sm->next_tick < now256) {
+                sm->next_tick = now256;
+            }
+        }
+    }
+}
+
+bool hostemu__pio_dreq(const uint dreq) {
+    const uint p = dreq / 8;
+    const uint s = dreq % 4;
+    const hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+    if((dreq % 8) < 4) {
+        return sm->tx_level < hostemu__tx_cap(hostemu_pio_hw[p].sm[s].shiftctrl);
+    }
+    return sm->rx_level != 0;
+}
+
+bool hostemu__pio_fifo_access(
+    const uintptr_t addr,
+    const bool write,
+    uint32_t* const data) {
+
+        for(uint p = 0; p < NUM_PIOS; ++p) {
+
+            pio_hw_t* const hw = &hostemu_pio_hw[p];
+
+            for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+
+                if(write && addr == (uintptr_t)&hw->txf[s]) {
+                    if(!hostemu__tx_push(p, s, *data)) {
+                        hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_TXOVER_LSB + s);
+                        hostemu__pio_changed(p);
+                    }
+                    hostemu__pio_sync(p);
+                    return true;
+                }
+
+                if(!write && addr == (uintptr_t)&hw->rxf[s]) {
+                    if(!hostemu__rx_pop(p, s, data)) {
+                        *data = 0;
+                        hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_RXUNDER_LSB + s);
+                        hostemu__pio_changed(p);
+                    }
+                    hostemu__pio_sync(p);
+                    return true;
+                }
+
+            }
+
+        }
+
+        return false;
+
+}
+
+static bool hostemu__program_fits(
+    const uint p,
+    const pio_program_t* const program,
+    const uint offset) {
+        if(offset + program->length > PIO_INSTRUCTION_COUNT) {
+            return false;
+        }
+        const uint32_t mask = (program->length == 32
+            ? 0xffffffffu
+            : ((1u << program->length) - 1)) << offset;
+        return (hostemu__pios[p].used_instr & mask) == 0;
+}
+
+static int hostemu__program_find_offset(
+    const uint p,
+    const pio_program_t* const program) {
+
+        assert(program->length <= PIO_INSTRUCTION_COUNT);
+
+        if(program->origin >= 0) {
+            return hostemu__program_fits(p, program, (uint)program->origin)
+                ? program->origin
+                : -1;
+        }
+
+        for(int i = PIO_INSTRUCTION_COUNT - program->length; i >= 0; --i) {
+            if(hostemu__program_fits(p, program, (uint)i)) {
+                return i;
+            }
+        }
+
+        return -1;
+
+}
+
+bool pio_can_add_program(const PIO pio, const pio_program_t* const program) {
+    return hostemu__program_find_offset(hostemu__pio_idx(pio), program) >= 0;
+}
+
+bool pio_can_add_program_at_offset(
+    const PIO pio,
+    const pio_program_t* const program,
+    const uint offset) {
+        if(program->origin >= 0 && (uint)program->origin != offset) {
+            return false;
+        }
+        return hostemu__program_fits(hostemu__pio_idx(pio), program, offset);
+}
+
+void pio_add_program_at_offset(
+    const PIO pio,
+    const pio_program_t* const program,
+    const uint offset) {
+
+        const uint p = hostemu__pio_idx(pio);
+
+        if(!pio_can_add_program_at_offset(pio, program, offset)) {
+            panic("No program space");
+        }
+
+        for(uint i = 0; i < program->length; ++i) {
+            uint16_t instr = program->instructions[i];
+            if(_pio_major_instr_bits(instr) == pio_instr_bits_jmp) {
+                instr = (uint16_t)(instr + offset);
+            }
+            pio->instr_mem[offset + i] = instr;
+        }
+
+        hostemu__pios[p].used_instr |= (program->length == 32
+            ? 0xffffffffu
+            : ((1u << program->length) - 1)) << offset;
+
+}
+
+uint pio_add_program(const PIO pio, const pio_program_t* const program) {
+    const int offset = hostemu__program_find_offset(hostemu__pio_idx(pio), program);
+    if(offset < 0) {
+        panic("No program space");
+    }
+    pio_add_program_at_offset(pio, program, (uint)offset);
+    return (uint)offset;
+}
+
+void pio_remove_program(
+    const PIO pio,
+    const pio_program_t* const program,
+    const uint loaded_offset) {
+        const uint p = hostemu__pio_idx(pio);
+        const uint32_t mask = (program->length == 32
+            ? 0xffffffffu
+            : ((1u << program->length) - 1)) << loaded_offset;
+        assert((hostemu__pios[p].used_instr & mask) == mask);
+        hostemu__pios[p].used_instr &= ~mask;
+}
+
+void pio_clear_instruction_memory(const PIO pio) {
+    const uint p = hostemu__pio_idx(pio);
+    hostemu__pios[p].used_instr = 0;
+    for(uint i = 0; i < PIO_INSTRUCTION_COUNT; ++i) {
+        pio->instr_mem[i] = pio_encode_jmp(i);
+    }
+}
+
+void pio_sm_set_config(
+    const PIO pio,
+    const uint sm,
+    const pio_sm_config* const config) {
+
+        check_sm_param(sm);
+
+        const uint p = hostemu__pio_idx(pio);
+        const uint32_t joins = PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS | PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS;
+        const bool rejoin = ((pio->sm[sm].shiftctrl ^ config->shiftctrl) & joins) != 0;
+
+        pio->sm[sm].clkdiv = config->clkdiv;
+        pio->sm[sm].execctrl = config->execctrl;
+        pio->sm[sm].shiftctrl = config->shiftctrl;
+        pio->sm[sm].pinctrl = config->pinctrl;
+
+        if(rejoin) {
+            hostemu__fifos_flush(p, sm);
+        }
+
+        hostemu__pio_cpu_done(p);
+
+}
+
+void pio_sm_clear_fifos(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    const uint p = hostemu__pio_idx(pio);
+    hostemu__fifos_flush(p, sm);
+    hostemu__pio_cpu_done(p);
+}
+
+void pio_sm_restart(const PIO pio, const uint sm) {
+    pio_restart_sm_mask(pio, 1u << sm);
+}
+
+void pio_restart_sm_mask(const PIO pio, const uint32_t mask) {
+    const uint p = hostemu__pio_idx(pio);
+    for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+        if(mask & (1u << s)) {
+            hostemu__sm_t* const sm = &hostemu__pios[p].sm[s];
+            sm->isr = 0;
+            sm->isr_count = 0;
+            sm->osr_count = 32;
+            sm->delay = 0;
+            sm->stalled = false;
+            sm->irq_wait_armed = false;
+            sm->autopush_pending = false;
+            sm->exec_pending = false;
+            sm->steady = false;
+        }
+    }
+    hostemu__pio_cpu_done(p);
+}
+
+void pio_sm_clkdiv_restart(const PIO pio, const uint sm) {
+    pio_clkdiv_restart_sm_mask(pio, 1u << sm);
+}
+
+void pio_clkdiv_restart_sm_mask(const PIO pio, const uint32_t mask) {
+    const uint p = hostemu__pio_idx(pio);
+    for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+        if(mask & (1u << s)) {
+            hostemu__pios[p].sm[s].next_tick = hostemu__now << 8;
+        }
+    }
+}
+
+void pio_sm_init(
+    const PIO pio,
+    const uint sm,
+    const uint initial_pc,
+    const pio_sm_config* const config) {
+
+        assert(initial_pc < PIO_INSTRUCTION_COUNT);
+
+        pio_sm_set_enabled(pio, sm, false);
+
+        if(config != NULL) {
+            pio_sm_set_config(pio, sm, config);
+        }
+        else {
+            const pio_sm_config c = pio_get_default_sm_config();
+            pio_sm_set_config(pio, sm, &c);
+        }
+
+        pio_sm_clear_fifos(pio, sm);
+
+        const uint p = hostemu__pio_idx(pio);
+        hostemu__pios[p].fdebug &= ~(0x01010101u << sm);
+
+        pio_sm_restart(pio, sm);
+        pio_sm_clkdiv_restart(pio, sm);
+        pio_sm_exec(pio, sm, pio_encode_jmp(initial_pc));
+
+}
+
+void pio_set_sm_mask_enabled(
+    const PIO pio,
+    const uint32_t mask,
+    const bool enabled) {
+
+        const uint p = hostemu__pio_idx(pio);
+        hostemu__pio_t* const hp = &hostemu__pios[p];
+        const uint64_t now256 = hostemu__now << 8;
+
+        for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+            if((mask & (1u << s)) && enabled && hp->sm[s].next_tick < now256) {
+                hp->sm[s].next_tick = now256;
+            }
+        }
+
+        hp->enabled = enabled
+            ? (uint8_t)(hp->enabled | mask)
+            : (uint8_t)(hp->enabled & ~mask);
+
+        hostemu__pio_cpu_done(p);
+
+}
+
+void pio_sm_set_enabled(const PIO pio, const uint sm, const bool enabled) {
+    check_sm_param(sm);
+    pio_set_sm_mask_enabled(pio, 1u << sm, enabled);
+}
+
+void pio_enable_sm_mask_in_sync(const PIO pio, const uint32_t mask) {
+    pio_clkdiv_restart_sm_mask(pio, mask);
+    pio_set_sm_mask_enabled(pio, mask, true);
+}
+
+uint8_t pio_sm_get_pc(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].pc;
+}
+
+void pio_sm_exec(const PIO pio, const uint sm, const uint instr) {
+    check_sm_param(sm);
+    const uint p = hostemu__pio_idx(pio);
+    hostemu__sm_t* const s = &hostemu__pios[p].sm[sm];
+    s->irq_wait_armed = false;
+    s->autopush_pending = false;
+    s->steady = false;
+    hostemu__sm_execute(p, sm, (uint16_t)instr, true);
+    hostemu__pio_cpu_done(p);
+}
+
+bool pio_sm_is_exec_stalled(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    const hostemu__sm_t* const s = &hostemu__pios[hostemu__pio_idx(pio)].sm[sm];
+    return s->stalled && s->stalled_exec;
+}
+
+void pio_sm_exec_wait_blocking(const PIO pio, const uint sm, const uint instr) {
+    pio_sm_exec(pio, sm, instr);
+    while(pio_sm_is_exec_stalled(pio, sm)) {
+        hostemu_poll();
+    }
+}
+
+void pio_sm_set_wrap(
+    const PIO pio,
+    const uint sm,
+    const uint wrap_target,
+    const uint wrap) {
+        check_sm_param(sm);
+        pio->sm[sm].execctrl = (pio->sm[sm].execctrl &
+            ~(PIO_SM0_EXECCTRL_WRAP_TOP_BITS | PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS)) |
+            (wrap_target << PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB) |
+            (wrap << PIO_SM0_EXECCTRL_WRAP_TOP_LSB);
+        hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_sm_set_out_pins(
+    const PIO pio,
+    const uint sm,
+    const uint out_base,
+    const uint out_count) {
+        check_sm_param(sm);
+        pio_sm_config c = { .pinctrl = pio->sm[sm].pinctrl };
+        sm_config_set_out_pins(&c, out_base, out_count);
+        pio->sm[sm].pinctrl = c.pinctrl;
+        hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_sm_set_set_pins(
+    const PIO pio,
+    const uint sm,
+    const uint set_base,
+    const uint set_count) {
+        check_sm_param(sm);
+        pio_sm_config c = { .pinctrl = pio->sm[sm].pinctrl };
+        sm_config_set_set_pins(&c, set_base, set_count);
+        pio->sm[sm].pinctrl = c.pinctrl;
+        hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_sm_set_in_pins(const PIO pio, const uint sm, const uint in_base) {
+    check_sm_param(sm);
+    pio_sm_config c = { .pinctrl = pio->sm[sm].pinctrl };
+    sm_config_set_in_pins(&c, in_base);
+    pio->sm[sm].pinctrl = c.pinctrl;
+    hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_sm_set_sideset_pins(const PIO pio, const uint sm, const uint sideset_base) {
+    check_sm_param(sm);
+    pio_sm_config c = { .pinctrl = pio->sm[sm].pinctrl };
+    sm_config_set_sideset_pins(&c, sideset_base);
+    pio->sm[sm].pinctrl = c.pinctrl;
+    hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_sm_put(const PIO pio, const uint sm, const uint32_t data) {
+    check_sm_param(sm);
+    const uint p = hostemu__pio_idx(pio);
+    if(!hostemu__tx_push(p, sm, data)) {
+        hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_TXOVER_LSB + sm);
+    }
+    hostemu__pio_cpu_done(p);
+}
+
+uint32_t pio_sm_get(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    const uint p = hostemu__pio_idx(pio);
+    uint32_t v;
+    if(!hostemu__rx_pop(p, sm, &v)) {
+        v = 0;
+        hostemu__pios[p].fdebug |= 1u << (PIO_FDEBUG_RXUNDER_LSB + sm);
+    }
+    hostemu__pio_cpu_done(p);
+    return v;
+}
+
+bool pio_sm_is_rx_fifo_full(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].rx_level >=
+        hostemu__rx_cap(pio->sm[sm].shiftctrl);
+}
+
+bool pio_sm_is_rx_fifo_empty(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].rx_level == 0;
+}
+
+uint pio_sm_get_rx_fifo_level(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].rx_level;
+}
+
+bool pio_sm_is_tx_fifo_full(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].tx_level >=
+        hostemu__tx_cap(pio->sm[sm].shiftctrl);
+}
+
+bool pio_sm_is_tx_fifo_empty(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].tx_level == 0;
+}
+
+uint pio_sm_get_tx_fifo_level(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu_poll();
+    return hostemu__pios[hostemu__pio_idx(pio)].sm[sm].tx_level;
+}
+
+void pio_sm_put_blocking(const PIO pio, const uint sm, const uint32_t data) {
+    while(pio_sm_is_tx_fifo_full(pio, sm)) {
+        //wait
+    }
+    pio_sm_put(pio, sm, data);
+}
+
+uint32_t pio_sm_get_blocking(const PIO pio, const uint sm) {
+    while(pio_sm_is_rx_fifo_empty(pio, sm)) {
+        //wait
+    }
+    return pio_sm_get(pio, sm);
+}
+
+void pio_sm_drain_tx_fifo(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    const uint instr = (pio->sm[sm].shiftctrl & PIO_SM0_SHIFTCTRL_AUTOPULL_BITS)
+        ? pio_encode_out(pio_null, 32)
+        : pio_encode_pull(false, false);
+    while(!pio_sm_is_tx_fifo_empty(pio, sm)) {
+        pio_sm_exec(pio, sm, instr);
+    }
+}
+
+void pio_sm_set_clkdiv_int_frac(
+    const PIO pio,
+    const uint sm,
+    const uint16_t div_int,
+    const uint8_t div_frac) {
+        check_sm_param(sm);
+        pio_sm_config c = { 0 };
+        sm_config_set_clkdiv_int_frac(&c, div_int, div_frac);
+        pio->sm[sm].clkdiv = c.clkdiv;
+}
+
+void pio_sm_set_clkdiv(const PIO pio, const uint sm, const float div) {
+    uint16_t div_int;
+    uint8_t div_frac;
+    pio_calculate_clkdiv_from_float(div, &div_int, &div_frac);
+    pio_sm_set_clkdiv_int_frac(pio, sm, div_int, div_frac);
+}
+
+void pio_sm_set_pins_with_mask(
+    const PIO pio,
+    const uint sm,
+    const uint32_t pin_values,
+    uint32_t pin_mask) {
+        check_sm_param(sm);
+        const uint p = hostemu__pio_idx(pio);
+        while(pin_mask != 0) {
+            const uint pin = (uint)__builtin_ctz(pin_mask);
+            pin_mask &= pin_mask - 1;
+            hostemu__pio_write_pads(p, pin, 1, pin_values >> pin, false);
+        }
+        hostemu__pio_cpu_done(p);
+}
+
+void pio_sm_set_pins(const PIO pio, const uint sm, const uint32_t pin_values) {
+    pio_sm_set_pins_with_mask(pio, sm, pin_values, 0xffffffffu);
+}
+
+void pio_sm_set_pindirs_with_mask(
+    const PIO pio,
+    const uint sm,
+    const uint32_t pin_dirs,
+    uint32_t pin_mask) {
+        check_sm_param(sm);
+        const uint p = hostemu__pio_idx(pio);
+        while(pin_mask != 0) {
+            const uint pin = (uint)__builtin_ctz(pin_mask);
+            pin_mask &= pin_mask - 1;
+            hostemu__pio_write_pads(p, pin, 1, pin_dirs >> pin, true);
+        }
+        hostemu__pio_cpu_done(p);
+}
+
+void pio_sm_set_consecutive_pindirs(
+    const PIO pio,
+    const uint sm,
+    const uint pin_base,
+    const uint pin_count,
+    const bool is_out) {
+        check_sm_param(sm);
+        assert(pin_base < 32 && pin_count <= 32);
+        const uint p = hostemu__pio_idx(pio);
+        hostemu__pio_write_pads(
+            p,
+            pin_base,
+            pin_count,
+            is_out ? 0xffffffffu : 0u,
+            true);
+        hostemu__pio_cpu_done(p);
+}
+
+void pio_sm_claim(const PIO pio, const uint sm) {
+    pio_claim_sm_mask(pio, 1u << sm);
+}
+
+void pio_claim_sm_mask(const PIO pio, const uint sm_mask) {
+    hostemu__pio_t* const hp = &hostemu__pios[hostemu__pio_idx(pio)];
+    if(hp->claimed & sm_mask) {
+        panic("PIO %u SM already claimed", hostemu__pio_idx(pio));
+    }
+    hp->claimed |= (uint8_t)sm_mask;
+}
+
+void pio_sm_unclaim(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    hostemu__pios[hostemu__pio_idx(pio)].claimed &= (uint8_t)~(1u << sm);
+}
+
+int pio_claim_unused_sm(const PIO pio, const bool required) {
+    hostemu__pio_t* const hp = &hostemu__pios[hostemu__pio_idx(pio)];
+    for(uint s = 0; s < NUM_PIO_STATE_MACHINES; ++s) {
+        if((hp->claimed & (1u << s)) == 0) {
+            hp->claimed |= (uint8_t)(1u << s);
+            return (int)s;
+        }
+    }
+    if(required) {
+        panic("No PIO state machines are available");
+    }
+    return -1;
+}
+
+bool pio_sm_is_claimed(const PIO pio, const uint sm) {
+    check_sm_param(sm);
+    return (hostemu__pios[hostemu__pio_idx(pio)].claimed & (1u << sm)) != 0;
+}
+
+void pio_set_irq0_source_mask_enabled(
+    const PIO pio,
+    const uint32_t source_mask,
+    const bool enabled) {
+        if(enabled) {
+            pio->inte0 |= source_mask;
+        }
+        else {
+            pio->inte0 &= ~source_mask;
+        }
+        hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_set_irq1_source_mask_enabled(
+    const PIO pio,
+    const uint32_t source_mask,
+    const bool enabled) {
+        if(enabled) {
+            pio->inte1 |= source_mask;
+        }
+        else {
+            pio->inte1 &= ~source_mask;
+        }
+        hostemu__pio_cpu_done(hostemu__pio_idx(pio));
+}
+
+void pio_set_irq0_source_enabled(
+    const PIO pio,
+    const enum pio_interrupt_source source,
+    const bool enabled) {
+        pio_set_irq0_source_mask_enabled(pio, 1u << source, enabled);
+}
+
+void pio_set_irq1_source_enabled(
+    const PIO pio,
+    const enum pio_interrupt_source source,
+    const bool enabled) {
+        pio_set_irq1_source_mask_enabled(pio, 1u << source, enabled);
+}
+
+bool pio_interrupt_get(const PIO pio, const uint pio_interrupt_num) {
+    assert(pio_interrupt_num < 8);
+    hostemu_poll();
+    return (hostemu__pios[hostemu__pio_idx(pio)].irq_flags >> pio_interrupt_num) & 1u;
+}
+
+void pio_interrupt_clear(const PIO pio, const uint pio_interrupt_num) {
+    assert(pio_interrupt_num < 8);
+    const uint p = hostemu__pio_idx(pio);
+    hostemu__pio_set_irq_flag(p, pio_interrupt_num, false);
+    hostemu__pio_cpu_done(p);
+}
@@ -0,0 +1,796 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "pico/platform.h"
+#include "hostemu.h"
+#include "hostemu_sr.h"
+
+#define HOSTEMU_SR_ZIP_EOCD_SIG     UINT32_C(0x06054b50)
+#define HOSTEMU_SR_ZIP_CDH_SIG      UINT32_C(0x02014b50)
+#define HOSTEMU_SR_ZIP_LFH_SIG      UINT32_C(0x04034b50)
+#define HOSTEMU_SR_ZIP_EOCD_LEN     22u
+#define HOSTEMU_SR_ZIP_CDH_LEN      46u
+#define HOSTEMU_SR_ZIP_LFH_LEN      30u
+#define HOSTEMU_SR_ZIP_STORED       0u
+#define HOSTEMU_SR_ZIP_DEFLATED     8u
+
+#define HOSTEMU_SR_NAME_LEN         64u
+#define HOSTEMU_SR_MAX_PROBES       64u
+
+//one byte repeated in each byte of a 64 bit word
+#define HOSTEMU_SR_BYTES(b) ((uint64_t)(b) * UINT64_C(0x0101010101010101))
+
+/**
+ * Decoder
+ */
+
+static void hostemu__sr_frame_begin(
+    hostemu_sr_decoder_t* const dec,
+    const uint64_t sample) {
+        memset(&dec->frame, 0, sizeof(dec->frame));
+        dec->frame.ready = sample;
+        dec->frame.min_high = UINT32_MAX;
+        dec->frame.min_low = UINT32_MAX;
+        dec->state = HOSTEMU_SR_READY;
+}
+
+static void hostemu__sr_frame_end(hostemu_sr_decoder_t* const dec) {
+
+    if(dec->frames_len == dec->frames_cap) {
+        dec->frames_cap = dec->frames_cap == 0 ? 64 : dec->frames_cap * 2;
+        dec->frames = realloc(dec->frames, dec->frames_cap * sizeof(*dec->frames));
+        if(dec->frames == NULL) {
+            panic("out of memory");
+        }
+    }
+
+    //24 bit two's complement
+    const uint32_t raw = (uint32_t)dec->frame.value;
+    dec->frame.value = (int32_t)(raw << 8) >> 8;
+
+    dec->frames[dec->frames_len++] = dec->frame;
+    dec->state = HOSTEMU_SR_IDLE;
+
+}
+
+static void hostemu__sr_rising(
+    hostemu_sr_decoder_t* const dec,
+    const uint64_t sample) {
+
+        switch(dec->state) {
+            case HOSTEMU_SR_IDLE:
+                ++dec->stray_pulses;
+                break;
+            case HOSTEMU_SR_READY:
+                dec->frame.first_rising = sample;
+                dec->frame.pulses = 1;
+                dec->state = HOSTEMU_SR_PULSES;
+                break;
+            case HOSTEMU_SR_PULSES: {
+                const uint32_t low = (uint32_t)(sample - dec->last_falling);
+                dec->frame.min_low = MIN(dec->frame.min_low, low);
+                ++dec->frame.pulses;
+                break;
+            }
+            default:
+                break;
+        }
+
+        dec->last_rising = sample;
+
+}
+
+static void hostemu__sr_falling(
+    hostemu_sr_decoder_t* const dec,
+    const uint64_t sample,
+    const bool dout) {
+
+        const uint64_t high = sample - dec->last_rising;
+
+        dec->last_falling = sample;
+
+        if(high > dec->power_down_samples) {
+            //whatever was being read is lost, and the chip only
+            //resumes once DOUT next goes high
+            ++dec->power_downs;
+            dec->state = HOSTEMU_SR_WAIT;
+            return;
+        }
+
+        if(dec->state != HOSTEMU_SR_PULSES) {
+            return;
+        }
+
+        dec->frame.min_high = MIN(dec->frame.min_high, (uint32_t)high);
+        dec->frame.max_high = MAX(dec->frame.max_high, (uint32_t)high);
+        dec->frame.last_falling = sample;
+
+        //bits are shifted out on the rising edge and sampled on the
+        //falling edge
+        if(dec->frame.pulses <= 24) {
+            dec->frame.value = (int32_t)(((uint32_t)dec->frame.value << 1) | dout);
+        }
+
+}
+
+static void hostemu__sr_dout(
+    hostemu_sr_decoder_t* const dec,
+    const uint64_t sample,
+    const bool dout,
+    const bool sck) {
+
+        switch(dec->state) {
+
+            case HOSTEMU_SR_WAIT:
+                if(dout && !sck) {
+                    dec->state = HOSTEMU_SR_IDLE;
+                }
+                break;
+
+            case HOSTEMU_SR_IDLE:
+                if(!dout && !sck) {
+                    hostemu__sr_frame_begin(dec, sample);
+                }
+                break;
+
+            case HOSTEMU_SR_READY:
+                if(dout) {
+                    dec->state = HOSTEMU_SR_IDLE;
+                }
+                break;
+
+            case HOSTEMU_SR_PULSES:
+                if(sck) {
+                    const uint32_t delay = (uint32_t)(sample - dec->last_rising);
+                    dec->frame.max_dout_delay = MAX(dec->frame.max_dout_delay, delay);
+                }
+                else if(!dout && dec->frame.pulses > 24) {
+                    //the next conversion is ready
+                    hostemu__sr_frame_end(dec);
+                    hostemu__sr_frame_begin(dec, sample);
+                }
+                break;
+
+        }
+
+}
+
+static void hostemu__sr_edge(
+    hostemu_sr_decoder_t* const dec,
+    const uint8_t prev,
+    const uint8_t cur) {
+
+        const uint8_t changed = prev ^ cur;
+        const bool sck = (cur & dec->clock_mask) != 0;
+        const bool dout = (cur & dec->data_mask) != 0;
+
+        dec->edges += ((changed & dec->clock_mask) != 0) + ((changed & dec->data_mask) != 0);
+
+        //DOUT changes follow rising edges of PD_SCK, and the bit is
+        //sampled at the falling edge before any change of DOUT
+        if(changed & dec->clock_mask) {
+            if(sck) {
+                hostemu__sr_rising(dec, dec->sample);
+            }
+            else {
+                hostemu__sr_falling(dec, dec->sample, (prev & dec->data_mask) != 0);
+            }
+        }
+
+        if(changed & dec->data_mask) {
+            hostemu__sr_dout(dec, dec->sample, dout, sck);
+        }
+
+}
+
+void hostemu_sr_decoder_init(
+    hostemu_sr_decoder_t* const dec,
+    const uint clock_bit,
+    const uint data_bit,
+    const uint64_t samplerate) {
+
+        assert(dec != NULL);
+        assert(clock_bit < 8 && data_bit < 8 && clock_bit != data_bit);
+        assert(samplerate > 0);
+
+        memset(dec, 0, sizeof(*dec));
+
+        dec->clock_mask = (uint8_t)(1u << clock_bit);
+        dec->data_mask = (uint8_t)(1u << data_bit);
+        dec->power_down_samples =
+            (HOSTEMU_SR_POWER_DOWN_NS * samplerate + 999999999u) / 1000000000u;
+        dec->state = HOSTEMU_SR_WAIT;
+
+}
+
+void hostemu_sr_decoder_free(hostemu_sr_decoder_t* const dec) {
+    assert(dec != NULL);
+    free(dec->frames);
+    dec->frames = NULL;
+    dec->frames_len = 0;
+    dec->frames_cap = 0;
+}
+
+void hostemu_sr_decode(
+    hostemu_sr_decoder_t* const dec,
+    const uint8_t* const samples,
+    const size_t len) {
+
+        assert(dec != NULL);
+        assert(samples != NULL || len == 0);
+
+        const uint8_t mask = dec->clock_mask | dec->data_mask;
+        const uint64_t wordMask = HOSTEMU_SR_BYTES(mask);
+        size_t i = 0;
+
+        if(len > 0 && !dec->started) {
+            dec->started = true;
+            dec->prev = samples[0] & mask;
+            if((dec->prev & dec->data_mask) && !(dec->prev & dec->clock_mask)) {
+                dec->state = HOSTEMU_SR_IDLE;
+            }
+        }
+
+        while(i < len) {
+
+            //skip whole words of samples in which nothing changes
+            const uint64_t same = HOSTEMU_SR_BYTES(dec->prev);
+
+            while(i + sizeof(uint64_t) <= len) {
+                uint64_t word;
+                memcpy(&word, &samples[i], sizeof(word));
+                if(((word & wordMask) ^ same) != 0) {
+                    break;
+                }
+                i += sizeof(word);
+                dec->sample += sizeof(word);
+            }
+
+            const size_t end = MIN(len, i + sizeof(uint64_t));
+
+            for(; i < end; ++i, ++dec->sample) {
+                const uint8_t cur = samples[i] & mask;
+                if(cur != dec->prev) {
+                    hostemu__sr_edge(dec, dec->prev, cur);
+                    dec->prev = cur;
+                }
+            }
+
+        }
+
+}
+
+void hostemu_sr_decode_end(hostemu_sr_decoder_t* const dec) {
+    assert(dec != NULL);
+    if(dec->state == HOSTEMU_SR_PULSES &&
+        dec->frame.pulses > 24 &&
+        (dec->prev & dec->clock_mask) == 0) {
+            hostemu__sr_frame_end(dec);
+    }
+}
+
+/**
+ * .sr files are zip archives holding a metadata file and one or more
+ * files of raw samples.
+ */
+
+typedef struct {
+    uint8_t* data;
+    size_t len;
+} hostemu__sr_zip_t;
+
+static uint16_t hostemu__sr_u16(const uint8_t* const p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t hostemu__sr_u32(const uint8_t* const p) {
+    return (uint32_t)p[0] |
+        ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[3] << 24);
+}
+
+static bool hostemu__sr_zip_open(
+    hostemu__sr_zip_t* const zip,
+    const char* const path) {
+
+        zip->data = NULL;
+        zip->len = 0;
+
+        FILE* const f = fopen(path, "rb");
+
+        if(f == NULL) {
+            return false;
+        }
+
+        bool ok = fseek(f, 0, SEEK_END) == 0;
+        const long len = ok ? ftell(f) : -1;
+
+        ok = ok && len > 0 && fseek(f, 0, SEEK_SET) == 0;
+
+        if(ok) {
+            zip->data = malloc((size_t)len);
+            ok = zip->data != NULL &&
+                fread(zip->data, 1, (size_t)len, f) == (size_t)len;
+            zip->len = (size_t)len;
+        }
+
+        fclose(f);
+
+        if(!ok) {
+            free(zip->data);
+            zip->data = NULL;
+        }
+
+        return ok;
+
+}
+
+/**
+ * Finds a file in the archive by name and returns its contents in a
+ * buffer the caller frees, or NULL if there is no such file or it
+ * cannot be extracted.
+ */
+static uint8_t* hostemu__sr_zip_extract(
+    const hostemu__sr_zip_t* const zip,
+    const char* const name,
+    size_t* const len) {
+
+        const uint8_t* const d = zip->data;
+        const size_t nameLen = strlen(name);
+
+        if(zip->len < HOSTEMU_SR_ZIP_EOCD_LEN) {
+            return NULL;
+        }
+
+        //the end of central directory record is followed by a
+        //comment of up to 64KiB
+        size_t eocd = zip->len - HOSTEMU_SR_ZIP_EOCD_LEN;
+
+        while(hostemu__sr_u32(&d[eocd]) != HOSTEMU_SR_ZIP_EOCD_SIG) {
+            if(eocd == 0 || zip->len - eocd > HOSTEMU_SR_ZIP_EOCD_LEN + UINT16_MAX) {
+                return NULL;
+            }
+            --eocd;
+        }
+
+        const uint entries = hostemu__sr_u16(&d[eocd + 10]);
+        size_t cdh = hostemu__sr_u32(&d[eocd + 16]);
+
+        for(uint i = 0; i < entries; ++i) {
+
+            if(cdh + HOSTEMU_SR_ZIP_CDH_LEN > zip->len ||
+                hostemu__sr_u32(&d[cdh]) != HOSTEMU_SR_ZIP_CDH_SIG) {
+                    return NULL;
+            }
+
+            const uint method = hostemu__sr_u16(&d[cdh + 10]);
+            const size_t compressed = hostemu__sr_u32(&d[cdh + 20]);
+            const size_t uncompressed = hostemu__sr_u32(&d[cdh + 24]);
+            const size_t entryNameLen = hostemu__sr_u16(&d[cdh + 28]);
+            const size_t skip = entryNameLen +
+                hostemu__sr_u16(&d[cdh + 30]) +
+                hostemu__sr_u16(&d[cdh + 32]);
+            const size_t lfh = hostemu__sr_u32(&d[cdh + 42]);
+
+            const bool match = entryNameLen == nameLen &&
+                cdh + HOSTEMU_SR_ZIP_CDH_LEN + nameLen <= zip->len &&
+                memcmp(&d[cdh + HOSTEMU_SR_ZIP_CDH_LEN], name, nameLen) == 0;
+
+            cdh += HOSTEMU_SR_ZIP_CDH_LEN + skip;
+
+            if(!match) {
+                continue;
+            }
+
+            if(lfh + HOSTEMU_SR_ZIP_LFH_LEN > zip->len ||
+                hostemu__sr_u32(&d[lfh]) != HOSTEMU_SR_ZIP_LFH_SIG) {
+                    return NULL;
+            }
+
+            const size_t start = lfh + HOSTEMU_SR_ZIP_LFH_LEN +
+                hostemu__sr_u16(&d[lfh + 26]) +
+                hostemu__sr_u16(&d[lfh + 28]);
+
+            if(start + compressed > zip->len) {
+                return NULL;
+            }
+
+            //+1 so that an empty file is not a NULL buffer
+            uint8_t* const out = malloc(uncompressed + 1);
+
+            if(out == NULL) {
+                return NULL;
+            }
+
+            bool ok = false;
+
+            if(method == HOSTEMU_SR_ZIP_STORED) {
+                ok = compressed == uncompressed;
+                if(ok) {
+                    memcpy(out, &d[start], uncompressed);
+                }
+            }
+            else if(method == HOSTEMU_SR_ZIP_DEFLATED) {
+                z_stream zs;
+                memset(&zs, 0, sizeof(zs));
+                zs.next_in = (Bytef*)&d[start];
+                zs.avail_in = (uInt)compressed;
+                zs.next_out = out;
+                zs.avail_out = (uInt)uncompressed;
+                //negative window bits for raw deflate data
+                if(inflateInit2(&zs, -MAX_WBITS) == Z_OK) {
+                    ok = inflate(&zs, Z_FINISH) == Z_STREAM_END &&
+                        zs.total_out == uncompressed;
+                    inflateEnd(&zs);
+                }
+            }
+
+            if(!ok) {
+                free(out);
+                return NULL;
+            }
+
+            *len = uncompressed;
+            return out;
+
+        }
+
+        return NULL;
+
+}
+
+/**
+ * Metadata is an ini file. Only the keys needed to find and interpret
+ * the samples are read.
+ */
+
+typedef struct {
+    char capturefile[HOSTEMU_SR_NAME_LEN];
+    uint64_t samplerate;
+    uint unitsize;
+    int clock_bit;
+    int data_bit;
+} hostemu__sr_metadata_t;
+
+static uint64_t hostemu__sr_parse_rate(const char* const s) {
+
+    char* unit;
+    const double val = strtod(s, &unit);
+
+    while(*unit == ' ') {
+        ++unit;
+    }
+
+    double mul = 1;
+
+    switch(*unit) {
+        case 'k':
+        case 'K':
+            mul = 1e3;
+            break;
+        case 'M':
+            mul = 1e6;
+            break;
+        case 'G':
+            mul = 1e9;
+            break;
+        default:
+            break;
+    }
+
+    return (uint64_t)(val * mul + 0.5);
+
+}
+
+static bool hostemu__sr_parse_metadata(
+    hostemu__sr_metadata_t* const meta,
+    char* const text,
+    const char* const clock_probe,
+    const char* const data_probe) {
+
+        memset(meta, 0, sizeof(*meta));
+        meta->clock_bit = -1;
+        meta->data_bit = -1;
+
+        for(char* line = strtok(text, "\r\n"); line != NULL; line = strtok(NULL, "\r\n")) {
+
+            char* const eq = strchr(line, '=');
+
+            if(eq == NULL) {
+                continue;
+            }
+
+            *eq = '\0';
+            const char* const key = line;
+            const char* const val = eq + 1;
+            uint probe;
+
+            if(strcmp(key, "capturefile") == 0) {
+                snprintf(meta->capturefile, sizeof(meta->capturefile), "%s", val);
+            }
+            else if(strcmp(key, "samplerate") == 0) {
+                meta->samplerate = hostemu__sr_parse_rate(val);
+            }
+            else if(strcmp(key, "unitsize") == 0) {
+                meta->unitsize = (uint)strtoul(val, NULL, 10);
+            }
+            else if(sscanf(key, "probe%u", &probe) == 1 &&
+                probe >= 1 && probe <= HOSTEMU_SR_MAX_PROBES) {
+                    if(strcmp(val, clock_probe) == 0) {
+                        meta->clock_bit = (int)probe - 1;
+                    }
+                    if(strcmp(val, data_probe) == 0) {
+                        meta->data_bit = (int)probe - 1;
+                    }
+            }
+
+        }
+
+        return meta->capturefile[0] != '\0' &&
+            meta->samplerate > 0 &&
+            meta->unitsize > 0 &&
+            meta->clock_bit >= 0 &&
+            meta->data_bit >= 0 &&
+            (uint)MAX(meta->clock_bit, meta->data_bit) < meta->unitsize * 8;
+
+}
+
+/**
+ * Reduces samples of unitsize bytes to one byte each, with PD_SCK in
+ * bit 0 and DOUT in bit 1, in place.
+ */
+static size_t hostemu__sr_narrow(
+    uint8_t* const buf,
+    const size_t len,
+    const hostemu__sr_metadata_t* const meta) {
+
+        const size_t count = len / meta->unitsize;
+
+        for(size_t i = 0; i < count; ++i) {
+            const uint8_t* const unit = &buf[i * meta->unitsize];
+            const uint clk = (unit[meta->clock_bit / 8] >> (meta->clock_bit % 8)) & 1u;
+            const uint dat = (unit[meta->data_bit / 8] >> (meta->data_bit % 8)) & 1u;
+            buf[i] = (uint8_t)(clk | (dat << 1));
+        }
+
+        return count;
+
+}
+
+/**
+ * Newer versions of sigrok split the samples across files named
+ * capturefile-1, capturefile-2, ... rather than writing one file named
+ * capturefile.
+ */
+static uint8_t* hostemu__sr_read_chunks(
+    const hostemu__sr_zip_t* const zip,
+    const char* const capturefile,
+    size_t* const len) {
+
+        uint8_t* buf = NULL;
+        size_t bufLen = 0;
+
+        for(uint chunk = 1; ; ++chunk) {
+
+            char name[HOSTEMU_SR_NAME_LEN + 16];
+            size_t chunkLen;
+
+            snprintf(name, sizeof(name), "%s-%u", capturefile, chunk);
+
+            uint8_t* const data = hostemu__sr_zip_extract(zip, name, &chunkLen);
+
+            if(data == NULL) {
+                break;
+            }
+
+            uint8_t* const grown = realloc(buf, bufLen + chunkLen + 1);
+
+            if(grown == NULL) {
+                free(data);
+                free(buf);
+                return NULL;
+            }
+
+            memcpy(&grown[bufLen], data, chunkLen);
+            free(data);
+            buf = grown;
+            bufLen += chunkLen;
+
+        }
+
+        *len = bufLen;
+
+        return buf;
+
+}
+
+bool hostemu_sr_read_samples(
+    hostemu_sr_capture_t* const cap,
+    const char* const path,
+    const char* const clock_probe,
+    const char* const data_probe,
+    uint8_t** const samples) {
+
+        assert(cap != NULL);
+        assert(path != NULL);
+        assert(clock_probe != NULL);
+        assert(data_probe != NULL);
+        assert(samples != NULL);
+
+        memset(cap, 0, sizeof(*cap));
+        *samples = NULL;
+
+        hostemu__sr_zip_t zip;
+        hostemu__sr_metadata_t meta;
+        size_t len;
+
+        if(!hostemu__sr_zip_open(&zip, path)) {
+            return false;
+        }
+
+        char* const text = (char*)hostemu__sr_zip_extract(&zip, "metadata", &len);
+        bool ok = text != NULL;
+
+        if(ok) {
+            text[len] = '\0';
+            ok = hostemu__sr_parse_metadata(&meta, text, clock_probe, data_probe);
+            free(text);
+        }
+
+        uint8_t* buf = NULL;
+        size_t bufLen = 0;
+
+        if(ok) {
+            buf = hostemu__sr_zip_extract(&zip, meta.capturefile, &bufLen);
+            if(buf == NULL) {
+                buf = hostemu__sr_read_chunks(&zip, meta.capturefile, &bufLen);
+            }
+            ok = buf != NULL;
+        }
+
+        free(zip.data);
+
+        if(!ok) {
+            free(buf);
+            return false;
+        }
+
+        cap->samplerate = meta.samplerate;
+        cap->unitsize = meta.unitsize;
+
+        if(meta.unitsize == 1) {
+            cap->samples = bufLen;
+            cap->clock_bit = meta.clock_bit;
+            cap->data_bit = meta.data_bit;
+        }
+        else {
+            cap->samples = hostemu__sr_narrow(buf, bufLen, &meta);
+            cap->clock_bit = 0;
+            cap->data_bit = 1;
+        }
+
+        *samples = buf;
+
+        return true;
+
+}
+
+bool hostemu_sr_load(
+    hostemu_sr_capture_t* const cap,
+    const char* const path,
+    const char* const clock_probe,
+    const char* const data_probe) {
+
+        uint8_t* samples;
+
+        if(!hostemu_sr_read_samples(cap, path, clock_probe, data_probe, &samples)) {
+            return false;
+        }
+
+        hostemu_sr_decoder_init(
+            &cap->decoder,
+            (uint)cap->clock_bit,
+            (uint)cap->data_bit,
+            cap->samplerate);
+
+        hostemu_sr_decode(&cap->decoder, samples, cap->samples);
+        hostemu_sr_decode_end(&cap->decoder);
+
+        free(samples);
+
+        return true;
+
+}
+
+void hostemu_sr_free(hostemu_sr_capture_t* const cap) {
+    assert(cap != NULL);
+    hostemu_sr_decoder_free(&cap->decoder);
+}
+
+double hostemu_sr_samples_to_ns(
+    const hostemu_sr_capture_t* const cap,
+    const uint64_t samples) {
+        assert(cap != NULL);
+        assert(cap->samplerate > 0);
+        return (double)samples * 1e9 / (double)cap->samplerate;
+}
+
+/**
+ * Replay
+ */
+
+static uint64_t hostemu__sr_to_cycles(
+    const hostemu_sr_capture_t* const cap,
+    const uint64_t samples) {
+        const uint64_t cycles = (samples * HOSTEMU_CLK_SYS_HZ + cap->samplerate / 2) /
+            cap->samplerate;
+        return MAX(UINT64_C(1), cycles);
+}
+
+static int32_t hostemu__sr_replay_source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gain_pulses) {
+        (void)gain_pulses;
+        const hostemu_sr_capture_t* const cap = ctx;
+        return cap->decoder.frames[index % cap->decoder.frames_len].value;
+}
+
+static uint64_t hostemu__sr_replay_interval(
+    void* const ctx,
+    const uint32_t index) {
+
+        const hostemu_sr_capture_t* const cap = ctx;
+        const hostemu_sr_frame_t* const frames = cap->decoder.frames;
+        const size_t len = cap->decoder.frames_len;
+
+        if(index == 0) {
+            return hostemu__sr_to_cycles(cap, frames[0].ready);
+        }
+
+        //the capture has len - 1 intervals between frames
+        const size_t n = 1 + (index - 1) % (len - 1);
+
+        return hostemu__sr_to_cycles(cap, frames[n].ready - frames[n - 1].ready);
+
+}
+
+void hostemu_sr_replay_config(
+    const hostemu_sr_capture_t* const cap,
+    hostemu_hx711_config_t* const cfg) {
+
+        assert(cap != NULL);
+        assert(cap->decoder.frames_len >= 2);
+        assert(cfg != NULL);
+
+        cfg->source = hostemu__sr_replay_source;
+        cfg->interval = hostemu__sr_replay_interval;
+        cfg->ctx = (void*)cap;
+        cfg->first_ready_us = 0;
+
+}
@@ -0,0 +1,208 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HOSTEMU_SR_H_4F8A2C61_B7D3_4E09_9A15_C2E6073B8D4F
+#define HOSTEMU_SR_H_4F8A2C61_B7D3_4E09_9A15_C2E6073B8D4F
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hostemu.h"
+
+/**
+ * Decoding and replay of sigrok (.sr) logic analyser captures of an
+ * HX711.
+ *
+ * A capture is decoded into frames, one for each conversion read
+ * from the chip. Each frame holds when DOUT went low, the value and
+ * number of PD_SCK pulses clocked out and the timing of those pulses.
+ * The frames can then be replayed through the emulated HX711 so that
+ * the drivers see the same values and DOUT timing as the real chip.
+ */
+
+/**
+ * PD_SCK held high for longer than this powers the HX711 down.
+ */
+#define HOSTEMU_SR_POWER_DOWN_NS    60000u
+
+typedef struct {
+    uint64_t ready;         //sample at which DOUT went low
+    uint64_t first_rising; //sample of the first PD_SCK rising edge
+    uint64_t last_falling; //sample of the last PD_SCK falling edge
+    int32_t value;
+    uint8_t pulses;
+    uint32_t min_high;      //shortest PD_SCK high time, in samples
+    uint32_t max_high;
+    uint32_t min_low;       //shortest PD_SCK low time between pulses
+    uint32_t max_dout_delay; //longest PD_SCK rising edge to DOUT change
+} hostemu_sr_frame_t;
+
+typedef enum {
+    HOSTEMU_SR_WAIT = 0,    //waiting for DOUT high and PD_SCK low
+    HOSTEMU_SR_IDLE,        //waiting for DOUT to go low
+    HOSTEMU_SR_READY,       //DOUT low, waiting for the first pulse
+    HOSTEMU_SR_PULSES       //clocking out bits and gain pulses
+} hostemu_sr_state_t;
+
+/**
+ * Incremental decoder state. Samples can be fed in chunks of any
+ * size with hostemu_sr_decode.
+ */
+typedef struct {
+    uint8_t clock_mask;
+    uint8_t data_mask;
+    uint8_t prev;
+    bool started;
+    hostemu_sr_state_t state;
+    uint64_t sample;
+    uint64_t last_rising;
+    uint64_t last_falling;
+    uint64_t power_down_samples;
+    hostemu_sr_frame_t frame;
+    hostemu_sr_frame_t* frames;
+    size_t frames_len;
+    size_t frames_cap;
+    uint32_t edges;
+    uint32_t power_downs;
+    uint32_t stray_pulses;
+} hostemu_sr_decoder_t;
+
+typedef struct {
+    uint64_t samplerate;
+    uint64_t samples;
+    uint unitsize;
+    int clock_bit;
+    int data_bit;
+    hostemu_sr_decoder_t decoder;
+} hostemu_sr_capture_t;
+
+/**
+ * @brief Initialises a decoder for samples of one byte each.
+ *
+ * @param dec
+ * @param clock_bit bit of each sample holding PD_SCK
+ * @param data_bit bit of each sample holding DOUT
+ * @param samplerate used to detect power down
+ */
+void hostemu_sr_decoder_init(
+    hostemu_sr_decoder_t* dec,
+    uint clock_bit,
+    uint data_bit,
+    uint64_t samplerate);
+
+/**
+ * @brief Frees the frames held by a decoder.
+ *
+ * @param dec
+ */
+void hostemu_sr_decoder_free(hostemu_sr_decoder_t* dec);
+
+/**
+ * @brief Decodes the next samples. Runs of samples in which neither
+ * PD_SCK nor DOUT change are skipped eight at a time.
+ *
+ * @param dec
+ * @param samples
+ * @param len number of samples
+ */
+void hostemu_sr_decode(
+    hostemu_sr_decoder_t* dec,
+    const uint8_t* samples,
+    size_t len);
+
+/**
+ * @brief Completes the frame being decoded, if it has all of its
+ * PD_SCK pulses. Otherwise, the frame would only be completed when
+ * DOUT next goes low.
+ *
+ * @param dec
+ */
+void hostemu_sr_decode_end(hostemu_sr_decoder_t* dec);
+
+/**
+ * @brief Reads and decodes a capture. Probes are found by name in the
+ * capture's metadata.
+ *
+ * @param cap
+ * @param path path to the .sr file
+ * @param clock_probe name of the PD_SCK probe, eg. "CLK"
+ * @param data_probe name of the DOUT probe, eg. "DAT"
+ * @return true if the capture was read
+ * @return false if the file could not be read or is not a capture
+ * with the named probes
+ */
+bool hostemu_sr_load(
+    hostemu_sr_capture_t* cap,
+    const char* path,
+    const char* clock_probe,
+    const char* data_probe);
+
+/**
+ * @brief Reads the raw samples of a capture into memory without
+ * decoding them, eg. to measure decode throughput.
+ *
+ * @param cap samplerate, samples, unitsize and probe bits are set
+ * @param path
+ * @param clock_probe
+ * @param data_probe
+ * @param samples set to a buffer of cap->samples bytes which the
+ * caller frees
+ * @return true
+ * @return false
+ */
+bool hostemu_sr_read_samples(
+    hostemu_sr_capture_t* cap,
+    const char* path,
+    const char* clock_probe,
+    const char* data_probe,
+    uint8_t** samples);
+
+void hostemu_sr_free(hostemu_sr_capture_t* cap);
+
+/**
+ * @brief Converts a number of samples to nanoseconds.
+ *
+ * @param cap
+ * @param samples
+ * @return double
+ */
+double hostemu_sr_samples_to_ns(
+    const hostemu_sr_capture_t* cap,
+    uint64_t samples);
+
+/**
+ * @brief Configures an emulated HX711 to replay the frames of a
+ * capture. Conversion n is ready as long after conversion n - 1 as it
+ * was in the capture and has the value of frame n. The frames repeat
+ * once the capture is exhausted. Pins and other settings are left as
+ * they are.
+ *
+ * @param cap must outlive the emulated HX711 and have at least two
+ * frames
+ * @param cfg
+ */
+void hostemu_sr_replay_config(
+    const hostemu_sr_capture_t* cap,
+    hostemu_hx711_config_t* cfg);
+
+#endif
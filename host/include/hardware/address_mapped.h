@@ -0,0 +1,47 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_ADDRESS_MAPPED_H_E7AD8997_F184_4750_8715_3B5AFA5281BD
+#define HOST_HARDWARE_ADDRESS_MAPPED_H_E7AD8997_F184_4750_8715_3B5AFA5281BD
+
+#include <stdint.h>
+
+/**
+ * Registers are plain memory on the host. The emulator keeps them in
+ * step with its own peripheral state, so drivers may read them
+ * directly exactly as they would on the RP2040.
+ */
+typedef volatile uint32_t io_rw_32;
+typedef const volatile uint32_t io_ro_32;
+typedef volatile uint32_t io_wo_32;
+typedef volatile uint16_t io_rw_16;
+typedef volatile uint8_t io_rw_8;
+
+/**
+ * DMA address registers hold pointers, which are wider than 32 bits
+ * on most hosts.
+ */
+typedef volatile uintptr_t io_rw_ptr;
+
+#endif
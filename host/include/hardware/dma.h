@@ -0,0 +1,257 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_DMA_H_353E503D_DF99_4CA5_9BA0_2E27082F7243
+#define HOST_HARDWARE_DMA_H_353E503D_DF99_4CA5_9BA0_2E27082F7243
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "hardware/regs/dreq.h"
+#include "hardware/structs/dma.h"
+
+#define check_dma_channel_param(channel) assert((channel) < NUM_DMA_CHANNELS)
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+static inline void channel_config_set_read_increment(
+    dma_channel_config* const c,
+    const bool incr) {
+        c->ctrl = incr ? (c->ctrl | DMA_CH0_CTRL_TRIG_INCR_READ_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_READ_BITS);
+}
+
+static inline void channel_config_set_write_increment(
+    dma_channel_config* const c,
+    const bool incr) {
+        c->ctrl = incr ? (c->ctrl | DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS);
+}
+
+static inline void channel_config_set_dreq(
+    dma_channel_config* const c,
+    const uint dreq) {
+        assert(dreq <= DREQ_FORCE);
+        c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) |
+            (dreq << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+static inline void channel_config_set_chain_to(
+    dma_channel_config* const c,
+    const uint chain_to) {
+        assert(chain_to <= NUM_DMA_CHANNELS);
+        c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) |
+            (chain_to << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+}
+
+static inline void channel_config_set_transfer_data_size(
+    dma_channel_config* const c,
+    const enum dma_channel_transfer_size size) {
+        assert(size == DMA_SIZE_8 || size == DMA_SIZE_16 || size == DMA_SIZE_32);
+        c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) |
+            (((uint)size) << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_ring(
+    dma_channel_config* const c,
+    const bool write,
+    const uint size_bits) {
+        assert(size_bits < 32);
+        c->ctrl = (c->ctrl & ~(DMA_CH0_CTRL_TRIG_RING_SIZE_BITS | DMA_CH0_CTRL_TRIG_RING_SEL_BITS)) |
+            (size_bits << DMA_CH0_CTRL_TRIG_RING_SIZE_LSB) |
+            (write ? DMA_CH0_CTRL_TRIG_RING_SEL_BITS : 0u);
+}
+
+static inline void channel_config_set_bswap(
+    dma_channel_config* const c,
+    const bool bswap) {
+        c->ctrl = bswap ? (c->ctrl | DMA_CH0_CTRL_TRIG_BSWAP_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_BSWAP_BITS);
+}
+
+static inline void channel_config_set_irq_quiet(
+    dma_channel_config* const c,
+    const bool irq_quiet) {
+        c->ctrl = irq_quiet ? (c->ctrl | DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS);
+}
+
+static inline void channel_config_set_high_priority(
+    dma_channel_config* const c,
+    const bool high_priority) {
+        c->ctrl = high_priority ? (c->ctrl | DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS);
+}
+
+static inline void channel_config_set_enable(
+    dma_channel_config* const c,
+    const bool enable) {
+        c->ctrl = enable ? (c->ctrl | DMA_CH0_CTRL_TRIG_EN_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_EN_BITS);
+}
+
+static inline void channel_config_set_sniff_enable(
+    dma_channel_config* const c,
+    const bool sniff_enable) {
+        c->ctrl = sniff_enable ? (c->ctrl | DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS) :
+            (c->ctrl & ~DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS);
+}
+
+static inline dma_channel_config dma_channel_get_default_config(const uint channel) {
+    dma_channel_config c = {0};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_ring(&c, false, 0);
+    channel_config_set_bswap(&c, false);
+    channel_config_set_irq_quiet(&c, false);
+    channel_config_set_enable(&c, true);
+    channel_config_set_sniff_enable(&c, false);
+    channel_config_set_high_priority(&c, false);
+    return c;
+}
+
+static inline uint32_t channel_config_get_ctrl_value(const dma_channel_config* const config) {
+    return config->ctrl;
+}
+
+void dma_channel_claim(uint channel);
+
+void dma_claim_mask(uint32_t channel_mask);
+
+void dma_channel_unclaim(uint channel);
+
+void dma_unclaim_mask(uint32_t channel_mask);
+
+int dma_claim_unused_channel(bool required);
+
+bool dma_channel_is_claimed(uint channel);
+
+dma_channel_config dma_get_channel_config(uint channel);
+
+void dma_channel_set_config(uint channel, const dma_channel_config* config, bool trigger);
+
+void dma_channel_set_read_addr(uint channel, const volatile void* read_addr, bool trigger);
+
+void dma_channel_set_write_addr(uint channel, volatile void* write_addr, bool trigger);
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+
+void dma_channel_configure(
+    uint channel,
+    const dma_channel_config* config,
+    volatile void* write_addr,
+    const volatile void* read_addr,
+    uint transfer_count,
+    bool trigger);
+
+void dma_start_channel_mask(uint32_t chan_mask);
+
+static inline void dma_channel_start(const uint channel) {
+    check_dma_channel_param(channel);
+    dma_start_channel_mask(1u << channel);
+}
+
+static inline void dma_channel_transfer_from_buffer_now(
+    const uint channel,
+    const volatile void* const read_addr,
+    const uint32_t transfer_count) {
+        dma_channel_set_read_addr(channel, read_addr, false);
+        dma_channel_set_trans_count(channel, transfer_count, true);
+}
+
+static inline void dma_channel_transfer_to_buffer_now(
+    const uint channel,
+    volatile void* const write_addr,
+    const uint32_t transfer_count) {
+        dma_channel_set_write_addr(channel, write_addr, false);
+        dma_channel_set_trans_count(channel, transfer_count, true);
+}
+
+void dma_channel_abort(uint channel);
+
+void dma_irqn_set_channel_mask_enabled(uint irq_index, uint32_t channel_mask, bool enabled);
+
+static inline void dma_irqn_set_channel_enabled(
+    const uint irq_index,
+    const uint channel,
+    const bool enabled) {
+        check_dma_channel_param(channel);
+        dma_irqn_set_channel_mask_enabled(irq_index, 1u << channel, enabled);
+}
+
+static inline void dma_channel_set_irq0_enabled(const uint channel, const bool enabled) {
+    dma_irqn_set_channel_enabled(0, channel, enabled);
+}
+
+static inline void dma_channel_set_irq1_enabled(const uint channel, const bool enabled) {
+    dma_irqn_set_channel_enabled(1, channel, enabled);
+}
+
+static inline void dma_set_irq0_channel_mask_enabled(const uint32_t channel_mask, const bool enabled) {
+    dma_irqn_set_channel_mask_enabled(0, channel_mask, enabled);
+}
+
+static inline void dma_set_irq1_channel_mask_enabled(const uint32_t channel_mask, const bool enabled) {
+    dma_irqn_set_channel_mask_enabled(1, channel_mask, enabled);
+}
+
+bool dma_irqn_get_channel_status(uint irq_index, uint channel);
+
+static inline bool dma_channel_get_irq0_status(const uint channel) {
+    return dma_irqn_get_channel_status(0, channel);
+}
+
+static inline bool dma_channel_get_irq1_status(const uint channel) {
+    return dma_irqn_get_channel_status(1, channel);
+}
+
+void dma_irqn_acknowledge_channel(uint irq_index, uint channel);
+
+static inline void dma_channel_acknowledge_irq0(const uint channel) {
+    dma_irqn_acknowledge_channel(0, channel);
+}
+
+static inline void dma_channel_acknowledge_irq1(const uint channel) {
+    dma_irqn_acknowledge_channel(1, channel);
+}
+
+/**
+ * Polling the busy flag lets emulated time pass.
+ */
+bool dma_channel_is_busy(uint channel);
+
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+#endif
@@ -0,0 +1,114 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_GPIO_H_732B5B04_76ED_4439_B051_DAFF42EA3039
+#define HOST_HARDWARE_GPIO_H_732B5B04_76ED_4439_B051_DAFF42EA3039
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "pico/platform.h"
+#include "hardware/irq.h"
+#include "hardware/platform_defs.h"
+
+enum gpio_function {
+    GPIO_FUNC_XIP = 0,
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_GPCK = 8,
+    GPIO_FUNC_USB = 9,
+    GPIO_FUNC_NULL = 0x1f
+};
+
+static inline void check_gpio_param(const uint gpio) {
+    invalid_params_if(GPIO, gpio >= NUM_BANK0_GPIOS);
+    (void)gpio;
+}
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+void gpio_set_function(uint gpio, enum gpio_function fn);
+
+enum gpio_function gpio_get_function(uint gpio);
+
+void gpio_init(uint gpio);
+
+void gpio_deinit(uint gpio);
+
+void gpio_init_mask(uint gpio_mask);
+
+void gpio_set_pulls(uint gpio, bool up, bool down);
+
+static inline void gpio_pull_up(const uint gpio) {
+    gpio_set_pulls(gpio, true, false);
+}
+
+static inline void gpio_pull_down(const uint gpio) {
+    gpio_set_pulls(gpio, false, true);
+}
+
+static inline void gpio_disable_pulls(const uint gpio) {
+    gpio_set_pulls(gpio, false, false);
+}
+
+void gpio_set_input_enabled(uint gpio, bool enabled);
+
+/**
+ * Reading a pin lets emulated time pass.
+ */
+bool gpio_get(uint gpio);
+
+uint32_t gpio_get_all(void);
+
+void gpio_put_masked(uint32_t mask, uint32_t value);
+
+static inline void gpio_put(const uint gpio, const bool value) {
+    gpio_put_masked(1u << gpio, value ? (1u << gpio) : 0u);
+}
+
+static inline void gpio_put_all(const uint32_t value) {
+    gpio_put_masked((1u << NUM_BANK0_GPIOS) - 1, value);
+}
+
+void gpio_set_dir_masked(uint32_t mask, uint32_t value);
+
+static inline void gpio_set_dir(const uint gpio, const bool out) {
+    gpio_set_dir_masked(1u << gpio, out ? (1u << gpio) : 0u);
+}
+
+static inline void gpio_set_dir_out_masked(const uint32_t mask) {
+    gpio_set_dir_masked(mask, mask);
+}
+
+static inline void gpio_set_dir_in_masked(const uint32_t mask) {
+    gpio_set_dir_masked(mask, 0);
+}
+
+#endif
@@ -0,0 +1,84 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_IRQ_H_44DD77E1_D9CA_4D5F_9F95_28C38B38652D
+#define HOST_HARDWARE_IRQ_H_44DD77E1_D9CA_4D5F_9F95_28C38B38652D
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "hardware/regs/intctrl.h"
+
+#define PICO_DEFAULT_IRQ_PRIORITY 0x80
+#define PICO_LOWEST_IRQ_PRIORITY 0xff
+#define PICO_HIGHEST_IRQ_PRIORITY 0x00
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+#define PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY 0xff
+#define PICO_SHARED_IRQ_HANDLER_LOWEST_ORDER_PRIORITY 0x00
+#define PICO_MAX_SHARED_IRQ_HANDLERS 4u
+
+typedef void (*irq_handler_t)(void);
+
+static inline void check_irq_param(const uint num) {
+    invalid_params_if(IRQ, num >= NUM_IRQS);
+    (void)num;
+}
+
+void irq_set_priority(uint num, uint8_t hardware_priority);
+
+uint irq_get_priority(uint num);
+
+void irq_set_enabled(uint num, bool enabled);
+
+bool irq_is_enabled(uint num);
+
+void irq_set_mask_enabled(uint32_t mask, bool enabled);
+
+/**
+ * Panics if a different handler (exclusive or shared) is already
+ * installed, as the SDK does.
+ */
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+
+irq_handler_t irq_get_exclusive_handler(uint num);
+
+void irq_add_shared_handler(
+    uint num,
+    irq_handler_t handler,
+    uint8_t order_priority);
+
+/**
+ * Removing a handler which is not installed does nothing.
+ */
+void irq_remove_handler(uint num, irq_handler_t handler);
+
+bool irq_has_shared_handler(uint num);
+
+irq_handler_t irq_get_vtable_handler(uint num);
+
+void irq_clear(uint int_num);
+
+void irq_set_pending(uint num);
+
+#endif
@@ -0,0 +1,421 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_PIO_H_7194B30E_E4E6_4849_8CCC_17C03A14E8BE
+#define HOST_HARDWARE_PIO_H_7194B30E_E4E6_4849_8CCC_17C03A14E8BE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "hardware/gpio.h"
+#include "hardware/pio_instructions.h"
+#include "hardware/regs/dreq.h"
+#include "hardware/regs/pio.h"
+#include "hardware/structs/pio.h"
+
+#define PIO_INSTRUCTION_COUNT 32u
+
+typedef pio_hw_t* PIO;
+
+#define pio0 pio0_hw
+#define pio1 pio1_hw
+
+#define check_sm_param(sm) assert((sm) < NUM_PIO_STATE_MACHINES)
+#define check_pio_param(pio) assert((pio) == pio0 || (pio) == pio1)
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2
+};
+
+enum pio_mov_status_type {
+    STATUS_TX_LESSTHAN = 0,
+    STATUS_RX_LESSTHAN = 1
+};
+
+enum pio_interrupt_source {
+    pis_sm0_rx_fifo_not_empty = PIO_INTR_SM0_RXNEMPTY_LSB,
+    pis_sm1_rx_fifo_not_empty = PIO_INTR_SM0_RXNEMPTY_LSB + 1,
+    pis_sm2_rx_fifo_not_empty = PIO_INTR_SM0_RXNEMPTY_LSB + 2,
+    pis_sm3_rx_fifo_not_empty = PIO_INTR_SM0_RXNEMPTY_LSB + 3,
+    pis_sm0_tx_fifo_not_full = PIO_INTR_SM0_TXNFULL_LSB,
+    pis_sm1_tx_fifo_not_full = PIO_INTR_SM0_TXNFULL_LSB + 1,
+    pis_sm2_tx_fifo_not_full = PIO_INTR_SM0_TXNFULL_LSB + 2,
+    pis_sm3_tx_fifo_not_full = PIO_INTR_SM0_TXNFULL_LSB + 3,
+    pis_interrupt0 = PIO_INTR_SM0_LSB,
+    pis_interrupt1 = PIO_INTR_SM0_LSB + 1,
+    pis_interrupt2 = PIO_INTR_SM0_LSB + 2,
+    pis_interrupt3 = PIO_INTR_SM0_LSB + 3
+};
+
+typedef struct {
+    uint32_t clkdiv;
+    uint32_t execctrl;
+    uint32_t shiftctrl;
+    uint32_t pinctrl;
+} pio_sm_config;
+
+typedef struct pio_program {
+    const uint16_t* instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+static inline void sm_config_set_out_pins(
+    pio_sm_config* const c,
+    const uint out_base,
+    const uint out_count) {
+        assert(out_base < 32);
+        assert(out_count <= 32);
+        c->pinctrl = (c->pinctrl & ~(PIO_SM0_PINCTRL_OUT_BASE_BITS | PIO_SM0_PINCTRL_OUT_COUNT_BITS)) |
+            (out_base << PIO_SM0_PINCTRL_OUT_BASE_LSB) |
+            (out_count << PIO_SM0_PINCTRL_OUT_COUNT_LSB);
+}
+
+static inline void sm_config_set_set_pins(
+    pio_sm_config* const c,
+    const uint set_base,
+    const uint set_count) {
+        assert(set_base < 32);
+        assert(set_count <= 5);
+        c->pinctrl = (c->pinctrl & ~(PIO_SM0_PINCTRL_SET_BASE_BITS | PIO_SM0_PINCTRL_SET_COUNT_BITS)) |
+            (set_base << PIO_SM0_PINCTRL_SET_BASE_LSB) |
+            (set_count << PIO_SM0_PINCTRL_SET_COUNT_LSB);
+}
+
+static inline void sm_config_set_in_pins(
+    pio_sm_config* const c,
+    const uint in_base) {
+        assert(in_base < 32);
+        c->pinctrl = (c->pinctrl & ~PIO_SM0_PINCTRL_IN_BASE_BITS) |
+            (in_base << PIO_SM0_PINCTRL_IN_BASE_LSB);
+}
+
+static inline void sm_config_set_sideset_pins(
+    pio_sm_config* const c,
+    const uint sideset_base) {
+        assert(sideset_base < 32);
+        c->pinctrl = (c->pinctrl & ~PIO_SM0_PINCTRL_SIDESET_BASE_BITS) |
+            (sideset_base << PIO_SM0_PINCTRL_SIDESET_BASE_LSB);
+}
+
+static inline void sm_config_set_sideset(
+    pio_sm_config* const c,
+    const uint bit_count,
+    const bool optional,
+    const bool pindirs) {
+        assert(bit_count <= 5);
+        assert(!optional || bit_count >= 1);
+        c->pinctrl = (c->pinctrl & ~PIO_SM0_PINCTRL_SIDESET_COUNT_BITS) |
+            (bit_count << PIO_SM0_PINCTRL_SIDESET_COUNT_LSB);
+        c->execctrl = (c->execctrl & ~(PIO_SM0_EXECCTRL_SIDE_EN_BITS | PIO_SM0_EXECCTRL_SIDE_PINDIR_BITS)) |
+            (optional ? PIO_SM0_EXECCTRL_SIDE_EN_BITS : 0u) |
+            (pindirs ? PIO_SM0_EXECCTRL_SIDE_PINDIR_BITS : 0u);
+}
+
+static inline void sm_config_set_clkdiv_int_frac(
+    pio_sm_config* const c,
+    const uint16_t div_int,
+    const uint8_t div_frac) {
+        assert(div_int || !div_frac);
+        c->clkdiv = (((uint32_t)div_frac) << PIO_SM0_CLKDIV_FRAC_LSB) |
+            (((uint32_t)div_int) << PIO_SM0_CLKDIV_INT_LSB);
+}
+
+static inline void pio_calculate_clkdiv_from_float(
+    const float div,
+    uint16_t* const div_int,
+    uint8_t* const div_frac) {
+        assert(div >= 1 && div <= 65536);
+        *div_int = (uint16_t)div;
+        if(*div_int == 0) {
+            *div_frac = 0;
+        }
+        else {
+            *div_frac = (uint8_t)((div - (float)*div_int) * (1u << 8u));
+        }
+}
+
+static inline void sm_config_set_clkdiv(
+    pio_sm_config* const c,
+    const float div) {
+        uint16_t div_int;
+        uint8_t div_frac;
+        pio_calculate_clkdiv_from_float(div, &div_int, &div_frac);
+        sm_config_set_clkdiv_int_frac(c, div_int, div_frac);
+}
+
+static inline void sm_config_set_wrap(
+    pio_sm_config* const c,
+    const uint wrap_target,
+    const uint wrap) {
+        assert(wrap < PIO_INSTRUCTION_COUNT);
+        assert(wrap_target < PIO_INSTRUCTION_COUNT);
+        c->execctrl = (c->execctrl & ~(PIO_SM0_EXECCTRL_WRAP_TOP_BITS | PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS)) |
+            (wrap_target << PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB) |
+            (wrap << PIO_SM0_EXECCTRL_WRAP_TOP_LSB);
+}
+
+static inline void sm_config_set_jmp_pin(
+    pio_sm_config* const c,
+    const uint pin) {
+        assert(pin < 32);
+        c->execctrl = (c->execctrl & ~PIO_SM0_EXECCTRL_JMP_PIN_BITS) |
+            (pin << PIO_SM0_EXECCTRL_JMP_PIN_LSB);
+}
+
+static inline void sm_config_set_in_shift(
+    pio_sm_config* const c,
+    const bool shift_right,
+    const bool autopush,
+    const uint push_threshold) {
+        assert(push_threshold <= 32);
+        c->shiftctrl = (c->shiftctrl &
+            ~(PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_BITS |
+              PIO_SM0_SHIFTCTRL_AUTOPUSH_BITS |
+              PIO_SM0_SHIFTCTRL_PUSH_THRESH_BITS)) |
+            (shift_right ? PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_BITS : 0u) |
+            (autopush ? PIO_SM0_SHIFTCTRL_AUTOPUSH_BITS : 0u) |
+            ((push_threshold & 0x1fu) << PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB);
+}
+
+static inline void sm_config_set_out_shift(
+    pio_sm_config* const c,
+    const bool shift_right,
+    const bool autopull,
+    const uint pull_threshold) {
+        assert(pull_threshold <= 32);
+        c->shiftctrl = (c->shiftctrl &
+            ~(PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS |
+              PIO_SM0_SHIFTCTRL_AUTOPULL_BITS |
+              PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS)) |
+            (shift_right ? PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS : 0u) |
+            (autopull ? PIO_SM0_SHIFTCTRL_AUTOPULL_BITS : 0u) |
+            ((pull_threshold & 0x1fu) << PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB);
+}
+
+static inline void sm_config_set_fifo_join(
+    pio_sm_config* const c,
+    const enum pio_fifo_join join) {
+        assert(join <= PIO_FIFO_JOIN_RX);
+        c->shiftctrl = (c->shiftctrl & ~(PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS | PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS)) |
+            (join == PIO_FIFO_JOIN_TX ? PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS : 0u) |
+            (join == PIO_FIFO_JOIN_RX ? PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS : 0u);
+}
+
+static inline void sm_config_set_out_special(
+    pio_sm_config* const c,
+    const bool sticky,
+    const bool has_enable_pin,
+    const uint enable_pin_index) {
+        c->execctrl = (c->execctrl &
+            ~(PIO_SM0_EXECCTRL_OUT_STICKY_BITS | PIO_SM0_EXECCTRL_INLINE_OUT_EN_BITS |
+              PIO_SM0_EXECCTRL_OUT_EN_SEL_BITS)) |
+            (sticky ? PIO_SM0_EXECCTRL_OUT_STICKY_BITS : 0u) |
+            (has_enable_pin ? PIO_SM0_EXECCTRL_INLINE_OUT_EN_BITS : 0u) |
+            ((enable_pin_index << PIO_SM0_EXECCTRL_OUT_EN_SEL_LSB) & PIO_SM0_EXECCTRL_OUT_EN_SEL_BITS);
+}
+
+static inline void sm_config_set_mov_status(
+    pio_sm_config* const c,
+    const enum pio_mov_status_type status_sel,
+    const uint status_n) {
+        c->execctrl = (c->execctrl & ~(PIO_SM0_EXECCTRL_STATUS_SEL_BITS | PIO_SM0_EXECCTRL_STATUS_N_BITS)) |
+            ((((uint)status_sel) << 4u) & PIO_SM0_EXECCTRL_STATUS_SEL_BITS) |
+            ((status_n << PIO_SM0_EXECCTRL_STATUS_N_LSB) & PIO_SM0_EXECCTRL_STATUS_N_BITS);
+}
+
+static inline pio_sm_config pio_get_default_sm_config(void) {
+    pio_sm_config c = {0, 0, 0, 0};
+    sm_config_set_clkdiv_int_frac(&c, 1, 0);
+    sm_config_set_wrap(&c, 0, 31);
+    sm_config_set_in_shift(&c, true, false, 32);
+    sm_config_set_out_shift(&c, true, false, 32);
+    return c;
+}
+
+static inline uint pio_get_index(const PIO pio) {
+    check_pio_param(pio);
+    return pio == pio1 ? 1u : 0u;
+}
+
+static inline void pio_gpio_init(const PIO pio, const uint pin) {
+    check_pio_param(pio);
+    assert(pin < NUM_BANK0_GPIOS);
+    gpio_set_function(pin, pio == pio0 ? GPIO_FUNC_PIO0 : GPIO_FUNC_PIO1);
+}
+
+static inline uint pio_get_dreq(
+    const PIO pio,
+    const uint sm,
+    const bool is_tx) {
+        check_sm_param(sm);
+        return sm + (is_tx ? 0u : NUM_PIO_STATE_MACHINES) +
+            (pio == pio0 ? (uint)DREQ_PIO0_TX0 : (uint)DREQ_PIO1_TX0);
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t* program);
+
+bool pio_can_add_program_at_offset(PIO pio, const pio_program_t* program, uint offset);
+
+uint pio_add_program(PIO pio, const pio_program_t* program);
+
+void pio_add_program_at_offset(PIO pio, const pio_program_t* program, uint offset);
+
+void pio_remove_program(PIO pio, const pio_program_t* program, uint loaded_offset);
+
+void pio_clear_instruction_memory(PIO pio);
+
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config* config);
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config* config);
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+
+void pio_set_sm_mask_enabled(PIO pio, uint32_t mask, bool enabled);
+
+void pio_sm_restart(PIO pio, uint sm);
+
+void pio_restart_sm_mask(PIO pio, uint32_t mask);
+
+void pio_sm_clkdiv_restart(PIO pio, uint sm);
+
+void pio_clkdiv_restart_sm_mask(PIO pio, uint32_t mask);
+
+void pio_enable_sm_mask_in_sync(PIO pio, uint32_t mask);
+
+uint8_t pio_sm_get_pc(PIO pio, uint sm);
+
+/**
+ * The instruction is executed immediately. If it stalls it remains
+ * pending until it completes, as on the RP2040.
+ */
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+
+bool pio_sm_is_exec_stalled(PIO pio, uint sm);
+
+void pio_sm_exec_wait_blocking(PIO pio, uint sm, uint instr);
+
+void pio_sm_set_wrap(PIO pio, uint sm, uint wrap_target, uint wrap);
+
+void pio_sm_set_out_pins(PIO pio, uint sm, uint out_base, uint out_count);
+
+void pio_sm_set_set_pins(PIO pio, uint sm, uint set_base, uint set_count);
+
+void pio_sm_set_in_pins(PIO pio, uint sm, uint in_base);
+
+void pio_sm_set_sideset_pins(PIO pio, uint sm, uint sideset_base);
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+
+uint32_t pio_sm_get(PIO pio, uint sm);
+
+/**
+ * FIFO status functions let emulated time pass, so loops which poll
+ * them make progress on the host.
+ */
+bool pio_sm_is_rx_fifo_full(PIO pio, uint sm);
+
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm);
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm);
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm);
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+uint32_t pio_sm_get_blocking(PIO pio, uint sm);
+
+void pio_sm_drain_tx_fifo(PIO pio, uint sm);
+
+void pio_sm_set_clkdiv_int_frac(PIO pio, uint sm, uint16_t div_int, uint8_t div_frac);
+
+void pio_sm_set_clkdiv(PIO pio, uint sm, float div);
+
+void pio_sm_clear_fifos(PIO pio, uint sm);
+
+void pio_sm_set_pins(PIO pio, uint sm, uint32_t pin_values);
+
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask);
+
+void pio_sm_set_pindirs_with_mask(PIO pio, uint sm, uint32_t pin_dirs, uint32_t pin_mask);
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+
+void pio_sm_claim(PIO pio, uint sm);
+
+void pio_claim_sm_mask(PIO pio, uint sm_mask);
+
+void pio_sm_unclaim(PIO pio, uint sm);
+
+int pio_claim_unused_sm(PIO pio, bool required);
+
+bool pio_sm_is_claimed(PIO pio, uint sm);
+
+void pio_set_irq0_source_enabled(PIO pio, enum pio_interrupt_source source, bool enabled);
+
+void pio_set_irq1_source_enabled(PIO pio, enum pio_interrupt_source source, bool enabled);
+
+void pio_set_irq0_source_mask_enabled(PIO pio, uint32_t source_mask, bool enabled);
+
+void pio_set_irq1_source_mask_enabled(PIO pio, uint32_t source_mask, bool enabled);
+
+static inline void pio_set_irqn_source_enabled(
+    const PIO pio,
+    const uint irq_index,
+    const enum pio_interrupt_source source,
+    const bool enabled) {
+        assert(irq_index <= 1);
+        if(irq_index) {
+            pio_set_irq1_source_enabled(pio, source, enabled);
+        }
+        else {
+            pio_set_irq0_source_enabled(pio, source, enabled);
+        }
+}
+
+static inline void pio_set_irqn_source_mask_enabled(
+    const PIO pio,
+    const uint irq_index,
+    const uint32_t source_mask,
+    const bool enabled) {
+        assert(irq_index <= 1);
+        if(irq_index) {
+            pio_set_irq1_source_mask_enabled(pio, source_mask, enabled);
+        }
+        else {
+            pio_set_irq0_source_mask_enabled(pio, source_mask, enabled);
+        }
+}
+
+bool pio_interrupt_get(PIO pio, uint pio_interrupt_num);
+
+void pio_interrupt_clear(PIO pio, uint pio_interrupt_num);
+
+#endif
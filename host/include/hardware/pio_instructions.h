@@ -0,0 +1,169 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_PIO_INSTRUCTIONS_H_4F9ABE90_0428_4191_B53B_01A9DA4CF53B
+#define HOST_HARDWARE_PIO_INSTRUCTIONS_H_4F9ABE90_0428_4191_B53B_01A9DA4CF53B
+
+#include "pico/platform.h"
+
+enum pio_instr_bits {
+    pio_instr_bits_jmp = 0x0000,
+    pio_instr_bits_wait = 0x2000,
+    pio_instr_bits_in = 0x4000,
+    pio_instr_bits_out = 0x6000,
+    pio_instr_bits_push = 0x8000,
+    pio_instr_bits_pull = 0x8080,
+    pio_instr_bits_mov = 0xa000,
+    pio_instr_bits_irq = 0xc000,
+    pio_instr_bits_set = 0xe000
+};
+
+#define _PIO_INVALID_IN_SRC    0x08u
+#define _PIO_INVALID_OUT_DEST  0x10u
+#define _PIO_INVALID_SET_DEST  0x20u
+#define _PIO_INVALID_MOV_SRC   0x40u
+#define _PIO_INVALID_MOV_DEST  0x80u
+
+enum pio_src_dest {
+    pio_pins = 0u,
+    pio_x = 1u,
+    pio_y = 2u,
+    pio_null = 3u | _PIO_INVALID_SET_DEST | _PIO_INVALID_MOV_DEST,
+    pio_pindirs = 4u | _PIO_INVALID_IN_SRC | _PIO_INVALID_MOV_SRC | _PIO_INVALID_MOV_DEST,
+    pio_exec_mov = 4u | _PIO_INVALID_IN_SRC | _PIO_INVALID_OUT_DEST | _PIO_INVALID_SET_DEST | _PIO_INVALID_MOV_SRC,
+    pio_status = 5u | _PIO_INVALID_IN_SRC | _PIO_INVALID_OUT_DEST | _PIO_INVALID_SET_DEST | _PIO_INVALID_MOV_DEST,
+    pio_pc = 5u | _PIO_INVALID_IN_SRC | _PIO_INVALID_SET_DEST | _PIO_INVALID_MOV_SRC,
+    pio_isr = 6u | _PIO_INVALID_SET_DEST,
+    pio_osr = 7u | _PIO_INVALID_OUT_DEST | _PIO_INVALID_SET_DEST,
+    pio_exec_out = 7u | _PIO_INVALID_IN_SRC | _PIO_INVALID_SET_DEST | _PIO_INVALID_MOV_SRC | _PIO_INVALID_MOV_DEST
+};
+
+static inline uint _pio_major_instr_bits(const uint instr) {
+    return instr & 0xe000u;
+}
+
+static inline uint _pio_encode_instr_and_args(
+    const enum pio_instr_bits instr_bits,
+    const uint arg1,
+    const uint arg2) {
+        return instr_bits | (arg1 << 5u) | (arg2 & 0x1fu);
+}
+
+static inline uint _pio_encode_instr_and_src_dest(
+    const enum pio_instr_bits instr_bits,
+    const enum pio_src_dest dest,
+    const uint value) {
+        return _pio_encode_instr_and_args(instr_bits, dest & 7u, value);
+}
+
+static inline uint pio_encode_delay(const uint cycles) {
+    return cycles << 8u;
+}
+
+static inline uint pio_encode_sideset(const uint sideset_bit_count, const uint value) {
+    return value << (13u - sideset_bit_count);
+}
+
+static inline uint pio_encode_sideset_opt(const uint sideset_bit_count, const uint value) {
+    return 0x1000u | value << (12u - sideset_bit_count);
+}
+
+static inline uint _pio_encode_jmp(const uint cond, const uint addr) {
+    return _pio_encode_instr_and_args(pio_instr_bits_jmp, cond, addr);
+}
+
+static inline uint pio_encode_jmp(const uint addr) { return _pio_encode_jmp(0, addr); }
+static inline uint pio_encode_jmp_not_x(const uint addr) { return _pio_encode_jmp(1, addr); }
+static inline uint pio_encode_jmp_x_dec(const uint addr) { return _pio_encode_jmp(2, addr); }
+static inline uint pio_encode_jmp_not_y(const uint addr) { return _pio_encode_jmp(3, addr); }
+static inline uint pio_encode_jmp_y_dec(const uint addr) { return _pio_encode_jmp(4, addr); }
+static inline uint pio_encode_jmp_x_ne_y(const uint addr) { return _pio_encode_jmp(5, addr); }
+static inline uint pio_encode_jmp_pin(const uint addr) { return _pio_encode_jmp(6, addr); }
+static inline uint pio_encode_jmp_not_osre(const uint addr) { return _pio_encode_jmp(7, addr); }
+
+static inline uint _pio_encode_irq(const bool relative, const uint irq) {
+    return (relative ? 0x10u : 0x0u) | irq;
+}
+
+static inline uint pio_encode_wait_gpio(const bool polarity, const uint gpio) {
+    return _pio_encode_instr_and_args(pio_instr_bits_wait, 0u | (polarity ? 4u : 0u), gpio);
+}
+
+static inline uint pio_encode_wait_pin(const bool polarity, const uint pin) {
+    return _pio_encode_instr_and_args(pio_instr_bits_wait, 1u | (polarity ? 4u : 0u), pin);
+}
+
+static inline uint pio_encode_wait_irq(const bool polarity, const bool relative, const uint irq) {
+    return _pio_encode_instr_and_args(pio_instr_bits_wait, 2u | (polarity ? 4u : 0u), _pio_encode_irq(relative, irq));
+}
+
+static inline uint pio_encode_in(const enum pio_src_dest src, const uint count) {
+    return _pio_encode_instr_and_src_dest(pio_instr_bits_in, src, count & 0x1fu);
+}
+
+static inline uint pio_encode_out(const enum pio_src_dest dest, const uint count) {
+    return _pio_encode_instr_and_src_dest(pio_instr_bits_out, dest, count & 0x1fu);
+}
+
+static inline uint pio_encode_push(const bool if_full, const bool block) {
+    return _pio_encode_instr_and_args(pio_instr_bits_push, (if_full ? 2u : 0u) | (block ? 1u : 0u), 0);
+}
+
+static inline uint pio_encode_pull(const bool if_empty, const bool block) {
+    return _pio_encode_instr_and_args(pio_instr_bits_pull, (if_empty ? 2u : 0u) | (block ? 1u : 0u), 0);
+}
+
+static inline uint pio_encode_mov(const enum pio_src_dest dest, const enum pio_src_dest src) {
+    return _pio_encode_instr_and_args(pio_instr_bits_mov, dest & 7u, src & 7u);
+}
+
+static inline uint pio_encode_mov_not(const enum pio_src_dest dest, const enum pio_src_dest src) {
+    return _pio_encode_instr_and_args(pio_instr_bits_mov, dest & 7u, (1u << 3u) | (src & 7u));
+}
+
+static inline uint pio_encode_mov_reverse(const enum pio_src_dest dest, const enum pio_src_dest src) {
+    return _pio_encode_instr_and_args(pio_instr_bits_mov, dest & 7u, (2u << 3u) | (src & 7u));
+}
+
+static inline uint pio_encode_irq_set(const bool relative, const uint irq) {
+    return _pio_encode_instr_and_args(pio_instr_bits_irq, 0, _pio_encode_irq(relative, irq));
+}
+
+static inline uint pio_encode_irq_wait(const bool relative, const uint irq) {
+    return _pio_encode_instr_and_args(pio_instr_bits_irq, 1, _pio_encode_irq(relative, irq));
+}
+
+static inline uint pio_encode_irq_clear(const bool relative, const uint irq) {
+    return _pio_encode_instr_and_args(pio_instr_bits_irq, 2, _pio_encode_irq(relative, irq));
+}
+
+static inline uint pio_encode_set(const enum pio_src_dest dest, const uint value) {
+    return _pio_encode_instr_and_src_dest(pio_instr_bits_set, dest, value);
+}
+
+static inline uint pio_encode_nop(void) {
+    return pio_encode_mov(pio_y, pio_y);
+}
+
+#endif
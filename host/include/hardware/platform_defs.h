@@ -0,0 +1,40 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_PLATFORM_DEFS_H_C83412F8_23DE_4A3C_A53F_2EF8D8AC9688
+#define HOST_HARDWARE_PLATFORM_DEFS_H_C83412F8_23DE_4A3C_A53F_2EF8D8AC9688
+
+#define NUM_CORES                   2u
+#define NUM_DMA_CHANNELS            12u
+#define NUM_DMA_TIMERS              4u
+#define NUM_IRQS                    32u
+#define NUM_USER_IRQS               6u
+#define NUM_PIOS                    2u
+#define NUM_PIO_STATE_MACHINES      4u
+#define NUM_BANK0_GPIOS             30u
+#define NUM_SPIN_LOCKS              32u
+
+#define PICO_NO_HARDWARE            0
+
+#endif
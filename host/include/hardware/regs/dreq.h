@@ -0,0 +1,50 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_REGS_DREQ_H_F89A5F9C_67A1_474B_A097_20EA02E8D3C6
+#define HOST_HARDWARE_REGS_DREQ_H_F89A5F9C_67A1_474B_A097_20EA02E8D3C6
+
+#define DREQ_PIO0_TX0   0
+#define DREQ_PIO0_TX1   1
+#define DREQ_PIO0_TX2   2
+#define DREQ_PIO0_TX3   3
+#define DREQ_PIO0_RX0   4
+#define DREQ_PIO0_RX1   5
+#define DREQ_PIO0_RX2   6
+#define DREQ_PIO0_RX3   7
+#define DREQ_PIO1_TX0   8
+#define DREQ_PIO1_TX1   9
+#define DREQ_PIO1_TX2   10
+#define DREQ_PIO1_TX3   11
+#define DREQ_PIO1_RX0   12
+#define DREQ_PIO1_RX1   13
+#define DREQ_PIO1_RX2   14
+#define DREQ_PIO1_RX3   15
+#define DREQ_DMA_TIMER0 0x3b
+#define DREQ_DMA_TIMER1 0x3c
+#define DREQ_DMA_TIMER2 0x3d
+#define DREQ_DMA_TIMER3 0x3e
+#define DREQ_FORCE      0x3f
+
+#endif
@@ -0,0 +1,55 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_REGS_INTCTRL_H_98B08BAE_1AC5_40BE_AF73_3D595848C43A
+#define HOST_HARDWARE_REGS_INTCTRL_H_98B08BAE_1AC5_40BE_AF73_3D595848C43A
+
+#define TIMER_IRQ_0     0
+#define TIMER_IRQ_1     1
+#define TIMER_IRQ_2     2
+#define TIMER_IRQ_3     3
+#define PWM_IRQ_WRAP    4
+#define USBCTRL_IRQ     5
+#define XIP_IRQ         6
+#define PIO0_IRQ_0      7
+#define PIO0_IRQ_1      8
+#define PIO1_IRQ_0      9
+#define PIO1_IRQ_1      10
+#define DMA_IRQ_0       11
+#define DMA_IRQ_1       12
+#define IO_IRQ_BANK0    13
+#define IO_IRQ_QSPI     14
+#define SIO_IRQ_PROC0   15
+#define SIO_IRQ_PROC1   16
+#define CLOCKS_IRQ      17
+#define SPI0_IRQ        18
+#define SPI1_IRQ        19
+#define UART0_IRQ       20
+#define UART1_IRQ       21
+#define ADC_IRQ_FIFO    22
+#define I2C0_IRQ        23
+#define I2C1_IRQ        24
+#define RTC_IRQ         25
+
+#endif
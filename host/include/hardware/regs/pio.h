@@ -0,0 +1,98 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_REGS_PIO_H_10CB6885_4941_4E28_A8F8_122914000526
+#define HOST_HARDWARE_REGS_PIO_H_10CB6885_4941_4E28_A8F8_122914000526
+
+#define PIO_CTRL_SM_ENABLE_LSB              0u
+#define PIO_CTRL_SM_ENABLE_BITS             0x0000000fu
+#define PIO_CTRL_SM_RESTART_LSB             4u
+#define PIO_CTRL_CLKDIV_RESTART_LSB         8u
+
+#define PIO_FSTAT_RXFULL_LSB                0u
+#define PIO_FSTAT_RXEMPTY_LSB               8u
+#define PIO_FSTAT_TXFULL_LSB                16u
+#define PIO_FSTAT_TXEMPTY_LSB               24u
+
+#define PIO_FDEBUG_RXSTALL_LSB              0u
+#define PIO_FDEBUG_RXUNDER_LSB              8u
+#define PIO_FDEBUG_TXOVER_LSB               16u
+#define PIO_FDEBUG_TXSTALL_LSB              24u
+
+#define PIO_FLEVEL_TX0_LSB                  0u
+#define PIO_FLEVEL_RX0_LSB                  4u
+
+#define PIO_SM0_CLKDIV_INT_LSB              16u
+#define PIO_SM0_CLKDIV_INT_BITS             0xffff0000u
+#define PIO_SM0_CLKDIV_FRAC_LSB             8u
+#define PIO_SM0_CLKDIV_FRAC_BITS            0x0000ff00u
+
+#define PIO_SM0_EXECCTRL_EXEC_STALLED_BITS  0x80000000u
+#define PIO_SM0_EXECCTRL_SIDE_EN_BITS       0x40000000u
+#define PIO_SM0_EXECCTRL_SIDE_PINDIR_BITS   0x20000000u
+#define PIO_SM0_EXECCTRL_JMP_PIN_LSB        24u
+#define PIO_SM0_EXECCTRL_JMP_PIN_BITS       0x1f000000u
+#define PIO_SM0_EXECCTRL_OUT_EN_SEL_LSB     19u
+#define PIO_SM0_EXECCTRL_OUT_EN_SEL_BITS    0x00f80000u
+#define PIO_SM0_EXECCTRL_INLINE_OUT_EN_BITS 0x00040000u
+#define PIO_SM0_EXECCTRL_OUT_STICKY_BITS    0x00020000u
+#define PIO_SM0_EXECCTRL_WRAP_TOP_LSB       12u
+#define PIO_SM0_EXECCTRL_WRAP_TOP_BITS      0x0001f000u
+#define PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB    7u
+#define PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS   0x00000f80u
+#define PIO_SM0_EXECCTRL_STATUS_SEL_BITS    0x00000010u
+#define PIO_SM0_EXECCTRL_STATUS_N_LSB       0u
+#define PIO_SM0_EXECCTRL_STATUS_N_BITS      0x0000000fu
+
+#define PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS     0x80000000u
+#define PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS     0x40000000u
+#define PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB   25u
+#define PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS  0x3e000000u
+#define PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB   20u
+#define PIO_SM0_SHIFTCTRL_PUSH_THRESH_BITS  0x01f00000u
+#define PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_BITS 0x00080000u
+#define PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_BITS  0x00040000u
+#define PIO_SM0_SHIFTCTRL_AUTOPULL_BITS     0x00020000u
+#define PIO_SM0_SHIFTCTRL_AUTOPUSH_BITS     0x00010000u
+
+#define PIO_SM0_PINCTRL_SIDESET_COUNT_LSB   29u
+#define PIO_SM0_PINCTRL_SIDESET_COUNT_BITS  0xe0000000u
+#define PIO_SM0_PINCTRL_SET_COUNT_LSB       26u
+#define PIO_SM0_PINCTRL_SET_COUNT_BITS      0x1c000000u
+#define PIO_SM0_PINCTRL_OUT_COUNT_LSB       20u
+#define PIO_SM0_PINCTRL_OUT_COUNT_BITS      0x03f00000u
+#define PIO_SM0_PINCTRL_IN_BASE_LSB         15u
+#define PIO_SM0_PINCTRL_IN_BASE_BITS        0x000f8000u
+#define PIO_SM0_PINCTRL_SIDESET_BASE_LSB    10u
+#define PIO_SM0_PINCTRL_SIDESET_BASE_BITS   0x00007c00u
+#define PIO_SM0_PINCTRL_SET_BASE_LSB        5u
+#define PIO_SM0_PINCTRL_SET_BASE_BITS       0x000003e0u
+#define PIO_SM0_PINCTRL_OUT_BASE_LSB        0u
+#define PIO_SM0_PINCTRL_OUT_BASE_BITS       0x0000001fu
+
+#define PIO_INTR_SM0_RXNEMPTY_LSB           0u
+#define PIO_INTR_SM0_TXNFULL_LSB            4u
+#define PIO_INTR_SM0_LSB                    8u
+
+#endif
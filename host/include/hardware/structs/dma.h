@@ -0,0 +1,78 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_STRUCTS_DMA_H_CEAB6773_CD8E_4120_B84A_25B079BDF60A
+#define HOST_HARDWARE_STRUCTS_DMA_H_CEAB6773_CD8E_4120_B84A_25B079BDF60A
+
+#include "hardware/address_mapped.h"
+#include "hardware/platform_defs.h"
+
+#define DMA_CH0_CTRL_TRIG_AHB_ERROR_BITS        0x80000000u
+#define DMA_CH0_CTRL_TRIG_BUSY_BITS             0x01000000u
+#define DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS         0x00800000u
+#define DMA_CH0_CTRL_TRIG_BSWAP_BITS            0x00400000u
+#define DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS        0x00200000u
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB          15u
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS         0x001f8000u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB          11u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS         0x00007800u
+#define DMA_CH0_CTRL_TRIG_RING_SEL_BITS         0x00000400u
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_LSB         6u
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_BITS        0x000003c0u
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS       0x00000020u
+#define DMA_CH0_CTRL_TRIG_INCR_READ_BITS        0x00000010u
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB         2u
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS        0x0000000cu
+#define DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS    0x00000002u
+#define DMA_CH0_CTRL_TRIG_EN_BITS               0x00000001u
+
+/**
+ * Only the first alias of each channel is modelled; the SDK functions
+ * in hardware/dma.h are the supported way to program a channel.
+ */
+typedef struct {
+    io_rw_ptr read_addr;
+    io_rw_ptr write_addr;
+    io_rw_32 transfer_count;
+    io_rw_32 ctrl_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+    dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+    io_rw_32 intr;
+    io_rw_32 inte0;
+    io_rw_32 intf0;
+    io_rw_32 ints0;
+    io_rw_32 inte1;
+    io_rw_32 intf1;
+    io_rw_32 ints1;
+    io_wo_32 multi_channel_trigger;
+    io_wo_32 abort;
+} dma_hw_t;
+
+extern dma_hw_t hostemu_dma_hw;
+
+#define dma_hw (&hostemu_dma_hw)
+
+#endif
@@ -0,0 +1,81 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_STRUCTS_PIO_H_FB52B84F_CD5A_4095_8101_E0365F33B230
+#define HOST_HARDWARE_STRUCTS_PIO_H_FB52B84F_CD5A_4095_8101_E0365F33B230
+
+#include "hardware/address_mapped.h"
+#include "hardware/platform_defs.h"
+#include "hardware/regs/pio.h"
+
+typedef struct {
+    io_rw_32 clkdiv;
+    io_rw_32 execctrl;
+    io_rw_32 shiftctrl;
+    io_ro_32 addr;
+    io_rw_32 instr;
+    io_rw_32 pinctrl;
+} pio_sm_hw_t;
+
+typedef struct {
+    io_rw_32 inte;
+    io_rw_32 intf;
+    io_ro_32 ints;
+} pio_irq_ctrl_hw_t;
+
+typedef struct {
+    io_rw_32 ctrl;
+    io_ro_32 fstat;
+    io_rw_32 fdebug;
+    io_ro_32 flevel;
+    io_wo_32 txf[NUM_PIO_STATE_MACHINES];
+    io_ro_32 rxf[NUM_PIO_STATE_MACHINES];
+    io_rw_32 irq;
+    io_wo_32 irq_force;
+    io_rw_32 input_sync_bypass;
+    io_rw_32 dbg_padout;
+    io_rw_32 dbg_padoe;
+    io_rw_32 dbg_cfginfo;
+    io_wo_32 instr_mem[32];
+    pio_sm_hw_t sm[NUM_PIO_STATE_MACHINES];
+    io_rw_32 intr;
+    union {
+        struct {
+            io_rw_32 inte0;
+            io_rw_32 intf0;
+            io_ro_32 ints0;
+            io_rw_32 inte1;
+            io_rw_32 intf1;
+            io_ro_32 ints1;
+        };
+        pio_irq_ctrl_hw_t irq_ctrl[2];
+    };
+} pio_hw_t;
+
+extern pio_hw_t hostemu_pio_hw[NUM_PIOS];
+
+#define pio0_hw (&hostemu_pio_hw[0])
+#define pio1_hw (&hostemu_pio_hw[1])
+
+#endif
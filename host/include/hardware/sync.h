@@ -0,0 +1,73 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_SYNC_H_92ED2908_9393_4691_9870_1BC81B42E804
+#define HOST_HARDWARE_SYNC_H_92ED2908_9393_4691_9870_1BC81B42E804
+
+#include <stdint.h>
+#include "pico/platform.h"
+
+/**
+ * The emulator models PRIMASK for each core. Interrupt handlers are
+ * dispatched when time passes or when interrupts are re-enabled.
+ */
+uint32_t save_and_disable_interrupts(void);
+
+void restore_interrupts(uint32_t status);
+
+/**
+ * __wfe() returns once an event has been signalled with __sev() or an
+ * interrupt has been taken, advancing emulated time until then.
+ */
+void __wfe(void);
+
+void __wfi(void);
+
+void __sev(void);
+
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __dsb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __isb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __mem_fence_acquire(void) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void __mem_fence_release(void) {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void __nop(void) {
+    __asm__ volatile ("nop");
+}
+
+#endif
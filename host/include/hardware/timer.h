@@ -0,0 +1,69 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_HARDWARE_TIMER_H_301F2F40_229A_44AF_98CF_3B89B5EA1069
+#define HOST_HARDWARE_TIMER_H_301F2F40_229A_44AF_98CF_3B89B5EA1069
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hardware/address_mapped.h"
+
+typedef struct {
+    io_wo_32 timehw;
+    io_wo_32 timelw;
+    io_ro_32 timehr;
+    io_ro_32 timelr;
+    io_rw_32 alarm[4];
+    io_rw_32 armed;
+    io_ro_32 timerawh;
+    io_ro_32 timerawl;
+} timer_hw_t;
+
+/**
+ * DMA reads of timerawl/timerawh return the current emulated time.
+ */
+extern timer_hw_t hostemu_timer_hw;
+
+#define timer_hw (&hostemu_timer_hw)
+
+/**
+ * Reading the timer lets emulated time pass, so loops polling it make
+ * progress on the host.
+ */
+uint64_t time_us_64(void);
+
+uint32_t time_us_32(void);
+
+void busy_wait_us_32(uint32_t delay_us);
+
+void busy_wait_us(uint64_t delay_us);
+
+void busy_wait_ms(uint32_t delay_ms);
+
+void busy_wait_until(absolute_time_t t);
+
+bool time_reached(absolute_time_t t);
+
+#endif
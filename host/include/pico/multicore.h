@@ -0,0 +1,58 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_PICO_MULTICORE_H_4A348D7E_915E_4B8B_806E_5CB66C291F08
+#define HOST_PICO_MULTICORE_H_4A348D7E_915E_4B8B_806E_5CB66C291F08
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+
+/**
+ * Core 1 runs cooperatively with core 0: it runs whenever core 0
+ * waits on the hardware, until it waits on the hardware itself.
+ * Both cores share emulated time. The inter-core FIFOs are 8 words
+ * deep in each direction.
+ */
+#define SIO_FIFO_DEPTH 8u
+
+void multicore_launch_core1(void (*entry)(void));
+
+void multicore_reset_core1(void);
+
+bool multicore_fifo_rvalid(void);
+
+bool multicore_fifo_wready(void);
+
+void multicore_fifo_push_blocking(uint32_t data);
+
+bool multicore_fifo_push_timeout_us(uint32_t data, uint64_t timeout_us);
+
+uint32_t multicore_fifo_pop_blocking(void);
+
+bool multicore_fifo_pop_timeout_us(uint64_t timeout_us, uint32_t* out);
+
+void multicore_fifo_drain(void);
+
+#endif
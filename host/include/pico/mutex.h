@@ -0,0 +1,65 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_PICO_MUTEX_H_B87B7256_2E14_478C_BF9B_FB118838A839
+#define HOST_PICO_MUTEX_H_B87B7256_2E14_478C_BF9B_FB118838A839
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+
+typedef int8_t lock_owner_id_t;
+
+#define LOCK_INVALID_OWNER_ID ((lock_owner_id_t)-1)
+
+typedef struct {
+    void* spin_lock;
+} lock_core_t;
+
+typedef struct {
+    lock_core_t core;
+    lock_owner_id_t owner;
+} mutex_t;
+
+void mutex_init(mutex_t* mtx);
+
+/**
+ * Blocks while the mutex is owned, letting emulated time pass so that
+ * an interrupt handler may release it. Panics if it is never released.
+ */
+void mutex_enter_blocking(mutex_t* mtx);
+
+bool mutex_try_enter(mutex_t* mtx, uint32_t* owner_out);
+
+void mutex_exit(mutex_t* mtx);
+
+static inline bool mutex_is_initialized(mutex_t* mtx) {
+    return mtx->core.spin_lock != NULL;
+}
+
+#define auto_init_mutex(name) static mutex_t name = { \
+    .core = { .spin_lock = &name }, \
+    .owner = LOCK_INVALID_OWNER_ID }
+
+#endif
@@ -0,0 +1,110 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name. Code
+// which would be placed in RAM on the RP2040 is compiled normally.
+
+#ifndef HOST_PICO_PLATFORM_H_3A9F6E21_8C4D_4B07_9E5A_1D2C7F8B6E30
+#define HOST_PICO_PLATFORM_H_3A9F6E21_8C4D_4B07_9E5A_1D2C7F8B6E30
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hardware/platform_defs.h"
+#include "hardware/regs/intctrl.h"
+
+#ifndef __aligned
+#define __aligned(x) __attribute__((aligned(x)))
+#endif
+
+#ifndef __packed
+#define __packed __attribute__((packed))
+#endif
+
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif
+
+#ifndef __used
+#define __used __attribute__((used))
+#endif
+
+#define __isr
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name) func_name
+#define __no_inline_not_in_flash_func(func_name) __attribute__((noinline)) func_name
+#define __time_critical_func(func_name) func_name
+#define __scratch_x(group)
+#define __scratch_y(group)
+#define __uninitialized_ram(name) name
+#define __force_inline inline __attribute__((always_inline))
+
+#ifndef count_of
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((b) > (a) ? (a) : (b))
+#endif
+
+#define VTABLE_FIRST_IRQ 16u
+
+#define hard_assert(x) assert(x)
+#define valid_params_if(x, test) assert(test)
+#define invalid_params_if(x, test) assert(!(test))
+
+void panic(const char* fmt, ...) __attribute__((noreturn));
+
+void panic_unsupported(void) __attribute__((noreturn));
+
+/**
+ * Lets emulated time pass. Busy-wait loops which call this (directly or
+ * through one of the status functions) make progress on the host.
+ */
+void tight_loop_contents(void);
+
+/**
+ * Returns the exception number currently being serviced, ie.
+ * VTABLE_FIRST_IRQ + irq while inside an interrupt handler, else 0.
+ */
+uint __get_current_exception(void);
+
+uint get_core_num(void);
+
+static inline void __compiler_memory_barrier(void) {
+    __asm__ volatile ("" : : : "memory");
+}
+
+static inline void __breakpoint(void) {
+    panic("breakpoint");
+}
+
+static inline uint32_t __mul_instruction(const int32_t a, const int32_t b) {
+    return (uint32_t)(a * b);
+}
+
+#endif
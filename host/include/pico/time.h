@@ -0,0 +1,105 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Host stand-in for the pico-sdk header of the same name.
+
+#ifndef HOST_PICO_TIME_H_1670A0F0_BD48_4D53_95B3_A01D8F39A606
+#define HOST_PICO_TIME_H_1670A0F0_BD48_4D53_95B3_A01D8F39A606
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hardware/timer.h"
+
+static inline absolute_time_t get_absolute_time(void) {
+    absolute_time_t t;
+    update_us_since_boot(&t, time_us_64());
+    return t;
+}
+
+static inline uint32_t to_ms_since_boot(const absolute_time_t t) {
+    return (uint32_t)(to_us_since_boot(t) / 1000);
+}
+
+static inline absolute_time_t delayed_by_us(
+    const absolute_time_t t,
+    const uint64_t us) {
+        absolute_time_t t2;
+        const uint64_t base = to_us_since_boot(t);
+        uint64_t delayed = base + us;
+        if(delayed < base) {
+            delayed = UINT64_MAX;
+        }
+        update_us_since_boot(&t2, delayed);
+        return t2;
+}
+
+static inline absolute_time_t delayed_by_ms(
+    const absolute_time_t t,
+    const uint32_t ms) {
+        return delayed_by_us(t, (uint64_t)ms * 1000);
+}
+
+static inline absolute_time_t make_timeout_time_us(const uint64_t us) {
+    return delayed_by_us(get_absolute_time(), us);
+}
+
+static inline absolute_time_t make_timeout_time_ms(const uint32_t ms) {
+    return delayed_by_ms(get_absolute_time(), ms);
+}
+
+static inline int64_t absolute_time_diff_us(
+    const absolute_time_t from,
+    const absolute_time_t to) {
+        return (int64_t)(to_us_since_boot(to) - to_us_since_boot(from));
+}
+
+static inline absolute_time_t absolute_time_min(
+    const absolute_time_t a,
+    const absolute_time_t b) {
+        return to_us_since_boot(a) < to_us_since_boot(b) ? a : b;
+}
+
+#define at_the_end_of_time ((absolute_time_t)UINT64_MAX)
+#define nil_time ((absolute_time_t)0)
+
+static inline bool is_at_the_end_of_time(const absolute_time_t t) {
+    return to_us_since_boot(t) == UINT64_MAX;
+}
+
+static inline bool is_nil_time(const absolute_time_t t) {
+    return to_us_since_boot(t) == 0;
+}
+
+void sleep_until(absolute_time_t target);
+
+void sleep_us(uint64_t us);
+
+void sleep_ms(uint32_t ms);
+
+/**
+ * Waits for an event (see __wfe()) or until the timeout is reached.
+ * Returns true if the timeout has been reached.
+ */
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+
+#endif
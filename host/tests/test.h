@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Helpers shared by the host tests. Each test is a function returning
+// the number of failed checks, which test_main runs from a freshly
+// reset emulator.
+
+#ifndef HOST_TEST_H_9B4E2F71_6A3C_4D58_B0E7_3C81F5A2D6E9
+#define HOST_TEST_H_9B4E2F71_6A3C_4D58_B0E7_3C81F5A2D6E9
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "hostemu.h"
+
+#define TEST_CHECK(cond) \
+    do { \
+        if(!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures; \
+        } \
+    } while(0)
+
+typedef int (*test_fn_t)(void);
+
+typedef struct {
+    const char* name;
+    test_fn_t fn;
+} test_case_t;
+
+#define TEST_CASE(fn) { #fn, fn }
+
+static inline int test_main(
+    const test_case_t* const tests,
+    const size_t len) {
+
+        int failed = 0;
+
+        for(size_t i = 0; i < len; ++i) {
+            hostemu_reset();
+            const int failures = tests[i].fn();
+            printf("%-40s %s\n", tests[i].name, failures == 0 ? "ok" : "FAILED");
+            failed += failures != 0;
+        }
+
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
+
+#endif
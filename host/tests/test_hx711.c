@@ -0,0 +1,1135 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs the hx711_t driver against the emulated PIO, DMA and HX711.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "hostemu.h"
+#include "pico/time.h"
+#include "../../include/common.h"
+#include "../../include/util.h"
+#include "test.h"
+
+#define CLOCK_PIN   14
+#define DATA_PIN    15
+#define STREAM_LEN  16
+
+// values count up from the conversion index, with the number of gain
+// pulses the conversion was made with in the upper digits so that
+// tests can tell which gain produced a value
+static int32_t source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        (void)ctx;
+        return (int32_t)gainPulses * 100000 + (int32_t)(index % 100000);
+}
+
+static void attach_device(
+    hostemu_hx711_t* const dev,
+    const uint32_t firstReadyUs) {
+
+        hostemu_hx711_config_t cfg;
+        hostemu_hx711_default_config(&cfg);
+
+        cfg.clock_pin = CLOCK_PIN;
+        cfg.data_pin = DATA_PIN;
+        cfg.source = source;
+
+        if(firstReadyUs != 0) {
+            cfg.first_ready_us = firstReadyUs;
+        }
+
+        hostemu_hx711_attach(dev, &cfg);
+
+}
+
+static void init_driver(
+    hx711_t* const hx,
+    const bool joinRxFifo) {
+
+        hx711_config_t cfg;
+        hx711_get_default_config(&cfg);
+
+        cfg.clock_pin = CLOCK_PIN;
+        cfg.data_pin = DATA_PIN;
+        cfg.join_rx_fifo = joinRxFifo;
+
+        hx711_init(hx, &cfg);
+        hx711_power_up(hx, hx711_gain_128);
+        hx711_wait_settle(hx711_rate_80);
+
+}
+
+static int test_shared_program(void) {
+
+    int failures = 0;
+    hostemu_hx711_t devs[NUM_PIO_STATE_MACHINES];
+    hx711_t hxs[NUM_PIO_STATE_MACHINES] = {0};
+
+    for(uint i = 0; i < NUM_PIO_STATE_MACHINES; ++i) {
+
+        hostemu_hx711_config_t devcfg;
+        hostemu_hx711_default_config(&devcfg);
+        devcfg.clock_pin = i * 2;
+        devcfg.data_pin = i * 2 + 1;
+        devcfg.source = source;
+        hostemu_hx711_attach(&devs[i], &devcfg);
+
+        hx711_config_t cfg;
+        hx711_get_default_config(&cfg);
+        cfg.clock_pin = devcfg.clock_pin;
+        cfg.data_pin = devcfg.data_pin;
+        hx711_init(&hxs[i], &cfg);
+        hx711_power_up(&hxs[i], hx711_gain_128);
+
+        //every state machine runs the same copy of the program
+        TEST_CHECK(hxs[i]._reader_offset == hxs[0]._reader_offset);
+
+    }
+
+    hx711_wait_settle(hx711_rate_80);
+
+    for(uint i = 0; i < NUM_PIO_STATE_MACHINES; ++i) {
+        //discard whatever accumulated in the RX FIFO
+        for(uint j = 0; j < 8; ++j) {
+            hx711_get_value(&hxs[i]);
+        }
+        const int32_t val = hx711_get_value(&hxs[i]);
+        TEST_CHECK(val == hostemu_hx711_get_read(&devs[i], 0)->value);
+    }
+
+    //the program stays loaded until the last instance is closed
+    for(uint i = 0; i < NUM_PIO_STATE_MACHINES; ++i) {
+        TEST_CHECK(!pio_can_add_program_at_offset(
+            pio0,
+            hxs[0]._reader_prog,
+            hxs[0]._reader_offset));
+        hx711_close(&hxs[i]);
+    }
+
+    TEST_CHECK(pio_can_add_program_at_offset(
+        pio0,
+        hxs[0]._reader_prog,
+        hxs[0]._reader_offset));
+
+    return failures;
+
+}
+
+static int test_get_value(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    //discard whatever accumulated in the RX FIFO while settling
+    for(uint i = 0; i < 8; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    int32_t prev = hx711_get_value(&hx);
+
+    for(uint i = 0; i < 16; ++i) {
+        const int32_t val = hx711_get_value(&hx);
+        TEST_CHECK(val == hostemu_hx711_get_read(&dev, 0)->value);
+        TEST_CHECK(val == prev + 1);
+        prev = val;
+    }
+
+    TEST_CHECK(dev.stats.power_downs == 0);
+    TEST_CHECK(dev.stats.stray_pulses == 0);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+// a value can be taken without blocking as soon as one is in the
+// RX FIFO, rather than once three have accumulated
+static int test_get_value_noblock(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    int32_t val;
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    for(uint i = 0; i < 8; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    for(uint i = 0; i < 4; ++i) {
+
+        TEST_CHECK(!hx711_get_value_noblock(&hx, &val));
+
+        const uint32_t reads = dev.stats.reads;
+
+        while(dev.stats.reads == reads) {
+            sleep_us(100);
+        }
+
+        //allow the gain pulse and push to complete
+        sleep_us(100);
+
+        TEST_CHECK(hx711_get_value_noblock(&hx, &val));
+        TEST_CHECK(val == hostemu_hx711_get_read(&dev, 0)->value);
+
+    }
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_get_value_sleeps(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.data_pin = DATA_PIN;
+    devCfg.rate = 10;
+    devCfg.source = source;
+    hostemu_hx711_attach(&dev, &devCfg);
+
+    init_driver(&hx, false);
+
+    //nothing is attached until the first wait
+    const uint irqNum = util_pio_get_irq_from_index(hx._pio, hx._pio_irq_index);
+    TEST_CHECK(hx711__callback_array[pio_get_index(hx._pio)][hx._reader_sm] == NULL);
+    TEST_CHECK(!irq_has_shared_handler(irqNum));
+
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+
+    const uint64_t startCycles = hostemu_cycles();
+    const uint64_t startPolls = hostemu_poll_cycles();
+
+    for(uint i = 0; i < 4; ++i) {
+        TEST_CHECK(hx711_get_value(&hx) == hostemu_hx711_get_read(&dev, 0)->value);
+    }
+
+    //about 400ms passed, nearly all of it asleep
+    const uint64_t elapsed = hostemu_cycles() - startCycles;
+    TEST_CHECK(elapsed >= hostemu_us_to_cycles(300000));
+    TEST_CHECK((hostemu_poll_cycles() - startPolls) * 1000 < elapsed);
+
+    //the handler stays installed after the first wait and
+    //only the source is enabled while waiting
+    const uint32_t source = 1u << (pis_sm0_rx_fifo_not_empty + hx._reader_sm);
+    TEST_CHECK(hx711__callback_array[pio_get_index(hx._pio)][hx._reader_sm] == &hx);
+    TEST_CHECK(irq_has_shared_handler(irqNum));
+    TEST_CHECK(((hx._pio_irq_index == 0 ? hx._pio->inte0 : hx._pio->inte1) & source) == 0);
+
+    hx711_close(&hx);
+
+    TEST_CHECK(hx711__callback_array[pio_get_index(hx._pio)][hx._reader_sm] == NULL);
+    TEST_CHECK(!irq_has_shared_handler(irqNum));
+
+    return failures;
+
+}
+
+static int test_get_values_joined(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    int32_t values[16];
+
+    attach_device(&dev, 0);
+    init_driver(&hx, true);
+
+    //the joined FIFO holds twice as many values
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+    sleep_us(12500 * 6 + 1000);
+    TEST_CHECK(pio_sm_get_rx_fifo_level(hx._pio, hx._reader_sm) >= 6);
+    TEST_CHECK(dev.stats.power_downs == 0);
+
+    hx711_get_values(&hx, values, count_of(values));
+
+    for(uint i = 1; i < count_of(values); ++i) {
+        TEST_CHECK(values[i] == values[i - 1] + 1);
+    }
+
+    TEST_CHECK(values[count_of(values) - 1] == hostemu_hx711_get_read(&dev, 0)->value);
+
+    //the gain is set without the TX FIFO
+    hx711_set_gain(&hx, hx711_gain_32);
+    hx711_get_values(&hx, values, 4);
+
+    for(uint i = 0; i < 4; ++i) {
+        TEST_CHECK(values[i] / 100000 == 26);
+    }
+
+    TEST_CHECK(dev.stats.stray_pulses == 0);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_get_value_timeout(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    int32_t val;
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    for(uint i = 0; i < 8; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    //a value should be returned as soon as one is available
+    for(uint i = 0; i < 4; ++i) {
+        TEST_CHECK(hx711_get_value_timeout(&hx, &val, 250000));
+        TEST_CHECK(val == hostemu_hx711_get_read(&dev, 0)->value);
+    }
+
+    hx711_close(&hx);
+
+    //no conversion will be ready before the timeout
+    hostemu_reset();
+    attach_device(&dev, 5000000);
+    init_driver(&hx, false);
+
+    const uint64_t start = time_us_64();
+    const uint64_t startPolls = hostemu_poll_cycles();
+    TEST_CHECK(!hx711_get_value_timeout(&hx, &val, 20000));
+    TEST_CHECK(time_us_64() - start >= 20000);
+
+    //the wait sleeps until the timeout rather than polling
+    TEST_CHECK(hostemu_poll_cycles() - startPolls < hostemu_us_to_cycles(100));
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_set_gain(void) {
+
+    static const struct {
+        hx711_gain_t gain;
+        uint8_t pulses;
+    } gains[] = {
+        { hx711_gain_64, 27 },
+        { hx711_gain_32, 26 },
+        { hx711_gain_128, 25 }
+    };
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    //the untagged functions skip values at the previous gain
+    for(uint i = 0; i < count_of(gains); ++i) {
+        hx711_set_gain(&hx, gains[i].gain);
+        for(uint j = 0; j < 4; ++j) {
+            TEST_CHECK(hx711_get_value(&hx) / 100000 == gains[i].pulses);
+        }
+    }
+
+    //the tagged function keeps them, but each is tagged with
+    //the gain it was converted at
+    for(uint i = 0; i < count_of(gains); ++i) {
+
+        uint32_t previous = 0;
+
+        //values at the previous gain, then the new gain
+        hx711_set_gain(&hx, gains[i].gain);
+        sleep_ms(30);
+
+        for(uint j = 0; j < 6; ++j) {
+            hx711_gain_t gain;
+            const int32_t val = hx711_get_tagged_value(&hx, &gain);
+            TEST_CHECK(val / 100000 == hx711_get_clock_pulses(gain));
+            if(gain != gains[i].gain) {
+                TEST_CHECK(j == previous);
+                ++previous;
+            }
+        }
+
+        TEST_CHECK(previous > 0 && previous < 6);
+
+    }
+
+    //as does the batch function
+    for(uint i = 0; i < count_of(gains); ++i) {
+
+        int32_t vals[6];
+        hx711_gain_t tags[6];
+        uint32_t previous = 0;
+
+        hx711_set_gain(&hx, gains[i].gain);
+        sleep_ms(30);
+
+        hx711_get_tagged_values(&hx, vals, tags, count_of(vals));
+
+        for(uint j = 0; j < count_of(vals); ++j) {
+            TEST_CHECK(vals[j] / 100000 == hx711_get_clock_pulses(tags[j]));
+            if(tags[j] != gains[i].gain) {
+                TEST_CHECK(j == previous);
+                ++previous;
+            }
+        }
+
+        TEST_CHECK(previous > 0 && previous < 6);
+
+    }
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+// no value at the previous gain is returned after the gain is
+// set, however many were left in the RX FIFO
+static int check_set_gain_stale_values(const bool joinRxFifo) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    attach_device(&dev, 0);
+    init_driver(&hx, joinRxFifo);
+
+    for(uint i = 0; i < 8; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    //several values, but not so many that the RX FIFO fills
+    //and the reader stalls
+    sleep_ms(40);
+    TEST_CHECK(pio_sm_get_rx_fifo_level(hx._pio, hx._reader_sm) >= 3);
+
+    hx711_set_gain(&hx, hx711_gain_64);
+
+    for(uint i = 0; i < 4; ++i) {
+        TEST_CHECK(hx711_get_value(&hx) / 100000 == 27);
+    }
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_set_gain_stale_values(void) {
+    return check_set_gain_stale_values(false);
+}
+
+static int test_set_gain_stale_values_joined(void) {
+    return check_set_gain_stale_values(true);
+}
+
+// hx711_is_gain_set becomes true without any value being read,
+// and leaves the values it saw in the RX FIFO
+static int check_gain_set_polled(const bool joinRxFifo) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    attach_device(&dev, 0);
+    init_driver(&hx, joinRxFifo);
+
+    for(uint i = 0; i < 8; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    //leave room in the unjoined RX FIFO for a value at the
+    //new gain; test_gain_set_polled_full covers a full one
+    sleep_ms(15);
+
+    hx711_set_gain(&hx, hx711_gain_64);
+    TEST_CHECK(!hx711_is_gain_set(&hx));
+
+    uint polls = 0;
+
+    while(!hx711_is_gain_set(&hx) && polls < 1000) {
+        sleep_ms(1);
+        ++polls;
+    }
+
+    TEST_CHECK(hx711_is_gain_set(&hx));
+
+    //the conversion underway when the gain was set, and
+    //one more, are read at 80 SPS in about 25ms
+    TEST_CHECK(polls < 40);
+
+    //the values at the previous gain are still there for
+    //the tagged reads, followed by the one at the new gain
+    uint previous = 0;
+    hx711_gain_t gain;
+
+    while(hx711_get_tagged_value(&hx, &gain) / 100000 == 25) {
+        TEST_CHECK(gain == hx711_gain_128);
+        ++previous;
+    }
+
+    TEST_CHECK(gain == hx711_gain_64);
+    TEST_CHECK(previous > 0);
+    TEST_CHECK(hx711_get_value(&hx) / 100000 == 27);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_gain_set_polled(void) {
+    return check_gain_set_polled(false);
+}
+
+static int test_gain_set_polled_joined(void) {
+    return check_gain_set_polled(true);
+}
+
+// with the RX FIFO full the reader cannot push a value at the
+// new gain until one is taken, so the oldest is discarded
+static int test_gain_set_polled_full(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    sleep_ms(200);
+    TEST_CHECK(pio_sm_is_rx_fifo_full(hx._pio, hx._reader_sm));
+
+    hx711_set_gain(&hx, hx711_gain_64);
+
+    //no value is discarded to make room for one at the new
+    //gain, so it stays pending until a value is read
+    for(uint i = 0; i < 50; ++i) {
+        sleep_ms(1);
+        TEST_CHECK(!hx711_is_gain_set(&hx));
+    }
+
+    TEST_CHECK(pio_sm_is_rx_fifo_full(hx._pio, hx._reader_sm));
+
+    //the reader holds one more value at the earlier gain, so
+    //two must be read before there is room for one at the new
+    //gain
+    for(uint i = 0; i < 2; ++i) {
+        hx711_gain_t gain;
+        hx711_get_tagged_value(&hx, &gain);
+        TEST_CHECK(gain == hx711_gain_128);
+    }
+
+    uint polls = 0;
+
+    while(!hx711_is_gain_set(&hx) && polls < 1000) {
+        sleep_ms(1);
+        ++polls;
+    }
+
+    //the reader stops with the clock pin high while the RX
+    //FIFO is full, so the HX711 has powered down and settles
+    //again once it resumes
+    TEST_CHECK(hx711_is_gain_set(&hx));
+    TEST_CHECK(polls < 1000);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+// each read sends exactly the clock pulses for the gain, rather
+// than one more which set gain 32 as 64 and sent 28 for gain 64
+static int test_gain_pulses(void) {
+
+    static const struct {
+        hx711_gain_t gain;
+        uint8_t pulses;
+    } gains[] = {
+        { hx711_gain_32, 26 },
+        { hx711_gain_64, 27 },
+        { hx711_gain_128, 25 }
+    };
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    for(uint i = 0; i < count_of(gains); ++i) {
+
+        hx711_set_gain(&hx, gains[i].gain);
+
+        for(uint j = 0; j < 3; ++j) {
+            TEST_CHECK(hx711_get_value(&hx) / 100000 == gains[i].pulses);
+        }
+
+        //the read before the latest has certainly finished
+        TEST_CHECK(hostemu_hx711_get_read(&dev, 1)->pulses == gains[i].pulses);
+
+    }
+
+    TEST_CHECK(dev.stats.stray_pulses == 0);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_gain_schedule(void) {
+
+    static uint32_t buffer[4] __aligned(4 * sizeof(uint32_t));
+
+    static const hx711_gain_t gains[4] = {
+        hx711_gain_128,
+        hx711_gain_32,
+        hx711_gain_128,
+        hx711_gain_64
+    };
+
+    static const uint8_t pulses[] = { 25, 26, 27 };
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    hx711_gain_t gain = hx711_gain_128;
+    int32_t val;
+    int32_t last = 0;
+    uint changes = 0;
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    hx711_gain_schedule_start(&hx, buffer, gains, count_of(gains));
+
+    for(uint i = 0; i < 40; ++i) {
+
+        const hx711_gain_t prev = gain;
+
+        val = hx711_get_tagged_value(&hx, &gain);
+
+        //every value is tagged with the gain it was converted at
+        TEST_CHECK(val / 100000 == pulses[gain]);
+
+        //and none are discarded
+        TEST_CHECK(i == 0 || val % 100000 == last % 100000 + 1);
+
+        changes += i > 0 && gain != prev;
+        last = val;
+
+    }
+
+    //three changes for every four values
+    TEST_CHECK(changes >= 28);
+    TEST_CHECK(dev.stats.missed == 0);
+    TEST_CHECK(dev.stats.stray_pulses == 0);
+
+    hx711_gain_schedule_stop(&hx);
+
+    //the last gain in use is kept
+    hx711_get_tagged_value(&hx, &gain);
+
+    for(uint i = 0; i < 4; ++i) {
+        const hx711_gain_t prev = gain;
+        val = hx711_get_tagged_value(&hx, &gain);
+        TEST_CHECK(gain == prev);
+        TEST_CHECK(val / 100000 == pulses[gain]);
+    }
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_stream(void) {
+
+    static uint32_t buffer[STREAM_LEN]
+        __aligned(STREAM_LEN * sizeof(uint32_t));
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    int32_t values[STREAM_LEN];
+    hx711_gain_t gains[STREAM_LEN];
+    size_t index;
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    hx711_stream_start(&hx, buffer, STREAM_LEN);
+
+    //80 SPS for 100ms
+    sleep_ms(100);
+    const size_t avail = hx711_stream_available(&hx, &index);
+    TEST_CHECK(avail >= 7 && avail <= 9);
+
+    size_t len = hx711_stream_get_values(&hx, values, STREAM_LEN);
+    TEST_CHECK(len == avail);
+    TEST_CHECK(hx711_stream_available(&hx, &index) == 0);
+
+    //long enough for the ring to be lapped; only the most recent
+    //STREAM_LEN values can be returned
+    sleep_ms(1000);
+    TEST_CHECK(hx711_stream_get_count(&hx) >= 80);
+
+    len = hx711_stream_get_values(&hx, values, STREAM_LEN);
+    TEST_CHECK(len == STREAM_LEN);
+    TEST_CHECK(values[len - 1] == hostemu_hx711_get_read(&dev, 0)->value);
+
+    for(size_t i = 1; i < len; ++i) {
+        TEST_CHECK(values[i] == values[i - 1] + 1);
+    }
+
+    sleep_ms(50);
+    len = hx711_stream_get_tagged_values(&hx, values, gains, STREAM_LEN);
+    TEST_CHECK(len >= 3 && len <= 5);
+    TEST_CHECK(values[len - 1] == hostemu_hx711_get_read(&dev, 0)->value);
+
+    for(size_t i = 0; i < len; ++i) {
+        TEST_CHECK(gains[i] == hx711_gain_128);
+    }
+
+    TEST_CHECK(dev.stats.missed == 0);
+
+    hx711_stream_stop(&hx);
+
+    //values can be read directly again once the stream is stopped
+    const int32_t val = hx711_get_value(&hx);
+    TEST_CHECK(val > values[len - 1]);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_publish(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    hx711_sample_t sample;
+    hx711_sample_t prev;
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    TEST_CHECK(!hx711_get_latest(&hx, &sample));
+
+    //the RX FIFO filled while settling; only the newest value
+    //is published but all of them are counted
+    TEST_CHECK(hx711_publish(&hx));
+    TEST_CHECK(hx711_get_latest(&hx, &prev));
+    TEST_CHECK(prev.value == hostemu_hx711_get_read(&dev, 0)->value);
+    TEST_CHECK(prev.count >= 3 && prev.count <= 4);
+
+    //nothing new yet
+    TEST_CHECK(!hx711_publish(&hx));
+
+    for(uint i = 0; i < 8; ++i) {
+
+        //80 SPS, so two or three conversions
+        sleep_ms(35);
+
+        TEST_CHECK(hx711_publish(&hx));
+        TEST_CHECK(hx711_get_latest(&hx, &sample));
+        TEST_CHECK(sample.value == hostemu_hx711_get_read(&dev, 0)->value);
+        TEST_CHECK(sample.gain == hx711_gain_128);
+        TEST_CHECK(sample.value == prev.value + (int32_t)(sample.count - prev.count));
+        TEST_CHECK(sample.count - prev.count >= 2 && sample.count - prev.count <= 3);
+        TEST_CHECK(absolute_time_diff_us(prev.time, sample.time) > 0);
+
+        prev = sample;
+
+    }
+
+    //published as soon as it arrives, the time is when the
+    //data pin went low, not when the value was taken
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+
+    while(pio_sm_is_rx_fifo_empty(hx._pio, hx._reader_sm)) {
+        sleep_us(1);
+    }
+
+    TEST_CHECK(hx711_publish(&hx));
+    TEST_CHECK(hx711_get_latest(&hx, &sample));
+
+    const hostemu_hx711_read_t* const r = hostemu_hx711_get_read(&dev, 0);
+    const int64_t readyUs = (int64_t)(r->ready_cycle / HOSTEMU_CYCLES_PER_US);
+
+    TEST_CHECK(llabs((int64_t)to_us_since_boot(sample.time) - readyUs) <= 2);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+typedef struct {
+    const hostemu_hx711_t* dev;
+    uint32_t calls;
+    uint32_t mismatches;
+    uint32_t late;
+    int32_t prev;
+} callback_ctx_t;
+
+static void __not_in_flash_func(on_value)(
+    const hx711_sample_t* const sample,
+    void* const ctx) {
+
+        callback_ctx_t* const c = ctx;
+        const hostemu_hx711_read_t* const r = hostemu_hx711_get_read(c->dev, 0);
+        const int64_t readyUs = (int64_t)(r->ready_cycle / HOSTEMU_CYCLES_PER_US);
+
+        if(sample->value != r->value ||
+            hx711_get_clock_pulses(sample->gain) != r->converted_gain_pulses ||
+            sample->count != c->calls + 1 ||
+            (c->calls > 0 && sample->value != c->prev + 1)) {
+                ++c->mismatches;
+        }
+
+        //the time is when the data pin went low, not when the
+        //value was read
+        if(llabs((int64_t)to_us_since_boot(sample->time) - readyUs) > 1) {
+            ++c->late;
+        }
+
+        c->prev = sample->value;
+        ++c->calls;
+
+}
+
+static int test_callback(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    callback_ctx_t ctx = { .dev = &dev };
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    //empty the RX FIFO so every value is delivered as it is read
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+
+    hx711_callback_start(&hx, on_value, &ctx);
+
+    //one value per interrupt; the CPU sleeps in between
+    for(uint i = 0; i < 16; ++i) {
+        __wfi();
+    }
+
+    TEST_CHECK(ctx.calls == 16);
+    TEST_CHECK(ctx.mismatches == 0);
+    TEST_CHECK(ctx.late == 0);
+    TEST_CHECK(hostemu_irq_count(PIO0_IRQ_1) == 16);
+
+    hx711_callback_stop(&hx);
+
+    //the handler is removed along with the callback
+    TEST_CHECK(!irq_has_shared_handler(PIO0_IRQ_1));
+
+    sleep_ms(50);
+    TEST_CHECK(ctx.calls == 16);
+
+    //direct reads work again once stopped
+    hx711_get_value(&hx);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+typedef struct {
+    hostemu_hx711_t* dev;
+    hx711_gain_t gain; //gain being set
+    hx711_gain_t last;
+    bool seen;
+    uint32_t calls;
+    uint32_t mismatches;
+    uint32_t reverted;
+} gain_ctx_t;
+
+static void __not_in_flash_func(on_gain_value)(
+    const hx711_sample_t* const sample,
+    void* const ctx) {
+
+        gain_ctx_t* const c = ctx;
+        const hostemu_hx711_read_t* const r = hostemu_hx711_get_read(c->dev, 0);
+
+        if(sample->value != r->value ||
+            hx711_get_clock_pulses(sample->gain) != r->converted_gain_pulses) {
+                ++c->mismatches;
+        }
+
+        //once at the new gain, never back at the previous one
+        if(c->seen && sample->gain != c->gain) {
+            ++c->reverted;
+        }
+
+        c->seen |= sample->gain == c->gain;
+        c->last = sample->gain;
+        ++c->calls;
+
+}
+
+static int test_set_gain_async(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    gain_ctx_t ctx = { .dev = &dev, .gain = hx711_gain_64 };
+
+    attach_device(&dev, 0);
+    init_driver(&hx, false);
+
+    TEST_CHECK(hx711_get_value(&hx) / 100000 == 25);
+    TEST_CHECK(hx711_is_gain_set(&hx));
+
+    //empty the RX FIFO so every value is delivered as it is read
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+
+    hx711_callback_start(&hx, on_gain_value, &ctx);
+
+    //returns without waiting for a conversion, even while
+    //callbacks are running
+    const uint32_t startUs = time_us_32();
+    hx711_set_gain(&hx, hx711_gain_64);
+    TEST_CHECK(time_us_32() - startUs < 100);
+    TEST_CHECK(!hx711_is_gain_set(&hx));
+
+    while(!hx711_is_gain_set(&hx)) {
+        __wfi();
+    }
+
+    //the conversion underway, and at most one more, were at
+    //the previous gain
+    TEST_CHECK(ctx.calls >= 1 && ctx.calls <= 3);
+    TEST_CHECK(ctx.last == hx711_gain_64);
+
+    sleep_ms(50);
+    TEST_CHECK(ctx.last == hx711_gain_64);
+    TEST_CHECK(ctx.mismatches == 0);
+    TEST_CHECK(ctx.reverted == 0);
+
+    hx711_callback_stop(&hx);
+
+    //the next direct read after setting the gain is at it
+    hx711_set_gain(&hx, hx711_gain_32);
+    TEST_CHECK(!hx711_is_gain_set(&hx));
+    TEST_CHECK(hx711_get_value(&hx) / 100000 == 26);
+    TEST_CHECK(hx711_is_gain_set(&hx));
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_pd_sck_hz(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    callback_ctx_t ctx = { .dev = &dev };
+
+    TEST_CHECK(hx711_is_pd_sck_hz_valid(HX711_PD_SCK_DEFAULT_HZ));
+    TEST_CHECK(!hx711_is_pd_sck_hz_valid(HX711_PD_SCK_MIN_HZ - 1));
+    TEST_CHECK(!hx711_is_pd_sck_hz_valid(HX711_PD_SCK_MAX_HZ + 1));
+    TEST_CHECK(hx711_pd_sck_hz_to_read_time_us(HX711_PD_SCK_DEFAULT_HZ) == 10);
+
+    attach_device(&dev, 0);
+
+    hx711_config_t cfg;
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN;
+    cfg.pd_sck_hz = 100000;
+
+    hx711_init(&hx, &cfg);
+    hx711_power_up(&hx, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    TEST_CHECK(hx711_get_read_time_us(&hx) == 235);
+    TEST_CHECK(hx711_get_read_time_us(&hx) ==
+        hx711_pd_sck_hz_to_read_time_us(cfg.pd_sck_hz));
+
+    //24 bits at 10us per pulse
+    hx711_get_value(&hx);
+    const hostemu_hx711_read_t* const r = hostemu_hx711_get_read(&dev, 0);
+    const uint64_t readUs = (r->read_cycle - r->ready_cycle) / HOSTEMU_CYCLES_PER_US;
+    TEST_CHECK(readUs >= 225 && readUs <= 235);
+
+    //sample times still mark when the data pin went low
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+    hx711_callback_start(&hx, on_value, &ctx);
+
+    for(uint i = 0; i < 8; ++i) {
+        __wfi();
+    }
+
+    hx711_callback_stop(&hx);
+
+    TEST_CHECK(ctx.calls == 8);
+    TEST_CHECK(ctx.mismatches == 0);
+    TEST_CHECK(ctx.late == 0);
+    TEST_CHECK(dev.stats.stray_pulses == 0);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int check_detect_rate(const hx711_rate_t rate) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.data_pin = DATA_PIN;
+    devCfg.rate = hx711_get_rate_sps(rate);
+    devCfg.source = source;
+    hostemu_hx711_attach(&dev, &devCfg);
+
+    hx711_config_t cfg;
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN;
+    hx711_init(&hx, &cfg);
+
+    //unknown until measured, and pessimistic until then
+    TEST_CHECK(!hx711_is_rate_detected(&hx));
+    TEST_CHECK(hx711_get_rate(&hx) == hx711_rate_10);
+
+    hx711_power_down(&hx);
+    hx711_wait_power_down();
+
+    //waits out the settling time and one more conversion,
+    //rather than always the settling time at 10SPS
+    const uint32_t startUs = time_us_32();
+    hx711_power_up(&hx, hx711_gain_64);
+    TEST_CHECK(hx711_detect_rate(&hx) == rate);
+    const uint32_t elapsedUs = time_us_32() - startUs;
+    const uint32_t periodUs = 1000000u / hx711_get_rate_sps(rate);
+
+    TEST_CHECK(elapsedUs <= hx711_get_settling_time(rate) * 1000u + periodUs * 2);
+    TEST_CHECK(hx711_is_rate_detected(&hx));
+    TEST_CHECK(hx711_get_rate(&hx) == rate);
+
+    //the values read were enough to set the gain
+    TEST_CHECK(hx711_is_gain_set(&hx));
+    TEST_CHECK(hx711_get_value(&hx) / 100000 == 27);
+
+    //waits and timeouts follow the detected rate
+    TEST_CHECK(hx711_get_timeout_us(&hx) == periodUs * 2 + hx711_get_read_time_us(&hx));
+
+    int32_t val;
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+    TEST_CHECK(hx711_get_value_timeout(&hx, &val, hx711_get_timeout_us(&hx)));
+
+    const uint32_t settleUs = time_us_32();
+    hx711_wait_until_settled(&hx);
+    const uint32_t settledUs = time_us_32() - settleUs;
+    TEST_CHECK(settledUs >= hx711_get_settling_time(rate) * 1000u);
+    TEST_CHECK(settledUs < hx711_get_settling_time(rate) * 1000u + 100);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_detect_rate_10(void) {
+    return check_detect_rate(hx711_rate_10);
+}
+
+static int test_detect_rate_80(void) {
+
+    int failures = check_detect_rate(hx711_rate_80);
+
+    //a conversion missed at 80SPS is still 80SPS
+    TEST_CHECK(hx711_interval_us_to_rate(12500) == hx711_rate_80);
+    TEST_CHECK(hx711_interval_us_to_rate(25000) == hx711_rate_80);
+    TEST_CHECK(hx711_interval_us_to_rate(100000) == hx711_rate_10);
+
+    return failures;
+
+}
+
+int main(void) {
+
+    static const test_case_t tests[] = {
+        TEST_CASE(test_shared_program),
+        TEST_CASE(test_get_value),
+        TEST_CASE(test_get_value_noblock),
+        TEST_CASE(test_get_value_sleeps),
+        TEST_CASE(test_get_values_joined),
+        TEST_CASE(test_get_value_timeout),
+        TEST_CASE(test_set_gain),
+        TEST_CASE(test_set_gain_async),
+        TEST_CASE(test_set_gain_stale_values),
+        TEST_CASE(test_set_gain_stale_values_joined),
+        TEST_CASE(test_gain_set_polled),
+        TEST_CASE(test_gain_set_polled_joined),
+        TEST_CASE(test_gain_set_polled_full),
+        TEST_CASE(test_gain_pulses),
+        TEST_CASE(test_gain_schedule),
+        TEST_CASE(test_stream),
+        TEST_CASE(test_publish),
+        TEST_CASE(test_callback),
+        TEST_CASE(test_pd_sck_hz),
+        TEST_CASE(test_detect_rate_10),
+        TEST_CASE(test_detect_rate_80)
+    };
+
+    return test_main(tests, count_of(tests));
+
+}
@@ -0,0 +1,314 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Checks the fixed-point conversion against exact rational values,
+// then tares an emulated hx711_t and hx711_multi_t.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "hostemu.h"
+#include "../../include/common.h"
+#include "../../include/hx711_calibration.h"
+#include "test.h"
+
+#define CLOCK_PIN       14
+#define DATA_PIN        15
+#define MULTI_CLOCK_PIN 0
+#define MULTI_DATA_PIN  1
+#define MULTI_CHIPS     3
+#define OFFSET          5000
+
+// nearest integer to num / den, with halves rounded away from zero
+static int64_t rational_round(
+    const int64_t num,
+    const int64_t den) {
+        const int64_t q = num / den;
+        const int64_t r = num % den;
+        return 2 * (r < 0 ? -r : r) >= den
+            ? q + ((num < 0) != (den < 0) ? -1 : 1)
+            : q;
+}
+
+static int check_scale(
+    const int32_t units,
+    const int32_t counts,
+    const int32_t offset) {
+
+        int failures = 0;
+        hx711_calibration_t cal;
+
+        hx711_calibration_init(&cal);
+        hx711_calibration_set_offset(&cal, hx711_gain_128, offset);
+        hx711_calibration_set_scale(&cal, hx711_gain_128, units, counts);
+
+        for(int32_t raw = HX711_MIN_VALUE; raw <= HX711_MAX_VALUE; raw += 4099) {
+            const int64_t expected = rational_round((int64_t)(raw - offset) * units, counts);
+            const int64_t diff = hx711_calibration_apply(&cal, hx711_gain_128, raw) - expected;
+            //the multiplier is rounded, which may move a value
+            //lying close to a half by one unit
+            TEST_CHECK(diff >= -1 && diff <= 1);
+        }
+
+        TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_128, offset) == 0);
+
+        return failures;
+
+}
+
+static int test_apply(void) {
+
+    int failures = 0;
+    hx711_calibration_t cal;
+
+    //unchanged after init
+    hx711_calibration_init(&cal);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, HX711_MIN_VALUE) == HX711_MIN_VALUE);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, HX711_MAX_VALUE) == HX711_MAX_VALUE);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, -1) == -1);
+
+    failures += check_scale(1000, 420, 0);
+    failures += check_scale(1000, 420, -123456);
+    failures += check_scale(-7, 3, 77);
+    failures += check_scale(1, 1, 0);
+    failures += check_scale(3, -8388607, HX711_MAX_VALUE);
+
+    //an exact multiplier is exact
+    hx711_calibration_set_multiplier(&cal, hx711_gain_64, 3, 1);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, 10) == 15);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, -3) == -4);
+
+    //large scales saturate
+    hx711_calibration_set_scale(&cal, hx711_gain_64, INT32_MAX, 1);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, 2) == INT32_MAX);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, -2) == INT32_MIN);
+
+    return failures;
+
+}
+
+static int test_gains(void) {
+
+    int failures = 0;
+    hx711_calibration_t cal;
+
+    hx711_calibration_init(&cal);
+    hx711_calibration_set_offset(&cal, hx711_gain_128, 100);
+    hx711_calibration_set_scale(&cal, hx711_gain_128, 1, 2);
+    hx711_calibration_set_offset(&cal, hx711_gain_64, 50);
+    hx711_calibration_set_scale(&cal, hx711_gain_64, 1, 1);
+
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_128, 300) == 100);
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_64, 300) == 250);
+
+    //untouched gain is unchanged
+    TEST_CHECK(hx711_calibration_apply(&cal, hx711_gain_32, 300) == 300);
+
+    TEST_CHECK(hx711_calibration_get_offset(&cal, hx711_gain_128) == 100);
+    TEST_CHECK(hx711_calibration_get_offset(&cal, hx711_gain_64) == 50);
+
+    return failures;
+
+}
+
+// the offset plus the chip's index, with noise which averages
+// out over each pair of conversions
+static int32_t noisy_source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        (void)gainPulses;
+        return OFFSET + (int32_t)(uintptr_t)ctx + (index % 2 == 0 ? 3 : -3);
+}
+
+// the offset plus the number of clock pulses of the gain the
+// value was converted at
+static int32_t gain_source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        (void)ctx;
+        (void)index;
+        return OFFSET + gainPulses;
+}
+
+static int test_tare(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.data_pin = DATA_PIN;
+    devCfg.source = noisy_source;
+    hostemu_hx711_attach(&dev, &devCfg);
+
+    hx711_config_t cfg;
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN;
+    hx711_init(&hx, &cfg);
+    hx711_power_up(&hx, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    hx711_calibration_t cal;
+    hx711_calibration_init(&cal);
+    hx711_calibration_set_scale(&cal, hx711_gain_128, 2, 1);
+
+    //an even number to cancel the noise
+    hx711_calibration_tare(&cal, &hx, 20);
+    TEST_CHECK(hx711_calibration_get_offset(&cal, hx711_gain_128) == OFFSET);
+
+    int32_t values[4];
+    hx711_calibration_get_values(&cal, &hx, values, count_of(values));
+
+    for(uint i = 0; i < count_of(values); ++i) {
+        TEST_CHECK(abs(values[i]) == 6);
+    }
+
+    TEST_CHECK(abs(hx711_calibration_get_value(&cal, &hx)) == 6);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+// each value is converted with the entry for the gain it is
+// tagged with, including those at the previous gain once the
+// gain has been changed
+static int test_tare_gains(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.data_pin = DATA_PIN;
+    devCfg.source = gain_source;
+    hostemu_hx711_attach(&dev, &devCfg);
+
+    hx711_config_t cfg;
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN;
+    hx711_init(&hx, &cfg);
+    hx711_power_up(&hx, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    hx711_calibration_t cal;
+    hx711_calibration_init(&cal);
+    hx711_calibration_tare(&cal, &hx, 4);
+
+    //set the gain without reading, then tare while the values
+    //at the previous gain are still arriving
+    hx711_set_gain(&hx, hx711_gain_64);
+    sleep_ms(30);
+    hx711_calibration_tare(&cal, &hx, 4);
+
+    TEST_CHECK(hx711_calibration_get_offset(&cal, hx711_gain_128) == OFFSET + 25);
+    TEST_CHECK(hx711_calibration_get_offset(&cal, hx711_gain_64) == OFFSET + 27);
+
+    //values at either gain are converted to 0
+    hx711_set_gain(&hx, hx711_gain_128);
+    sleep_ms(30);
+
+    int32_t values[6];
+    hx711_calibration_get_values(&cal, &hx, values, count_of(values));
+
+    for(uint i = 0; i < count_of(values); ++i) {
+        TEST_CHECK(values[i] == 0);
+    }
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_multi_tare(void) {
+
+    int failures = 0;
+    hostemu_hx711_t devs[MULTI_CHIPS];
+    hx711_multi_t hxm = {0};
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = MULTI_CLOCK_PIN;
+    devCfg.source = noisy_source;
+
+    for(uint i = 0; i < MULTI_CHIPS; ++i) {
+        devCfg.data_pin = MULTI_DATA_PIN + i;
+        devCfg.ctx = (void*)(uintptr_t)i;
+        hostemu_hx711_attach(&devs[i], &devCfg);
+    }
+
+    hx711_multi_config_t cfg;
+    hx711_multi_get_default_config(&cfg);
+    cfg.clock_pin = MULTI_CLOCK_PIN;
+    cfg.data_pin_base = MULTI_DATA_PIN;
+    cfg.chips_len = MULTI_CHIPS;
+    hx711_multi_init(&hxm, &cfg);
+    hx711_multi_power_up(&hxm, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    hx711_calibration_t cals[MULTI_CHIPS];
+
+    for(uint i = 0; i < MULTI_CHIPS; ++i) {
+        hx711_calibration_init(&cals[i]);
+    }
+
+    hx711_calibration_multi_tare(cals, &hxm, 8);
+
+    for(uint i = 0; i < MULTI_CHIPS; ++i) {
+        TEST_CHECK(hx711_calibration_get_offset(&cals[i], hx711_gain_128) == OFFSET + (int32_t)i);
+    }
+
+    int32_t values[MULTI_CHIPS];
+    hx711_calibration_multi_get_values(cals, &hxm, values);
+
+    for(uint i = 0; i < MULTI_CHIPS; ++i) {
+        TEST_CHECK(abs(values[i]) == 3);
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+int main(void) {
+
+    static const test_case_t tests[] = {
+        TEST_CASE(test_apply),
+        TEST_CASE(test_gains),
+        TEST_CASE(test_tare),
+        TEST_CASE(test_tare_gains),
+        TEST_CASE(test_multi_tare)
+    };
+
+    return test_main(tests, count_of(tests));
+
+}
@@ -0,0 +1,254 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Checks each filter stage against hand-worked values, then runs a
+// pipeline on values from the emulated HX711.
+
+#include <stdint.h>
+#include "hostemu.h"
+#include "../../include/common.h"
+#include "../../include/hx711_filter.h"
+#include "test.h"
+
+#define CLOCK_PIN   14
+#define DATA_PIN    15
+#define SPIKE       800000
+
+static int check_stage(
+    hx711_filter_stage_t* const stage,
+    const int32_t* const in,
+    const int32_t* const out,
+    const size_t len) {
+
+        int failures = 0;
+
+        for(size_t i = 0; i < len; ++i) {
+            const int32_t val = hx711_filter_stage_apply(stage, in[i]);
+            if(val != out[i]) {
+                fprintf(stderr, "value %zu: %ld != %ld\n", i, (long)val, (long)out[i]);
+                ++failures;
+            }
+        }
+
+        return failures;
+
+}
+
+static int test_moving_average(void) {
+
+    static const int32_t in[] =  { 1, 2, 3, 4, 5, -9, -9, -10 };
+    static const int32_t out[] = { 1, 2, 2, 3, 4, 0, -4, -9 };
+
+    hx711_filter_stage_t stage;
+    int32_t window[3];
+
+    hx711_filter_moving_average_init(&stage, window, count_of(window));
+
+    return check_stage(&stage, in, out, count_of(in));
+
+}
+
+static int test_median(void) {
+
+    static const int32_t in[] =  { 5, 1, 9, 2, 100, -3, -4 };
+    static const int32_t out[] = { 5, 3, 5, 2, 9, 2, -3 };
+
+    hx711_filter_stage_t stage;
+    int32_t window[3];
+
+    hx711_filter_median_init(&stage, window, count_of(window));
+
+    return check_stage(&stage, in, out, count_of(in));
+
+}
+
+static int test_iir(void) {
+
+    static const int32_t in[] =  { 0, 1000, 1000, 1000, -1000 };
+    static const int32_t out[] = { 0, 500, 750, 875, -62 };
+
+    int failures = 0;
+    hx711_filter_stage_t stage;
+
+    hx711_filter_iir_init(&stage, HX711_FILTER_IIR_COEFF(0.5));
+    failures += check_stage(&stage, in, out, count_of(in));
+
+    //a step is followed all the way rather than stopping short
+    //once each step becomes smaller than one
+    int32_t val = 0;
+    hx711_filter_iir_init(&stage, HX711_FILTER_IIR_COEFF(0.01));
+    for(uint i = 0; i < 4000; ++i) {
+        val = hx711_filter_stage_apply(&stage, i == 0 ? 0 : HX711_MAX_VALUE);
+    }
+    TEST_CHECK(val == HX711_MAX_VALUE);
+
+    hx711_filter_iir_init(&stage, HX711_FILTER_IIR_COEFF(1.0));
+    TEST_CHECK(hx711_filter_stage_apply(&stage, HX711_MIN_VALUE) == HX711_MIN_VALUE);
+    TEST_CHECK(hx711_filter_stage_apply(&stage, HX711_MAX_VALUE) == HX711_MAX_VALUE);
+
+    return failures;
+
+}
+
+static int test_outlier(void) {
+
+    static const int32_t in[] =  { 100, 105, 500, 500, 500, 90, 495 };
+    static const int32_t out[] = { 100, 105, 105, 105, 500, 500, 495 };
+
+    hx711_filter_stage_t stage;
+
+    hx711_filter_outlier_init(&stage, 10, 2);
+
+    return check_stage(&stage, in, out, count_of(in));
+
+}
+
+static int test_bank(void) {
+
+    //three channels; each column must match its scalar stage
+    static const int32_t in[][3] = {
+        { 1, 0, HX711_MIN_VALUE },
+        { 2, 1000, HX711_MAX_VALUE },
+        { 3, 1000, HX711_MAX_VALUE },
+        { 4, 1000, -7 },
+        { 5, -1000, -8 },
+        { -9, -1000, -9 }
+    };
+
+    int failures = 0;
+    hx711_filter_bank_t bank;
+    hx711_filter_stage_t stages[3];
+    int32_t bankWindow[3 * 3];
+    int32_t stageWindows[3][3];
+    int32_t out[3];
+
+    for(uint type = 0; type < 2; ++type) {
+
+        if(type == 0) {
+            hx711_filter_bank_moving_average_init(&bank, 3, bankWindow, 3);
+            for(uint i = 0; i < 3; ++i) {
+                hx711_filter_moving_average_init(&stages[i], stageWindows[i], 3);
+            }
+        }
+        else {
+            hx711_filter_bank_iir_init(&bank, 3, HX711_FILTER_IIR_COEFF(0.5));
+            for(uint i = 0; i < 3; ++i) {
+                hx711_filter_iir_init(&stages[i], HX711_FILTER_IIR_COEFF(0.5));
+            }
+        }
+
+        for(uint n = 0; n < count_of(in); ++n) {
+            hx711_filter_bank_apply(&bank, in[n], out);
+            for(uint i = 0; i < 3; ++i) {
+                TEST_CHECK(out[i] == hx711_filter_stage_apply(&stages[i], in[n][i]));
+            }
+        }
+
+        //filtering in place and after a reset
+        hx711_filter_bank_reset(&bank);
+        out[0] = 10;
+        out[1] = -10;
+        out[2] = 0;
+        hx711_filter_bank_apply(&bank, out, out);
+        TEST_CHECK(out[0] == 10 && out[1] == -10 && out[2] == 0);
+
+    }
+
+    return failures;
+
+}
+
+// a constant value with a spike every tenth conversion
+static int32_t spiky_source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        (void)ctx;
+        (void)gainPulses;
+        return index % 10 == 5 ? SPIKE : 1234;
+}
+
+static int test_pipeline(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.data_pin = DATA_PIN;
+    devCfg.source = spiky_source;
+    hostemu_hx711_attach(&dev, &devCfg);
+
+    hx711_config_t cfg;
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN;
+    hx711_init(&hx, &cfg);
+    hx711_power_up(&hx, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    int32_t medianWindow[3];
+    int32_t averageWindow[4];
+    hx711_filter_stage_t stages[2];
+    hx711_filter_t filter;
+
+    hx711_filter_median_init(&stages[0], medianWindow, count_of(medianWindow));
+    hx711_filter_moving_average_init(&stages[1], averageWindow, count_of(averageWindow));
+    hx711_filter_init(&filter, stages, count_of(stages));
+
+    uint spikes = 0;
+
+    for(uint i = 0; i < 40; ++i) {
+        const int32_t val = hx711_filter_get_value(&filter, &hx);
+        spikes += hostemu_hx711_get_read(&dev, 0)->value == SPIKE;
+        //the first value may be a spike before the median has
+        //anything to compare it with
+        TEST_CHECK(val == 1234 || i == 0);
+    }
+
+    TEST_CHECK(spikes >= 3);
+
+    hx711_filter_reset(&filter);
+    TEST_CHECK(hx711_filter_apply(&filter, -5) == -5);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+int main(void) {
+
+    static const test_case_t tests[] = {
+        TEST_CASE(test_moving_average),
+        TEST_CASE(test_median),
+        TEST_CASE(test_iir),
+        TEST_CASE(test_outlier),
+        TEST_CASE(test_bank),
+        TEST_CASE(test_pipeline)
+    };
+
+    return test_main(tests, count_of(tests));
+
+}
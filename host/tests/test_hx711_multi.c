@@ -0,0 +1,1297 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs the hx711_multi_t driver against the emulated PIO, DMA and a
+// set of HX711s sharing a clock pin.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hostemu.h"
+#include "hardware/sync.h"
+#include "pico/time.h"
+#include "../../include/common.h"
+#include "../../include/util.h"
+#include "test.h"
+
+#define CLOCK_PIN       0
+#define DATA_PIN_BASE   1
+#define MAX_CHIPS       29
+
+static hostemu_hx711_t devs[MAX_CHIPS];
+
+//continuous reads ring, naturally aligned to its size
+static uint32_t ring[HX711_MULTI_RING_MIN_LEN]
+    __aligned(HX711_MULTI_RING_MIN_LEN * sizeof(uint32_t));
+
+// a different pseudo-random 24 bit value for each chip and conversion
+static int32_t source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        const uint32_t x = (uint32_t)(uintptr_t)ctx * 2654435761u +
+            index * 40503u + gainPulses;
+        return (int32_t)(x % 16777216u) - 8388608;
+}
+
+static void init_driver(
+    hx711_multi_t* const hxm,
+    const size_t len,
+    const bool pack) {
+
+        hostemu_hx711_config_t devCfg;
+        hostemu_hx711_default_config(&devCfg);
+
+        devCfg.clock_pin = CLOCK_PIN;
+        devCfg.source = source;
+
+        for(size_t i = 0; i < len; ++i) {
+            devCfg.data_pin = DATA_PIN_BASE + i;
+            devCfg.ctx = (void*)(uintptr_t)(i + 1);
+            hostemu_hx711_attach(&devs[i], &devCfg);
+        }
+
+        hx711_multi_config_t cfg;
+        hx711_multi_get_default_config(&cfg);
+
+        cfg.clock_pin = CLOCK_PIN;
+        cfg.data_pin_base = DATA_PIN_BASE;
+        cfg.chips_len = len;
+        cfg.pack_pinvals = pack;
+
+        hx711_multi_init(hxm, &cfg);
+        hx711_multi_power_up(hxm, hx711_gain_128);
+        hx711_wait_settle(hx711_rate_80);
+
+}
+
+// whether a time is within 1us of when the chips last became
+// ready, which allows for the read time being rounded up
+static bool is_ready_time(
+    const absolute_time_t time,
+    const size_t len) {
+
+        uint64_t readyCycle = 0;
+
+        //the read starts once every chip is ready
+        for(size_t i = 0; i < len; ++i) {
+            readyCycle = MAX(readyCycle, hostemu_hx711_get_read(&devs[i], 0)->ready_cycle);
+        }
+
+        return llabs((int64_t)to_us_since_boot(time) -
+            (int64_t)(readyCycle / HOSTEMU_CYCLES_PER_US)) <= 1;
+
+}
+
+static uint count_mismatches(
+    const int32_t* const values,
+    const size_t len) {
+
+        uint mismatches = 0;
+
+        for(size_t i = 0; i < len; ++i) {
+            if(values[i] != hostemu_hx711_get_read(&devs[i], 0)->value) {
+                ++mismatches;
+            }
+        }
+
+        return mismatches;
+
+}
+
+static int check_get_values(
+    const size_t len,
+    const bool pack) {
+
+        int failures = 0;
+        hx711_multi_t hxm = {0};
+        int32_t values[MAX_CHIPS];
+
+        init_driver(&hxm, len, pack);
+
+        for(uint i = 0; i < 4; ++i) {
+            hx711_multi_get_values(&hxm, values);
+            TEST_CHECK(count_mismatches(values, len) == 0);
+        }
+
+        TEST_CHECK(hx711_multi_get_values_timeout(&hxm, values, 250000));
+        TEST_CHECK(count_mismatches(values, len) == 0);
+
+        hx711_multi_close(&hxm);
+
+        return failures;
+
+}
+
+static int test_get_values_sleeps(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[4];
+
+    init_driver(&hxm, 4, false);
+
+    const uint64_t startCycles = hostemu_cycles();
+    const uint64_t startPolls = hostemu_poll_cycles();
+
+    for(uint i = 0; i < 4; ++i) {
+        hx711_multi_get_values(&hxm, values);
+        TEST_CHECK(count_mismatches(values, 4) == 0);
+        TEST_CHECK(hx711_multi_get_values_timeout(&hxm, values, 250000));
+        TEST_CHECK(count_mismatches(values, 4) == 0);
+    }
+
+    //waiting for each conversion was spent asleep
+    TEST_CHECK((hostemu_poll_cycles() - startPolls) * 1000 <
+        hostemu_cycles() - startCycles);
+
+    //and so is waiting for a timeout, which ends before the
+    //next conversion 12.5ms after the last
+    const uint64_t start = time_us_64();
+    const uint64_t timeoutPolls = hostemu_poll_cycles();
+    TEST_CHECK(!hx711_multi_get_values_timeout(&hxm, values, 5000));
+    TEST_CHECK(time_us_64() - start >= 5000);
+    TEST_CHECK(hostemu_poll_cycles() - timeoutPolls < hostemu_us_to_cycles(100));
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int test_get_values(void) {
+
+    int failures = 0;
+
+    for(size_t len = 1; len <= MAX_CHIPS; ++len) {
+        hostemu_reset();
+        failures += check_get_values(len, false);
+    }
+
+    return failures;
+
+}
+
+static int test_get_values_packed(void) {
+
+    int failures = 0;
+
+    for(size_t len = 1; len <= MAX_CHIPS; ++len) {
+        hostemu_reset();
+        failures += check_get_values(len, true);
+    }
+
+    return failures;
+
+}
+
+static int test_set_gain(void) {
+
+    static const struct {
+        hx711_gain_t gain;
+        uint8_t pulses;
+    } gains[] = {
+        { hx711_gain_64, 27 },
+        { hx711_gain_32, 26 },
+        { hx711_gain_128, 25 }
+    };
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    init_driver(&hxm, 3, false);
+
+    for(uint i = 0; i < count_of(gains); ++i) {
+        hx711_multi_set_gain(&hxm, gains[i].gain);
+        TEST_CHECK(!hx711_multi_is_gain_set(&hxm));
+        hx711_multi_get_values(&hxm, values);
+        TEST_CHECK(hx711_multi_is_gain_set(&hxm));
+        TEST_CHECK(count_mismatches(values, 3) == 0);
+        for(uint j = 0; j < 3; ++j) {
+            const hostemu_hx711_read_t* const r =
+                hostemu_hx711_get_read(&devs[j], 0);
+            TEST_CHECK(r->converted_gain_pulses == gains[i].pulses);
+        }
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// hx711_multi_is_gain_set becomes true without any conversion
+// being read
+static int test_gain_set_polled(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    init_driver(&hxm, 3, false);
+    hx711_multi_get_values(&hxm, values);
+
+    hx711_multi_set_gain(&hxm, hx711_gain_64);
+    TEST_CHECK(!hx711_multi_is_gain_set(&hxm));
+
+    //while a read holds the mutex it reports the gain as
+    //pending rather than waiting
+    mutex_enter_blocking(&hxm._mut);
+    const absolute_time_t start = get_absolute_time();
+    TEST_CHECK(!hx711_multi_is_gain_set(&hxm));
+    TEST_CHECK(absolute_time_diff_us(start, get_absolute_time()) < 1000);
+    mutex_exit(&hxm._mut);
+
+    uint polls = 0;
+
+    while(!hx711_multi_is_gain_set(&hxm) && polls < 1000) {
+        sleep_ms(1);
+        ++polls;
+    }
+
+    //the conversion underway when the gain was set, and one
+    //more, end at 80 SPS in about 25ms
+    TEST_CHECK(hx711_multi_is_gain_set(&hxm));
+    TEST_CHECK(polls < 40);
+
+    for(uint j = 0; j < 3; ++j) {
+        TEST_CHECK(hostemu_hx711_get_read(&devs[j], 0)->converted_gain_pulses == 27);
+        TEST_CHECK(hostemu_hx711_get_read(&devs[j], 1)->converted_gain_pulses == 25);
+    }
+
+    hx711_multi_get_values(&hxm, values);
+    TEST_CHECK(count_mismatches(values, 3) == 0);
+    TEST_CHECK(hostemu_hx711_get_read(&devs[0], 0)->converted_gain_pulses == 27);
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// each read sends exactly the clock pulses for the gain, rather
+// than one more which set gain 32 as 64 and sent 28 for gain 64
+static int test_gain_pulses(void) {
+
+    static const struct {
+        hx711_gain_t gain;
+        uint8_t pulses;
+    } gains[] = {
+        { hx711_gain_32, 26 },
+        { hx711_gain_64, 27 },
+        { hx711_gain_128, 25 }
+    };
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    init_driver(&hxm, 3, false);
+
+    for(uint i = 0; i < count_of(gains); ++i) {
+
+        hx711_multi_set_gain(&hxm, gains[i].gain);
+
+        for(uint j = 0; j < 3; ++j) {
+            hx711_multi_get_values(&hxm, values);
+        }
+
+        //the read before the latest has certainly finished
+        for(uint j = 0; j < 3; ++j) {
+            TEST_CHECK(hostemu_hx711_get_read(&devs[j], 1)->pulses == gains[i].pulses);
+            TEST_CHECK(devs[j].stats.stray_pulses == 0);
+        }
+
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// set_gain checks the PIO gain it sends the reader rather than
+// the gain it was given, and each is accepted and converted at
+static int test_set_gain_pio_gain(void) {
+
+    static const hx711_gain_t gains[] = {
+        hx711_gain_32,
+        hx711_gain_64,
+        hx711_gain_128
+    };
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+    hx711_gain_t gain;
+
+    init_driver(&hxm, 2, false);
+
+    for(uint i = 0; i < count_of(gains); ++i) {
+
+        const uint32_t pioGain = hx711_gain_to_pio_gain(gains[i]);
+        TEST_CHECK(hx711_is_pio_gain_valid(pioGain));
+        TEST_CHECK(hx711_pio_gain_to_gain(pioGain) == gains[i]);
+
+        hx711_multi_set_gain(&hxm, gains[i]);
+
+        do {
+            hx711_multi_get_tagged_values(&hxm, values, &gain);
+        } while(gain != gains[i]);
+
+        TEST_CHECK(count_mismatches(values, 2) == 0);
+
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int test_tagged_values(void) {
+
+    static const hx711_gain_t gains[] = {
+        hx711_gain_64,
+        hx711_gain_32,
+        hx711_gain_128
+    };
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    //packed, so the gain follows fewer words
+    init_driver(&hxm, 3, true);
+
+    for(uint i = 0; i < count_of(gains); ++i) {
+
+        bool current = false;
+
+        //conversions at the previous gain are kept and tagged
+        //with it, followed by those at the new gain
+        hx711_multi_set_gain(&hxm, gains[i]);
+
+        for(uint j = 0; j < 4; ++j) {
+            hx711_gain_t gain;
+            hx711_multi_get_tagged_values(&hxm, values, &gain);
+            TEST_CHECK(count_mismatches(values, 3) == 0);
+            TEST_CHECK(hx711_get_clock_pulses(gain) ==
+                hostemu_hx711_get_read(&devs[0], 0)->converted_gain_pulses);
+            TEST_CHECK(!current || gain == gains[i]);
+            current = gain == gains[i];
+        }
+
+        TEST_CHECK(current);
+
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int test_set_gain_continuous(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+    uint32_t frame;
+    hx711_gain_t gain;
+    uint32_t last = 0;
+    uint frames = 0;
+    uint previous = 0;
+
+    init_driver(&hxm, 4, false);
+
+    hx711_multi_continuous_start(&hxm, ring, count_of(ring));
+    sleep_ms(30);
+
+    //the gain can be changed without stopping
+    hx711_multi_set_gain(&hxm, hx711_gain_32);
+    TEST_CHECK(!hx711_multi_is_gain_set(&hxm));
+
+    for(uint i = 0; i < 40; ++i) {
+
+        sleep_us(5000);
+
+        if(!hx711_multi_continuous_get_values(&hxm, values, &frame, NULL, &gain) ||
+            frame == last) {
+                continue;
+        }
+
+        TEST_CHECK(hx711_get_clock_pulses(gain) ==
+            hostemu_hx711_get_read(&devs[0], 0)->converted_gain_pulses);
+        //a newer frame may already be at the new gain
+        TEST_CHECK(gain != hx711_gain_32 || hx711_multi_is_gain_set(&hxm));
+
+        if(gain != hx711_gain_32) {
+            //only before the new gain is first seen
+            TEST_CHECK(previous == frames);
+            ++previous;
+        }
+
+        last = frame;
+        ++frames;
+
+    }
+
+    TEST_CHECK(frames > 10);
+    TEST_CHECK(previous <= 2);
+    TEST_CHECK(hx711_multi_is_gain_set(&hxm));
+
+    hx711_multi_continuous_stop(&hxm);
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int test_async(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    init_driver(&hxm, 4, false);
+
+    for(uint i = 0; i < 4; ++i) {
+
+        hx711_multi_async_start(&hxm);
+
+        while(!hx711_multi_async_done(&hxm)) {
+            tight_loop_contents();
+        }
+
+        hx711_multi_async_get_values(&hxm, values);
+        TEST_CHECK(count_mismatches(values, 4) == 0);
+        TEST_CHECK(is_ready_time(hx711_multi_async_get_time(&hxm), 4));
+
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// started while a conversion is being read, an async read waits
+// on the conversion done source of its PIO IRQ, not on the NVIC
+// IRQ number mistaken for a source
+static int test_async_waits(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    init_driver(&hxm, 4, false);
+
+    for(uint i = 0; i < 4; ++i) {
+
+        //the conversion done IRQ is cleared once the chips are
+        //ready and set again after they are read
+        while(pio_interrupt_get(hxm._pio, hxm._conversion_done_irq_num)) {
+            tight_loop_contents();
+        }
+
+        hx711_multi_async_start(&hxm);
+        TEST_CHECK(hxm._async_state == HX711_MULTI_ASYNC_STATE_WAITING);
+
+        TEST_CHECK(hxm._pio->irq_ctrl[hxm._pio_irq_index].inte ==
+            (1u << util_pio_get_pis_from_pio_interrupt_num(
+                hxm._conversion_done_irq_num)));
+
+        for(uint j = 0; j < 20 && !hx711_multi_async_done(&hxm); ++j) {
+            sleep_us(1000);
+        }
+
+        TEST_CHECK(hx711_multi_async_done(&hxm));
+        hx711_multi_async_get_values(&hxm, values);
+        TEST_CHECK(count_mismatches(values, 4) == 0);
+
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// closing removes both of the handlers it added, and from the
+// IRQs they were added to
+static int test_close_handlers(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    init_driver(&hxm, 4, false);
+
+    const uint pioIrq = util_pion_get_irqn(hxm._pio, hxm._pio_irq_index);
+    const uint dmaIrq = util_dma_get_irqn(hxm._dma_irq_index);
+
+    TEST_CHECK(irq_has_shared_handler(pioIrq));
+    TEST_CHECK(irq_has_shared_handler(dmaIrq));
+
+    hx711_multi_close(&hxm);
+
+    TEST_CHECK(!irq_has_shared_handler(pioIrq));
+    TEST_CHECK(!irq_has_shared_handler(dmaIrq));
+    TEST_CHECK(!irq_is_enabled(pioIrq));
+    TEST_CHECK(!irq_is_enabled(dmaIrq));
+
+    //and they are added again by the next init
+    hx711_multi_config_t cfg;
+    hx711_multi_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin_base = DATA_PIN_BASE;
+    cfg.chips_len = 4;
+
+    hx711_multi_init(&hxm, &cfg);
+    hx711_multi_power_up(&hxm, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    hx711_multi_async_start(&hxm);
+
+    while(!hx711_multi_async_done(&hxm)) {
+        tight_loop_contents();
+    }
+
+    hx711_multi_async_get_values(&hxm, values);
+    TEST_CHECK(count_mismatches(values, 4) == 0);
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// each PIO has two NVIC IRQs, so the lookups must not resolve
+// pio1 to one of pio0's
+static int test_pio_irq_lookup(void) {
+
+    int failures = 0;
+
+    TEST_CHECK(util_pion_get_irqn(pio0, 0) == PIO0_IRQ_0);
+    TEST_CHECK(util_pion_get_irqn(pio0, 1) == PIO0_IRQ_1);
+    TEST_CHECK(util_pion_get_irqn(pio1, 0) == PIO1_IRQ_0);
+    TEST_CHECK(util_pion_get_irqn(pio1, 1) == PIO1_IRQ_1);
+
+    TEST_CHECK(util_pio_get_irq_from_index(pio0, 0) == PIO0_IRQ_0);
+    TEST_CHECK(util_pio_get_irq_from_index(pio0, 1) == PIO0_IRQ_1);
+    TEST_CHECK(util_pio_get_irq_from_index(pio1, 0) == PIO1_IRQ_0);
+    TEST_CHECK(util_pio_get_irq_from_index(pio1, 1) == PIO1_IRQ_1);
+
+    return failures;
+
+}
+
+// the reader pushes a word for each bit and one for the gain,
+// and nothing between conversion periods, so a DMA channel
+// started while the conversion done IRQ is set stays aligned to
+// whole conversions
+static int test_reader_push_count(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+    uint32_t frame;
+    uint32_t last = 0;
+
+    init_driver(&hxm, 4, false);
+
+    hx711_multi_continuous_start(&hxm, ring, count_of(ring));
+
+    for(uint i = 0; i < 8; ++i) {
+
+        //seen within 1ms of the end of the frame, well before
+        //the next conversion period begins
+        do {
+            sleep_us(1000);
+        } while(!hx711_multi_continuous_get_values(&hxm, values, &frame, NULL, NULL) ||
+            frame == last);
+
+        const uint32_t pushed = HX711_MULTI_RING_TRANSFER_COUNT -
+            util_dma_get_transfer_count(hxm._ring_dma_channel) +
+            pio_sm_get_rx_fifo_level(hxm._pio, hxm._reader_sm);
+
+        TEST_CHECK(pushed == frame * (HX711_READ_BITS + 1));
+        TEST_CHECK(count_mismatches(values, 4) == 0);
+
+        last = frame;
+
+    }
+
+    hx711_multi_continuous_stop(&hxm);
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int test_pd_sck_hz(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.source = source;
+
+    for(size_t i = 0; i < 4; ++i) {
+        devCfg.data_pin = DATA_PIN_BASE + i;
+        devCfg.ctx = (void*)(uintptr_t)(i + 1);
+        hostemu_hx711_attach(&devs[i], &devCfg);
+    }
+
+    hx711_multi_config_t cfg;
+    hx711_multi_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin_base = DATA_PIN_BASE;
+    cfg.chips_len = 4;
+    cfg.pd_sck_hz = 100000;
+
+    hx711_multi_init(&hxm, &cfg);
+    hx711_multi_power_up(&hxm, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    TEST_CHECK(hx711_multi_pd_sck_hz_to_read_time_us(HX711_PD_SCK_DEFAULT_HZ) == 10);
+    TEST_CHECK(hx711_multi_get_read_time_us(&hxm) == 250);
+    TEST_CHECK(hx711_multi_get_read_time_us(&hxm) ==
+        hx711_multi_pd_sck_hz_to_read_time_us(cfg.pd_sck_hz));
+
+    for(uint i = 0; i < 4; ++i) {
+
+        hx711_multi_async_start(&hxm);
+
+        while(!hx711_multi_async_done(&hxm)) {
+            tight_loop_contents();
+        }
+
+        hx711_multi_async_get_values(&hxm, values);
+        TEST_CHECK(count_mismatches(values, 4) == 0);
+        TEST_CHECK(is_ready_time(hx711_multi_async_get_time(&hxm), 4));
+
+    }
+
+    for(size_t i = 0; i < 4; ++i) {
+        TEST_CHECK(devs[i].stats.stray_pulses == 0);
+    }
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int check_detect_rate(const hx711_rate_t rate) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.rate = hx711_get_rate_sps(rate);
+    devCfg.source = source;
+
+    for(size_t i = 0; i < 3; ++i) {
+        devCfg.data_pin = DATA_PIN_BASE + i;
+        devCfg.ctx = (void*)(uintptr_t)(i + 1);
+        hostemu_hx711_attach(&devs[i], &devCfg);
+    }
+
+    hx711_multi_config_t cfg;
+    hx711_multi_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin_base = DATA_PIN_BASE;
+    cfg.chips_len = 3;
+
+    hx711_multi_init(&hxm, &cfg);
+
+    TEST_CHECK(!hx711_multi_is_rate_detected(&hxm));
+    TEST_CHECK(hx711_multi_get_rate(&hxm) == hx711_rate_10);
+
+    hx711_multi_power_down(&hxm);
+    hx711_wait_power_down();
+
+    const uint32_t startUs = time_us_32();
+    hx711_multi_power_up(&hxm, hx711_gain_128);
+    TEST_CHECK(hx711_multi_detect_rate(&hxm) == rate);
+    const uint32_t elapsedUs = time_us_32() - startUs;
+    const uint32_t periodUs = 1000000u / hx711_get_rate_sps(rate);
+
+    //the first async read after powering up waits for the end
+    //of the first conversion and reads the one after it
+    TEST_CHECK(elapsedUs <= hx711_get_settling_time(rate) * 1000u + periodUs * 3);
+    TEST_CHECK(hx711_multi_is_rate_detected(&hxm));
+    TEST_CHECK(hx711_multi_get_rate(&hxm) == rate);
+
+    hx711_multi_get_values(&hxm, values);
+    TEST_CHECK(count_mismatches(values, 3) == 0);
+
+    //waits and timeouts follow the detected rate
+    TEST_CHECK(hx711_multi_get_timeout_us(&hxm) ==
+        periodUs * 2 + hx711_multi_get_read_time_us(&hxm));
+    TEST_CHECK(hx711_multi_get_values_timeout(&hxm, values, hx711_multi_get_timeout_us(&hxm)));
+
+    const uint32_t settleUs = time_us_32();
+    hx711_multi_wait_until_settled(&hxm);
+    const uint32_t settledUs = time_us_32() - settleUs;
+    TEST_CHECK(settledUs >= hx711_get_settling_time(rate) * 1000u);
+    TEST_CHECK(settledUs < hx711_get_settling_time(rate) * 1000u + 100);
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+static int test_detect_rate_10(void) {
+    return check_detect_rate(hx711_rate_10);
+}
+
+static int test_detect_rate_80(void) {
+    return check_detect_rate(hx711_rate_80);
+}
+
+static int test_many_instances(void) {
+
+    //two on each PIO, which is more than one per PIO, with
+    //some sharing PIO IRQs and all sharing a DMA IRQ
+    enum { INSTANCES = 4, CHIPS = 2, PINS = CHIPS + 1 };
+
+    int failures = 0;
+    hx711_multi_t hxms[INSTANCES] = {0};
+    int32_t values[CHIPS];
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.source = source;
+
+    for(uint k = 0; k < INSTANCES; ++k) {
+
+        devCfg.clock_pin = k * PINS;
+
+        for(uint c = 0; c < CHIPS; ++c) {
+            devCfg.data_pin = k * PINS + 1 + c;
+            devCfg.ctx = (void*)(uintptr_t)(k * CHIPS + c + 1);
+            hostemu_hx711_attach(&devs[k * CHIPS + c], &devCfg);
+        }
+
+        hx711_multi_config_t cfg;
+        hx711_multi_get_default_config(&cfg);
+
+        cfg.clock_pin = k * PINS;
+        cfg.data_pin_base = k * PINS + 1;
+        cfg.chips_len = CHIPS;
+        cfg.pio = k < 2 ? pio0 : pio1;
+        cfg.pio_irq_index = k == 3 ? 1 : 0;
+
+        hx711_multi_init(&hxms[k], &cfg);
+        hx711_multi_power_up(&hxms[k], hx711_gain_128);
+
+    }
+
+    hx711_wait_settle(hx711_rate_80);
+
+    //each instance closed in turn must not stop the others
+    for(uint closed = 0; closed < INSTANCES; ++closed) {
+
+        for(uint i = 0; i < 3; ++i) {
+
+            for(uint k = closed; k < INSTANCES; ++k) {
+                hx711_multi_async_start(&hxms[k]);
+            }
+
+            for(uint k = closed; k < INSTANCES; ++k) {
+
+                while(!hx711_multi_async_done(&hxms[k])) {
+                    tight_loop_contents();
+                }
+
+                hx711_multi_async_get_values(&hxms[k], values);
+
+                for(uint c = 0; c < CHIPS; ++c) {
+                    TEST_CHECK(values[c] ==
+                        hostemu_hx711_get_read(&devs[k * CHIPS + c], 0)->value);
+                }
+
+            }
+
+        }
+
+        hx711_multi_close(&hxms[closed]);
+
+    }
+
+    return failures;
+
+}
+
+static int test_group(void) {
+
+    //one member on each PIO with its own clock pin, using all
+    //but one of the GPIOs between them
+    enum { MEMBERS = 2 };
+    static const uint clockPins[MEMBERS] = { 0, 13 };
+    static const size_t chips[MEMBERS] = { 12, 16 };
+
+    int failures = 0;
+    hx711_multi_t hxms[MEMBERS] = {0};
+    hx711_multi_group_t group;
+    int32_t values[MAX_CHIPS];
+    size_t dev = 0;
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.source = source;
+
+    for(uint k = 0; k < MEMBERS; ++k) {
+
+        devCfg.clock_pin = clockPins[k];
+
+        //the second member's chips run slightly slower
+        devCfg.ppm = k * 200;
+
+        for(uint c = 0; c < chips[k]; ++c, ++dev) {
+            devCfg.data_pin = clockPins[k] + 1 + c;
+            devCfg.ctx = (void*)(uintptr_t)(dev + 1);
+            hostemu_hx711_attach(&devs[dev], &devCfg);
+        }
+
+        hx711_multi_config_t cfg;
+        hx711_multi_get_default_config(&cfg);
+
+        cfg.clock_pin = clockPins[k];
+        cfg.data_pin_base = clockPins[k] + 1;
+        cfg.chips_len = chips[k];
+        cfg.pio = k == 0 ? pio0 : pio1;
+
+        hx711_multi_init(&hxms[k], &cfg);
+
+    }
+
+    hx711_multi_group_init(&group, hxms, MEMBERS);
+    TEST_CHECK(hx711_multi_group_get_chips_len(&group) == 28);
+
+    hx711_multi_group_power_up(&group, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    for(uint i = 0; i < 8; ++i) {
+
+        const uint32_t start = time_us_32();
+
+        hx711_multi_group_get_values(&group, values);
+
+        //both members read within one conversion period
+        TEST_CHECK(time_us_32() - start < 12500 + 1000);
+        TEST_CHECK(count_mismatches(values, 28) == 0);
+
+    }
+
+    //starting while a member's read is still in progress waits
+    //for it to finish, rather than for its interrupt with
+    //interrupts disabled
+    hx711_multi_async_start(&hxms[1]);
+    hx711_multi_group_async_start(&group);
+
+    while(!hx711_multi_group_async_done(&group)) {
+        tight_loop_contents();
+    }
+
+    hx711_multi_group_async_get_values(&group, values);
+    TEST_CHECK(count_mismatches(values, 28) == 0);
+
+    hx711_multi_group_set_gain(&group, hx711_gain_64);
+    hx711_multi_group_get_values(&group, values);
+    TEST_CHECK(count_mismatches(values, 28) == 0);
+    TEST_CHECK(hostemu_hx711_get_read(&devs[27], 0)->converted_gain_pulses == 27);
+
+    for(uint k = 0; k < MEMBERS; ++k) {
+        hx711_multi_close(&hxms[k]);
+    }
+
+    return failures;
+
+}
+
+// members whose chips powered up at different times convert in
+// step once the group is synced
+static int test_group_sync(void) {
+
+    enum { MEMBERS = 2, CHIPS = 4 };
+    static const uint clockPins[MEMBERS] = { 0, 13 };
+
+    int failures = 0;
+    hx711_multi_t hxms[MEMBERS] = {0};
+    hx711_multi_group_t group;
+    int32_t values[MEMBERS * CHIPS];
+    size_t dev = 0;
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.source = source;
+
+    for(uint k = 0; k < MEMBERS; ++k) {
+
+        devCfg.clock_pin = clockPins[k];
+
+        //half a conversion period apart
+        devCfg.first_ready_us = 12500 + k * 6250;
+
+        for(uint c = 0; c < CHIPS; ++c, ++dev) {
+            devCfg.data_pin = clockPins[k] + 1 + c;
+            devCfg.ctx = (void*)(uintptr_t)(dev + 1);
+            hostemu_hx711_attach(&devs[dev], &devCfg);
+        }
+
+        hx711_multi_config_t cfg;
+        hx711_multi_get_default_config(&cfg);
+
+        cfg.clock_pin = clockPins[k];
+        cfg.data_pin_base = clockPins[k] + 1;
+        cfg.chips_len = CHIPS;
+        cfg.pio = k == 0 ? pio0 : pio1;
+
+        hx711_multi_init(&hxms[k], &cfg);
+
+    }
+
+    hx711_multi_group_init(&group, hxms, MEMBERS);
+
+    hx711_multi_group_power_up(&group, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+    hx711_multi_group_get_values(&group, values);
+
+    const int64_t before = (int64_t)hostemu_hx711_get_read(&devs[CHIPS], 0)->ready_cycle -
+        (int64_t)hostemu_hx711_get_read(&devs[0], 0)->ready_cycle;
+
+    TEST_CHECK(llabs(before) > hostemu_us_to_cycles(5000));
+
+    hx711_multi_group_sync(&group, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+    hx711_multi_group_get_values(&group, values);
+    TEST_CHECK(count_mismatches(values, MEMBERS * CHIPS) == 0);
+
+    const int64_t after = (int64_t)hostemu_hx711_get_read(&devs[CHIPS], 0)->ready_cycle -
+        (int64_t)hostemu_hx711_get_read(&devs[0], 0)->ready_cycle;
+
+    TEST_CHECK(llabs(after) < hostemu_us_to_cycles(10));
+
+    for(size_t i = 0; i < MEMBERS * CHIPS; ++i) {
+        TEST_CHECK(devs[i].stats.power_downs == 1);
+    }
+
+    for(uint k = 0; k < MEMBERS; ++k) {
+        hx711_multi_close(&hxms[k]);
+    }
+
+    return failures;
+
+}
+
+static int check_masked(
+    const uint32_t mask,
+    const uint clockPin,
+    const uint32_t highPins,
+    const bool pack) {
+
+        int failures = 0;
+        hx711_multi_t hxm = {0};
+        int32_t values[MAX_CHIPS];
+        size_t len = 0;
+
+        hostemu_hx711_config_t devCfg;
+        hostemu_hx711_default_config(&devCfg);
+
+        devCfg.clock_pin = clockPin;
+        devCfg.source = source;
+
+        for(uint pin = 0; pin < 32; ++pin) {
+            if((mask >> pin) & 1) {
+                //each chip runs at a slightly different rate so
+                //that they become ready at different times
+                devCfg.data_pin = pin;
+                devCfg.ppm = len * 300;
+                devCfg.ctx = (void*)(uintptr_t)(len + 1);
+                hostemu_hx711_attach(&devs[len++], &devCfg);
+            }
+        }
+
+        //pins in the gaps are used by something else and must
+        //be ignored by the awaiter
+        for(uint pin = 0; pin < 32; ++pin) {
+            if((highPins >> pin) & 1) {
+                hostemu_gpio_drive(pin, 1);
+            }
+        }
+
+        hx711_multi_config_t cfg;
+        hx711_multi_get_masked_default_config(&cfg);
+
+        cfg.clock_pin = clockPin;
+        cfg.data_pin_mask = mask;
+        cfg.pack_pinvals = pack;
+
+        hx711_multi_init(&hxm, &cfg);
+        TEST_CHECK(hxm._chips_len == len);
+
+        hx711_multi_power_up(&hxm, hx711_gain_128);
+        hx711_wait_settle(hx711_rate_80);
+
+        for(uint i = 0; i < 8; ++i) {
+            TEST_CHECK(hx711_multi_get_values_timeout(&hxm, values, 250000));
+            TEST_CHECK(count_mismatches(values, len) == 0);
+        }
+
+        //none of the chips should have been read before they
+        //were ready
+        for(size_t i = 0; i < len; ++i) {
+            TEST_CHECK(devs[i].stats.stray_pulses == 0);
+        }
+
+        hx711_multi_close(&hxm);
+
+        return failures;
+
+}
+
+static int test_masked(void) {
+
+    int failures = 0;
+
+    for(uint pack = 0; pack < 2; ++pack) {
+
+        //two runs with the clock pin between them
+        hostemu_reset();
+        failures += check_masked(
+            (1u << 1) | (1u << 2) | (1u << 4),
+            3,
+            0,
+            pack);
+
+        //three runs with the clock pin and pins held high in
+        //the gaps
+        hostemu_reset();
+        failures += check_masked(
+            (1u << 1) | (1u << 3) | (1u << 4) | (1u << 8) | (1u << 9) | (1u << 10),
+            5,
+            (1u << 2) | (1u << 6),
+            pack);
+
+        //the widest window, with one pin in each of the first
+        //and last runs
+        hostemu_reset();
+        failures += check_masked(
+            (1u << 0) | (0x3ffu << 10) | (1u << 29),
+            1,
+            (1u << 2) | (1u << 28),
+            pack);
+
+    }
+
+    return failures;
+
+}
+
+static int test_continuous(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+    uint32_t frame;
+    absolute_time_t time;
+    hx711_gain_t gain;
+    uint32_t last = 0;
+    uint32_t frames = 0;
+
+    init_driver(&hxm, 8, true);
+
+    hx711_multi_continuous_start(&hxm, ring, count_of(ring));
+    TEST_CHECK(hx711_multi_continuous_is_running(&hxm));
+
+    //poll at varying intervals, all shorter than the 12.5ms
+    //between conversions, so no frame should be skipped
+    for(uint i = 0; i < 200; ++i) {
+
+        sleep_us(3000 + (i % 7) * 1000);
+
+        if(hx711_multi_continuous_get_values(&hxm, values, &frame, &time, &gain) &&
+            frame != last) {
+                TEST_CHECK(last == 0 || frame == last + 1);
+                TEST_CHECK(gain == hx711_gain_128);
+                TEST_CHECK(count_mismatches(values, 8) == 0);
+                TEST_CHECK(is_ready_time(time, 8));
+                last = frame;
+                ++frames;
+        }
+
+    }
+
+    TEST_CHECK(frames > 80);
+    TEST_CHECK(devs[0].stats.missed == 0);
+
+    hx711_multi_continuous_stop(&hxm);
+    TEST_CHECK(!hx711_multi_continuous_is_running(&hxm));
+
+    //one-shot reads work again once stopped
+    hx711_multi_get_values(&hxm, values);
+    TEST_CHECK(count_mismatches(values, 8) == 0);
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// a late PIO ISR must neither corrupt nor lose frames; the DMA
+// channel keeps filling the ring while interrupts are off
+static int test_continuous_late_isr(void) {
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+    uint32_t frame;
+    uint32_t last;
+
+    init_driver(&hxm, 8, true);
+
+    hx711_multi_continuous_start(&hxm, ring, count_of(ring));
+
+    while(!hx711_multi_continuous_get_values(&hxm, values, &last, NULL, NULL)) {
+        sleep_us(1000);
+    }
+
+    //every read from here on is a frame
+    const uint32_t reads = devs[0].stats.reads;
+
+    //several conversions, more than the ring holds
+    const uint32_t status = save_and_disable_interrupts();
+    sleep_us(45000);
+    restore_interrupts(status);
+
+    TEST_CHECK(hx711_multi_continuous_get_values(&hxm, values, &frame, NULL, NULL));
+    TEST_CHECK(frame >= last + 3);
+    TEST_CHECK(frame == last + devs[0].stats.reads - reads);
+    TEST_CHECK(count_mismatches(values, 8) == 0);
+
+    //and carries on as normal afterwards
+    const uint32_t late = frame;
+    last = frame;
+
+    for(uint i = 0; i < 40; ++i) {
+
+        sleep_us(5000);
+
+        if(hx711_multi_continuous_get_values(&hxm, values, &frame, NULL, NULL) &&
+            frame != last) {
+                TEST_CHECK(frame == last + 1);
+                TEST_CHECK(count_mismatches(values, 8) == 0);
+                last = frame;
+        }
+
+    }
+
+    TEST_CHECK(last >= late + 10);
+
+    hx711_multi_continuous_stop(&hxm);
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+// a longer ring is written all the way round before wrapping
+static int test_continuous_ring_len(void) {
+
+    enum { RING_LEN = 256 };
+
+    static uint32_t longRing[RING_LEN]
+        __aligned(RING_LEN * sizeof(uint32_t));
+
+    int failures = 0;
+    hx711_multi_t hxm = {0};
+    int32_t values[MAX_CHIPS];
+    uint32_t frame = 0;
+
+    memset(longRing, 0xff, sizeof(longRing));
+
+    init_driver(&hxm, 4, false);
+    hx711_multi_continuous_start(&hxm, longRing, RING_LEN);
+
+    //25 words a frame, so 11 frames reach the end of the ring
+    while(frame < 12) {
+        sleep_us(5000);
+        if(hx711_multi_continuous_get_values(&hxm, values, &frame, NULL, NULL)) {
+            TEST_CHECK(count_mismatches(values, 4) == 0);
+        }
+    }
+
+    //the gain of the tenth frame, as for every frame, is last
+    TEST_CHECK(longRing[10 * (HX711_READ_BITS + 1) - 1] == hx711_gain_to_pio_gain(hx711_gain_128));
+    TEST_CHECK(longRing[RING_LEN - 1] != 0xffffffff);
+
+    hx711_multi_continuous_stop(&hxm);
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+int main(void) {
+
+    static const test_case_t tests[] = {
+        TEST_CASE(test_get_values),
+        TEST_CASE(test_get_values_packed),
+        TEST_CASE(test_get_values_sleeps),
+        TEST_CASE(test_set_gain),
+        TEST_CASE(test_gain_set_polled),
+        TEST_CASE(test_gain_pulses),
+        TEST_CASE(test_set_gain_pio_gain),
+        TEST_CASE(test_tagged_values),
+        TEST_CASE(test_set_gain_continuous),
+        TEST_CASE(test_async),
+        TEST_CASE(test_async_waits),
+        TEST_CASE(test_close_handlers),
+        TEST_CASE(test_pio_irq_lookup),
+        TEST_CASE(test_reader_push_count),
+        TEST_CASE(test_pd_sck_hz),
+        TEST_CASE(test_detect_rate_10),
+        TEST_CASE(test_detect_rate_80),
+        TEST_CASE(test_many_instances),
+        TEST_CASE(test_group),
+        TEST_CASE(test_group_sync),
+        TEST_CASE(test_masked),
+        TEST_CASE(test_continuous),
+        TEST_CASE(test_continuous_late_isr),
+        TEST_CASE(test_continuous_ring_len)
+    };
+
+    return test_main(tests, count_of(tests));
+
+}
@@ -0,0 +1,227 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs a hx711_t and a hx711_multi_t from the core1 service, with
+// core0 popping their frames.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "hardware/irq.h"
+#include "hostemu.h"
+#include "pico/time.h"
+#include "../../include/common.h"
+#include "test.h"
+
+#define HX_CLOCK_PIN        0
+#define HX_DATA_PIN         1
+#define HXM_CLOCK_PIN       2
+#define HXM_DATA_PIN_BASE   3
+#define HXM_CHIPS           4
+#define DEVS_LEN            (1 + HXM_CHIPS)
+
+static hostemu_hx711_t devs[DEVS_LEN];
+
+// a different pseudo-random 24 bit value for each chip and conversion
+static int32_t source(
+    void* const ctx,
+    const uint32_t index,
+    const uint8_t gainPulses) {
+        const uint32_t x = (uint32_t)(uintptr_t)ctx * 2654435761u +
+            index * 40503u + gainPulses;
+        return (int32_t)(x % 16777216u) - 8388608;
+}
+
+static void attach_devices(void) {
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+
+    devCfg.source = source;
+
+    for(uint i = 0; i < DEVS_LEN; ++i) {
+        devCfg.clock_pin = i == 0 ? HX_CLOCK_PIN : HXM_CLOCK_PIN;
+        devCfg.data_pin = i == 0 ? HX_DATA_PIN : HXM_DATA_PIN_BASE + i - 1;
+        devCfg.ctx = (void*)(uintptr_t)(i + 1);
+        hostemu_hx711_attach(&devs[i], &devCfg);
+    }
+
+}
+
+static void add_sources(
+    hx711_service_t* const svc,
+    hx711_t* const hx,
+    hx711_multi_t* const hxm) {
+
+        static uint32_t ring[HX711_MULTI_RING_MIN_LEN]
+            __aligned(HX711_MULTI_RING_MIN_LEN * sizeof(uint32_t));
+
+        hx711_config_t cfg;
+        hx711_get_default_config(&cfg);
+        cfg.clock_pin = HX_CLOCK_PIN;
+        cfg.data_pin = HX_DATA_PIN;
+        cfg.pio = pio1; //the hx711_multi_t fills most of pio0
+
+        hx711_multi_config_t multiCfg;
+        hx711_multi_get_default_config(&multiCfg);
+        multiCfg.clock_pin = HXM_CLOCK_PIN;
+        multiCfg.data_pin_base = HXM_DATA_PIN_BASE;
+        multiCfg.chips_len = HXM_CHIPS;
+
+        hx711_service_add(svc, hx, &cfg, hx711_gain_128);
+        hx711_service_add_multi(svc, hxm, &multiCfg, hx711_gain_128, ring, count_of(ring));
+
+}
+
+// whether the value is one of the chip's recent reads
+static bool was_read(
+    const hostemu_hx711_t* const dev,
+    const int32_t value) {
+
+        const hostemu_hx711_read_t* r;
+
+        for(uint32_t back = 0; (r = hostemu_hx711_get_read(dev, back)) != NULL; ++back) {
+            if(r->value == value) {
+                return true;
+            }
+        }
+
+        return false;
+
+}
+
+static bool any_irq_enabled(void) {
+    for(uint i = 0; i < NUM_IRQS; ++i) {
+        if(irq_is_enabled(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int test_frames(void) {
+
+    int failures = 0;
+    hx711_service_t svc;
+    static hx711_service_frame_t frames[16];
+    hx711_service_frame_t frame;
+    hx711_t hx = {0};
+    hx711_multi_t hxm = {0};
+    uint32_t last[2] = {0, 0};
+    uint32_t popped[2] = {0, 0};
+
+    attach_devices();
+
+    hx711_service_init(&svc, frames, count_of(frames));
+    add_sources(&svc, &hx, &hxm);
+    hx711_service_start(&svc);
+
+    //the interrupts belong to core1
+    TEST_CHECK(!any_irq_enabled());
+
+    for(uint i = 0; i < 100; ++i) {
+
+        hx711_service_pop_blocking(&svc, &frame);
+
+        TEST_CHECK(frame.source < 2);
+        TEST_CHECK(frame.len == (frame.source == 0 ? 1 : HXM_CHIPS));
+        TEST_CHECK(frame.count == last[frame.source] + 1);
+
+        for(uint j = 0; j < frame.len; ++j) {
+            TEST_CHECK(was_read(&devs[frame.source + j], frame.values[j]));
+        }
+
+        last[frame.source] = frame.count;
+        ++popped[frame.source];
+
+    }
+
+    //both sources run at 80SPS
+    TEST_CHECK(popped[0] > 40);
+    TEST_CHECK(popped[1] > 40);
+    TEST_CHECK(hx711_service_get_dropped(&svc) == 0);
+
+    //core0 slept while waiting
+    TEST_CHECK(hostemu_poll_cycles() < hostemu_cycles() / 10);
+
+    hx711_service_stop(&svc);
+
+    //nothing more arrives once stopped
+    while(hx711_service_pop(&svc, &frame)) {
+    }
+
+    TEST_CHECK(!hx711_service_pop_timeout(&svc, &frame, 50000));
+
+    return failures;
+
+}
+
+static int test_dropped(void) {
+
+    int failures = 0;
+    hx711_service_t svc;
+    static hx711_service_frame_t frames[4];
+    hx711_service_frame_t frame;
+    hx711_t hx = {0};
+    hx711_multi_t hxm = {0};
+
+    attach_devices();
+
+    hx711_service_init(&svc, frames, count_of(frames));
+    add_sources(&svc, &hx, &hxm);
+    hx711_service_start(&svc);
+
+    //about 16 frames from each source
+    sleep_ms(200);
+
+    TEST_CHECK(hx711_service_get_dropped(&svc) > 20);
+
+    //the oldest frames are kept
+    TEST_CHECK(hx711_service_pop_timeout(&svc, &frame, 0));
+    TEST_CHECK(frame.count == 1);
+
+    uint n = 1;
+
+    while(hx711_service_pop_timeout(&svc, &frame, 0)) {
+        ++n;
+    }
+
+    TEST_CHECK(n == count_of(frames));
+
+    //frames are published again once there is room
+    TEST_CHECK(hx711_service_pop_timeout(&svc, &frame, 50000));
+
+    hx711_service_stop(&svc);
+
+    return failures;
+
+}
+
+int main(void) {
+
+    static const test_case_t tests[] = {
+        TEST_CASE(test_frames),
+        TEST_CASE(test_dropped)
+    };
+
+    return test_main(tests, count_of(tests));
+
+}
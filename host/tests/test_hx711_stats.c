@@ -0,0 +1,233 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Checks the counters gathered when HX711_STATS is defined, for both
+// drivers running against the emulator.
+
+#include <stdint.h>
+#include "hostemu.h"
+#include "pico/time.h"
+#include "../../include/common.h"
+#include "../../include/hx711_stats.h"
+#include "../../include/util.h"
+#include "test.h"
+
+#define CLOCK_PIN       14
+#define DATA_PIN        15
+#define MULTI_CLOCK_PIN 0
+#define MULTI_DATA_PIN  1
+#define MULTI_CHIPS     2
+
+static uint32_t histogram_sum(const hx711_stats_latency_t* const latency) {
+    uint32_t sum = 0;
+    for(uint i = 0; i < HX711_STATS_HISTOGRAM_LEN; ++i) {
+        sum += latency->histogram[i];
+    }
+    return sum;
+}
+
+static void on_value(
+    const hx711_sample_t* const sample,
+    void* const ctx) {
+        (void)sample;
+        ++*(uint32_t*)ctx;
+}
+
+static int test_latency(void) {
+
+    int failures = 0;
+    hx711_stats_t stats;
+
+    hx711_stats_reset(&stats);
+    TEST_CHECK(stats.wait_us.count == 0);
+    TEST_CHECK(stats.wait_us.min == UINT32_MAX);
+
+    static const uint32_t us[] = { 0, 1, 2, 3, 4, 1000, UINT32_MAX };
+    static const uint bins[] = { 0, 1, 2, 2, 3, 10, HX711_STATS_HISTOGRAM_LEN - 1 };
+
+    for(uint i = 0; i < count_of(us); ++i) {
+        const uint32_t before = stats.wait_us.histogram[bins[i]];
+        hx711_stats_latency_add(&stats.wait_us, us[i]);
+        TEST_CHECK(stats.wait_us.histogram[bins[i]] == before + 1);
+    }
+
+    TEST_CHECK(stats.wait_us.count == count_of(us));
+    TEST_CHECK(stats.wait_us.min == 0);
+    TEST_CHECK(stats.wait_us.max == UINT32_MAX);
+    TEST_CHECK(histogram_sum(&stats.wait_us) == count_of(us));
+
+    return failures;
+
+}
+
+static int test_hx711(void) {
+
+    int failures = 0;
+    hostemu_hx711_t dev;
+    hx711_t hx = {0};
+    hx711_stats_t stats;
+    int32_t val;
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = CLOCK_PIN;
+    devCfg.data_pin = DATA_PIN;
+    hostemu_hx711_attach(&dev, &devCfg);
+
+    hx711_config_t cfg;
+    hx711_get_default_config(&cfg);
+    cfg.clock_pin = CLOCK_PIN;
+    cfg.data_pin = DATA_PIN;
+    hx711_init(&hx, &cfg);
+    hx711_power_up(&hx, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+    hx711_reset_stats(&hx);
+
+    //each waits for a new conversion
+    for(uint i = 0; i < 4; ++i) {
+        hx711_get_value(&hx);
+    }
+
+    hx711_get_stats(&hx, &stats);
+    TEST_CHECK(stats.values == 4);
+    TEST_CHECK(stats.overflows == 0);
+    TEST_CHECK(stats.wait_us.count == 4);
+    TEST_CHECK(stats.wait_us.max <= 12500 + hx711_get_read_time_us(&hx));
+    TEST_CHECK(stats.wait_us.min <= stats.wait_us.max);
+    TEST_CHECK(histogram_sum(&stats.wait_us) == 4);
+
+    //the next conversion is over 12ms away
+    TEST_CHECK(!hx711_get_value_timeout(&hx, &val, 100));
+    hx711_get_stats(&hx, &stats);
+    TEST_CHECK(stats.timeouts == 1);
+    TEST_CHECK(stats.values == 4);
+
+    //long enough for the RX FIFO to fill
+    sleep_ms(100);
+    hx711_get_value(&hx);
+    hx711_get_stats(&hx, &stats);
+    TEST_CHECK(stats.overflows == 1);
+
+    uint32_t calls = 0;
+
+    util_pio_sm_clear_rx_fifo(hx._pio, hx._reader_sm);
+    hx711_reset_stats(&hx);
+    hx711_callback_start(&hx, on_value, &calls);
+
+    for(uint i = 0; i < 4; ++i) {
+        __wfi();
+    }
+
+    hx711_callback_stop(&hx);
+
+    hx711_get_stats(&hx, &stats);
+    TEST_CHECK(stats.values == calls);
+    TEST_CHECK(stats.isr_us.count == calls);
+    TEST_CHECK(stats.overflows == 0);
+
+    hx711_close(&hx);
+
+    return failures;
+
+}
+
+static int test_hx711_multi(void) {
+
+    static uint32_t ring[HX711_MULTI_RING_MIN_LEN]
+        __aligned(HX711_MULTI_RING_MIN_LEN * sizeof(uint32_t));
+
+    int failures = 0;
+    hostemu_hx711_t devs[MULTI_CHIPS];
+    hx711_multi_t hxm = {0};
+    hx711_stats_t stats;
+    int32_t values[MULTI_CHIPS];
+
+    hostemu_hx711_config_t devCfg;
+    hostemu_hx711_default_config(&devCfg);
+    devCfg.clock_pin = MULTI_CLOCK_PIN;
+
+    for(uint i = 0; i < MULTI_CHIPS; ++i) {
+        devCfg.data_pin = MULTI_DATA_PIN + i;
+        hostemu_hx711_attach(&devs[i], &devCfg);
+    }
+
+    hx711_multi_config_t cfg;
+    hx711_multi_get_default_config(&cfg);
+    cfg.clock_pin = MULTI_CLOCK_PIN;
+    cfg.data_pin_base = MULTI_DATA_PIN;
+    cfg.chips_len = MULTI_CHIPS;
+    hx711_multi_init(&hxm, &cfg);
+    hx711_multi_power_up(&hxm, hx711_gain_128);
+    hx711_wait_settle(hx711_rate_80);
+
+    hx711_multi_reset_stats(&hxm);
+
+    for(uint i = 0; i < 3; ++i) {
+        hx711_multi_get_values(&hxm, values);
+    }
+
+    hx711_multi_get_stats(&hxm, &stats);
+    TEST_CHECK(stats.values == 3);
+    TEST_CHECK(stats.wait_us.count == 3);
+    TEST_CHECK(stats.wait_us.max <= 2 * 12500);
+    TEST_CHECK(stats.isr_us.count >= 3);
+
+    TEST_CHECK(!hx711_multi_get_values_timeout(&hxm, values, 100));
+    hx711_multi_get_stats(&hxm, &stats);
+    TEST_CHECK(stats.timeouts == 1);
+    TEST_CHECK(stats.values == 3);
+
+    //polled three times more slowly than frames complete
+    hx711_multi_reset_stats(&hxm);
+    hx711_multi_continuous_start(&hxm, ring, count_of(ring));
+
+    for(uint i = 0; i < 5; ++i) {
+        sleep_us(3 * 12500);
+        hx711_multi_continuous_get_values(&hxm, values, NULL, NULL, NULL);
+    }
+
+    hx711_multi_continuous_stop(&hxm);
+
+    hx711_multi_get_stats(&hxm, &stats);
+    TEST_CHECK(stats.values >= 14);
+    TEST_CHECK(stats.overflows >= 8);
+    TEST_CHECK(stats.overflows < stats.values);
+
+    hx711_multi_close(&hxm);
+
+    return failures;
+
+}
+
+int main(void) {
+
+    static const test_case_t tests[] = {
+        TEST_CASE(test_latency),
+        TEST_CASE(test_hx711),
+        TEST_CASE(test_hx711_multi)
+    };
+
+    return test_main(tests, count_of(tests));
+
+}
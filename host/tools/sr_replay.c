@@ -0,0 +1,380 @@
+// MIT License
+//
+// Copyright (c) 2023 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Decodes a sigrok capture of an HX711, checks its timing against the
+// datasheet, measures decode throughput and replays the conversions
+// through the drivers running against the emulator.
+//
+// sr_replay [-v] [-c clock_probe] [-d data_probe] capture.sr
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hostemu.h"
+#include "hostemu_sr.h"
+#include "pico/time.h"
+#include "../../include/common.h"
+
+#define CLOCK_PIN           0
+#define DATA_PIN_BASE       1
+#define MULTI_CHIPS         4
+
+// datasheet PD_SCK and DOUT timing, in ns
+#define T2_MAX_NS           100.0
+#define T3_MIN_NS           200.0
+#define T3_MAX_NS           50000.0
+#define T4_MIN_NS           200.0
+
+#define DECODE_MIN_NS       5e8
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+typedef struct {
+    double min;
+    double max;
+    double sum;
+    uint32_t n;
+} range_t;
+
+static void range_add(range_t* const r, const double v) {
+    if(r->n == 0 || v < r->min) {
+        r->min = v;
+    }
+    if(r->n == 0 || v > r->max) {
+        r->max = v;
+    }
+    r->sum += v;
+    ++r->n;
+}
+
+static void print_range(
+    const char* const name,
+    const range_t* const r,
+    const char* const unit) {
+        printf("  %-28s min %10.3f  max %10.3f  mean %10.3f %s\n",
+            name, r->min, r->max, r->n ? r->sum / r->n : 0.0, unit);
+}
+
+// measurements are only as precise as one sample, so limits are
+// checked allowing for one sample either way
+static int check_limit(
+    const char* const name,
+    const double val,
+    const double limit,
+    const bool isMax,
+    const double resolution) {
+        const bool ok = isMax ? val <= limit + resolution : val >= limit - resolution;
+        printf("  %-28s %10.1f ns %s %10.1f ns  %s\n",
+            name, val, isMax ? "<=" : ">=", limit, ok ? "ok" : "VIOLATION");
+        return ok ? 0 : 1;
+}
+
+static int report_capture(
+    const hostemu_sr_capture_t* const cap,
+    const bool verbose) {
+
+        const hostemu_sr_decoder_t* const dec = &cap->decoder;
+        const double res = hostemu_sr_samples_to_ns(cap, 1);
+        range_t period = {0}, wait = {0}, read = {0};
+        double minHigh = 0, maxHigh = 0, minLow = 0, maxDelay = 0;
+        int violations = 0;
+
+        printf("samplerate %llu Hz, %llu samples (%.1f ms), %u edges\n",
+            (unsigned long long)cap->samplerate,
+            (unsigned long long)cap->samples,
+            hostemu_sr_samples_to_ns(cap, cap->samples) / 1e6,
+            dec->edges);
+
+        printf("%zu conversions, %u power downs, %u stray pulses\n",
+            dec->frames_len, dec->power_downs, dec->stray_pulses);
+
+        for(size_t i = 0; i < dec->frames_len; ++i) {
+
+            const hostemu_sr_frame_t* const f = &dec->frames[i];
+
+            if(i > 0) {
+                range_add(&period, hostemu_sr_samples_to_ns(cap, f->ready - dec->frames[i - 1].ready) / 1e6);
+            }
+
+            range_add(&wait, hostemu_sr_samples_to_ns(cap, f->first_rising - f->ready) / 1e3);
+            range_add(&read, hostemu_sr_samples_to_ns(cap, f->last_falling - f->first_rising) / 1e3);
+
+            const double high = hostemu_sr_samples_to_ns(cap, f->min_high);
+            const double low = hostemu_sr_samples_to_ns(cap, f->min_low);
+
+            minHigh = i == 0 ? high : MIN(minHigh, high);
+            minLow = i == 0 ? low : MIN(minLow, low);
+            maxHigh = MAX(maxHigh, hostemu_sr_samples_to_ns(cap, f->max_high));
+            maxDelay = MAX(maxDelay, hostemu_sr_samples_to_ns(cap, f->max_dout_delay));
+
+            if(verbose) {
+                printf("  %4zu  ready %10.3f ms  value %9ld  pulses %u\n",
+                    i, hostemu_sr_samples_to_ns(cap, f->ready) / 1e6,
+                    (long)f->value, f->pulses);
+            }
+
+        }
+
+        if(dec->frames_len < 2) {
+            return 1;
+        }
+
+        printf("timing\n");
+        print_range("conversion period", &period, "ms");
+        printf("  %-28s %.2f SPS\n", "rate", 1e3 / (period.sum / period.n));
+        print_range("DOUT low to first PD_SCK", &wait, "us");
+        print_range("first to last PD_SCK", &read, "us");
+
+        printf("datasheet limits (+/- %.1f ns sample resolution)\n", res);
+        violations += check_limit("T2 PD_SCK rise to DOUT", maxDelay, T2_MAX_NS, true, res);
+        violations += check_limit("T3 PD_SCK high (min)", minHigh, T3_MIN_NS, false, res);
+        violations += check_limit("T3 PD_SCK high (max)", maxHigh, T3_MAX_NS, true, res);
+        violations += check_limit("T4 PD_SCK low", minLow, T4_MIN_NS, false, res);
+
+        for(size_t i = 0; i < dec->frames_len; ++i) {
+            const uint8_t pulses = dec->frames[i].pulses;
+            if(pulses < 25 || pulses > 27) {
+                printf("  conversion %zu has %u PD_SCK pulses  VIOLATION\n", i, pulses);
+                ++violations;
+            }
+        }
+
+        return violations;
+
+}
+
+static int bench_decode(
+    const char* const path,
+    const char* const clockProbe,
+    const char* const dataProbe,
+    const size_t expectedFrames) {
+
+        hostemu_sr_capture_t cap;
+        uint8_t* samples;
+        uint32_t runs = 0;
+        int failures = 0;
+
+        if(!hostemu_sr_read_samples(&cap, path, clockProbe, dataProbe, &samples)) {
+            return 1;
+        }
+
+        const double start = now_ns();
+        double elapsed;
+
+        do {
+            hostemu_sr_decoder_t dec;
+            hostemu_sr_decoder_init(&dec, (uint)cap.clock_bit, (uint)cap.data_bit, cap.samplerate);
+            hostemu_sr_decode(&dec, samples, cap.samples);
+            hostemu_sr_decode_end(&dec);
+            failures += dec.frames_len != expectedFrames;
+            hostemu_sr_decoder_free(&dec);
+            ++runs;
+            elapsed = now_ns() - start;
+        } while(elapsed < DECODE_MIN_NS);
+
+        const double perSample = elapsed / ((double)runs * cap.samples);
+
+        printf("decode\n");
+        printf("  %-28s %.1f Msamples/s (%.0fx real time)\n", "throughput",
+            1e3 / perSample, 1e9 / perSample / cap.samplerate);
+
+        free(samples);
+
+        return failures;
+
+}
+
+// the frame an emulated HX711 last clocked out
+static int32_t last_frame_value(
+    const hostemu_sr_capture_t* const cap,
+    const hostemu_hx711_t* const dev) {
+        const hostemu_hx711_read_t* const r = hostemu_hx711_get_read(dev, 0);
+        return cap->decoder.frames[r->index % cap->decoder.frames_len].value;
+}
+
+// replays conversions into hx711_t, reading every value as it is
+// ready, and checks each is the frame the emulated HX711 clocked out
+static int replay_single(
+    const hostemu_sr_capture_t* const cap,
+    const uint32_t count) {
+
+        hostemu_hx711_t dev;
+        hostemu_hx711_config_t devCfg;
+        hx711_config_t cfg;
+        hx711_t hx = {0};
+        int failures = 0;
+
+        hostemu_reset();
+
+        hostemu_hx711_default_config(&devCfg);
+        devCfg.clock_pin = CLOCK_PIN;
+        devCfg.data_pin = DATA_PIN_BASE;
+        hostemu_sr_replay_config(cap, &devCfg);
+        hostemu_hx711_attach(&dev, &devCfg);
+
+        hx711_get_default_config(&cfg);
+        cfg.clock_pin = CLOCK_PIN;
+        cfg.data_pin = DATA_PIN_BASE;
+
+        hx711_init(&hx, &cfg);
+        hx711_power_up(&hx, hx711_gain_128);
+
+        const double start = now_ns();
+
+        for(uint32_t i = 0; i < count; ++i) {
+            const int32_t val = hx711_get_value(&hx);
+            failures += val != last_frame_value(cap, &dev);
+        }
+
+        const double host = now_ns() - start;
+        const double emulated = (double)hostemu_cycles() * 1e9 / HOSTEMU_CLK_SYS_HZ;
+
+        hx711_close(&hx);
+
+        failures += dev.stats.missed != 0;
+
+        printf("  %-28s %u values, %u mismatched, %u missed, %.0fx real time\n",
+            "hx711_t", count, failures, dev.stats.missed, emulated / host);
+
+        return failures;
+
+}
+
+// replays the same conversions on several chips into hx711_multi_t
+static int replay_multi(
+    const hostemu_sr_capture_t* const cap,
+    const uint32_t count) {
+
+        static hostemu_hx711_t devs[MULTI_CHIPS];
+        hostemu_hx711_config_t devCfg;
+        hx711_multi_config_t cfg;
+        hx711_multi_t hxm = {0};
+        int32_t values[MULTI_CHIPS];
+        uint32_t missed = 0;
+        int failures = 0;
+
+        hostemu_reset();
+
+        hostemu_hx711_default_config(&devCfg);
+        devCfg.clock_pin = CLOCK_PIN;
+        hostemu_sr_replay_config(cap, &devCfg);
+
+        for(uint i = 0; i < MULTI_CHIPS; ++i) {
+            devCfg.data_pin = DATA_PIN_BASE + i;
+            hostemu_hx711_attach(&devs[i], &devCfg);
+        }
+
+        hx711_multi_get_default_config(&cfg);
+        cfg.clock_pin = CLOCK_PIN;
+        cfg.data_pin_base = DATA_PIN_BASE;
+        cfg.chips_len = MULTI_CHIPS;
+
+        hx711_multi_init(&hxm, &cfg);
+        hx711_multi_power_up(&hxm, hx711_gain_128);
+
+        const double start = now_ns();
+
+        for(uint32_t i = 0; i < count; ++i) {
+            hx711_multi_get_values(&hxm, values);
+            for(uint j = 0; j < MULTI_CHIPS; ++j) {
+                failures += values[j] != last_frame_value(cap, &devs[j]);
+            }
+        }
+
+        const double host = now_ns() - start;
+        const double emulated = (double)hostemu_cycles() * 1e9 / HOSTEMU_CLK_SYS_HZ;
+
+        hx711_multi_close(&hxm);
+
+        for(uint i = 0; i < MULTI_CHIPS; ++i) {
+            missed += devs[i].stats.missed;
+        }
+
+        failures += missed != 0;
+
+        printf("  %-28s %u values, %u mismatched, %u missed, %.0fx real time\n",
+            "hx711_multi_t", count * MULTI_CHIPS, failures, missed, emulated / host);
+
+        return failures;
+
+}
+
+int main(int argc, char** argv) {
+
+    const char* clockProbe = "CLK";
+    const char* dataProbe = "DAT";
+    const char* path = NULL;
+    bool verbose = false;
+
+    for(int i = 1; i < argc; ++i) {
+        if(strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        }
+        else if(strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            clockProbe = argv[++i];
+        }
+        else if(strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            dataProbe = argv[++i];
+        }
+        else {
+            path = argv[i];
+        }
+    }
+
+    if(path == NULL) {
+        fprintf(stderr, "usage: %s [-v] [-c clock_probe] [-d data_probe] capture.sr\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    hostemu_sr_capture_t cap;
+
+    if(!hostemu_sr_load(&cap, path, clockProbe, dataProbe)) {
+        fprintf(stderr, "%s: not a capture with probes %s and %s\n", path, clockProbe, dataProbe);
+        return EXIT_FAILURE;
+    }
+
+    int failures = report_capture(&cap, verbose);
+
+    if(cap.decoder.frames_len >= 2) {
+
+        failures += bench_decode(path, clockProbe, dataProbe, cap.decoder.frames_len);
+
+        //go around the capture a few times
+        const uint32_t count = (uint32_t)cap.decoder.frames_len * 4;
+
+        printf("replay\n");
+        failures += replay_single(&cap, count);
+        failures += replay_multi(&cap, count);
+
+    }
+
+    hostemu_sr_free(&cap);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
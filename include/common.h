@@ -24,7 +24,11 @@
 #define COMMON_H_D032FD58_DAFE_4AE1_8E48_54A388BFECE4
 
 #include "hx711.h"
+#include "hx711_calibration.h"
+#include "hx711_filter.h"
 #include "hx711_multi.h"
+#include "hx711_multi_group.h"
+#include "hx711_service.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,9 +36,11 @@ extern "C" {
 
 extern const hx711_config_t HX711__DEFAULT_CONFIG;
 extern const hx711_multi_config_t HX711__MULTI_DEFAULT_CONFIG;
+extern const hx711_multi_config_t HX711__MULTI_MASKED_DEFAULT_CONFIG;
 
 void hx711_get_default_config(hx711_config_t* const cfg);
 void hx711_multi_get_default_config(hx711_multi_config_t* const cfg);
+void hx711_multi_get_masked_default_config(hx711_multi_config_t* const cfg);
 
 #ifdef __cplusplus
 }
@@ -24,9 +24,11 @@
 #define HX711_H_0ED0E077_8980_484C_BB94_AF52973CDC09
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "hardware/pio.h"
 #include "pico/mutex.h"
+#include "hx711_stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,22 +41,94 @@ extern "C" {
             __VA_ARGS__ \
             mutex_exit(&mut); \
         } while(0)
+    //skips the block rather than waiting if the mutex is held
+    #define HX711_MUTEX_TRY_BLOCK(mut, ...) \
+        do { \
+            if(mutex_try_enter(&mut, NULL)) { \
+                __VA_ARGS__ \
+                mutex_exit(&mut); \
+            } \
+        } while(0)
 #else
     #define HX711_MUTEX_BLOCK(mut, ...) \
     do { \
         __VA_ARGS__ \
     } while(0)
+    #define HX711_MUTEX_TRY_BLOCK(mut, ...) \
+    do { \
+        __VA_ARGS__ \
+    } while(0)
 #endif
 
 #define HX711_READ_BITS                 UINT8_C(24)
 #define HX711_POWER_DOWN_TIMEOUT        UINT8_C(60) //microseconds
 
+/**
+ * @brief Range of PD_SCK (clock pin) frequencies the reader
+ * programs can be run at. Both programs hold the clock pin
+ * high for half of each period and low for the other half.
+ * The datasheet requires the high time (T3) and low time (T4)
+ * to each be at least 0.2us, and the high time to be at most
+ * 50us. Lower frequencies suit long cable runs.
+ */
+#define HX711_PD_SCK_MIN_HZ             UINT32_C(10000)
+#define HX711_PD_SCK_MAX_HZ             UINT32_C(2500000)
+#define HX711_PD_SCK_DEFAULT_HZ         HX711_PD_SCK_MAX_HZ
+
+/**
+ * @brief Half clock periods the reader adds to the 24 bits
+ * before a value is timed. The last bit is read while the
+ * clock pin is high. Its low half is not waited for.
+ */
+#define HX711_READ_OVERHEAD_HALVES      INT8_C(-1)
+
+/**
+ * @brief Interval between conversions below which the HX711
+ * is taken to be running at 80SPS (12.5ms) rather than 10SPS
+ * (100ms). It is far enough from both that a conversion missed
+ * at 80SPS is still taken as 80SPS.
+ */
+#define HX711_RATE_INTERVAL_THRESHOLD_US UINT32_C(40000) //microseconds
+
 #define HX711_MIN_VALUE                 INT32_C(-0x800000) //−8,388,608
 #define HX711_MAX_VALUE                 INT32_C(0x7fffff) //8,388,607
 
 #define HX711_PIO_MIN_GAIN              UINT8_C(0)
 #define HX711_PIO_MAX_GAIN              UINT8_C(2)
 
+/**
+ * @brief Number of bits above the 24 bit value in which the
+ * reader program gives the PIO gain the value was converted at.
+ */
+#define HX711_GAIN_TAG_BITS             UINT8_C(2)
+
+/**
+ * @brief Largest gain schedule (in words). As for streaming,
+ * DMA ring sizes are limited to 2^15 bytes.
+ */
+#define HX711_GAIN_SCHEDULE_MAX_LEN     UINT16_C(8192)
+
+/**
+ * @brief Largest ring buffer (in words) which can be used for
+ * streaming. DMA ring sizes are limited to 2^15 bytes.
+ */
+#define HX711_STREAM_MAX_LEN            UINT16_C(8192)
+
+/**
+ * @brief Number of transfers a streaming DMA channel is
+ * triggered with. The difference between this and the
+ * channel's remaining transfer count is the number of
+ * values written to the ring buffer.
+ */
+#define HX711_STREAM_TRANSFER_COUNT     UINT32_MAX
+
+/**
+ * @brief Default PIO IRQ index used to deliver values to a
+ * callback. This is the opposite index to the default used by
+ * hx711_multi_t so both can share a PIO.
+ */
+#define HX711_CALLBACK_PIO_IRQ_IDX      UINT8_C(1)
+
 extern const unsigned short HX711_SETTLING_TIMES[3]; //milliseconds
 extern const unsigned char HX711_SAMPLE_RATES[2];
 extern const unsigned char HX711_CLOCK_PULSES[3];
@@ -70,17 +144,83 @@ typedef enum {
     hx711_gain_64
 } hx711_gain_t;
 
+/**
+ * @brief A value published by hx711_publish.
+ */
+typedef struct {
+    int32_t value;
+    hx711_gain_t gain; //gain the value was converted at
+    uint32_t count; //number of values read from the HX711 up to and including this one
+    absolute_time_t time; //when the conversion ended
+} hx711_sample_t;
+
+/**
+ * @brief Called from an interrupt handler with each value
+ * obtained from the HX711, its count since callbacks started
+ * and when its conversion ended.
+ * 
+ * @param sample only valid for the duration of the call
+ * @param ctx pointer given to hx711_callback_start
+ */
+typedef void (*hx711_callback_t)(
+    const hx711_sample_t* const sample,
+    void* const ctx);
+
 typedef struct {
 
     uint _clock_pin;
     uint _data_pin;
 
+    uint32_t _pd_sck_hz;
+    uint32_t _read_time_us;
+
     PIO _pio;
     const pio_program_t* _reader_prog;
     pio_sm_config _reader_prog_default_config;
     uint _reader_sm;
     uint _reader_offset;
 
+    uint _dma_channel;
+    const volatile uint32_t* _stream_buffer;
+    size_t _stream_len;
+    uint32_t _stream_read_count;
+
+    uint _schedule_dma_channel;
+    const uint32_t* _schedule_buffer;
+    size_t _schedule_len;
+
+    //seqlock protecting the latest published value; odd while
+    //the value is being written
+    volatile uint32_t _latest_seq;
+    volatile int32_t _latest_value;
+    volatile hx711_gain_t _latest_gain;
+    volatile uint32_t _latest_count;
+    volatile uint64_t _latest_time_us;
+
+    bool _join_rx_fifo;
+
+    //gain last set, and whether a value converted at it has
+    //yet to be read; values at the gain before it may still be
+    //waiting in the RX FIFO until then. Old values counts
+    //those still to be read, or an upper bound of them
+    volatile hx711_gain_t _gain;
+    volatile bool _gain_pending;
+    volatile uint _gain_old_values;
+
+    //rate measured by hx711_detect_rate; the RATE pin is
+    //strapped in hardware, so it is kept across power downs
+    hx711_rate_t _rate;
+    bool _rate_detected;
+
+    uint _pio_irq_index;
+    hx711_callback_t _callback;
+    void* _callback_ctx;
+    uint32_t _callback_count;
+
+#ifdef HX711_STATS
+    hx711_stats_t _stats;
+#endif
+
 #ifndef HX711_NO_MUTEX
     mutex_t _mut;
 #endif
@@ -95,14 +235,47 @@ typedef struct {
     uint clock_pin;
     uint data_pin;
 
+    /**
+     * @brief Frequency of the clock pulses sent to the HX711,
+     * between HX711_PD_SCK_MIN_HZ and HX711_PD_SCK_MAX_HZ.
+     * It sets the reader State Machine's clock divider, and so
+     * how long each conversion takes to read; see
+     * hx711_get_read_time_us.
+     */
+    uint32_t pd_sck_hz;
+
     PIO pio;
     hx711_pio_init_t pio_init;
 
     const pio_program_t* reader_prog;
     hx711_program_init_t reader_prog_init;
 
+    /**
+     * @brief Whether the reader's TX FIFO should be joined to
+     * its RX FIFO, so that the state machine can hold 8 values
+     * instead of 4 before any are lost. The gain is then set
+     * by writing it directly to the state machine rather than
+     * through the TX FIFO. The reader program must support it.
+     */
+    bool join_rx_fifo;
+
+    /**
+     * @brief PIO IRQ index (0 or 1) used when values are
+     * delivered to a callback, and to wake the CPU while
+     * hx711_get_value* wait for a value. The handler is shared,
+     * so hx711_t instances on the same PIO can use the same
+     * index.
+     */
+    uint pio_irq_index;
+
 } hx711_config_t;
 
+/**
+ * @brief Array of hx for the callback ISR to access, indexed
+ * by PIO index and state machine. This is a global variable.
+ */
+extern hx711_t* hx711__callback_array[NUM_PIOS][NUM_PIO_STATE_MACHINES];
+
 void hx711_init(
     hx711_t* const hx,
     const hx711_config_t* const config);
@@ -115,7 +288,19 @@ void hx711_init(
 void hx711_close(hx711_t* const hx);
 
 /**
- * @brief Sets the HX711 gain.
+ * @brief Sets the HX711 gain. Never waits for a conversion;
+ * the gain is handed to the reader State Machine, which sets
+ * it after the conversion currently underway. Values already
+ * converted at the previous gain are not discarded; they are
+ * kept in the RX FIFO so that hx711_get_tagged_value can
+ * return them with the gain they were converted at. The
+ * untagged hx711_get_value* functions skip them instead, so
+ * that the next value they return is at the new gain.
+ * 
+ * This can also be called while streaming or while callbacks
+ * are running, in which case each value's gain is in its tag
+ * or hx711_sample_t. Use hx711_is_gain_set to find out when
+ * the change is complete.
  * 
  * @param hx 
  * @param gain 
@@ -124,6 +309,64 @@ void hx711_set_gain(
     hx711_t* const hx,
     const hx711_gain_t gain);
 
+/**
+ * @brief Returns true once the HX711 has converted a value at
+ * the gain last set with hx711_set_gain (or hx711_power_up).
+ * Values are not taken to find out, so this can be polled
+ * without reading. The untagged hx711_get_value* functions
+ * skip any values at an earlier gain still waiting to be
+ * read; hx711_get_tagged_value returns them.
+ * 
+ * This never waits. It returns false while another read holds
+ * the mutex, and while the RX FIFO is full of values at the
+ * earlier gain; the reader cannot convert at the new gain
+ * until one of them is read.
+ * 
+ * @param hx 
+ * @return true 
+ * @return false 
+ */
+bool hx711_is_gain_set(hx711_t* const hx);
+
+/**
+ * @brief Start a repeating schedule of gains. A DMA channel is
+ * claimed which keeps the reader State Machine's TX FIFO
+ * topped up from the schedule, so the state machine sets the
+ * next gain in the schedule after each value without any CPU
+ * involvement and without discarding any values. Use
+ * hx711_get_tagged_value (or hx711_get_raw_gain) to obtain
+ * the gain each value was converted at.
+ * 
+ * eg. alternating between channel A and channel B:
+ * static uint32_t buff[2] __aligned(2 * sizeof(uint32_t));
+ * const hx711_gain_t gains[2] = { hx711_gain_128, hx711_gain_32 };
+ * hx711_gain_schedule_start(&hx, buff, gains, 2);
+ * 
+ * @note The buffer must be naturally aligned to its size in
+ * bytes, as for hx711_stream_start, and len must be a power of
+ * 2 no larger than HX711_GAIN_SCHEDULE_MAX_LEN. The reader
+ * State Machine's FIFOs cannot be joined.
+ * 
+ * @param hx 
+ * @param buffer ring of PIO gains owned by the caller; filled
+ * from gains
+ * @param gains 
+ * @param len number of gains
+ */
+void hx711_gain_schedule_start(
+    hx711_t* const hx,
+    uint32_t* const buffer,
+    const hx711_gain_t* const gains,
+    const size_t len);
+
+/**
+ * @brief Stop the gain schedule and release its DMA channel.
+ * The HX711 stays at whichever gain was set last.
+ * 
+ * @param hx 
+ */
+void hx711_gain_schedule_stop(hx711_t* const hx);
+
 /**
  * @brief Convert a raw value from the HX711 to a 32-bit signed int.
  * 
@@ -169,6 +412,15 @@ unsigned short hx711_get_settling_time(const hx711_rate_t rate);
  */
 unsigned char hx711_get_rate_sps(const hx711_rate_t rate);
 
+/**
+ * @brief Returns the rate the HX711 is running at given the
+ * interval between two consecutive conversions.
+ * 
+ * @param us interval in microseconds
+ * @return hx711_rate_t 
+ */
+hx711_rate_t hx711_interval_us_to_rate(const uint64_t us);
+
 /**
  * @brief Returns the clock pulse count for a given gain value.
  * 
@@ -177,6 +429,18 @@ unsigned char hx711_get_rate_sps(const hx711_rate_t rate);
  */
 unsigned char hx711_get_clock_pulses(const hx711_gain_t gain);
 
+/**
+ * @brief Obtains a value from the HX711 along with the gain it
+ * was converted at. Blocks until a value is available.
+ * 
+ * @param hx 
+ * @param gain pointer to the gain the value was converted at
+ * @return int32_t 
+ */
+int32_t hx711_get_tagged_value(
+    hx711_t* const hx,
+    hx711_gain_t* const gain);
+
 /**
  * @brief Obtains a value from the HX711. Blocks until a value
  * is available.
@@ -186,6 +450,39 @@ unsigned char hx711_get_clock_pulses(const hx711_gain_t gain);
  */
 int32_t hx711_get_value(hx711_t* const hx);
 
+/**
+ * @brief Obtains len values from the HX711 in the order they
+ * were read. Blocks until all of them are available. This is
+ * equivalent to calling hx711_get_value len times, but only
+ * acquires the hx once.
+ * 
+ * @param hx 
+ * @param values array of at least len values to fill
+ * @param len number of values to obtain
+ */
+void hx711_get_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    const size_t len);
+
+/**
+ * @brief Obtains len values from the HX711 in the order they
+ * were read, along with the gain each was converted at. Blocks
+ * until all of them are available. This is equivalent to
+ * calling hx711_get_tagged_value len times, but only acquires
+ * the hx once.
+ * 
+ * @param hx 
+ * @param values array of at least len values to fill
+ * @param gains array of at least len gains to fill
+ * @param len number of values to obtain
+ */
+void hx711_get_tagged_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    hx711_gain_t* const gains,
+    const size_t len);
+
 /**
  * @brief Obtains a value from the HX711. Blocks until a value
  * is available or the timeout is reached.
@@ -214,6 +511,198 @@ bool hx711_get_value_noblock(
     hx711_t* const hx,
     int32_t* const val);
 
+/**
+ * @brief Start streaming values from the HX711 into a ring
+ * buffer. A DMA channel is claimed and paced by the reader
+ * State Machine's RX FIFO, so every value is copied into the
+ * buffer without any CPU involvement. While streaming, values
+ * must be obtained with the hx711_stream_* functions rather
+ * than hx711_get_value*.
+ * 
+ * @note The buffer must be naturally aligned to its size in
+ * bytes (ie. len * sizeof(uint32_t)) as required by the DMA
+ * ring, and len must be a power of 2 no larger than
+ * HX711_STREAM_MAX_LEN. eg.
+ * static uint32_t buff[64] __aligned(64 * sizeof(uint32_t));
+ * 
+ * @param hx 
+ * @param buffer ring buffer of raw values owned by the caller
+ * @param len number of words in buffer
+ */
+void hx711_stream_start(
+    hx711_t* const hx,
+    uint32_t* const buffer,
+    const size_t len);
+
+/**
+ * @brief Stop streaming values and release the DMA channel.
+ * Values which have not been read are discarded.
+ * 
+ * @param hx 
+ */
+void hx711_stream_stop(hx711_t* const hx);
+
+/**
+ * @brief Returns the total number of values written to the
+ * ring buffer since streaming started. The n-th value
+ * written is at index n % len of the buffer.
+ * 
+ * @param hx 
+ * @return uint32_t 
+ */
+uint32_t hx711_stream_get_count(hx711_t* const hx);
+
+/**
+ * @brief Returns the number of values in the ring buffer which
+ * have not yet been read. If the reader has fallen more than
+ * len values behind, the oldest values have been overwritten
+ * and are skipped.
+ * 
+ * @param hx 
+ * @param index pointer to the buffer index of the oldest unread
+ * value; may be NULL
+ * @return size_t 
+ */
+size_t hx711_stream_available(
+    hx711_t* const hx,
+    size_t* const index);
+
+/**
+ * @brief Mark values as read after accessing the ring buffer
+ * directly with the index from hx711_stream_available.
+ * 
+ * @param hx 
+ * @param count number of values to mark as read
+ */
+void hx711_stream_consume(
+    hx711_t* const hx,
+    const size_t count);
+
+/**
+ * @brief Copies up to len unread values from the ring buffer
+ * into an array, oldest first, and marks them as read. Never
+ * blocks.
+ * 
+ * @param hx 
+ * @param values 
+ * @param len maximum number of values to copy
+ * @return size_t number of values copied
+ */
+size_t hx711_stream_get_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    const size_t len);
+
+/**
+ * @brief As for hx711_stream_get_values, but also copies the
+ * gain each value was converted at.
+ * 
+ * @param hx 
+ * @param values 
+ * @param gains same length as values
+ * @param len maximum number of values to copy
+ * @return size_t number of values copied
+ */
+size_t hx711_stream_get_tagged_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    hx711_gain_t* const gains,
+    const size_t len);
+
+/**
+ * @brief Takes every value in the RX FIFO and publishes the
+ * newest so that it can be obtained with hx711_get_latest
+ * from any core without blocking. Never blocks and does not
+ * use the mutex, so it can be called from an interrupt
+ * handler or in a loop on one core.
+ * 
+ * As with callbacks, the sample's time is when hx711_publish
+ * was called less hx711_get_read_time_us, which is when the
+ * conversion ended if it is called as soon as the value
+ * arrives.
+ * 
+ * @note Only one core or interrupt handler should publish
+ * values. While publishing, values should only be obtained
+ * with hx711_get_latest rather than hx711_get_value*.
+ * 
+ * @param hx 
+ * @return true if a new value was published
+ * @return false if the RX FIFO was empty
+ */
+bool hx711_publish(hx711_t* const hx);
+
+/**
+ * @brief Obtains the value most recently published with
+ * hx711_publish. Never blocks on the mutex or the publisher;
+ * if a value is being published at the same time, the copy
+ * is retried. This takes at most a few cycles as publishing
+ * is done with interrupts disabled.
+ * 
+ * @param hx 
+ * @param sample pointer to the sample to set
+ * @return true if a value has been published
+ * @return false if no value has been published yet
+ */
+bool hx711_get_latest(
+    hx711_t* const hx,
+    hx711_sample_t* const sample);
+
+/**
+ * @brief Calls a function with each value as soon as it is
+ * available, from the interrupt handler for the PIO's RX FIFO
+ * not empty interrupt. The CPU is free, or can sleep with
+ * __wfi(), between values. While callbacks are running,
+ * values cannot be obtained with hx711_get_value*.
+ * 
+ * Each value's time is taken when the interrupt handler runs,
+ * less hx711_get_read_time_us, so it is when the conversion ended
+ * rather than when the application got around to the value.
+ * If the interrupt was held off for long enough that several
+ * values were waiting, they are given the same time.
+ * 
+ * @note The callback runs in interrupt context and should be
+ * short. Place it in RAM with __not_in_flash_func() so flash
+ * accesses do not delay it.
+ * 
+ * @param hx 
+ * @param callback 
+ * @param ctx pointer passed to each call of the callback; may
+ * be NULL
+ */
+void hx711_callback_start(
+    hx711_t* const hx,
+    const hx711_callback_t callback,
+    void* const ctx);
+
+/**
+ * @brief Stop calling the callback. Once this returns, the
+ * callback will not be called again.
+ * 
+ * @param hx 
+ */
+void hx711_callback_stop(hx711_t* const hx);
+
+#ifdef HX711_STATS
+/**
+ * @brief Copies the hx's statistics. Only available when
+ * HX711_STATS is defined.
+ * 
+ * @param hx 
+ * @param stats 
+ */
+void hx711_get_stats(
+    hx711_t* const hx,
+    hx711_stats_t* const stats);
+
+/**
+ * @brief Clears the hx's statistics. Only available when
+ * HX711_STATS is defined.
+ * 
+ * @param hx 
+ */
+void hx711_reset_stats(hx711_t* const hx);
+#endif
+
 /**
  * @brief Check whether the hx struct has been initalised.
  * 
@@ -233,6 +722,202 @@ static bool hx711__is_initd(hx711_t* const hx);
  */
 static bool hx711__is_state_machine_enabled(hx711_t* const hx);
 
+/**
+ * @brief Check whether the hx struct is streaming values
+ * via DMA.
+ * 
+ * @param hx 
+ * @return true 
+ * @return false 
+ */
+static bool hx711__is_streaming(hx711_t* const hx);
+
+/**
+ * @brief Check whether a gain schedule is running.
+ * 
+ * @param hx 
+ * @return true 
+ * @return false 
+ */
+static bool hx711__is_gain_scheduled(hx711_t* const hx);
+
+/**
+ * @brief Number of values the DMA channel has written to the
+ * ring buffer. Not mutex protected.
+ * 
+ * @param hx 
+ * @return uint32_t 
+ */
+static uint32_t hx711__stream_get_count(hx711_t* const hx);
+
+/**
+ * @brief Number of unread values in the ring buffer. Skips over
+ * any values which have been overwritten. Not mutex protected.
+ * 
+ * @param hx 
+ * @return size_t 
+ */
+static size_t hx711__stream_get_unread(hx711_t* const hx);
+
+/**
+ * @brief Check whether values are being delivered to a
+ * callback.
+ * 
+ * @param hx 
+ * @return true 
+ * @return false 
+ */
+static bool hx711__is_callback_running(hx711_t* const hx);
+
+/**
+ * @brief Check whether any other hx is using the same NVIC
+ * IRQ, in which case the shared handler is already installed.
+ * hx711__callback_array_mut must be held.
+ * 
+ * @param hx 
+ * @return true 
+ * @return false 
+ */
+static bool hx711__callback_irq_is_shared(hx711_t* const hx);
+
+/**
+ * @brief Registers the hx's state machine with the shared
+ * handler, installing it if no other hx on the same IRQ
+ * already has. The RX FIFO not empty source is left disabled.
+ * hx711__callback_array_mut must be held and interrupts must
+ * be disabled.
+ * 
+ * @param hx 
+ */
+static void hx711__irq_attach(hx711_t* const hx);
+
+/**
+ * @brief Unregisters the hx's state machine from the shared
+ * handler, removing it if no other hx on the same IRQ still
+ * needs it. hx711__callback_array_mut must be held and
+ * interrupts must be disabled.
+ * 
+ * @param hx 
+ */
+static void hx711__irq_detach(hx711_t* const hx);
+
+/**
+ * @brief Attaches the hx to the shared handler the first time
+ * a callback or blocking read needs it. Does nothing if it is
+ * already attached. The hx's mutex must be held.
+ * 
+ * @param hx 
+ */
+static void hx711__irq_acquire(hx711_t* const hx);
+
+/**
+ * @brief Detaches the hx from the shared handler if it is
+ * attached. Called from hx711_callback_stop and hx711_close.
+ * 
+ * @param hx 
+ */
+static void hx711__irq_release(hx711_t* const hx);
+
+/**
+ * @brief Enables or disables the RX FIFO not empty interrupt
+ * source of the hx's state machine.
+ * 
+ * @param hx 
+ * @param enabled 
+ */
+static void hx711__irq_set_source_enabled(
+    hx711_t* const hx,
+    const bool enabled);
+
+/**
+ * @brief Waits for a value from the RX FIFO by sleeping with
+ * __wfe until the RX FIFO not empty interrupt wakes the CPU,
+ * rather than polling the FIFO. The hx's mutex must be held.
+ * 
+ * @param hx 
+ * @param end time to give up at, or NULL to wait forever
+ * @param rawVal 
+ * @return true if a value was obtained
+ * @return false if end was reached first
+ */
+static bool hx711__wait_value(
+    hx711_t* const hx,
+    const absolute_time_t* const end,
+    uint32_t* const rawVal);
+
+/**
+ * @brief As for hx711__wait_value, but skips any values
+ * converted at the gain before the one last set with
+ * hx711_set_gain. The hx's mutex must be held.
+ * 
+ * @param hx 
+ * @param end time to give up at, or NULL to wait forever
+ * @param rawVal 
+ * @return true if a value was obtained
+ * @return false if end was reached first
+ */
+static bool hx711__wait_current_value(
+    hx711_t* const hx,
+    const absolute_time_t* const end,
+    uint32_t* const rawVal);
+
+/**
+ * @brief Returns true if the raw value was converted at the
+ * gain before the one last set with hx711_set_gain. Once a
+ * value at the new gain is seen, no later value can be at the
+ * previous gain, so no further values are checked and
+ * hx711_is_gain_set returns true. Every function which takes
+ * values from the reader calls this, which also counts off
+ * the values still at the previous gain.
+ * 
+ * @param hx 
+ * @param raw 
+ * @return true 
+ * @return false 
+ */
+static bool __not_in_flash_func(hx711__is_superseded)(
+    hx711_t* const hx,
+    const uint32_t raw);
+
+/**
+ * @brief ISR for the RX FIFO not empty interrupts of every hx
+ * using callbacks on the IRQ being serviced. Each hx is found
+ * directly from the state machines whose interrupt is set.
+ */
+static void __isr __not_in_flash_func(hx711__callback_irq_handler)();
+
+/**
+ * @brief Writes a value to the seqlock protected latest value.
+ * There must only be one writer.
+ * 
+ * @param hx 
+ * @param value 
+ * @param gain gain the value was converted at
+ * @param count number of values read from the HX711
+ * @param time when the value was read
+ */
+static void hx711__latest_write(
+    hx711_t* const hx,
+    const int32_t value,
+    const hx711_gain_t gain,
+    const uint32_t count,
+    const absolute_time_t time);
+
+#ifdef HX711_STATS
+/**
+ * @brief Records a value obtained by the application.
+ * 
+ * @param hx 
+ * @param startUs time_us_32() when the value was asked for
+ * @param full whether the RX FIFO was full before the value
+ * was taken from it
+ */
+static void hx711__stats_value(
+    hx711_t* const hx,
+    const uint32_t startUs,
+    const bool full);
+#endif
+
 /**
  * @brief Check whether the given value is valid for a HX711
  * implementation.
@@ -274,6 +959,52 @@ bool hx711_is_rate_valid(const hx711_rate_t r);
  */
 bool hx711_is_gain_valid(const hx711_gain_t g);
 
+/**
+ * @brief Check whether the given PD_SCK frequency is within
+ * the datasheet's clock pulse timings.
+ * 
+ * @param hz 
+ * @return true 
+ * @return false 
+ */
+bool hx711_is_pd_sck_hz_valid(const uint32_t hz);
+
+/**
+ * @brief Returns the time from a conversion ending until its
+ * last bit is read at the given PD_SCK frequency, in
+ * microseconds, rounded up. This is one clock period per bit
+ * plus HX711_READ_OVERHEAD_HALVES half periods.
+ * 
+ * @param hz 
+ * @return uint32_t 
+ */
+uint32_t hx711_pd_sck_hz_to_read_time_us(const uint32_t hz);
+
+/**
+ * @brief Returns the time to read HX711_READ_BITS bits at the
+ * given PD_SCK frequency plus a reader's overhead, in
+ * microseconds, rounded up. Shared by hx711_t and
+ * hx711_multi_t.
+ * 
+ * @param hz 
+ * @param overheadHalves half clock periods the reader adds
+ * @return uint32_t 
+ */
+uint32_t hx711__pd_sck_hz_to_read_time_us(
+    const uint32_t hz,
+    const int overheadHalves);
+
+/**
+ * @brief Returns the time taken to read each conversion at the
+ * PD_SCK frequency the hx was configured with, in microseconds,
+ * rounded up. This is the delay between a conversion ending and
+ * its value being available.
+ * 
+ * @param hx 
+ * @return uint32_t 
+ */
+uint32_t hx711_get_read_time_us(hx711_t* const hx);
+
 /**
  * @brief Power up the HX711 and start the internal read/write
  * functionality.
@@ -304,6 +1035,60 @@ void hx711_power_down(hx711_t* const hx);
  */
 void hx711_wait_settle(const hx711_rate_t rate);
 
+/**
+ * @brief Measures the rate the HX711 is running at from the
+ * interval between two consecutive conversions, which are
+ * read and discarded. The HX711 does not signal a conversion
+ * until it has settled, so calling this straight after
+ * hx711_power_up also waits for the HX711 to settle, taking
+ * about 62.5ms at 80SPS rather than the 400ms hx711_wait_settle
+ * would need to assume when the rate is unknown.
+ * 
+ * @param hx 
+ * @return hx711_rate_t 
+ */
+hx711_rate_t hx711_detect_rate(hx711_t* const hx);
+
+/**
+ * @brief Returns the rate measured by hx711_detect_rate, or
+ * hx711_rate_10 if it has not been measured, so that settling
+ * times and timeouts derived from it are never too short.
+ * 
+ * @param hx 
+ * @return hx711_rate_t 
+ */
+hx711_rate_t hx711_get_rate(hx711_t* const hx);
+
+/**
+ * @brief Returns true if hx711_detect_rate has measured the
+ * rate the HX711 is running at.
+ * 
+ * @param hx 
+ * @return true 
+ * @return false 
+ */
+bool hx711_is_rate_detected(hx711_t* const hx);
+
+/**
+ * @brief As for hx711_wait_settle, at the rate from
+ * hx711_get_rate.
+ * 
+ * @param hx 
+ */
+void hx711_wait_until_settled(hx711_t* const hx);
+
+/**
+ * @brief Returns a timeout for hx711_get_value_timeout of two
+ * conversions at the rate from hx711_get_rate, plus the time
+ * taken to read a value, in microseconds. A value arrives
+ * within one conversion period; the second allows for the
+ * HX711's oscillator running slow.
+ * 
+ * @param hx 
+ * @return uint 
+ */
+uint hx711_get_timeout_us(hx711_t* const hx);
+
 /**
  * @brief Convenience function for sleeping for the
  * appropriate amount of time to allow the HX711 to power
@@ -320,6 +1105,27 @@ void hx711_wait_power_down();
  */
 uint32_t hx711_gain_to_pio_gain(const hx711_gain_t gain);
 
+/**
+ * @brief Convert a numeric value for a PIO State Machine to a
+ * hx711_gain_t.
+ * 
+ * @param pioGain 
+ * @return hx711_gain_t 
+ */
+hx711_gain_t hx711_pio_gain_to_gain(const uint32_t pioGain);
+
+/**
+ * @brief Returns the gain a raw value from the reader program
+ * was converted at, from the bits above the value.
+ * 
+ * @note Reader programs other than hx711_reader may not tag
+ * values, in which case the gain appears to be 128.
+ * 
+ * @param raw 
+ * @return hx711_gain_t 
+ */
+hx711_gain_t hx711_get_raw_gain(const uint32_t raw);
+
 /**
  * @brief Attempts to obtain a value from the PIO RX FIFO if one is available.
  * 
@@ -0,0 +1,247 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HX711_CALIBRATION_H_D80730DA_01EC_4995_91CD_8978C242AE61
+#define HX711_CALIBRATION_H_D80730DA_01EC_4995_91CD_8978C242AE61
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hx711.h"
+#include "hx711_multi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of hx711_gain_t values, each of which has its
+ * own offset and scale.
+ */
+#define HX711_CALIBRATION_GAINS                 UINT8_C(3)
+
+/**
+ * @brief Largest number of fractional bits in a scale's
+ * multiplier.
+ */
+#define HX711_CALIBRATION_MAX_SHIFT             UINT8_C(31)
+
+/**
+ * @brief Number of values hx711_calibration_tare and
+ * hx711_calibration_get_values read with each call to
+ * hx711_get_tagged_values.
+ */
+#define HX711_CALIBRATION_BATCH_LEN             UINT8_C(16)
+
+/**
+ * @brief Offset and scale for one gain. A raw value is converted
+ * to ((raw - offset) * multiplier) >> shift, rounded to the
+ * nearest unit.
+ */
+typedef struct {
+    int32_t _offset;
+    int32_t _multiplier;
+    uint8_t _shift;
+} hx711_calibration_entry_t;
+
+/**
+ * @brief Converts raw HX711 values to whatever integer unit the
+ * scale was set in (eg. milligrams) without floating point. One
+ * entry is kept for each gain; each value is converted with the
+ * entry for the gain it was converted at.
+ */
+typedef struct {
+    hx711_calibration_entry_t _entries[HX711_CALIBRATION_GAINS];
+} hx711_calibration_t;
+
+/**
+ * @brief Initialise a calibration where every gain has an offset
+ * of 0 and a scale of 1, so values are output unchanged.
+ * 
+ * @param cal 
+ */
+void hx711_calibration_init(hx711_calibration_t* const cal);
+
+/**
+ * @brief Sets the raw value which is output as 0 at the given
+ * gain.
+ * 
+ * @param cal 
+ * @param gain 
+ * @param offset HX711_MIN_VALUE to HX711_MAX_VALUE
+ */
+void hx711_calibration_set_offset(
+    hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t offset);
+
+/**
+ * @brief Returns the raw value which is output as 0 at the
+ * given gain.
+ * 
+ * @param cal 
+ * @param gain 
+ * @return int32_t 
+ */
+int32_t hx711_calibration_get_offset(
+    const hx711_calibration_t* const cal,
+    const hx711_gain_t gain);
+
+/**
+ * @brief Sets the scale at the given gain such that counts raw
+ * values above the offset are output as units, eg. the raw
+ * difference measured with a known weight and that weight in
+ * milligrams. The multiplier and shift are chosen to keep as
+ * much precision as fits in 32 bits.
+ * 
+ * @param cal 
+ * @param gain 
+ * @param units 
+ * @param counts non-zero
+ */
+void hx711_calibration_set_scale(
+    hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t units,
+    const int32_t counts);
+
+/**
+ * @brief Sets the scale at the given gain directly as a
+ * fixed-point multiplier with shift fractional bits.
+ * 
+ * @param cal 
+ * @param gain 
+ * @param multiplier 
+ * @param shift 0 to HX711_CALIBRATION_MAX_SHIFT
+ */
+void hx711_calibration_set_multiplier(
+    hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t multiplier,
+    const uint8_t shift);
+
+/**
+ * @brief Converts a raw value with the offset and scale of the
+ * gain it was converted at. Results outside of the range of
+ * int32_t are saturated.
+ * 
+ * @param cal 
+ * @param gain gain the value was converted at
+ * @param raw 
+ * @return int32_t 
+ */
+int32_t hx711_calibration_apply(
+    const hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t raw);
+
+/**
+ * @brief Obtains a value from the HX711 with
+ * hx711_get_tagged_value and converts it at the gain it is
+ * tagged with.
+ * 
+ * @param cal 
+ * @param hx 
+ * @return int32_t 
+ */
+int32_t hx711_calibration_get_value(
+    const hx711_calibration_t* const cal,
+    hx711_t* const hx);
+
+/**
+ * @brief Obtains len values from the HX711 with
+ * hx711_get_tagged_values and converts each at the gain it is
+ * tagged with.
+ * 
+ * @param cal 
+ * @param hx 
+ * @param values array of at least len values to fill
+ * @param len 
+ */
+void hx711_calibration_get_values(
+    const hx711_calibration_t* const cal,
+    hx711_t* const hx,
+    int32_t* const values,
+    const size_t len);
+
+/**
+ * @brief Obtains values from the HX711s with
+ * hx711_multi_get_tagged_values and converts each with its own
+ * calibration at the gain they are tagged with.
+ * 
+ * @param cals array of one calibration for each chip
+ * @param hxm 
+ * @param values array of converted values for each chip
+ */
+void hx711_calibration_multi_get_values(
+    const hx711_calibration_t* const cals,
+    hx711_multi_t* const hxm,
+    int32_t* const values);
+
+/**
+ * @brief Sets the offset to the mean of the next samples values
+ * obtained from the HX711, so that the current load is output
+ * as 0. The offset is set for the gain the values are tagged
+ * with. If the gain changes partway through, the values at the
+ * previous gain are discarded and taring starts over.
+ * 
+ * @param cal 
+ * @param hx 
+ * @param samples number of values to average, greater than 0
+ */
+void hx711_calibration_tare(
+    hx711_calibration_t* const cal,
+    hx711_t* const hx,
+    const size_t samples);
+
+/**
+ * @brief Sets the offset of each chip's calibration to the mean
+ * of that chip's next samples values, for the gain the values
+ * are tagged with. If the gain changes partway through, taring
+ * starts over.
+ * 
+ * @param cals array of one calibration for each chip
+ * @param hxm 
+ * @param samples number of values to average, greater than 0
+ */
+void hx711_calibration_multi_tare(
+    hx711_calibration_t* const cals,
+    hx711_multi_t* const hxm,
+    const size_t samples);
+
+/**
+ * @brief Round a quotient to the nearest integer, with halves
+ * rounded away from zero.
+ * 
+ * @param num 
+ * @param den greater than 0
+ * @return int64_t 
+ */
+static int64_t hx711_calibration__div_round(
+    const int64_t num,
+    const int64_t den);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,362 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HX711_FILTER_H_9B81E9FD_15A6_4866_9F16_E5E7E551F671
+#define HX711_FILTER_H_9B81E9FD_15A6_4866_9F16_E5E7E551F671
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hx711.h"
+#include "hx711_multi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of fractional bits in IIR coefficients.
+ */
+#define HX711_FILTER_IIR_COEFF_BITS             UINT8_C(16)
+
+/**
+ * @brief Number of fractional bits kept in the IIR's state, in
+ * addition to the 24 bits of an HX711 value.
+ */
+#define HX711_FILTER_IIR_STATE_BITS             UINT8_C(8)
+
+/**
+ * @brief Converts a constant in the range (0, 1] to an IIR
+ * coefficient at compile time, eg. HX711_FILTER_IIR_COEFF(0.1).
+ */
+#define HX711_FILTER_IIR_COEFF(x) \
+    ((uint32_t)((x) * (double)(1u << HX711_FILTER_IIR_COEFF_BITS) + 0.5))
+
+/**
+ * @brief Maximum window length of a moving average stage. The
+ * sum of this many HX711 values fits in 32 bits, so no 64 bit
+ * arithmetic is needed.
+ */
+#define HX711_FILTER_MOVING_AVERAGE_MAX_LEN     UINT8_C(128)
+
+/**
+ * @brief Maximum window length of a median stage. The window
+ * is sorted on the stack each time a value is applied.
+ */
+#define HX711_FILTER_MEDIAN_MAX_LEN             UINT8_C(15)
+
+/**
+ * @brief Maximum number of channels in a filter bank; one for
+ * each chip of an hx711_multi_t.
+ */
+#define HX711_FILTER_BANK_MAX_CHANNELS          UINT8_C(32)
+
+typedef enum {
+    hx711_filter_type_moving_average = 0,
+    hx711_filter_type_median,
+    hx711_filter_type_iir,
+    hx711_filter_type_outlier
+} hx711_filter_type_t;
+
+/**
+ * @brief One stage of a filter. Initialise with one of the
+ * hx711_filter_*_init functions.
+ */
+typedef struct {
+
+    hx711_filter_type_t _type;
+
+    //moving average and median window, owned by the caller
+    int32_t* _window;
+    size_t _len;
+    size_t _count;
+    size_t _index;
+    int32_t _sum;
+
+    //iir coefficient and state, with HX711_FILTER_IIR_STATE_BITS
+    //fractional bits
+    uint32_t _coeff;
+    int32_t _state;
+
+    //outlier rejection
+    int32_t _threshold;
+    uint _max_rejects;
+    uint _rejects;
+    int32_t _last;
+
+    bool _primed;
+
+} hx711_filter_stage_t;
+
+/**
+ * @brief A pipeline of stages, each of which is applied to the
+ * output of the one before it.
+ */
+typedef struct {
+    hx711_filter_stage_t* _stages;
+    size_t _len;
+} hx711_filter_t;
+
+/**
+ * @brief The same moving average or IIR filter applied to
+ * several channels at once, such as every chip of an
+ * hx711_multi_t. State is kept as a structure of arrays, so
+ * each value applied updates contiguous arrays in one pass.
+ */
+typedef struct {
+
+    hx711_filter_type_t _type;
+    size_t _channels;
+
+    //moving average window, owned by the caller; one row of
+    //_channels values for each of _window_len values
+    int32_t* _window;
+    size_t _window_len;
+    size_t _count;
+    size_t _index;
+    int32_t _sum[HX711_FILTER_BANK_MAX_CHANNELS];
+
+    //iir coefficient and state, with HX711_FILTER_IIR_STATE_BITS
+    //fractional bits
+    uint32_t _coeff;
+    int32_t _state[HX711_FILTER_BANK_MAX_CHANNELS];
+
+    bool _primed;
+
+} hx711_filter_bank_t;
+
+/**
+ * @brief Initialise a stage which outputs the mean of the last
+ * len values.
+ * 
+ * @param stage 
+ * @param window array of len values for the stage to use
+ * @param len 1 to HX711_FILTER_MOVING_AVERAGE_MAX_LEN
+ */
+void hx711_filter_moving_average_init(
+    hx711_filter_stage_t* const stage,
+    int32_t* const window,
+    const size_t len);
+
+/**
+ * @brief Initialise a stage which outputs the median of the
+ * last len values. With an even number of values, the mean of
+ * the middle two is output.
+ * 
+ * @param stage 
+ * @param window array of len values for the stage to use
+ * @param len 1 to HX711_FILTER_MEDIAN_MAX_LEN
+ */
+void hx711_filter_median_init(
+    hx711_filter_stage_t* const stage,
+    int32_t* const window,
+    const size_t len);
+
+/**
+ * @brief Initialise a first-order IIR (exponential moving
+ * average) stage: y += coeff * (x - y). The first value
+ * applied is output as is.
+ * 
+ * @param stage 
+ * @param coeff coefficient with HX711_FILTER_IIR_COEFF_BITS
+ * fractional bits, greater than 0 and at most 1.0
+ */
+void hx711_filter_iir_init(
+    hx711_filter_stage_t* const stage,
+    const uint32_t coeff);
+
+/**
+ * @brief Initialise a stage which rejects values differing
+ * from the last accepted value by more than threshold, and
+ * outputs the last accepted value instead. After max_rejects
+ * consecutive rejections, the next value is accepted so that
+ * a genuine change is followed.
+ * 
+ * @param stage 
+ * @param threshold 
+ * @param max_rejects 
+ */
+void hx711_filter_outlier_init(
+    hx711_filter_stage_t* const stage,
+    const int32_t threshold,
+    const uint max_rejects);
+
+/**
+ * @brief Initialise a filter with an array of initialised
+ * stages. Nothing is allocated; the filter uses the given
+ * stages and their windows.
+ * 
+ * @param filter 
+ * @param stages 
+ * @param len 
+ */
+void hx711_filter_init(
+    hx711_filter_t* const filter,
+    hx711_filter_stage_t* const stages,
+    const size_t len);
+
+/**
+ * @brief Clears the history of every stage in the filter.
+ * 
+ * @param filter 
+ */
+void hx711_filter_reset(hx711_filter_t* const filter);
+
+/**
+ * @brief Apply a value to a single stage.
+ * 
+ * @param stage 
+ * @param value 
+ * @return int32_t output of the stage
+ */
+int32_t hx711_filter_stage_apply(
+    hx711_filter_stage_t* const stage,
+    const int32_t value);
+
+/**
+ * @brief Apply a value to each stage of the filter in turn.
+ * 
+ * @param filter 
+ * @param value 
+ * @return int32_t output of the last stage
+ */
+int32_t hx711_filter_apply(
+    hx711_filter_t* const filter,
+    const int32_t value);
+
+/**
+ * @brief Obtains a value from the HX711 with hx711_get_value
+ * and applies it to the filter.
+ * 
+ * @param filter 
+ * @param hx 
+ * @return int32_t filtered value
+ */
+int32_t hx711_filter_get_value(
+    hx711_filter_t* const filter,
+    hx711_t* const hx);
+
+/**
+ * @brief Obtains values from the HX711s with
+ * hx711_multi_get_values and applies each to its own filter.
+ * 
+ * @param filters array of one filter for each chip
+ * @param hxm 
+ * @param values array of filtered values for each chip
+ */
+void hx711_filter_multi_get_values(
+    hx711_filter_t* const filters,
+    hx711_multi_t* const hxm,
+    int32_t* const values);
+
+/**
+ * @brief Initialise a bank which outputs the mean of the last
+ * window_len values of each channel.
+ * 
+ * @param bank 
+ * @param channels 1 to HX711_FILTER_BANK_MAX_CHANNELS
+ * @param window array of window_len * channels values for the
+ * bank to use
+ * @param window_len 1 to HX711_FILTER_MOVING_AVERAGE_MAX_LEN
+ */
+void hx711_filter_bank_moving_average_init(
+    hx711_filter_bank_t* const bank,
+    const size_t channels,
+    int32_t* const window,
+    const size_t window_len);
+
+/**
+ * @brief Initialise a bank which applies a first-order IIR to
+ * each channel. See hx711_filter_iir_init.
+ * 
+ * @param bank 
+ * @param channels 1 to HX711_FILTER_BANK_MAX_CHANNELS
+ * @param coeff coefficient with HX711_FILTER_IIR_COEFF_BITS
+ * fractional bits, greater than 0 and at most 1.0
+ */
+void hx711_filter_bank_iir_init(
+    hx711_filter_bank_t* const bank,
+    const size_t channels,
+    const uint32_t coeff);
+
+/**
+ * @brief Clears the history of every channel in the bank.
+ * 
+ * @param bank 
+ */
+void hx711_filter_bank_reset(hx711_filter_bank_t* const bank);
+
+/**
+ * @brief Apply one value to each channel of the bank. The
+ * function is placed in RAM.
+ * 
+ * @param bank 
+ * @param in array of a value for each channel
+ * @param out array of a filtered value for each channel; may
+ * be the same array as in
+ */
+void hx711_filter_bank_apply(
+    hx711_filter_bank_t* const bank,
+    const int32_t* const in,
+    int32_t* const out);
+
+/**
+ * @brief Obtains values from the HX711s with
+ * hx711_multi_get_values and applies them to the bank, which
+ * must have a channel for each chip.
+ * 
+ * @param bank 
+ * @param hxm 
+ * @param values array of filtered values for each chip
+ */
+void hx711_filter_bank_multi_get_values(
+    hx711_filter_bank_t* const bank,
+    hx711_multi_t* const hxm,
+    int32_t* const values);
+
+/**
+ * @brief Round a quotient to the nearest integer, with halves
+ * rounded away from zero.
+ * 
+ * @param num 
+ * @param den greater than 0
+ * @return int32_t 
+ */
+static int32_t hx711_filter__div_round(
+    const int32_t num,
+    const int32_t den);
+
+/**
+ * @brief Median of the values in a stage's window.
+ * 
+ * @param stage 
+ * @return int32_t 
+ */
+static int32_t hx711_filter__median(
+    const hx711_filter_stage_t* const stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -38,7 +38,8 @@ extern "C" {
  * @brief PIO interrupt number which is set by the reader
  * PIO State Machine when a conversion period ends. It is
  * the period of time between a conversion ending and the
- * next period beginning.
+ * next period beginning. The reader State Machine's number
+ * is added to this, so each hx711_multi_t has its own.
  */
 #define HX711_MULTI_CONVERSION_DONE_IRQ_NUM     UINT8_C(0)
 
@@ -47,18 +48,11 @@ extern "C" {
  * awaiter and reader PIO State Machines to indicate when
  * data is ready to be retrieved. It is not used directly
  * within the main set of code, but is used to validate
- * that the IRQ number is properly available.
+ * that the IRQ number is properly available. The reader
+ * State Machine's number is added to this.
  */
 #define HX711_MULTI_DATA_READY_IRQ_NUM          UINT8_C(4)
 
-/**
- * @brief Only one instance of a hx711_multi can operate
- * within a PIO. So the maximum number of concurrent
- * asynchronous read processes is limited to the numeer of
- * PIOs available.
- */
-#define HX711_MULTI_ASYNC_READ_COUNT            UINT8_C(NUM_PIOS)
-
 /**
  * @brief IRQ index defaults for PIO and DMA.
  */
@@ -79,6 +73,35 @@ extern "C" {
  */
 #define HX711_MULTI_MAX_CHIPS                   UINT8_C(MIN(NUM_BANK0_GPIOS, 32))
 
+/**
+ * @brief Range of the number of words in the ring buffer
+ * continuous reads are written to. The ring must hold at least
+ * two frames so the latest complete frame is not overwritten
+ * until the one after it is being read. The DMA channel can
+ * wrap its write address on at most 2^15 bytes.
+ */
+#define HX711_MULTI_RING_MIN_LEN                UINT32_C(64)
+#define HX711_MULTI_RING_MAX_LEN                UINT32_C(8192)
+
+/**
+ * @brief Transfer count the continuous DMA channel is
+ * triggered with. The channel is re-triggered between
+ * conversions once fewer than half of these remain, so it
+ * never runs out while reads continue.
+ */
+#define HX711_MULTI_RING_TRANSFER_COUNT         UINT32_C(0x80000000)
+
+/**
+ * @brief Half clock periods the reader adds to the 24 bits
+ * before a conversion is timed. It clears the conversion done
+ * IRQ before the bits. After them, it moves and pushes the
+ * gain and sets the IRQ. Each of these four instructions takes
+ * a quarter of a clock period, as a bit takes four. That is
+ * one clock period in all. The 25th pulse and any gain pulses
+ * come later.
+ */
+#define HX711_MULTI_READ_OVERHEAD_HALVES        INT8_C(2)
+
 /**
  * @brief State of the read as it moves through the async process.
  */
@@ -94,6 +117,19 @@ typedef struct {
     uint _clock_pin;
     uint _data_pin_base;
     size_t _chips_len;
+    uint _pinvals_per_word;
+
+    uint32_t _pd_sck_hz;
+    uint32_t _read_time_us;
+
+    //the data pins, and the number of pins from the lowest to
+    //the highest of them which the state machines read
+    uint32_t _data_pin_mask;
+    uint _data_pins_width;
+
+    //offset of each chip's data pin from _data_pin_base, which
+    //is its column in each pinval
+    uint8_t _chip_cols[HX711_MULTI_MAX_CHIPS];
 
     PIO _pio;
 
@@ -108,13 +144,53 @@ typedef struct {
     uint _reader_offset;
 
     uint _dma_channel;
+    uint _ring_dma_channel;
+
+    //the words pushed for a conversion followed by the PIO
+    //gain it was converted at
+    uint32_t _buffer[HX711_READ_BITS + 1];
+
+    //every frame of continuous reads, one after another; frame
+    //n begins (n - 1) * buffer length words in, modulo its length
+    uint32_t* _ring;
+    uint32_t _ring_len;
 
-    uint32_t _buffer[HX711_READ_BITS];
+    //gain last set, and whether a conversion at it has yet to
+    //be read; conversions at the gain before it may still be
+    //read until then. Pulled is set once the reader is seen to
+    //have taken the gain
+    volatile hx711_gain_t _gain;
+    volatile bool _gain_pending;
+    volatile bool _gain_pulled;
+
+    //rate measured by hx711_multi_detect_rate
+    hx711_rate_t _rate;
+    bool _rate_detected;
+
+    uint _conversion_done_irq_num;
+    uint _data_ready_irq_num;
 
     uint _pio_irq_index;
     uint _dma_irq_index;
     volatile hx711_multi_async_state_t _async_state;
 
+    volatile bool _continuous;
+    volatile uint32_t _frame_count;
+
+    //the ring DMA channel's transfer count as of the end of
+    //the latest frame
+    volatile uint32_t _frame_remaining;
+
+    //when the conversion in _buffer, or the latest frame,
+    //ended, in microseconds since boot
+    volatile uint64_t _buffer_time_us;
+
+#ifdef HX711_STATS
+    hx711_stats_t _stats;
+    uint32_t _stats_start_us;
+    uint32_t _stats_frame;
+#endif
+
 #ifndef HX711_NO_MUTEX
     mutex_t _mut;
 #endif
@@ -131,6 +207,15 @@ typedef struct {
      */
     uint clock_pin;
 
+    /**
+     * @brief Frequency of the clock pulses sent to the HX711
+     * chips, between HX711_PD_SCK_MIN_HZ and HX711_PD_SCK_MAX_HZ.
+     * It sets the reader State Machine's clock divider, and so
+     * how long each conversion takes to read; see
+     * hx711_multi_get_read_time_us.
+     */
+    uint32_t pd_sck_hz;
+
     /**
      * @brief Lowest GPIO pin number connected to a HX711 chip.
      */
@@ -141,6 +226,26 @@ typedef struct {
      */
     size_t chips_len;
 
+    /**
+     * @brief Bitmask of the GPIO pins connected to the HX711
+     * chips, for when they are not next to each other. The chip
+     * on the lowest pin is chip 0, the next lowest is chip 1,
+     * and so on. If non-zero, data_pin_base and chips_len are
+     * ignored. If the pins are not contiguous, the masked awaiter
+     * program must be used.
+     */
+    uint32_t data_pin_mask;
+
+    /**
+     * @brief Whether the reader should pack as many pinvals as
+     * will fit into each word it pushes, instead of pushing one
+     * pinval per word. This reduces the number of DMA transfers
+     * for each conversion from 24 to as few as 1 (for a single
+     * chip) or 3 (for up to 4 chips). The reader program must
+     * support it.
+     */
+    bool pack_pinvals;
+
 
     /**
      * @brief Which index to use for a PIO interrupt. Either 0 or 1.
@@ -196,11 +301,19 @@ typedef struct {
 } hx711_multi_config_t;
 
 /**
- * @brief Array of hxm for ISR to access. This is a global
- * variable.
+ * @brief hxms for the PIO ISR to access, indexed by PIO
+ * index and conversion done PIO interrupt number. This is a
+ * global variable.
  */
-extern hx711_multi_t* hx711_multi__async_read_array[
-    HX711_MULTI_ASYNC_READ_COUNT];
+extern hx711_multi_t* hx711_multi__async_pio_array[
+    NUM_PIOS][NUM_PIO_STATE_MACHINES];
+
+/**
+ * @brief hxms for the DMA ISR to access, indexed by DMA
+ * channel. This is a global variable.
+ */
+extern hx711_multi_t* hx711_multi__async_dma_array[
+    NUM_DMA_CHANNELS];
 
 static void hx711_multi__init_asert(
     const hx711_multi_config_t* const config);
@@ -212,6 +325,29 @@ static void hx711_multi__init_asert(
  */
 static void hx711_multi__init_pio(hx711_multi_t* const hxm);
 
+/**
+ * @brief Sets the data pin mask of the hxm from the config,
+ * along with the window of pins the state machines read and
+ * the column of each chip within it.
+ * 
+ * @param hxm 
+ * @param config 
+ */
+static void hx711_multi__init_data_pins(
+    hx711_multi_t* const hxm,
+    const hx711_multi_config_t* const config);
+
+/**
+ * @brief Whether the data pins of the hxm are next to each
+ * other, in which case each chip's column is its index.
+ * 
+ * @param hxm 
+ * @return true 
+ * @return false 
+ */
+static bool hx711_multi__is_contiguous(
+    const hx711_multi_t* const hxm);
+
 /**
  * @brief Subroutine for initialising DMA.
  * 
@@ -227,51 +363,70 @@ static void hx711_multi__init_dma(hx711_multi_t* const hxm);
 static void hx711_multi__init_irq(hx711_multi_t* const hxm);
 
 /**
- * @brief Whether a given hxm is the cause of the current
- * DMA IRQ.
+ * @brief Whether another hxm shares the hxm's PIO IRQ, and
+ * therefore the PIO ISR.
  * 
  * @param hxm 
  * @return true 
  * @return false 
  */
-static bool hx711_multi__async_dma_irq_is_set(
-    hx711_multi_t* const hxm);
+static bool hx711_multi__async_pio_irq_is_shared(
+    const hx711_multi_t* const hxm);
 
 /**
- * @brief Whether a given hxm is the cause of the current
- * PIO IRQ.
+ * @brief Whether another hxm shares the hxm's DMA IRQ, and
+ * therefore the DMA ISR.
  * 
  * @param hxm 
  * @return true 
  * @return false 
  */
-static bool hx711_multi__async_pio_irq_is_set(
-    hx711_multi_t* const hxm);
+static bool hx711_multi__async_dma_irq_is_shared(
+    const hx711_multi_t* const hxm);
 
 /**
- * @brief Get the hxm which caused the current DMA IRQ. Returns
- * NULL if none found.
+ * @brief Triggers DMA reading; moves request state from WAITING to READING.
  * 
- * @return hx711_multi_t* const 
+ * @param hxm 
  */
-static hx711_multi_t* const hx711_multi__async_get_dma_irq_request();
+static void hx711_multi__async_start_dma(
+    hx711_multi_t* const hxm);
 
 /**
- * @brief Get the hxm which caused the current PIO IRQ. Returns
- * NULL if none found.
+ * @brief Waits for the next conversion period to begin and
+ * then triggers DMA. Must be called with interrupts disabled.
  * 
- * @return hx711_multi_t* const 
+ * @param hxm 
  */
-static hx711_multi_t* const hx711_multi__async_get_pio_irq_request();
+static void hx711_multi__async_arm(
+    hx711_multi_t* const hxm);
 
 /**
- * @brief Triggers DMA reading; moves request state from WAITING to READING.
+ * @brief Starts the ring DMA channel for continuous reads.
+ * Must be called while the conversion done IRQ is set and
+ * after the RX FIFO is cleared, so the ring is aligned to
+ * whole conversions.
  * 
  * @param hxm 
  */
-static void hx711_multi__async_start_dma(
+static void hx711_multi__continuous_start_dma(
     hx711_multi_t* const hxm);
 
+/**
+ * @brief Called from the PIO ISR in continuous mode when a
+ * conversion period ends. The number of frames completed is
+ * counted from the words the reader has pushed, so frames
+ * which ended while the ISR was delayed are still counted,
+ * and the latest is published along with when its conversion
+ * ended.
+ * 
+ * @param hxm 
+ * @param timeUs when the conversion ended
+ */
+static void hx711_multi__continuous_frame_done(
+    hx711_multi_t* const hxm,
+    const uint64_t timeUs);
+
 /**
  * @brief Check whether an async read is currently occurring.
  * 
@@ -292,28 +447,48 @@ static void hx711_multi__async_finish(
     hx711_multi_t* const hxm);
 
 /**
- * @brief ISR handler for PIO IRQs.
+ * @brief Handles the end of a conversion period for the hxm
+ * from the PIO ISR; moves request state from WAITING to
+ * READING.
+ * 
+ * @param hxm 
+ */
+static void __not_in_flash_func(hx711_multi__async_pio_irq)(
+    hx711_multi_t* const hxm);
+
+/**
+ * @brief Handles completed DMA transfers for the hxm from
+ * the DMA ISR.
+ * 
+ * @param hxm 
+ * @param timeUs when the conversion which was read ended
+ */
+static void __not_in_flash_func(hx711_multi__async_dma_irq)(
+    hx711_multi_t* const hxm,
+    const uint64_t timeUs);
+
+/**
+ * @brief ISR handler for PIO IRQs. Shared by every hxm using
+ * the same PIO IRQ.
  */
 static void __isr __not_in_flash_func(hx711_multi__async_pio_irq_handler)();
 
 /**
- * @brief ISR handler for DMA IRQs.
+ * @brief ISR handler for DMA IRQs. Shared by every hxm using
+ * the same DMA IRQ.
  */
 static void __isr __not_in_flash_func(hx711_multi__async_dma_irq_handler)();
 
 /**
- * @brief Adds hxm to the array for ISR access. Returns false
- * if no space.
+ * @brief Adds hxm to the arrays for ISR access.
  * 
  * @param hxm 
- * @return true 
- * @return false 
  */
-static bool hx711_multi__async_add_reader(
+static void hx711_multi__async_add_reader(
     hx711_multi_t* const hxm);
 
 /**
- * @brief Removes the given hxm from the request array.
+ * @brief Removes the given hxm from the arrays for ISR access.
  * 
  * @param hxm 
  */
@@ -340,6 +515,93 @@ static bool hx711_multi__is_initd(hx711_multi_t* const hxm);
 static bool hx711_multi__is_state_machines_enabled(
     hx711_multi_t* const hxm);
 
+/**
+ * @brief Returns the number of pinvals which can be packed into
+ * a single word pushed from the reader. This is the largest
+ * divisor of HX711_READ_BITS which keeps the bits in a word
+ * within 32.
+ * 
+ * @param chips_len 
+ * @return uint 
+ */
+static uint hx711_multi__get_pinvals_per_word(const size_t chips_len);
+
+/**
+ * @brief Returns the number of words the reader pushes for
+ * each conversion, including the gain after its bits.
+ * 
+ * @param hxm 
+ * @return uint 
+ */
+static uint hx711_multi__get_buffer_len(hx711_multi_t* const hxm);
+
+/**
+ * @brief Convert a buffer read from the reader to regular HX711
+ * values, unpacking the pinvals first if necessary.
+ * 
+ * @param hxm 
+ * @param buffer 
+ * @param values 
+ */
+static void hx711_multi__buffer_to_values(
+    hx711_multi_t* const hxm,
+    const uint32_t* const buffer,
+    int32_t* const values);
+
+/**
+ * @brief Returns the gain the conversion in a buffer read from
+ * the reader was converted at.
+ * 
+ * @param hxm 
+ * @param buffer 
+ * @return hx711_gain_t 
+ */
+static hx711_gain_t hx711_multi__buffer_to_gain(
+    hx711_multi_t* const hxm,
+    const uint32_t* const buffer);
+
+/**
+ * @brief Copies the gain of the latest continuous frame in the
+ * same way as hx711_multi_continuous_get_values, without
+ * taking its values.
+ * 
+ * @param hxm 
+ * @param gain 
+ * @return true if a frame has been read
+ * @return false if no frame has been read yet
+ */
+static bool hx711_multi__continuous_get_gain(
+    hx711_multi_t* const hxm,
+    hx711_gain_t* const gain);
+
+/**
+ * @brief Clears the pending gain once a conversion at it has
+ * ended, using the reader's FIFOs and conversion done IRQ
+ * rather than reading the conversion. Nothing must be reading
+ * from the reader; the hxm's mutex must be held.
+ * 
+ * @param hxm 
+ */
+static void hx711_multi__poll_gain(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns true if a conversion read at the given gain
+ * was at the gain before the one last set with
+ * hx711_multi_set_gain. Once a conversion at the new gain is
+ * seen, no later one can be at the previous gain, so no
+ * further conversions are checked and hx711_multi_is_gain_set
+ * returns true. Every function which obtains values calls
+ * this.
+ * 
+ * @param hxm 
+ * @param gain gain the conversion was read at
+ * @return true 
+ * @return false 
+ */
+static bool hx711_multi__is_superseded(
+    hx711_multi_t* const hxm,
+    const hx711_gain_t gain);
+
 /**
  * @brief Convert an array of pinvals to regular HX711
  * values.
@@ -365,7 +627,16 @@ void hx711_multi_init(
 void hx711_multi_close(hx711_multi_t* const hxm);
 
 /**
- * @brief Sets the HX711s' gain.
+ * @brief Sets the HX711s' gain. Never waits for a conversion;
+ * the gain is handed to the reader State Machine, which sets
+ * it after the conversion currently underway. No conversion
+ * is read and discarded; hx711_multi_get_values and
+ * hx711_multi_get_values_timeout skip any conversions still at
+ * the previous gain, and the async and continuous functions
+ * read every conversion along with the gain it was converted
+ * at. This can also be called while continuous reads are
+ * running. Use hx711_multi_is_gain_set to find out when the
+ * change is complete.
  * 
  * @param hxm 
  * @param gain 
@@ -374,6 +645,23 @@ void hx711_multi_set_gain(
     hx711_multi_t* const hxm,
     const hx711_gain_t gain);
 
+/**
+ * @brief Returns true once a conversion at the gain last set
+ * with hx711_multi_set_gain (or hx711_multi_power_up) has
+ * ended, whether or not it has been read. This can be polled
+ * without reading. hx711_multi_get_values and
+ * hx711_multi_get_values_timeout never return a conversion at
+ * an earlier gain; an async read already underway may.
+ * 
+ * This never waits; it returns false while another read
+ * holds the mutex.
+ * 
+ * @param hxm 
+ * @return true 
+ * @return false 
+ */
+bool hx711_multi_is_gain_set(hx711_multi_t* const hxm);
+
 /**
  * @brief Fill an array with one value from each HX711. Blocks
  * until values are obtained.
@@ -401,6 +689,22 @@ bool hx711_multi_get_values_timeout(
     int32_t* const values,
     const uint timeout);
 
+/**
+ * @brief Fill an array with one value from each HX711 along
+ * with the gain they were converted at. Blocks until values
+ * are obtained. Unlike hx711_multi_get_values, values at the
+ * gain before the one last set are returned rather than
+ * skipped.
+ * 
+ * @param hxm 
+ * @param values 
+ * @param gain pointer to the gain the values were converted at
+ */
+void hx711_multi_get_tagged_values(
+    hx711_multi_t* const hxm,
+    int32_t* const values,
+    hx711_gain_t* const gain);
+
 /**
  * @brief Start an asynchronos read. This function is not
  * mutex protected.
@@ -409,6 +713,27 @@ bool hx711_multi_get_values_timeout(
  */
 void hx711_multi_async_start(hx711_multi_t* const hxm);
 
+/**
+ * @brief Waits for any asynchronous read in progress to finish
+ * and acquires hxm for the next, which must then be started
+ * with hx711_multi_async_start_acquired. Used to start reads
+ * on several hx711_multi_t together with interrupts disabled,
+ * as acquiring may block until a read's interrupt handler
+ * releases hxm.
+ * 
+ * @param hxm 
+ */
+void hx711_multi_async_acquire(hx711_multi_t* const hxm);
+
+/**
+ * @brief Start an asynchronous read on a hxm acquired with
+ * hx711_multi_async_acquire. Must be called with interrupts
+ * disabled.
+ * 
+ * @param hxm 
+ */
+void hx711_multi_async_start_acquired(hx711_multi_t* const hxm);
+
 /**
  * @brief Check whether an asynchronous read is complete.
  * This function is not mutex protected.
@@ -421,7 +746,9 @@ bool hx711_multi_async_done(hx711_multi_t* const hxm);
 
 /**
  * @brief Get the values from the last asynchronous read.
- * This function is not mutex protected.
+ * Values at any gain are returned; use
+ * hx711_multi_async_get_gain to tell which. This function is
+ * not mutex protected.
  * 
  * @param hxm 
  * @param values 
@@ -430,6 +757,193 @@ void hx711_multi_async_get_values(
     hx711_multi_t* const hxm,
     int32_t* const values);
 
+/**
+ * @brief Get when the conversion read by the last asynchronous
+ * read ended. This is taken in the DMA interrupt handler, less
+ * hx711_multi_get_read_time_us, so it does not include any delay before
+ * the values are obtained.
+ * 
+ * @param hxm 
+ * @return absolute_time_t 
+ */
+absolute_time_t hx711_multi_async_get_time(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns the time from a conversion ending until its
+ * values have been read at the given PD_SCK frequency, in
+ * microseconds, rounded up. This is one clock period per bit
+ * plus HX711_MULTI_READ_OVERHEAD_HALVES half periods.
+ * 
+ * @param hz 
+ * @return uint32_t 
+ */
+uint32_t hx711_multi_pd_sck_hz_to_read_time_us(const uint32_t hz);
+
+/**
+ * @brief Returns the time taken to read each conversion at the
+ * PD_SCK frequency the hxm was configured with, in
+ * microseconds, rounded up. This is the delay between a
+ * conversion ending and its values being available.
+ * 
+ * @param hxm 
+ * @return uint32_t 
+ */
+uint32_t hx711_multi_get_read_time_us(hx711_multi_t* const hxm);
+
+/**
+ * @brief Measures the rate the HX711s are running at from the
+ * times of two consecutive conversions, which are read and
+ * discarded. As with hx711_detect_rate, calling this straight
+ * after hx711_multi_power_up also waits for the chips to settle.
+ * 
+ * @param hxm 
+ * @return hx711_rate_t 
+ */
+hx711_rate_t hx711_multi_detect_rate(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns the rate measured by hx711_multi_detect_rate,
+ * or hx711_rate_10 if it has not been measured.
+ * 
+ * @param hxm 
+ * @return hx711_rate_t 
+ */
+hx711_rate_t hx711_multi_get_rate(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns true if hx711_multi_detect_rate has measured
+ * the rate the HX711s are running at.
+ * 
+ * @param hxm 
+ * @return true 
+ * @return false 
+ */
+bool hx711_multi_is_rate_detected(hx711_multi_t* const hxm);
+
+/**
+ * @brief As for hx711_wait_settle, at the rate from
+ * hx711_multi_get_rate.
+ * 
+ * @param hxm 
+ */
+void hx711_multi_wait_until_settled(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns a timeout for hx711_multi_get_values_timeout
+ * of two conversions at the rate from hx711_multi_get_rate,
+ * plus the time taken to read them, in microseconds.
+ * Values arrive within one conversion period; the second allows
+ * for the HX711s' oscillators running slow.
+ * 
+ * @param hxm 
+ * @return uint 
+ */
+uint hx711_multi_get_timeout_us(hx711_multi_t* const hxm);
+
+/**
+ * @brief Get the gain the conversion read by the last
+ * asynchronous read was converted at. This function is not
+ * mutex protected.
+ * 
+ * @param hxm 
+ * @return hx711_gain_t 
+ */
+hx711_gain_t hx711_multi_async_get_gain(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns false if the conversion read by the last
+ * asynchronous read was at the gain before the one last set
+ * with hx711_multi_set_gain. Once a conversion at the new gain
+ * has been seen, no later one can be at the previous gain, so
+ * this returns true until the gain is next set. This function
+ * is not mutex protected.
+ * 
+ * @param hxm 
+ * @return true 
+ * @return false 
+ */
+bool hx711_multi_async_is_gain_current(hx711_multi_t* const hxm);
+
+/**
+ * @brief Start reading every conversion into a ring buffer.
+ * A second DMA channel writes each frame after the last and
+ * wraps its write address in hardware, so the CPU is never
+ * needed to re-arm a read and a delayed ISR cannot cause
+ * writes outside the ring. The PIO ISR only counts and
+ * publishes the frames which have completed. While running,
+ * the blocking and async read functions cannot be used.
+ * 
+ * @note The ring must be naturally aligned to its size in
+ * bytes (ie. len * sizeof(uint32_t)) as required by the DMA
+ * ring, and len must be a power of 2 from
+ * HX711_MULTI_RING_MIN_LEN to HX711_MULTI_RING_MAX_LEN. A
+ * longer ring keeps more frames before they are overwritten.
+ * eg.
+ * static uint32_t ring[64] __aligned(64 * sizeof(uint32_t));
+ * 
+ * @param hxm 
+ * @param ring ring buffer owned by the caller
+ * @param len number of words in ring
+ */
+void hx711_multi_continuous_start(
+    hx711_multi_t* const hxm,
+    uint32_t* const ring,
+    const size_t len);
+
+/**
+ * @brief Stop continuous reads and release the second DMA
+ * channel.
+ * 
+ * @param hxm 
+ */
+void hx711_multi_continuous_stop(hx711_multi_t* const hxm);
+
+/**
+ * @brief Check whether continuous reads are running.
+ * 
+ * @param hxm 
+ * @return true 
+ * @return false 
+ */
+bool hx711_multi_continuous_is_running(hx711_multi_t* const hxm);
+
+/**
+ * @brief Returns the number of frames completed since
+ * continuous reads started. Compare against the frame number
+ * from hx711_multi_continuous_get_values to detect new or
+ * missed frames.
+ * 
+ * @param hxm 
+ * @return uint32_t 
+ */
+uint32_t hx711_multi_continuous_get_frame_count(
+    hx711_multi_t* const hxm);
+
+/**
+ * @brief Fill an array with the values from the latest complete
+ * frame. Does not block. A frame remains valid for an entire
+ * conversion period after it completes, and a frame which is
+ * overwritten while it is being converted is discarded in favour
+ * of the newer frame.
+ * 
+ * @param hxm 
+ * @param values 
+ * @param frame pointer to the number of the frame the values came
+ * from, starting at 1; may be NULL
+ * @param time pointer to when the frame's conversion ended, as
+ * for hx711_multi_async_get_time; may be NULL
+ * @param gain pointer to the gain the frame was converted at;
+ * may be NULL
+ * @return true if values were obtained
+ * @return false if no frame has completed yet
+ */
+bool hx711_multi_continuous_get_values(
+    hx711_multi_t* const hxm,
+    int32_t* const values,
+    uint32_t* const frame,
+    absolute_time_t* const time,
+    hx711_gain_t* const gain);
+
 /**
  * @brief Power up each HX711 and start the internal read/write
  * functionality.
@@ -451,6 +965,18 @@ void hx711_multi_power_up(
  */
 void hx711_multi_power_down(hx711_multi_t* const hxm);
 
+/**
+ * @brief Drives the clock pin low, which powers up the chips of
+ * a powered down hxm so they begin converting, without starting
+ * its state machines. hx711_multi_power_up must be called
+ * afterwards; it also does this first. Used with interrupts
+ * disabled to power up the chips of several hx711_multi_t at
+ * the same moment. This function is not mutex protected.
+ * 
+ * @param hxm 
+ */
+void hx711_multi_release_clock_pin(hx711_multi_t* const hxm);
+
 /**
  * @brief Attempt to synchronise all connected chips. This
  * does not include a settling time.
@@ -465,6 +991,9 @@ void hx711_multi_sync(
 /**
  * @brief Returns the state of each chip as a bitmask. The 0th
  * bit is the first chip, 1th bit is the second, and so on.
+ * When the data pins are not contiguous, the masked awaiter does
+ * not push the pin states, so they are read from the GPIO pins
+ * directly.
  * 
  * @param hxm 
  * @return uint32_t 
@@ -482,6 +1011,27 @@ uint32_t hx711_multi_get_sync_state(
 bool hx711_multi_is_syncd(
     hx711_multi_t* const hxm);
 
+#ifdef HX711_STATS
+/**
+ * @brief Copies the hxm's statistics. Only available when
+ * HX711_STATS is defined.
+ * 
+ * @param hxm 
+ * @param stats 
+ */
+void hx711_multi_get_stats(
+    hx711_multi_t* const hxm,
+    hx711_stats_t* const stats);
+
+/**
+ * @brief Clears the hxm's statistics. Only available when
+ * HX711_STATS is defined.
+ * 
+ * @param hxm 
+ */
+void hx711_multi_reset_stats(hx711_multi_t* const hxm);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
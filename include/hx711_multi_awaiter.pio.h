@@ -23,9 +23,9 @@ static const uint16_t hx711_multi_awaiter_program_instructions[] = {
     0xa046, //  1: mov    y, isr                     
     0x8000, //  2: push   noblock                    
     0x0066, //  3: jmp    !y, 6                      
-    0xc044, //  4: irq    clear 4                    
+    0xc057, //  4: irq    clear 7 rel                
     0x0000, //  5: jmp    0                          
-    0xc004, //  6: irq    nowait 4                   
+    0xc017, //  6: irq    nowait 7 rel               
             //     .wrap
 };
 
@@ -72,6 +72,10 @@ void hx711_multi_awaiter_program_init(hx711_multi_t* const hxm) {
     assert(hxm != NULL);
     assert(hxm->_pio != NULL);
     assert(hxm->_chips_len > 0);
+    //this program reads all of the pins between the lowest
+    //and highest data pins, so they must all be data pins.
+    //hx711_multi_masked_awaiter allows gaps
+    assert(hxm->_data_pins_width == hxm->_chips_len);
     pio_sm_config cfg = hx711_multi_awaiter_program_get_default_config(
         hxm->_awaiter_offset);
     //replace placeholder in instruction with the number of pins
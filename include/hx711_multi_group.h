@@ -0,0 +1,167 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HX711_MULTI_GROUP_H_C98B9E53_B82F_4F6C_9A9D_9BF438D4EB59
+#define HX711_MULTI_GROUP_H_C98B9E53_B82F_4F6C_9A9D_9BF438D4EB59
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/types.h"
+#include "hx711.h"
+#include "hx711_multi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Several hx711_multi_t, such as one on each PIO, read
+ * together as if they were one. Each member has its own clock
+ * pin and state machines; the group starts their reads at the
+ * same time and places their values one after the other in a
+ * single array.
+ */
+typedef struct {
+    hx711_multi_t* _members;
+    size_t _len;
+    size_t _chips_len;
+} hx711_multi_group_t;
+
+/**
+ * @brief Initialise a group from an array of hx711_multi_t which
+ * have each been initialised with hx711_multi_init. Nothing is
+ * allocated; the group uses the given array.
+ * 
+ * @param group 
+ * @param members 
+ * @param len at least 1
+ */
+void hx711_multi_group_init(
+    hx711_multi_group_t* const group,
+    hx711_multi_t* const members,
+    const size_t len);
+
+/**
+ * @brief Returns the number of chips in all members, which is
+ * the length of the array filled by the group's get_values
+ * functions.
+ * 
+ * @param group 
+ * @return size_t 
+ */
+size_t hx711_multi_group_get_chips_len(
+    const hx711_multi_group_t* const group);
+
+/**
+ * @brief Power up every member. Each member's chips are powered
+ * up together, but the members are powered up one after
+ * another, so their conversions are not aligned; use
+ * hx711_multi_group_sync for that.
+ * 
+ * @related hx711_wait_settle
+ * @param group 
+ * @param gain 
+ */
+void hx711_multi_group_power_up(
+    hx711_multi_group_t* const group,
+    const hx711_gain_t gain);
+
+/**
+ * @brief Power down every member.
+ * 
+ * @related hx711_wait_power_down
+ * @param group 
+ */
+void hx711_multi_group_power_down(hx711_multi_group_t* const group);
+
+/**
+ * @brief Power down every member, then power all of their chips
+ * up at the same moment so that they convert in step, as
+ * hx711_multi_sync does for the chips of one hx711_multi_t.
+ * 
+ * @related hx711_wait_settle
+ * @param group 
+ * @param gain 
+ */
+void hx711_multi_group_sync(
+    hx711_multi_group_t* const group,
+    const hx711_gain_t gain);
+
+/**
+ * @brief Sets the gain of every member. As for
+ * hx711_multi_set_gain, hx711_multi_group_get_values skips
+ * conversions still at the previous gain.
+ * 
+ * @param group 
+ * @param gain 
+ */
+void hx711_multi_group_set_gain(
+    hx711_multi_group_t* const group,
+    const hx711_gain_t gain);
+
+/**
+ * @brief Starts an asynchronous read on every member. They are
+ * all started with interrupts disabled, so each reads the
+ * first conversion to end on its chips after this is called.
+ * 
+ * @param group 
+ */
+void hx711_multi_group_async_start(hx711_multi_group_t* const group);
+
+/**
+ * @brief Check whether every member's asynchronous read has
+ * completed.
+ * 
+ * @param group 
+ * @return true 
+ * @return false 
+ */
+bool hx711_multi_group_async_done(hx711_multi_group_t* const group);
+
+/**
+ * @brief Get the values from the last asynchronous read, in
+ * member order.
+ * 
+ * @param group 
+ * @param values array of hx711_multi_group_get_chips_len values
+ */
+void hx711_multi_group_async_get_values(
+    hx711_multi_group_t* const group,
+    int32_t* const values);
+
+/**
+ * @brief Fill an array with one value from each chip of every
+ * member, in member order. Blocks until all are obtained.
+ * 
+ * @param group 
+ * @param values array of hx711_multi_group_get_chips_len values
+ */
+void hx711_multi_group_get_values(
+    hx711_multi_group_t* const group,
+    int32_t* const values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,156 @@
+// -------------------------------------------------- //
+// This file is autogenerated by pioasm; do not edit! //
+// -------------------------------------------------- //
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// -------------------------- //
+// hx711_multi_masked_awaiter //
+// -------------------------- //
+
+#define hx711_multi_masked_awaiter_wrap_target 0
+#define hx711_multi_masked_awaiter_wrap 11
+
+#define hx711_multi_masked_awaiter_MAX_RUNS 3
+
+#define hx711_multi_masked_awaiter_offset_run_0 1u
+#define hx711_multi_masked_awaiter_offset_gap_1 3u
+#define hx711_multi_masked_awaiter_offset_run_1 4u
+#define hx711_multi_masked_awaiter_offset_gap_2 6u
+#define hx711_multi_masked_awaiter_offset_run_2 7u
+#define hx711_multi_masked_awaiter_offset_ready 9u
+
+static const uint16_t hx711_multi_masked_awaiter_program_instructions[] = {
+            //     .wrap_target
+    0xa0e0, //  0: mov    osr, pins                   
+    0x6041, //  1: out    y, 1                        
+    0x008b, //  2: jmp    y--, 11                     
+    0x6061, //  3: out    null, 1                     
+    0x6041, //  4: out    y, 1                        
+    0x008b, //  5: jmp    y--, 11                     
+    0x6061, //  6: out    null, 1                     
+    0x6041, //  7: out    y, 1                        
+    0x008b, //  8: jmp    y--, 11                     
+    0xc017, //  9: irq    nowait 7 rel                
+    0x0000, // 10: jmp    0                           
+    0xc057, // 11: irq    clear 7 rel                 
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program hx711_multi_masked_awaiter_program = {
+    .instructions = hx711_multi_masked_awaiter_program_instructions,
+    .length = 12,
+    .origin = -1,
+};
+
+static inline pio_sm_config hx711_multi_masked_awaiter_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + hx711_multi_masked_awaiter_wrap_target, offset + hx711_multi_masked_awaiter_wrap);
+    return c;
+}
+
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <assert.h>
+#include <stddef.h>
+#include "hardware/pio.h"
+#include "hardware/pio_instructions.h"
+#include "hx711_multi.h"
+void hx711_multi_masked_awaiter_program_init(hx711_multi_t* const hxm) {
+    assert(hxm != NULL);
+    assert(hxm->_pio != NULL);
+    assert(hxm->_chips_len > 0);
+    //hx711_multi_get_sync_state only reads the pin values from
+    //the awaiter when the data pins are contiguous, so this
+    //program is only for data pins with gaps between them
+    assert(hxm->_data_pins_width > hxm->_chips_len);
+    static const uint runOffsets[hx711_multi_masked_awaiter_MAX_RUNS] = {
+        hx711_multi_masked_awaiter_offset_run_0,
+        hx711_multi_masked_awaiter_offset_run_1,
+        hx711_multi_masked_awaiter_offset_run_2
+    };
+    //there is no gap before the first run
+    static const uint gapOffsets[hx711_multi_masked_awaiter_MAX_RUNS] = {
+        0,
+        hx711_multi_masked_awaiter_offset_gap_1,
+        hx711_multi_masked_awaiter_offset_gap_2
+    };
+    pio_sm_config cfg = hx711_multi_masked_awaiter_program_get_default_config(
+        hxm->_awaiter_offset);
+    //replace placeholders in instructions with the length of
+    //each run of data pins and each gap between them. The
+    //mask is at most 30 bits, so there is always a clear bit
+    //above the last run
+    uint32_t mask = hxm->_data_pin_mask >> hxm->_data_pin_base;
+    uint run = 0;
+    while(mask != 0) {
+        assert(run < hx711_multi_masked_awaiter_MAX_RUNS);
+        if(run > 0) {
+            const uint gap = (uint)__builtin_ctz(mask);
+            hxm->_pio->instr_mem[hxm->_awaiter_offset + gapOffsets[run]] =
+                pio_encode_out(pio_null, gap);
+            mask >>= gap;
+        }
+        const uint len = (uint)__builtin_ctz(~mask);
+        hxm->_pio->instr_mem[hxm->_awaiter_offset + runOffsets[run]] =
+            pio_encode_out(pio_y, len);
+        mask >>= len;
+        ++run;
+    }
+    //skip any runs which are not needed
+    if(run < hx711_multi_masked_awaiter_MAX_RUNS) {
+        hxm->_pio->instr_mem[hxm->_awaiter_offset + gapOffsets[run]] =
+            pio_encode_jmp(hxm->_awaiter_offset + hx711_multi_masked_awaiter_offset_ready);
+    }
+    //data pins
+    pio_sm_set_in_pins(
+        hxm->_pio,
+        hxm->_awaiter_sm,
+        hxm->_data_pin_base);
+    pio_sm_set_pindirs_with_mask(
+        hxm->_pio,
+        hxm->_awaiter_sm,
+        0,                  //0 = input
+        hxm->_data_pin_mask);
+    sm_config_set_in_pins(
+        &cfg,
+        hxm->_data_pin_base);
+    //the lowest pins are shifted out first, and the OSR is
+    //refilled by the program rather than pulled
+    sm_config_set_out_shift(
+        &cfg,
+        true,               //true = shift right
+        false,              //false = autopull disabled
+        32);                //autopull threshold
+    pio_sm_clear_fifos(
+        hxm->_pio,
+        hxm->_awaiter_sm);
+    hxm->_awaiter_default_config = cfg;
+}
+
+#endif
+
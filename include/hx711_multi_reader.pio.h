@@ -12,41 +12,40 @@
 // hx711_multi_reader //
 // ------------------ //
 
-#define hx711_multi_reader_wrap_target 3
-#define hx711_multi_reader_wrap 18
+#define hx711_multi_reader_wrap_target 1
+#define hx711_multi_reader_wrap 17
 
-#define hx711_multi_reader_HZ 10000000
+#define hx711_multi_reader_PD_SCK_CYCLES 4
 
-#define hx711_multi_reader_offset_bitloop_in_pins_bit_count 9u
+#define hx711_multi_reader_offset_bitloop_in_pins_bit_count 5u
 
 static const uint16_t hx711_multi_reader_program_instructions[] = {
     0xe020, //  0: set    x, 0                       
-    0x8080, //  1: pull   noblock                    
-    0x6020, //  2: out    x, 32                      
             //     .wrap_target
-    0xe057, //  3: set    y, 23                      
-    0x4060, //  4: in     null, 32                   
-    0x8000, //  5: push   noblock                    
-    0x20c4, //  6: wait   1 irq, 4                   
-    0xc040, //  7: irq    clear 0                    
-    0xe001, //  8: set    pins, 1                    
-    0x4001, //  9: in     pins, 1                    
-    0x8000, // 10: push   noblock                    
-    0x1088, // 11: jmp    y--, 8          side 0     
-    0xc000, // 12: irq    nowait 0                   
-    0x9880, // 13: pull   noblock         side 1     
-    0x6020, // 14: out    x, 32                      
-    0x1023, // 15: jmp    !x, 3           side 0     
-    0xa041, // 16: mov    y, x                       
-    0xe101, // 17: set    pins, 1                [1] 
-    0x1191, // 18: jmp    y--, 17         side 0 [1] 
+    0xe057, //  1: set    y, 23                      
+    0x20d4, //  2: wait   1 irq, 4 rel               
+    0xc050, //  3: irq    clear 0 rel                
+    0xe001, //  4: set    pins, 1                    
+    0x4001, //  5: in     pins, 1                    
+    0x9040, //  6: push   iffull noblock  side 0     
+    0x0084, //  7: jmp    y--, 4                     
+    0xa0c1, //  8: mov    isr, x                     
+    0x8000, //  9: push   noblock                    
+    0xc010, // 10: irq    nowait 0 rel               
+    0x9880, // 11: pull   noblock         side 1     
+    0x6020, // 12: out    x, 32                      
+    0x1021, // 13: jmp    !x, 1           side 0     
+    0xa041, // 14: mov    y, x                       
+    0x0090, // 15: jmp    y--, 16                    
+    0xe101, // 16: set    pins, 1                [1] 
+    0x1190, // 17: jmp    y--, 16         side 0 [1] 
             //     .wrap
 };
 
 #if !PICO_NO_HARDWARE
 static const struct pio_program hx711_multi_reader_program = {
     .instructions = hx711_multi_reader_program_instructions,
-    .length = 19,
+    .length = 18,
     .origin = -1,
 };
 
@@ -93,34 +92,40 @@ void hx711_multi_pio_init(hx711_multi_t* const hxm) {
     pio_gpio_init(
         hxm->_pio,
         hxm->_clock_pin);
-    util_pio_gpio_contiguous_init(
+    util_pio_gpio_mask_init(
         hxm->_pio,
-        hxm->_data_pin_base,
-        hxm->_chips_len);
+        hxm->_data_pin_mask);
     // make sure conversion done is valid and routable
     assert(util_routable_pio_interrupt_num_is_valid(
-        HX711_MULTI_CONVERSION_DONE_IRQ_NUM));
+        hxm->_conversion_done_irq_num));
     pio_interrupt_clear(
         hxm->_pio,
-        HX711_MULTI_CONVERSION_DONE_IRQ_NUM);
+        hxm->_conversion_done_irq_num);
     // make sure data ready is valid and not routable
     // although this is not strictly necessary
     assert(util_pio_interrupt_num_is_valid(
-        HX711_MULTI_DATA_READY_IRQ_NUM));
+        hxm->_data_ready_irq_num));
     assert(!util_routable_pio_interrupt_num_is_valid(
-        HX711_MULTI_DATA_READY_IRQ_NUM));
+        hxm->_data_ready_irq_num));
     pio_interrupt_clear(
         hxm->_pio,
-        HX711_MULTI_DATA_READY_IRQ_NUM);
+        hxm->_data_ready_irq_num);
 }
 void hx711_multi_reader_program_init(hx711_multi_t* const hxm) {
     assert(hxm != NULL);
     assert(hxm->_pio != NULL);
+    //the reader reads every pin from the lowest data pin to
+    //the highest, including any pins in between which are
+    //not data pins
     hxm->_pio->instr_mem[hxm->_reader_offset + hx711_multi_reader_offset_bitloop_in_pins_bit_count] = 
-        pio_encode_in(pio_pins, hxm->_chips_len);
+        pio_encode_in(pio_pins, hxm->_data_pins_width);
     pio_sm_config cfg = hx711_multi_reader_program_get_default_config(
         hxm->_reader_offset);
-    const float div = (float)(clock_get_hz(clk_sys)) / (uint)hx711_multi_reader_HZ;
+    const float div = (float)(clock_get_hz(clk_sys)) /
+        ((float)hxm->_pd_sck_hz * hx711_multi_reader_PD_SCK_CYCLES);
+
+    //the clock divider can be at most 65536
+    assert(div >= 1.0f && div <= 65536.0f);
     sm_config_set_clkdiv(
         &cfg,
         div);
@@ -157,20 +162,23 @@ void hx711_multi_reader_program_init(hx711_multi_t* const hxm) {
         hxm->_pio,
         hxm->_reader_sm,
         hxm->_data_pin_base);
-    pio_sm_set_consecutive_pindirs(
+    //only the data pins are set to input; the clock pin
+    //may be between them
+    pio_sm_set_pindirs_with_mask(
         hxm->_pio,
         hxm->_reader_sm,
-        hxm->_data_pin_base,
-        hxm->_chips_len,
-        false);                 //false = input
+        0,                      //0 = input
+        hxm->_data_pin_mask);
     sm_config_set_in_pins(
         &cfg,
         hxm->_data_pin_base);
+    //push iffull uses the threshold, so this is the number
+    //of bits in each push
     sm_config_set_in_shift(
         &cfg,
         false,                  //false = shift in left
         false,                  //false = autopush disabled
-        hxm->_chips_len);
+        hxm->_data_pins_width * hxm->_pinvals_per_word);
     pio_sm_clear_fifos(
         hxm->_pio,
         hxm->_reader_sm);
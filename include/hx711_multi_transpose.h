@@ -0,0 +1,103 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HX711_MULTI_TRANSPOSE_H_5C1E7A2D_3F4B_4E8A_9D6C_2B7F0A1E8C43
+#define HX711_MULTI_TRANSPOSE_H_5C1E7A2D_3F4B_4E8A_9D6C_2B7F0A1E8C43
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of pinvals in a conversion. This is the same
+ * as HX711_READ_BITS, but is repeated here so that the
+ * transpose does not depend on the pico-sdk.
+ */
+#define HX711_MULTI_TRANSPOSE_ROWS      UINT8_C(24)
+
+/**
+ * @brief Number of bits in a pinval, and therefore the maximum
+ * number of chips which can be transposed.
+ */
+#define HX711_MULTI_TRANSPOSE_COLS      UINT8_C(32)
+
+/**
+ * @brief Convert an array of pinvals to sign-extended HX711
+ * values by transposing the 24x32 bit matrix they form. This
+ * is done 32 bits at a time by swapping progressively smaller
+ * blocks of bits with masks (16x16, 8x8, ... 1x1) rather than
+ * moving each bit individually. Only the blocks needed for the
+ * first len chips are transposed. The function is placed in RAM.
+ * 
+ * @param pinvals 24 pinvals, MSB first
+ * @param values 
+ * @param len number of chips, 1 to 32
+ */
+void hx711_multi_transpose(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const size_t len);
+
+/**
+ * @brief Convert an array of pinvals to sign-extended HX711
+ * values in the same way as hx711_multi_transpose, except the
+ * value for chip i is taken from column cols[i] of the pinvals
+ * rather than column i. This allows chips to be connected to
+ * pins which are not next to each other. Only the blocks needed
+ * for columns up to the last one are transposed, so the cost is
+ * the same as hx711_multi_transpose for cols[len - 1] + 1 chips.
+ * The function is placed in RAM.
+ * 
+ * @param pinvals 24 pinvals, MSB first
+ * @param values 
+ * @param cols column of each chip, in ascending order, each
+ * less than 32
+ * @param len number of chips, 1 to 32
+ */
+void hx711_multi_transpose_cols(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const uint8_t* const cols,
+    const size_t len);
+
+/**
+ * @brief Transposes the first cols columns of pinvals into the
+ * first cols rows of mat. Rows beyond these are left in an
+ * unspecified state.
+ * 
+ * @param pinvals 24 pinvals, MSB first
+ * @param mat 32 rows
+ * @param cols number of columns needed, 1 to 32
+ */
+static void hx711_multi_transpose__matrix(
+    const uint32_t* const pinvals,
+    uint32_t* const mat,
+    const size_t cols);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
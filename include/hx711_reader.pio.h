@@ -12,25 +12,25 @@
 // hx711_reader //
 // ------------ //
 
-#define hx711_reader_wrap_target 3
+#define hx711_reader_wrap_target 1
 #define hx711_reader_wrap 13
 
-#define hx711_reader_HZ 10000000
+#define hx711_reader_PD_SCK_CYCLES 4
 
 static const uint16_t hx711_reader_program_instructions[] = {
     0xe020, //  0: set    x, 0                       
-    0x8080, //  1: pull   noblock                    
-    0x6020, //  2: out    x, 32                      
             //     .wrap_target
-    0xe057, //  3: set    y, 23                      
-    0x2020, //  4: wait   0 pin, 0                   
-    0xe001, //  5: set    pins, 1                    
-    0x4001, //  6: in     pins, 1                    
-    0x1185, //  7: jmp    y--, 5          side 0 [1] 
-    0x9880, //  8: pull   noblock         side 1     
-    0x6020, //  9: out    x, 32                      
-    0x1023, // 10: jmp    !x, 3           side 0     
-    0xa041, // 11: mov    y, x                       
+    0xe057, //  1: set    y, 23                      
+    0x4022, //  2: in     x, 2                       
+    0x2020, //  3: wait   0 pin, 0                   
+    0xe001, //  4: set    pins, 1                    
+    0x4001, //  5: in     pins, 1                    
+    0x1184, //  6: jmp    y--, 4          side 0 [1] 
+    0x9880, //  7: pull   noblock         side 1     
+    0x6020, //  8: out    x, 32                      
+    0x1021, //  9: jmp    !x, 1           side 0     
+    0xa041, // 10: mov    y, x                       
+    0x008c, // 11: jmp    y--, 12                    
     0xe101, // 12: set    pins, 1                [1] 
     0x118c, // 13: jmp    y--, 12         side 0 [1] 
             //     .wrap
@@ -120,7 +120,11 @@ void hx711_reader_program_init(hx711_t* const hx) {
     assert(hx->_pio != NULL);
     pio_sm_config cfg = hx711_reader_program_get_default_config(
         hx->_reader_offset);
-    const float div = (float)(clock_get_hz(clk_sys)) / (uint)hx711_reader_HZ;
+    const float div = (float)(clock_get_hz(clk_sys)) /
+        ((float)hx->_pd_sck_hz * hx711_reader_PD_SCK_CYCLES);
+
+    //the clock divider can be at most 65536
+    assert(div >= 1.0f && div <= 65536.0f);
     sm_config_set_clkdiv(
         &cfg,
         div);
@@ -161,7 +165,14 @@ void hx711_reader_program_init(hx711_t* const hx) {
         &cfg,
         false,            //false = shift in left
         true,             //true = autopush enabled
-        HX711_READ_BITS); //autopush on 24 bits
+        HX711_READ_BITS + HX711_GAIN_TAG_BITS); //autopush on the gain tag and 24 bits
+    //the gain is then set without the TX FIFO; see
+    //hx711_set_gain
+    if(hx->_join_rx_fifo) {
+        sm_config_set_fifo_join(
+            &cfg,
+            PIO_FIFO_JOIN_RX);
+    }
     pio_sm_clear_fifos(
         hx->_pio,
         hx->_reader_sm);
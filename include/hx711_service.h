@@ -0,0 +1,303 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HX711_SERVICE_H_DBF37A31_0B0E_4F81_9981_54C823ACFC7E
+#define HX711_SERVICE_H_DBF37A31_0B0E_4F81_9981_54C823ACFC7E
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "pico/types.h"
+#include "hx711.h"
+#include "hx711_multi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of hx711_t and hx711_multi_t a service
+ * can own. Each needs at least one of the eight state machines.
+ */
+#define HX711_SERVICE_MAX_SOURCES       UINT8_C(8)
+
+/**
+ * @brief Maximum number of values in a frame, which is the
+ * most chips a hx711_multi_t can read.
+ */
+#define HX711_SERVICE_MAX_VALUES        HX711_MULTI_MAX_CHIPS
+
+/**
+ * @brief A reading from one of the service's sources: a single
+ * value from a hx711_t, or one value per chip from a
+ * hx711_multi_t.
+ */
+typedef struct {
+    uint8_t source; //index of the source, in the order added
+    uint8_t len; //number of values
+    uint32_t count; //count of frames from this source, from 1
+    absolute_time_t time; //when the conversion ended
+    hx711_gain_t gain; //gain the values were converted at
+    int32_t values[HX711_SERVICE_MAX_VALUES];
+} hx711_service_frame_t;
+
+typedef struct hx711_service hx711_service_t;
+
+typedef struct {
+    hx711_service_t* _svc;
+    uint8_t _index;
+    hx711_t* _hx;
+    hx711_multi_t* _hxm;
+    uint32_t* _ring;
+    size_t _ring_len;
+    hx711_config_t _config;
+    hx711_multi_config_t _multi_config;
+    hx711_gain_t _gain;
+    uint32_t _count;
+} hx711_service_source_t;
+
+/**
+ * @brief Acquisition running on core1. The service initialises
+ * and owns its hx711_t and hx711_multi_t, so that all of their
+ * interrupt handlers run on core1, and publishes their readings
+ * to core0 through a single producer, single consumer ring of
+ * frames. Core1 sends a word through the inter-core FIFO after
+ * each frame so that core0 can sleep until one arrives.
+ */
+struct hx711_service {
+
+    hx711_service_source_t _sources[HX711_SERVICE_MAX_SOURCES];
+    size_t _sources_len;
+
+    //written only by core1
+    hx711_service_frame_t* _frames;
+    size_t _frames_len;
+    volatile uint32_t _head;
+    volatile uint32_t _dropped;
+
+    //written only by core0
+    volatile uint32_t _tail;
+
+    volatile bool _stopping;
+    volatile bool _running;
+
+};
+
+/**
+ * @brief The service running on core1, for its entry function
+ * to access. This is a global variable.
+ */
+extern hx711_service_t* hx711_service__instance;
+
+/**
+ * @brief Initialise a service. Nothing is allocated; the
+ * service uses the given array for its ring of frames.
+ * 
+ * @param svc 
+ * @param frames 
+ * @param len number of frames in the ring; a power of 2
+ */
+void hx711_service_init(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frames,
+    const size_t len);
+
+/**
+ * @brief Add a hx711_t for the service to own. It is initialised
+ * with the config and powered up with the gain on core1 once the
+ * service starts, and closed when it stops. It must not be used
+ * directly in the meantime.
+ * 
+ * @param svc 
+ * @param hx uninitialised
+ * @param config copied
+ * @param gain 
+ * @return uint index of the source
+ */
+uint hx711_service_add(
+    hx711_service_t* const svc,
+    hx711_t* const hx,
+    const hx711_config_t* const config,
+    const hx711_gain_t gain);
+
+/**
+ * @brief Add a hx711_multi_t for the service to own, in the same
+ * way as hx711_service_add. It is read continuously into the
+ * ring; see hx711_multi_continuous_start for its requirements.
+ * 
+ * @param svc 
+ * @param hxm uninitialised
+ * @param config copied
+ * @param gain 
+ * @param ring ring buffer owned by the caller
+ * @param len number of words in ring
+ * @return uint index of the source
+ */
+uint hx711_service_add_multi(
+    hx711_service_t* const svc,
+    hx711_multi_t* const hxm,
+    const hx711_multi_config_t* const config,
+    const hx711_gain_t gain,
+    uint32_t* const ring,
+    const size_t len);
+
+/**
+ * @brief Launch the service on core1 and wait until its sources
+ * are running. Core1 must not be in use. The inter-core FIFO is
+ * used by the service until it is stopped, so nothing else (eg.
+ * multicore_lockout) should use it in the meantime.
+ * 
+ * @note As with hx711_wait_settle, the first frames after the
+ * service starts may be taken before the chips have settled.
+ * 
+ * @param svc 
+ */
+void hx711_service_start(hx711_service_t* const svc);
+
+/**
+ * @brief Stop the service, close its sources and reset core1.
+ * Frames which have not been popped can still be popped until
+ * the service is started again.
+ * 
+ * @param svc 
+ */
+void hx711_service_stop(hx711_service_t* const svc);
+
+/**
+ * @brief Obtain the oldest frame which has not been popped.
+ * Only core0 should pop frames.
+ * 
+ * @param svc 
+ * @param frame 
+ * @return true if a frame was obtained
+ * @return false if there are none
+ */
+bool hx711_service_pop(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frame);
+
+/**
+ * @brief Obtain the oldest frame which has not been popped,
+ * sleeping until core1 publishes one if there are none.
+ * 
+ * @param svc 
+ * @param frame 
+ */
+void hx711_service_pop_blocking(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frame);
+
+/**
+ * @brief Obtain the oldest frame which has not been popped,
+ * sleeping until core1 publishes one or until the timeout.
+ * 
+ * @param svc 
+ * @param frame 
+ * @param timeout microseconds
+ * @return true if a frame was obtained
+ * @return false if timed out
+ */
+bool hx711_service_pop_timeout(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frame,
+    const uint timeout);
+
+/**
+ * @brief Returns the number of frames which were discarded
+ * because the ring was full. Core1 never waits for core0.
+ * 
+ * @param svc 
+ * @return uint32_t 
+ */
+uint32_t hx711_service_get_dropped(hx711_service_t* const svc);
+
+/**
+ * @brief Entry function for core1. Runs the service in
+ * hx711_service__instance until it is stopped.
+ */
+static void hx711_service__core1_main(void);
+
+/**
+ * @brief Initialise, power up and start each source on the
+ * calling core, which is core1.
+ * 
+ * @param svc 
+ */
+static void hx711_service__sources_start(hx711_service_t* const svc);
+
+/**
+ * @brief Publish any new frames from hx711_multi_t sources. This
+ * is called each time core1 wakes. Values from hx711_t sources
+ * are published by their callbacks.
+ * 
+ * @param svc 
+ */
+static void hx711_service__poll(hx711_service_t* const svc);
+
+/**
+ * @brief Stop and close each source on the calling core, which
+ * is core1.
+ * 
+ * @param svc 
+ */
+static void hx711_service__sources_stop(hx711_service_t* const svc);
+
+/**
+ * @brief Copy a frame into the ring and signal core0. If the
+ * ring is full, the frame is dropped. Only core1 may push, and
+ * it must not be interrupted by another push.
+ * 
+ * @param source 
+ * @param count 
+ * @param time 
+ * @param gain 
+ * @param values 
+ * @param len 
+ * @return true if the frame was pushed
+ * @return false if the ring was full
+ */
+static bool __not_in_flash_func(hx711_service__push)(
+    hx711_service_source_t* const source,
+    const uint32_t count,
+    const absolute_time_t time,
+    const hx711_gain_t gain,
+    const int32_t* const values,
+    const size_t len);
+
+/**
+ * @brief Callback for hx711_t sources, run from the RX FIFO
+ * interrupt handler on core1.
+ * 
+ * @param sample 
+ * @param ctx the source
+ */
+static void __not_in_flash_func(hx711_service__on_value)(
+    const hx711_sample_t* const sample,
+    void* const ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
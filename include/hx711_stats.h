@@ -0,0 +1,111 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HX711_STATS_H_71BA1DAC_02F6_496E_A5B7_0BB71FA4F61C
+#define HX711_STATS_H_71BA1DAC_02F6_496E_A5B7_0BB71FA4F61C
+
+#include <stdint.h>
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statistics are only gathered when HX711_STATS is
+ * defined. Otherwise, anything given to this macro is removed,
+ * so there is no cost at all. It can be used inside other
+ * macros, such as HX711_MUTEX_BLOCK.
+ */
+#ifdef HX711_STATS
+    #define HX711_STATS_ONLY(...) __VA_ARGS__
+#else
+    #define HX711_STATS_ONLY(...)
+#endif
+
+/**
+ * @brief Number of histogram bins for each latency. Bin 0
+ * counts latencies of 0us and bin n counts latencies from
+ * 2^(n-1) up to 2^n - 1us. The last bin also counts anything
+ * longer.
+ */
+#define HX711_STATS_HISTOGRAM_LEN               UINT8_C(16)
+
+/**
+ * @brief Distribution of a latency, in microseconds.
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t histogram[HX711_STATS_HISTOGRAM_LEN];
+} hx711_stats_latency_t;
+
+/**
+ * @brief Counters for one hx711_t or hx711_multi_t.
+ */
+typedef struct {
+
+    //values obtained; for hx711_multi_t, conversions read
+    //from all chips
+    uint32_t values;
+
+    //hx711_t: values obtained from a full RX FIFO, after
+    //which the state machine stalls and conversions are missed
+    //hx711_multi_t: continuous frames which completed without
+    //being obtained
+    uint32_t overflows;
+
+    //hx711_get_value_timeout or hx711_multi_get_values_timeout
+    //calls which timed out
+    uint32_t timeouts;
+
+    //time from asking for a value until it was obtained
+    hx711_stats_latency_t wait_us;
+
+    //time spent in the driver's interrupt handlers
+    hx711_stats_latency_t isr_us;
+
+} hx711_stats_t;
+
+/**
+ * @brief Clears every counter.
+ * 
+ * @param stats 
+ */
+void hx711_stats_reset(hx711_stats_t* const stats);
+
+/**
+ * @brief Adds one latency to its distribution.
+ * 
+ * @param latency 
+ * @param us 
+ */
+void hx711_stats_latency_add(
+    hx711_stats_latency_t* const latency,
+    const uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
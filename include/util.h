@@ -49,6 +49,12 @@ extern "C" {
 #define UTIL_ROUTABLE_PIO_INTERRUPT_NUM_MIN UINT8_C(0)
 #define UTIL_ROUTABLE_PIO_INTERRUPT_NUM_MAX UINT8_C(3)
 
+/**
+ * @brief Maximum number of distinct programs which can be
+ * shared on each PIO.
+ */
+#define UTIL_PIO_SHARED_PROGRAMS_MAX UINT8_C(8)
+
 /**
  * @brief Own a mutex for the duration of this block of
  * code.
@@ -104,6 +110,23 @@ extern const uint8_t util_pio_to_irq_map[NUM_PIOS * 2];
  */
 extern const uint8_t util_dma_to_irq_map[UTIL_NUM_DMA_IRQS];
 
+/**
+ * @brief A program loaded into a PIO's instruction memory and
+ * the number of state machines using it.
+ */
+typedef struct {
+    const pio_program_t* prog;
+    uint variant;
+    uint offset;
+    uint refs;
+} util_pio_shared_program_t;
+
+/**
+ * @brief Programs loaded with util_pio_add_shared_program,
+ * for each PIO.
+ */
+extern util_pio_shared_program_t util_pio_shared_programs[NUM_PIOS][UTIL_PIO_SHARED_PROGRAMS_MAX];
+
 /**
  * @brief Check whether a DMA IRQ index is valid.
  * 
@@ -188,6 +211,18 @@ void util_dma_channel_set_quiet(
     const uint channel,
     const bool quiet);
 
+/**
+ * @brief Sets the channel a DMA channel triggers when it
+ * completes. Setting a channel to chain to itself disables
+ * chaining.
+ * 
+ * @param channel 
+ * @param chain_to 
+ */
+void util_dma_channel_set_chain_to(
+    const uint channel,
+    const uint chain_to);
+
 /**
  * @brief Sets GPIO pins from base to base + len to input.
  * 
@@ -198,6 +233,13 @@ void util_gpio_set_contiguous_input_pins(
     const uint base,
     const uint len);
 
+/**
+ * @brief Sets each GPIO pin in the mask to input.
+ * 
+ * @param mask 
+ */
+void util_gpio_set_input_pins_mask(const uint32_t mask);
+
 /**
  * @brief Initialises and sets GPIO pin to output.
  * 
@@ -298,6 +340,16 @@ void util_pio_gpio_contiguous_init(
     const uint base,
     const uint len);
 
+/**
+ * @brief Inits each GPIO pin in the mask for PIO.
+ * 
+ * @param pio 
+ * @param mask 
+ */
+void util_pio_gpio_mask_init(
+    PIO const pio,
+    const uint32_t mask);
+
 /**
  * @brief Clears a given state machine's RX FIFO.
  * 
@@ -455,6 +507,54 @@ bool util_pio_sm_try_get(
     uint32_t* const word,
     const uint threshold);
 
+/**
+ * @brief Claims two unused state machines, sm and
+ * (sm + 1) % NUM_PIO_STATE_MACHINES, so that programs can
+ * address each other's IRQs relative to their own state
+ * machine numbers.
+ * 
+ * @param pio 
+ * @param required if true, panics if no pair is available
+ * @return int the first state machine of the pair, or -1 if
+ * none is available
+ */
+int util_pio_claim_unused_sm_pair(
+    PIO const pio,
+    const bool required);
+
+/**
+ * @brief Adds a program to the PIO, or if the same program has
+ * already been added with the same variant, returns its offset
+ * instead of adding another copy. Panics if the program cannot
+ * be added.
+ * 
+ * @param pio 
+ * @param prog 
+ * @param variant distinguishes copies of a program which are
+ * modified in instruction memory after being added (eg. a pin
+ * count patched into an instruction); use 0 for programs which
+ * are never modified
+ * @return uint offset of the program
+ */
+uint util_pio_add_shared_program(
+    PIO const pio,
+    const pio_program_t* const prog,
+    const uint variant);
+
+/**
+ * @brief Releases a program added with util_pio_add_shared_program.
+ * The program is removed from the PIO once it has been released
+ * as many times as it was added.
+ * 
+ * @param pio 
+ * @param prog 
+ * @param offset offset returned by util_pio_add_shared_program
+ */
+void util_pio_remove_shared_program(
+    PIO const pio,
+    const pio_program_t* const prog,
+    const uint offset);
+
 #undef UTIL_DECL_IN_RANGE_FUNC
 
 #ifdef __cplusplus
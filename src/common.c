@@ -28,21 +28,28 @@
 #include "../include/hx711_reader.pio.h"
 #include "../include/hx711_multi.h"
 #include "../include/hx711_multi_awaiter.pio.h"
+#include "../include/hx711_multi_masked_awaiter.pio.h"
 #include "../include/hx711_multi_reader.pio.h"
 
 const hx711_config_t HX711__DEFAULT_CONFIG = {
     .clock_pin = 0,
     .data_pin = 0,
+    .pd_sck_hz = HX711_PD_SCK_DEFAULT_HZ,
     .pio = pio0,
     .pio_init = hx711_reader_pio_init,
     .reader_prog = &hx711_reader_program,
-    .reader_prog_init = hx711_reader_program_init
+    .reader_prog_init = hx711_reader_program_init,
+    .join_rx_fifo = false,
+    .pio_irq_index = HX711_CALLBACK_PIO_IRQ_IDX
 };
 
 const hx711_multi_config_t HX711__MULTI_DEFAULT_CONFIG = {
     .clock_pin = 0,
+    .pd_sck_hz = HX711_PD_SCK_DEFAULT_HZ,
     .data_pin_base = 0,
     .chips_len = 0,
+    .data_pin_mask = 0,
+    .pack_pinvals = false,
     .pio_irq_index = HX711_MULTI_ASYNC_PIO_IRQ_IDX,
     .dma_irq_index = HX711_MULTI_ASYNC_DMA_IRQ_IDX,
     .pio = pio0,
@@ -53,6 +60,23 @@ const hx711_multi_config_t HX711__MULTI_DEFAULT_CONFIG = {
     .reader_prog_init = hx711_multi_reader_program_init
 };
 
+const hx711_multi_config_t HX711__MULTI_MASKED_DEFAULT_CONFIG = {
+    .clock_pin = 0,
+    .pd_sck_hz = HX711_PD_SCK_DEFAULT_HZ,
+    .data_pin_base = 0,
+    .chips_len = 0,
+    .data_pin_mask = 0,
+    .pack_pinvals = false,
+    .pio_irq_index = HX711_MULTI_ASYNC_PIO_IRQ_IDX,
+    .dma_irq_index = HX711_MULTI_ASYNC_DMA_IRQ_IDX,
+    .pio = pio0,
+    .pio_init = hx711_multi_pio_init,
+    .awaiter_prog = &hx711_multi_masked_awaiter_program,
+    .awaiter_prog_init = hx711_multi_masked_awaiter_program_init,
+    .reader_prog = &hx711_multi_reader_program,
+    .reader_prog_init = hx711_multi_reader_program_init
+};
+
 void hx711_get_default_config(hx711_config_t* const cfg) {
     assert(cfg != NULL);
     *cfg = HX711__DEFAULT_CONFIG;
@@ -62,3 +86,8 @@ void hx711_multi_get_default_config(hx711_multi_config_t* const cfg) {
     assert(cfg != NULL);
     *cfg = HX711__MULTI_DEFAULT_CONFIG;
 }
+
+void hx711_multi_get_masked_default_config(hx711_multi_config_t* const cfg) {
+    assert(cfg != NULL);
+    *cfg = HX711__MULTI_MASKED_DEFAULT_CONFIG;
+}
@@ -21,9 +21,14 @@
 // SOFTWARE.
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "hardware/dma.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
 #include "hardware/pio.h"
+#include "hardware/pio_instructions.h"
+#include "hardware/sync.h"
 #include "hardware/timer.h"
 #include "pico/platform.h"
 #include "pico/mutex.h"
@@ -47,6 +52,19 @@ const unsigned char HX711_CLOCK_PULSES[] = {
     27
 };
 
+hx711_t* hx711__callback_array[NUM_PIOS][NUM_PIO_STATE_MACHINES] = {
+    { NULL }, //...
+};
+
+#ifndef HX711_NO_MUTEX
+/**
+ * Guards hx711__callback_array. Finding whether another hx
+ * shares an IRQ must happen under the same lock as adding or
+ * removing the handler.
+ */
+auto_init_mutex(hx711__callback_array_mut);
+#endif
+
 void hx711_init(
     hx711_t* const hx, 
     const hx711_config_t* const config) {
@@ -65,6 +83,8 @@ void hx711_init(
         check_gpio_param(config->clock_pin);
         check_gpio_param(config->data_pin);
         assert(config->clock_pin != config->data_pin);
+        assert(util_pio_irq_index_is_valid(config->pio_irq_index));
+        assert(hx711_is_pd_sck_hz_valid(config->pd_sck_hz));
 
 #ifndef HX711_NO_MUTEX
         mutex_init(&hx->_mut);
@@ -74,9 +94,40 @@ void hx711_init(
 
             hx->_clock_pin = config->clock_pin;
             hx->_data_pin = config->data_pin;
+            hx->_pd_sck_hz = config->pd_sck_hz;
+            hx->_read_time_us = hx711_pd_sck_hz_to_read_time_us(config->pd_sck_hz);
             hx->_pio = config->pio;
             hx->_reader_prog = config->reader_prog;
 
+            hx->_stream_buffer = NULL;
+            hx->_stream_len = 0;
+            hx->_stream_read_count = 0;
+
+            hx->_schedule_buffer = NULL;
+            hx->_schedule_len = 0;
+
+            hx->_latest_seq = 0;
+            hx->_latest_value = 0;
+            hx->_latest_gain = hx711_gain_128;
+            hx->_latest_count = 0;
+            hx->_latest_time_us = 0;
+
+            hx->_join_rx_fifo = config->join_rx_fifo;
+
+            hx->_gain = hx711_gain_128;
+            hx->_gain_pending = false;
+            hx->_gain_old_values = 0;
+
+            hx->_rate = hx711_rate_10;
+            hx->_rate_detected = false;
+
+            hx->_pio_irq_index = config->pio_irq_index;
+            hx->_callback = NULL;
+            hx->_callback_ctx = NULL;
+            hx->_callback_count = 0;
+
+            HX711_STATS_ONLY(hx711_stats_reset(&hx->_stats);)
+
             util_gpio_set_output(hx->_clock_pin);
 
             /**
@@ -104,10 +155,13 @@ void hx711_init(
              * DOUT pin back to high (Fig.2)."
              */
 
-            //either statement below will panic if it fails
-            hx->_reader_offset = pio_add_program(
+            //either statement below will panic if it fails;
+            //every hx711_t on the same PIO shares one copy of
+            //the program
+            hx->_reader_offset = util_pio_add_shared_program(
                 hx->_pio,
-                hx->_reader_prog);
+                hx->_reader_prog,
+                0);
 
             hx->_reader_sm = (uint)pio_claim_unused_sm(
                 hx->_pio,
@@ -126,6 +180,20 @@ void hx711_close(hx711_t* const hx) {
     //to close
     assert(hx711__is_initd(hx));
 
+    if(hx711__is_streaming(hx)) {
+        hx711_stream_stop(hx);
+    }
+
+    if(hx711__is_callback_running(hx)) {
+        hx711_callback_stop(hx);
+    }
+
+    if(hx711__is_gain_scheduled(hx)) {
+        hx711_gain_schedule_stop(hx);
+    }
+
+    hx711__irq_release(hx);
+
     HX711_MUTEX_BLOCK(hx->_mut, 
 
         pio_sm_set_enabled(
@@ -137,7 +205,7 @@ void hx711_close(hx711_t* const hx) {
             hx->_pio,
             hx->_reader_sm);
 
-        pio_remove_program(
+        util_pio_remove_shared_program(
             hx->_pio,
             hx->_reader_prog,
             hx->_reader_offset);
@@ -149,6 +217,7 @@ void hx711_close(hx711_t* const hx) {
 void hx711_set_gain(hx711_t* const hx, const hx711_gain_t gain) {
 
     assert(hx711__is_state_machine_enabled(hx));
+    assert(!hx711__is_gain_scheduled(hx));
     assert(hx711_is_gain_valid(gain));
 
     const uint32_t pioGain = hx711_gain_to_pio_gain(gain);
@@ -157,80 +226,149 @@ void hx711_set_gain(hx711_t* const hx, const hx711_gain_t gain) {
 
     HX711_MUTEX_BLOCK(hx->_mut, 
 
-        /**
-         * Before putting anything in the TX FIFO buffer,
-         * assume the worst-case scenario which is that
-         * there's something already in there. There ought
-         * not to be, but clearing it ensures the following
-         * pio_sm_put* call does not need to block as this
-         * function to change the gain should take precedence.
-         */
-        pio_sm_drain_tx_fifo(
-            hx->_pio,
-            hx->_reader_sm);
+        if(hx->_join_rx_fifo) {
 
-        pio_sm_put(
-            hx->_pio,
-            hx->_reader_sm,
-            pioGain);
+            /**
+             * With the FIFOs joined there is no TX FIFO to put
+             * the gain into, so write it directly into the x
+             * register the program pulls from. It also goes
+             * into the OSR in case the state machine is stopped
+             * between its pull and out, which would otherwise
+             * overwrite x with the previous gain. The state
+             * machine is only stopped for a few cycles, far less
+             * than the 60us after which the HX711 would power
+             * down if the clock pin happened to be high.
+             * 
+             * NOTE: x is also the gain each value is tagged with.
+             * If the state machine is stopped in the two cycles
+             * between the previous gain's pulses and the tag
+             * being taken, the conversion underway is tagged
+             * with the new gain despite being at the previous
+             * one.
+             */
+            UTIL_INTERRUPTS_OFF_BLOCK(
 
-        /**
-         * At this point the current value in the RX FIFO will
-         * have been calculated based on whatever the previous
-         * set gain was. So, the RX FIFO needs to be cleared.
-         * 
-         * NOTE: checking for whether the RX FIFO is not empty
-         * won't work. A conversion may have already begun
-         * before any bits have been moved into the ISR.
-         * 
-         * UPDATE: the worst-case scenario here is that the
-         * pio_sm_put call has occurred after the pio "pull",
-         * because we then need to wait until the following
-         * "pull" in the state machine. If this happens:
-         * 
-         * 1. there may already be a value in the RX FIFO; and
-         * 2. another value will need to be read and discarded
-         * following which the new gain will be set.
-         * 
-         * To handle 1.: Clear the RX FIFO with a non-blocking
-         * read. If the RX FIFO is empty, no harm done because
-         * the call won't block.
-         * 
-         * To handle 2.: Read the "next" value with a blocking
-         * read to ensure the "next, next" value will be set
-         * to the desired gain.
-         */
+                pio_sm_set_enabled(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    false);
 
-        //1. clear the RX FIFO with the non-blocking read
-        pio_sm_get(
-            hx->_pio,
-            hx->_reader_sm);
+                pio_sm_exec(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    pio_encode_set(pio_x, pioGain));
 
-        //2. wait until the value from the currently-set gain
-        //can be safely read and discarded
-        pio_sm_get_blocking(
-            hx->_pio,
-            hx->_reader_sm);
+                pio_sm_exec(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    pio_encode_mov(pio_osr, pio_x));
+
+                pio_sm_set_enabled(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    true);
+
+            );
+
+        }
+        else {
+
+            /**
+             * Before putting anything in the TX FIFO buffer,
+             * assume the worst-case scenario which is that
+             * there's something already in there. There ought
+             * not to be, but clearing it ensures the following
+             * pio_sm_put* call does not need to block as this
+             * function to change the gain should take precedence.
+             */
+            pio_sm_drain_tx_fifo(
+                hx->_pio,
+                hx->_reader_sm);
+
+            pio_sm_put(
+                hx->_pio,
+                hx->_reader_sm,
+                pioGain);
+
+        }
 
         /**
-         * Immediately following the above blocking call, the
-         * state machine will pull in the data in the
-         * pio_sm_put call above and pulse the HX711 the
-         * correct number of times to set the desired gain.
+         * Values already in the RX FIFO, and the one from the
+         * conversion currently underway, were converted at the
+         * previous gain. Rather than clearing the RX FIFO and
+         * reading and discarding a value to wait for the new
+         * gain to take effect, each value carries the gain it
+         * was converted at. The untagged hx711_get_value*
+         * functions use it to skip values until one at the
+         * new gain is seen.
          * 
-         * No further communication with the state machine
-         * from this function is required. Any other function(s)
-         * wishing to obtain a value from the HX711 need only
-         * block until one is there (or check the RX FIFO level).
+         * Every value in the RX FIFO and the one from the
+         * conversion underway are at the previous gain; the
+         * reader pulls the new gain once that conversion ends.
+         * 
+         * The callback interrupt handler may be checking
+         * values on the other core, so it must see the new
+         * gain before it is told one is pending.
          */
+        hx->_gain = gain;
+        hx->_gain_old_values = pio_sm_get_rx_fifo_level(
+            hx->_pio,
+            hx->_reader_sm) + 1;
+        __dmb();
+        hx->_gain_pending = true;
 
     );
 
 }
 
+bool hx711_is_gain_set(hx711_t* const hx) {
+
+    assert(hx711__is_initd(hx));
+
+    if(!hx->_gain_pending) {
+        return true;
+    }
+
+    //callbacks take every value as it arrives
+    if(hx711__is_callback_running(hx)) {
+        return false;
+    }
+
+    if(hx711__is_streaming(hx)) {
+
+        //stream reads do not skip values, so the unread ones
+        //can be checked without taking them; if a read holds
+        //the mutex, the gain is reported as pending
+        HX711_MUTEX_TRY_BLOCK(hx->_mut, 
+
+            const size_t unread = hx711__stream_get_unread(hx);
+
+            for(size_t i = 0; i < unread && hx->_gain_pending; ++i) {
+                const size_t idx = (hx->_stream_read_count + i) & (hx->_stream_len - 1);
+                hx711__is_superseded(hx, hx->_stream_buffer[idx]);
+            }
+
+        );
+
+        return !hx->_gain_pending;
+
+    }
+
+    /**
+     * Values are only counted off as they are taken, so any
+     * value in the RX FIFO beyond those still at the previous
+     * gain was converted at the new one. It is left for the
+     * next read.
+     */
+    return pio_sm_get_rx_fifo_level(hx->_pio, hx->_reader_sm) > hx->_gain_old_values;
+
+}
+
 int32_t hx711_get_twos_comp(const uint32_t raw) {
+    //only the sign bit of the 24 bit value is negated; the
+    //bits above it hold the gain tag
     return
-        (int32_t)(-(raw & +HX711_MIN_VALUE)) + 
+        (int32_t)(-(raw & (uint32_t)-HX711_MIN_VALUE)) + 
         (int32_t)(raw & HX711_MAX_VALUE);
 }
 
@@ -256,6 +394,12 @@ unsigned char hx711_get_rate_sps(const hx711_rate_t rate) {
     return HX711_SAMPLE_RATES[(int)rate];
 }
 
+hx711_rate_t hx711_interval_us_to_rate(const uint64_t us) {
+    return us < HX711_RATE_INTERVAL_THRESHOLD_US
+        ? hx711_rate_80
+        : hx711_rate_10;
+}
+
 unsigned char hx711_get_clock_pulses(const hx711_gain_t gain) {
     assert(hx711_is_gain_valid(gain));
     assert((int)gain <= count_of(HX711_CLOCK_PULSES) - 1);
@@ -265,23 +409,24 @@ unsigned char hx711_get_clock_pulses(const hx711_gain_t gain) {
 int32_t hx711_get_value(hx711_t* const hx) {
 
     assert(hx711__is_state_machine_enabled(hx));
+    assert(!hx711__is_streaming(hx));
+    assert(!hx711__is_callback_running(hx));
 
     uint32_t rawVal;
 
     HX711_MUTEX_BLOCK(hx->_mut, 
 
-        /**
-         * Block until a value is available
-         * 
-         * NOTE: remember that reading from the RX FIFO
-         * simultaneously clears it. That's why we can keep
-         * calling this function hx711_get_value and be
-         * assured we'll be getting a new value each time,
-         * even if the RX FIFO is currently empty.
-         */
-        rawVal = pio_sm_get_blocking(
-            hx->_pio,
-            hx->_reader_sm);
+        HX711_STATS_ONLY(
+            const uint32_t startUs = time_us_32();
+            const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+        )
+
+        hx711__wait_current_value(
+            hx,
+            NULL,
+            &rawVal);
+
+        HX711_STATS_ONLY(hx711__stats_value(hx, startUs, full);)
 
     );
 
@@ -289,12 +434,139 @@ int32_t hx711_get_value(hx711_t* const hx) {
 
 }
 
+int32_t hx711_get_tagged_value(
+    hx711_t* const hx,
+    hx711_gain_t* const gain) {
+
+        assert(hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
+        assert(gain != NULL);
+
+        uint32_t rawVal;
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            HX711_STATS_ONLY(
+                const uint32_t startUs = time_us_32();
+                const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+            )
+
+            /**
+             * Block until a value is available
+             * 
+             * NOTE: remember that reading from the RX FIFO
+             * simultaneously clears it. That's why we can keep
+             * calling this function hx711_get_value and be
+             * assured we'll be getting a new value each time,
+             * even if the RX FIFO is currently empty.
+             */
+            hx711__wait_value(
+                hx,
+                NULL,
+                &rawVal);
+
+            //the value is kept either way, but it may be the
+            //first at the new gain
+            hx711__is_superseded(hx, rawVal);
+
+            HX711_STATS_ONLY(hx711__stats_value(hx, startUs, full);)
+
+        );
+
+        *gain = hx711_get_raw_gain(rawVal);
+
+        return hx711_get_twos_comp(rawVal);
+
+}
+
+void hx711_get_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    const size_t len) {
+
+        assert(hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
+        assert(values != NULL);
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            for(size_t i = 0; i < len; ++i) {
+
+                HX711_STATS_ONLY(
+                    const uint32_t startUs = time_us_32();
+                    const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+                )
+
+                uint32_t rawVal;
+
+                hx711__wait_current_value(
+                    hx,
+                    NULL,
+                    &rawVal);
+
+                values[i] = hx711_get_twos_comp(rawVal);
+
+                HX711_STATS_ONLY(hx711__stats_value(hx, startUs, full);)
+
+            }
+
+        );
+
+}
+
+void hx711_get_tagged_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    hx711_gain_t* const gains,
+    const size_t len) {
+
+        assert(hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
+        assert(values != NULL);
+        assert(gains != NULL);
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            for(size_t i = 0; i < len; ++i) {
+
+                HX711_STATS_ONLY(
+                    const uint32_t startUs = time_us_32();
+                    const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+                )
+
+                uint32_t rawVal;
+
+                hx711__wait_value(
+                    hx,
+                    NULL,
+                    &rawVal);
+
+                //the value is kept either way, but it may be the
+                //first at the new gain
+                hx711__is_superseded(hx, rawVal);
+
+                values[i] = hx711_get_twos_comp(rawVal);
+                gains[i] = hx711_get_raw_gain(rawVal);
+
+                HX711_STATS_ONLY(hx711__stats_value(hx, startUs, full);)
+
+            }
+
+        );
+
+}
+
 bool hx711_get_value_timeout(
     hx711_t* const hx,
     int32_t* const val,
     const uint timeout) {
 
         assert(hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
         assert(val != NULL);
 
         bool success = false;
@@ -304,11 +576,26 @@ bool hx711_get_value_timeout(
         assert(!is_nil_time(endTime));
 
         HX711_MUTEX_BLOCK(hx->_mut, 
-            while(!time_reached(endTime)) {
-                if((success = hx711__try_get_value(hx->_pio, hx->_reader_sm, &tempVal))) {
-                    break;
+
+            HX711_STATS_ONLY(
+                const uint32_t startUs = time_us_32();
+                const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+            )
+
+            success = hx711__wait_current_value(
+                hx,
+                &endTime,
+                &tempVal);
+
+            HX711_STATS_ONLY(
+                if(success) {
+                    hx711__stats_value(hx, startUs, full);
                 }
-            }
+                else {
+                    ++hx->_stats.timeouts;
+                }
+            )
+
         );
 
         if(success) {
@@ -324,16 +611,33 @@ bool hx711_get_value_noblock(
     int32_t* const val) {
 
         assert(hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
         assert(val != NULL);
 
         bool success;
         uint32_t tempVal;
 
         HX711_MUTEX_BLOCK(hx->_mut, 
-            success = hx711__try_get_value(
-                hx->_pio,
-                hx->_reader_sm,
-                &tempVal);
+
+            HX711_STATS_ONLY(
+                const uint32_t startUs = time_us_32();
+                const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+            )
+
+            do {
+                success = hx711__try_get_value(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    &tempVal);
+            } while(success && hx711__is_superseded(hx, tempVal));
+
+            HX711_STATS_ONLY(
+                if(success) {
+                    hx711__stats_value(hx, startUs, full);
+                }
+            )
+
         );
 
         if(success) {
@@ -344,130 +648,686 @@ bool hx711_get_value_noblock(
 
 }
 
-bool hx711__is_initd(hx711_t* const hx) {
-    return hx != NULL &&
-        hx->_pio != NULL &&
-#ifndef HX711_NO_MUTEX
-        mutex_is_initialized(&hx->_mut) &&
-#endif
-        pio_sm_is_claimed(hx->_pio, hx->_reader_sm);
-}
-
-bool hx711__is_state_machine_enabled(hx711_t* const hx) {
-    return hx711__is_initd(hx) &&
-        util_pio_sm_is_enabled(hx->_pio, hx->_reader_sm);
-}
-
-bool hx711_is_value_valid(const int32_t v) {
-    return util_int32_t_in_range(
-        v,
-        HX711_MIN_VALUE,
-        HX711_MAX_VALUE);
-}
-
-bool hx711_is_pio_gain_valid(const uint32_t g) {
-    return util_uint32_t_in_range(
-        g,
-        HX711_PIO_MIN_GAIN,
-        HX711_PIO_MAX_GAIN);
-}
-
-bool hx711_is_rate_valid(const hx711_rate_t r) {
-    return util_int_in_range(
-        (int)r,
-        hx711_rate_10,
-        hx711_rate_80);
-}
-
-bool hx711_is_gain_valid(const hx711_gain_t g) {
-    return util_int_in_range(
-        (int)g,
-        hx711_gain_128,
-        hx711_gain_64);
-}
-
-void hx711_power_up(
+void hx711_stream_start(
     hx711_t* const hx,
-    const hx711_gain_t gain) {
+    uint32_t* const buffer,
+    const size_t len) {
 
-        //the struct should be init'd, but the state machines
-        //should not be running
         assert(hx711__is_initd(hx));
-        assert(!hx711__is_state_machine_enabled(hx));
-
-        assert(hx711_is_gain_valid(gain));
-
-        const uint32_t gainVal = hx711_gain_to_pio_gain(gain);
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
+        assert(buffer != NULL);
+        assert(len > 0 && len <= HX711_STREAM_MAX_LEN);
 
-        assert(hx711_is_pio_gain_valid(gainVal));
+        //ring buffer must be a power of 2 in size and
+        //naturally aligned to that size
+        const uint ringBytes = (uint)(len * sizeof(uint32_t));
+        assert((len & (len - 1)) == 0);
+        assert(((uintptr_t)buffer & (ringBytes - 1)) == 0);
 
         HX711_MUTEX_BLOCK(hx->_mut, 
 
             /**
-             * NOTE: pio_sm_restart should not be used here.
-             * That function clears the clock divider which is
-             * currently set in the dedicated pio init function.
+             * Casting dma_claim_unused_channel to uint is OK in
+             * this circumstance. Ordinarily it would return -1 if
+             * the claim failed, but since the flag is given to
+             * require a DMA channel, panic would be called instead.
              */
+            hx->_dma_channel = (uint)dma_claim_unused_channel(true);
+
+            dma_channel_config cfg = dma_channel_get_default_config(
+                hx->_dma_channel);
 
             /**
-             * 1. set the clock pin low to power up the chip
-             * 
-             * There does not appear to be any delay after
-             * powering up. Any actual delay would presumably be
-             * dealt with by the HX711 prior to the data pin
-             * going low. Which, in turn, is handled by the state
-             * machine in waiting for the low signal.
+             * The reader program autopushes each 24 bit value as a
+             * full 32 bit word, so each transfer is one value and
+             * the ring always wraps on a value boundary.
              */
-            gpio_put(
-                hx->_clock_pin,
+            channel_config_set_transfer_data_size(
+                &cfg,
+                DMA_SIZE_32);
+
+            channel_config_set_read_increment(
+                &cfg,
                 false);
 
-            //2. reset the state machine using the default config
-            //obtained when init'ing.
-            pio_sm_init(
-                hx->_pio,
-                hx->_reader_sm,
-                hx->_reader_offset,
-                &hx->_reader_prog_default_config);
+            channel_config_set_write_increment(
+                &cfg,
+                true);
 
-            //make sure TX FIFO is empty before putting the 
-            //gain in.
-            pio_sm_drain_tx_fifo(
-                hx->_pio,
-                hx->_reader_sm);
+            channel_config_set_ring(
+                &cfg,
+                true,                               //true = wrap the write address
+                (uint)__builtin_ctz(ringBytes));    //log2 of the ring size in bytes
+
+            channel_config_set_dreq(
+                &cfg,
+                pio_get_dreq(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    false));
+
+            //no interrupts; the consumer polls the transfer count
+            channel_config_set_irq_quiet(
+                &cfg,
+                true);
 
-            //3. Push the initial gain into the TX FIFO
-            pio_sm_put(
-                hx->_pio,
-                hx->_reader_sm,
-                gainVal);
+            hx->_stream_buffer = buffer;
+            hx->_stream_len = len;
+            hx->_stream_read_count = 0;
 
-            //4. start the state machine
-            pio_sm_set_enabled(
+            //anything already in the RX FIFO may be stale
+            util_pio_sm_clear_rx_fifo(
                 hx->_pio,
-                hx->_reader_sm,
-                true);
+                hx->_reader_sm);
+
+            dma_channel_configure(
+                hx->_dma_channel,
+                &cfg,
+                buffer,                             //write to the ring buffer
+                &hx->_pio->rxf[hx->_reader_sm],     //read from reader pio program rx fifo
+                HX711_STREAM_TRANSFER_COUNT,
+                true);                              //true = start now
 
         );
 
 }
 
-void hx711_power_down(hx711_t* const hx) {
+void hx711_stream_stop(hx711_t* const hx) {
 
-    //don't have to have SMs running; just check for init
-    assert(hx711__is_initd(hx));
+    assert(hx711__is_streaming(hx));
 
     HX711_MUTEX_BLOCK(hx->_mut, 
 
-        //1. stop the state machine
-        pio_sm_set_enabled(
-            hx->_pio,
-            hx->_reader_sm,
-            false);
+        dma_channel_abort(hx->_dma_channel);
 
-        /**
-         * 2. set clock pin high to start the power down
-         * process
+        dma_channel_unclaim(hx->_dma_channel);
+
+        hx->_stream_buffer = NULL;
+        hx->_stream_len = 0;
+        hx->_stream_read_count = 0;
+
+    );
+
+}
+
+void hx711_gain_schedule_start(
+    hx711_t* const hx,
+    uint32_t* const buffer,
+    const hx711_gain_t* const gains,
+    const size_t len) {
+
+        assert(hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_gain_scheduled(hx));
+        assert(buffer != NULL);
+        assert(gains != NULL);
+        assert(len > 0 && len <= HX711_GAIN_SCHEDULE_MAX_LEN);
+
+        //the schedule is fed through the TX FIFO
+        assert(!hx->_join_rx_fifo);
+
+        //ring buffer must be a power of 2 in size and
+        //naturally aligned to that size
+        const uint ringBytes = (uint)(len * sizeof(uint32_t));
+        assert((len & (len - 1)) == 0);
+        assert(((uintptr_t)buffer & (ringBytes - 1)) == 0);
+
+        for(size_t i = 0; i < len; ++i) {
+            buffer[i] = hx711_gain_to_pio_gain(gains[i]);
+        }
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            hx->_schedule_dma_channel = (uint)dma_claim_unused_channel(true);
+
+            dma_channel_config cfg = dma_channel_get_default_config(
+                hx->_schedule_dma_channel);
+
+            channel_config_set_transfer_data_size(
+                &cfg,
+                DMA_SIZE_32);
+
+            channel_config_set_read_increment(
+                &cfg,
+                true);
+
+            channel_config_set_write_increment(
+                &cfg,
+                false);
+
+            channel_config_set_ring(
+                &cfg,
+                false,                              //false = wrap the read address
+                (uint)__builtin_ctz(ringBytes));    //log2 of the ring size in bytes
+
+            /**
+             * Paced by the TX FIFO, so the channel only runs
+             * when the state machine pulls a gain and the FIFO
+             * is kept full. The state machine pulls once after
+             * each value, so the schedule advances one gain per
+             * value.
+             */
+            channel_config_set_dreq(
+                &cfg,
+                pio_get_dreq(
+                    hx->_pio,
+                    hx->_reader_sm,
+                    true));
+
+            channel_config_set_irq_quiet(
+                &cfg,
+                true);
+
+            hx->_schedule_buffer = buffer;
+            hx->_schedule_len = len;
+
+            //every value is wanted while following a schedule
+            hx->_gain_pending = false;
+
+            //a gain left over from hx711_set_gain would
+            //otherwise come before the schedule
+            pio_sm_drain_tx_fifo(
+                hx->_pio,
+                hx->_reader_sm);
+
+            dma_channel_configure(
+                hx->_schedule_dma_channel,
+                &cfg,
+                &hx->_pio->txf[hx->_reader_sm],     //write to reader pio program tx fifo
+                buffer,                             //read from the schedule
+                HX711_STREAM_TRANSFER_COUNT,
+                true);                              //true = start now
+
+        );
+
+}
+
+void hx711_gain_schedule_stop(hx711_t* const hx) {
+
+    assert(hx711__is_gain_scheduled(hx));
+
+    HX711_MUTEX_BLOCK(hx->_mut, 
+
+        dma_channel_abort(hx->_schedule_dma_channel);
+
+        dma_channel_unclaim(hx->_schedule_dma_channel);
+
+        //the state machine keeps reusing the last gain it
+        //pulled once the FIFO is empty
+        pio_sm_drain_tx_fifo(
+            hx->_pio,
+            hx->_reader_sm);
+
+        hx->_schedule_buffer = NULL;
+        hx->_schedule_len = 0;
+
+    );
+
+}
+
+uint32_t hx711_stream_get_count(hx711_t* const hx) {
+    assert(hx711__is_streaming(hx));
+    return hx711__stream_get_count(hx);
+}
+
+size_t hx711_stream_available(
+    hx711_t* const hx,
+    size_t* const index) {
+
+        assert(hx711__is_streaming(hx));
+
+        size_t unread;
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            unread = hx711__stream_get_unread(hx);
+
+            if(index != NULL) {
+                *index = hx->_stream_read_count & (hx->_stream_len - 1);
+            }
+
+        );
+
+        return unread;
+
+}
+
+void hx711_stream_consume(
+    hx711_t* const hx,
+    const size_t count) {
+
+        assert(hx711__is_streaming(hx));
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            const size_t unread = hx711__stream_get_unread(hx);
+
+            assert(count <= unread);
+
+            hx->_stream_read_count += (uint32_t)MIN(count, unread);
+
+        );
+
+}
+
+size_t hx711_stream_get_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    const size_t len) {
+
+        assert(hx711__is_streaming(hx));
+        assert(values != NULL);
+
+        size_t count;
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            count = MIN(len, hx711__stream_get_unread(hx));
+
+            for(size_t i = 0; i < count; ++i) {
+                const size_t idx = (hx->_stream_read_count + i) & (hx->_stream_len - 1);
+                const uint32_t rawVal = hx->_stream_buffer[idx];
+                values[i] = hx711_get_twos_comp(rawVal);
+                hx711__is_superseded(hx, rawVal);
+            }
+
+            hx->_stream_read_count += (uint32_t)count;
+
+        );
+
+        return count;
+
+}
+
+size_t hx711_stream_get_tagged_values(
+    hx711_t* const hx,
+    int32_t* const values,
+    hx711_gain_t* const gains,
+    const size_t len) {
+
+        assert(hx711__is_streaming(hx));
+        assert(values != NULL);
+        assert(gains != NULL);
+
+        size_t count;
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            count = MIN(len, hx711__stream_get_unread(hx));
+
+            for(size_t i = 0; i < count; ++i) {
+                const size_t idx = (hx->_stream_read_count + i) & (hx->_stream_len - 1);
+                const uint32_t rawVal = hx->_stream_buffer[idx];
+                values[i] = hx711_get_twos_comp(rawVal);
+                gains[i] = hx711_get_raw_gain(rawVal);
+                hx711__is_superseded(hx, rawVal);
+            }
+
+            hx->_stream_read_count += (uint32_t)count;
+
+        );
+
+        return count;
+
+}
+
+bool hx711_publish(hx711_t* const hx) {
+
+    assert(hx711__is_state_machine_enabled(hx));
+    assert(!hx711__is_streaming(hx));
+    assert(!hx711__is_callback_running(hx));
+
+    //taken first, as in the callback handler, so that the time
+    //is as close as possible to the value being pushed
+    const uint64_t nowUs = time_us_64();
+
+    uint32_t rawVal;
+    uint32_t count = 0;
+    absolute_time_t time;
+
+    HX711_STATS_ONLY(
+        const uint32_t startUs = (uint32_t)nowUs;
+        const bool full = pio_sm_is_rx_fifo_full(hx->_pio, hx->_reader_sm);
+    )
+
+    //only the newest value is published; older values in the
+    //RX FIFO are still counted so readers can tell how many
+    //were skipped
+    while(hx711__try_get_value(hx->_pio, hx->_reader_sm, &rawVal)) {
+        hx711__is_superseded(hx, rawVal);
+        ++count;
+    }
+
+    if(count == 0) {
+        return false;
+    }
+
+    HX711_STATS_ONLY(
+        hx->_stats.values += count - 1;
+        hx711__stats_value(hx, startUs, full);
+    )
+
+    update_us_since_boot(
+        &time,
+        nowUs - hx->_read_time_us);
+
+    hx711__latest_write(
+        hx,
+        hx711_get_twos_comp(rawVal),
+        hx711_get_raw_gain(rawVal),
+        hx->_latest_count + count,
+        time);
+
+    return true;
+
+}
+
+bool hx711_get_latest(
+    hx711_t* const hx,
+    hx711_sample_t* const sample) {
+
+        assert(hx711__is_initd(hx));
+        assert(sample != NULL);
+
+        uint32_t begin;
+        uint32_t end;
+        uint64_t timeUs;
+
+        do {
+
+            begin = hx->_latest_seq;
+            __dmb();
+
+            sample->value = hx->_latest_value;
+            sample->gain = hx->_latest_gain;
+            sample->count = hx->_latest_count;
+            timeUs = hx->_latest_time_us;
+
+            __dmb();
+            end = hx->_latest_seq;
+
+        } while((begin & 1) != 0 || begin != end);
+
+        update_us_since_boot(&sample->time, timeUs);
+
+        return sample->count != 0;
+
+}
+
+void hx711_callback_start(
+    hx711_t* const hx,
+    const hx711_callback_t callback,
+    void* const ctx) {
+
+        assert(hx711__is_initd(hx));
+        assert(!hx711__is_streaming(hx));
+        assert(!hx711__is_callback_running(hx));
+        assert(callback != NULL);
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            hx711__irq_acquire(hx);
+
+            UTIL_INTERRUPTS_OFF_BLOCK(
+
+                hx->_callback = callback;
+                hx->_callback_ctx = ctx;
+                hx->_callback_count = 0;
+
+                hx711__irq_set_source_enabled(hx, true);
+
+            );
+
+        );
+
+}
+
+void hx711_callback_stop(hx711_t* const hx) {
+
+    assert(hx711__is_callback_running(hx));
+
+    HX711_MUTEX_BLOCK(hx->_mut, 
+
+        UTIL_INTERRUPTS_OFF_BLOCK(
+
+            hx711__irq_set_source_enabled(hx, false);
+
+            hx->_callback = NULL;
+            hx->_callback_ctx = NULL;
+
+        );
+
+        hx711__irq_release(hx);
+
+    );
+
+}
+
+#ifdef HX711_STATS
+void hx711_get_stats(
+    hx711_t* const hx,
+    hx711_stats_t* const stats) {
+
+        assert(hx711__is_initd(hx));
+        assert(stats != NULL);
+
+        //the interrupt handler may be part way through
+        //updating them
+        UTIL_INTERRUPTS_OFF_BLOCK(
+            *stats = hx->_stats;
+        );
+
+}
+
+void hx711_reset_stats(hx711_t* const hx) {
+
+    assert(hx711__is_initd(hx));
+
+    UTIL_INTERRUPTS_OFF_BLOCK(
+        hx711_stats_reset(&hx->_stats);
+    );
+
+}
+#endif
+
+bool hx711__is_initd(hx711_t* const hx) {
+    return hx != NULL &&
+        hx->_pio != NULL &&
+#ifndef HX711_NO_MUTEX
+        mutex_is_initialized(&hx->_mut) &&
+#endif
+        pio_sm_is_claimed(hx->_pio, hx->_reader_sm);
+}
+
+bool hx711__is_state_machine_enabled(hx711_t* const hx) {
+    return hx711__is_initd(hx) &&
+        util_pio_sm_is_enabled(hx->_pio, hx->_reader_sm);
+}
+
+bool hx711__is_streaming(hx711_t* const hx) {
+    return hx711__is_initd(hx) &&
+        hx->_stream_buffer != NULL;
+}
+
+bool hx711__is_gain_scheduled(hx711_t* const hx) {
+    return hx711__is_initd(hx) &&
+        hx->_schedule_buffer != NULL;
+}
+
+uint32_t hx711__stream_get_count(hx711_t* const hx) {
+
+    //the remaining transfer count is decremented as each
+    //value is read from the RX FIFO
+    return HX711_STREAM_TRANSFER_COUNT -
+        util_dma_get_transfer_count(hx->_dma_channel);
+
+}
+
+size_t hx711__stream_get_unread(hx711_t* const hx) {
+
+    const uint32_t count = hx711__stream_get_count(hx);
+    uint32_t unread = count - hx->_stream_read_count;
+
+    if(unread > hx->_stream_len) {
+        //the DMA channel has lapped the reader, so the
+        //oldest values have been overwritten
+        hx->_stream_read_count = count - (uint32_t)hx->_stream_len;
+        unread = (uint32_t)hx->_stream_len;
+    }
+
+    return unread;
+
+}
+
+bool hx711_is_value_valid(const int32_t v) {
+    return util_int32_t_in_range(
+        v,
+        HX711_MIN_VALUE,
+        HX711_MAX_VALUE);
+}
+
+bool hx711_is_pio_gain_valid(const uint32_t g) {
+    return util_uint32_t_in_range(
+        g,
+        HX711_PIO_MIN_GAIN,
+        HX711_PIO_MAX_GAIN);
+}
+
+bool hx711_is_rate_valid(const hx711_rate_t r) {
+    return util_int_in_range(
+        (int)r,
+        hx711_rate_10,
+        hx711_rate_80);
+}
+
+bool hx711_is_pd_sck_hz_valid(const uint32_t hz) {
+    return util_uint32_t_in_range(
+        hz,
+        HX711_PD_SCK_MIN_HZ,
+        HX711_PD_SCK_MAX_HZ);
+}
+
+uint32_t hx711_pd_sck_hz_to_read_time_us(const uint32_t hz) {
+    return hx711__pd_sck_hz_to_read_time_us(
+        hz,
+        HX711_READ_OVERHEAD_HALVES);
+}
+
+uint32_t hx711__pd_sck_hz_to_read_time_us(
+    const uint32_t hz,
+    const int overheadHalves) {
+
+        assert(hx711_is_pd_sck_hz_valid(hz));
+
+        //one clock period (two halves) per bit
+        const uint64_t halves = (uint64_t)((int)HX711_READ_BITS * 2 + overheadHalves);
+        const uint64_t div = (uint64_t)hz * 2;
+
+        return (uint32_t)((halves * 1000000u + div - 1) / div);
+
+}
+
+uint32_t hx711_get_read_time_us(hx711_t* const hx) {
+    assert(hx711__is_initd(hx));
+    return hx->_read_time_us;
+}
+
+bool hx711_is_gain_valid(const hx711_gain_t g) {
+    return util_int_in_range(
+        (int)g,
+        hx711_gain_128,
+        hx711_gain_64);
+}
+
+void hx711_power_up(
+    hx711_t* const hx,
+    const hx711_gain_t gain) {
+
+        //the struct should be init'd, but the state machines
+        //should not be running
+        assert(hx711__is_initd(hx));
+        assert(!hx711__is_state_machine_enabled(hx));
+        assert(!hx711__is_gain_scheduled(hx));
+
+        assert(hx711_is_gain_valid(gain));
+
+        const uint32_t gainVal = hx711_gain_to_pio_gain(gain);
+
+        assert(hx711_is_pio_gain_valid(gainVal));
+
+        HX711_MUTEX_BLOCK(hx->_mut, 
+
+            /**
+             * NOTE: pio_sm_restart should not be used here.
+             * That function clears the clock divider which is
+             * currently set in the dedicated pio init function.
+             */
+
+            /**
+             * 1. set the clock pin low to power up the chip
+             * 
+             * There does not appear to be any delay after
+             * powering up. Any actual delay would presumably be
+             * dealt with by the HX711 prior to the data pin
+             * going low. Which, in turn, is handled by the state
+             * machine in waiting for the low signal.
+             */
+            gpio_put(
+                hx->_clock_pin,
+                false);
+
+            //2. reset the state machine using the default config
+            //obtained when init'ing.
+            pio_sm_init(
+                hx->_pio,
+                hx->_reader_sm,
+                hx->_reader_offset,
+                &hx->_reader_prog_default_config);
+
+            //make sure TX FIFO is empty before putting the 
+            //gain in.
+            pio_sm_drain_tx_fifo(
+                hx->_pio,
+                hx->_reader_sm);
+
+            //3. Push the initial gain into the TX FIFO
+            pio_sm_put(
+                hx->_pio,
+                hx->_reader_sm,
+                gainVal);
+
+            //the first conversion after power up is always at
+            //a gain of 128
+            hx->_gain = gain;
+            hx->_gain_old_values = 1;
+            hx->_gain_pending = true;
+
+            //4. start the state machine
+            pio_sm_set_enabled(
+                hx->_pio,
+                hx->_reader_sm,
+                true);
+
+        );
+
+}
+
+void hx711_power_down(hx711_t* const hx) {
+
+    //don't have to have SMs running; just check for init
+    assert(hx711__is_initd(hx));
+
+    HX711_MUTEX_BLOCK(hx->_mut, 
+
+        //1. stop the state machine
+        pio_sm_set_enabled(
+            hx->_pio,
+            hx->_reader_sm,
+            false);
+
+        /**
+         * 2. set clock pin high to start the power down
+         * process
          *
          * NOTE: the HX711 chip requires the clock pin to
          * be held high for 60+ us
@@ -488,8 +1348,63 @@ void hx711_wait_settle(const hx711_rate_t rate) {
     sleep_ms(hx711_get_settling_time(rate));
 }
 
+hx711_rate_t hx711_detect_rate(hx711_t* const hx) {
+
+    assert(hx711__is_state_machine_enabled(hx));
+    assert(!hx711__is_streaming(hx));
+    assert(!hx711__is_callback_running(hx));
+
+    HX711_MUTEX_BLOCK(hx->_mut, 
+
+        //a value already waiting could have been converted at
+        //any time, so only values which arrive from here are
+        //timed. Both are still checked so that a pending gain
+        //is seen as set
+        util_pio_sm_clear_rx_fifo(hx->_pio, hx->_reader_sm);
+
+        uint32_t rawVal;
+
+        hx711__wait_value(hx, NULL, &rawVal);
+        const uint64_t firstUs = time_us_64();
+        hx711__is_superseded(hx, rawVal);
+
+        //the reader is free-running, so this is the next
+        //conversion whether or not it is at the same gain
+        hx711__wait_value(hx, NULL, &rawVal);
+        const uint64_t secondUs = time_us_64();
+        hx711__is_superseded(hx, rawVal);
+
+        hx->_rate = hx711_interval_us_to_rate(secondUs - firstUs);
+        hx->_rate_detected = true;
+
+    );
+
+    return hx->_rate;
+
+}
+
+hx711_rate_t hx711_get_rate(hx711_t* const hx) {
+    assert(hx711__is_initd(hx));
+    return hx->_rate;
+}
+
+bool hx711_is_rate_detected(hx711_t* const hx) {
+    assert(hx711__is_initd(hx));
+    return hx->_rate_detected;
+}
+
+void hx711_wait_until_settled(hx711_t* const hx) {
+    hx711_wait_settle(hx711_get_rate(hx));
+}
+
+uint hx711_get_timeout_us(hx711_t* const hx) {
+    assert(hx711__is_initd(hx));
+    return 2000000u / hx711_get_rate_sps(hx->_rate) + hx->_read_time_us;
+}
+
 void hx711_wait_power_down() {
-    sleep_us(HX711_POWER_DOWN_TIMEOUT);
+    //the clock pin must be high for longer than the timeout
+    sleep_us(HX711_POWER_DOWN_TIMEOUT + 1);
 }
 
 uint32_t hx711_gain_to_pio_gain(const hx711_gain_t gain) {
@@ -513,6 +1428,371 @@ uint32_t hx711_gain_to_pio_gain(const hx711_gain_t gain) {
 
 }
 
+hx711_gain_t hx711_pio_gain_to_gain(const uint32_t pioGain) {
+
+    assert(hx711_is_pio_gain_valid(pioGain));
+
+    //the reverse of hx711_gain_to_pio_gain
+    const uint clockPulses = pioGain + HX711_READ_BITS + 1;
+
+    for(uint i = 0; i < count_of(HX711_CLOCK_PULSES); ++i) {
+        if(HX711_CLOCK_PULSES[i] == clockPulses) {
+            return (hx711_gain_t)i;
+        }
+    }
+
+    assert(false);
+    return hx711_gain_128;
+
+}
+
+hx711_gain_t hx711_get_raw_gain(const uint32_t raw) {
+
+    const uint32_t pioGain =
+        (raw >> HX711_READ_BITS) & ((1u << HX711_GAIN_TAG_BITS) - 1);
+
+    //x can only be set to a valid gain, but the tag is
+    //outside the value so may be anything if the program
+    //does not tag values
+    return hx711_is_pio_gain_valid(pioGain)
+        ? hx711_pio_gain_to_gain(pioGain)
+        : hx711_gain_128;
+
+}
+
+bool hx711__is_callback_running(hx711_t* const hx) {
+    return hx711__is_initd(hx) &&
+        hx->_callback != NULL;
+}
+
+bool hx711__callback_irq_is_shared(hx711_t* const hx) {
+
+    hx711_t* const* const row =
+        hx711__callback_array[pio_get_index(hx->_pio)];
+
+    for(uint i = 0; i < NUM_PIO_STATE_MACHINES; ++i) {
+        if(row[i] != NULL &&
+            row[i] != hx &&
+            row[i]->_pio_irq_index == hx->_pio_irq_index) {
+                return true;
+        }
+    }
+
+    return false;
+
+}
+
+void hx711__irq_attach(hx711_t* const hx) {
+
+    const uint irqNum = util_pio_get_irq_from_index(
+        hx->_pio,
+        hx->_pio_irq_index);
+
+    if(!hx711__callback_irq_is_shared(hx)) {
+        irq_add_shared_handler(
+            irqNum,
+            hx711__callback_irq_handler,
+            PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    }
+
+    hx711__callback_array[pio_get_index(hx->_pio)][hx->_reader_sm] = hx;
+
+    irq_set_enabled(
+        irqNum,
+        true);
+
+}
+
+void hx711__irq_detach(hx711_t* const hx) {
+
+    const uint irqNum = util_pio_get_irq_from_index(
+        hx->_pio,
+        hx->_pio_irq_index);
+
+    hx711__irq_set_source_enabled(hx, false);
+
+    hx711__callback_array[pio_get_index(hx->_pio)][hx->_reader_sm] = NULL;
+
+    if(!hx711__callback_irq_is_shared(hx)) {
+
+        irq_remove_handler(
+            irqNum,
+            hx711__callback_irq_handler);
+
+        //other code may still have handlers on the IRQ
+        if(!irq_has_shared_handler(irqNum)) {
+            irq_set_enabled(
+                irqNum,
+                false);
+        }
+
+    }
+
+}
+
+void hx711__irq_acquire(hx711_t* const hx) {
+
+    //only this hx writes its own entry, and it holds its
+    //mutex, so the entry can be checked without the lock
+    if(hx711__callback_array[pio_get_index(hx->_pio)][hx->_reader_sm] == hx) {
+        return;
+    }
+
+    HX711_MUTEX_BLOCK(hx711__callback_array_mut, 
+        UTIL_INTERRUPTS_OFF_BLOCK(
+            hx711__irq_attach(hx);
+        );
+    );
+
+}
+
+void hx711__irq_release(hx711_t* const hx) {
+
+    if(hx711__callback_array[pio_get_index(hx->_pio)][hx->_reader_sm] != hx) {
+        return;
+    }
+
+    HX711_MUTEX_BLOCK(hx711__callback_array_mut, 
+        UTIL_INTERRUPTS_OFF_BLOCK(
+            hx711__irq_detach(hx);
+        );
+    );
+
+}
+
+void hx711__irq_set_source_enabled(
+    hx711_t* const hx,
+    const bool enabled) {
+
+        pio_set_irqn_source_enabled(
+            hx->_pio,
+            hx->_pio_irq_index,
+            (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + hx->_reader_sm),
+            enabled);
+
+}
+
+bool hx711__wait_value(
+    hx711_t* const hx,
+    const absolute_time_t* const end,
+    uint32_t* const rawVal) {
+
+        //no need to involve the IRQ if a value is already
+        //waiting, as it will be when reading continuously
+        if(hx711__try_get_value(hx->_pio, hx->_reader_sm, rawVal)) {
+            return true;
+        }
+
+        bool success = false;
+
+        //the handler stays attached after the first wait so
+        //later ones only enable the source
+        hx711__irq_acquire(hx);
+
+        while(true) {
+
+            //the handler disables the source each time it wakes
+            //this core, so it is enabled again before checking.
+            //If the value arrives after the check, the handler
+            //runs and __wfe returns immediately
+            hx711__irq_set_source_enabled(hx, true);
+
+            if(hx711__try_get_value(hx->_pio, hx->_reader_sm, rawVal)) {
+                success = true;
+                break;
+            }
+
+            if(end == NULL) {
+                __wfe();
+            }
+            else if(best_effort_wfe_or_timeout(*end)) {
+                break;
+            }
+
+        }
+
+        //values which arrive while not waiting are left in
+        //the RX FIFO
+        hx711__irq_set_source_enabled(hx, false);
+
+        return success;
+
+}
+
+bool hx711__wait_current_value(
+    hx711_t* const hx,
+    const absolute_time_t* const end,
+    uint32_t* const rawVal) {
+
+        while(hx711__wait_value(hx, end, rawVal)) {
+            if(!hx711__is_superseded(hx, *rawVal)) {
+                return true;
+            }
+        }
+
+        return false;
+
+}
+
+bool __not_in_flash_func(hx711__is_superseded)(
+    hx711_t* const hx,
+    const uint32_t raw) {
+
+        if(!hx->_gain_pending) {
+            return false;
+        }
+
+        if(hx->_gain_old_values != 0) {
+            --hx->_gain_old_values;
+        }
+
+        if(hx711_get_raw_gain(raw) != hx->_gain) {
+            return true;
+        }
+
+        hx->_gain_pending = false;
+
+        return false;
+
+}
+
+void __isr __not_in_flash_func(hx711__callback_irq_handler)() {
+
+    //taken first so that the time is as close as possible to
+    //the value being pushed
+    const uint64_t nowUs = time_us_64();
+
+    HX711_STATS_ONLY(const uint32_t startUs = (uint32_t)nowUs;)
+
+    const uint irqNum = __get_current_exception() - VTABLE_FIRST_IRQ;
+    PIO const pio = util_pio_get_pio_from_irq(irqNum);
+    const int irqIndex = util_pio_get_index_from_irq(irqNum);
+
+    assert(irqIndex >= 0);
+
+    //one RX FIFO not empty source per state machine, starting
+    //from sm0
+    static const uint32_t rxNotEmptyMask =
+        ((1u << NUM_PIO_STATE_MACHINES) - 1) << pis_sm0_rx_fifo_not_empty;
+
+    hx711_t* const* const row = hx711__callback_array[pio_get_index(pio)];
+    uint32_t status = (irqIndex == 0 ? pio->ints0 : pio->ints1) & rxNotEmptyMask;
+    hx711_sample_t sample;
+
+    while(status != 0) {
+
+        const uint sm = (uint)__builtin_ctz(status) - pis_sm0_rx_fifo_not_empty;
+        hx711_t* const hx = row[sm];
+
+        status &= status - 1;
+
+        //the IRQ may be shared with other code
+        if(hx == NULL) {
+            continue;
+        }
+
+        //a blocking read is waiting for the value and takes it
+        //itself once woken. The interrupt is level triggered, so
+        //the source is disabled until the reader next waits
+        if(hx->_callback == NULL) {
+            pio_set_irqn_source_enabled(
+                pio,
+                (uint)irqIndex,
+                (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + sm),
+                false);
+            //the reader may be waiting on the other core
+            __sev();
+            continue;
+        }
+
+        HX711_STATS_ONLY(
+            hx->_stats.overflows += pio_sm_is_rx_fifo_full(pio, sm) ? 1 : 0;
+        )
+
+        //each hx may be clocked at a different rate
+        update_us_since_boot(
+            &sample.time,
+            nowUs - hx->_read_time_us);
+
+        //the interrupt is level triggered and only clears
+        //once the RX FIFO is empty
+        while(!pio_sm_is_rx_fifo_empty(pio, sm)) {
+            HX711_STATS_ONLY(++hx->_stats.values;)
+            const uint32_t rawVal = pio_sm_get(pio, sm);
+            sample.value = hx711_get_twos_comp(rawVal);
+            sample.gain = hx711_get_raw_gain(rawVal);
+            hx711__is_superseded(hx, rawVal);
+            sample.count = ++hx->_callback_count;
+            hx->_callback(
+                &sample,
+                hx->_callback_ctx);
+        }
+
+        //includes any earlier hx handled in this call
+        HX711_STATS_ONLY(
+            hx711_stats_latency_add(
+                &hx->_stats.isr_us,
+                time_us_32() - startUs);
+        )
+
+    }
+
+    //the IRQ was set pending again while the RX FIFO was not
+    //empty; clear it so the CPU is not woken a second time for
+    //the same value. If any source is still asserted, the IRQ
+    //will immediately be set pending again.
+    irq_clear(irqNum);
+
+}
+
+void hx711__latest_write(
+    hx711_t* const hx,
+    const int32_t value,
+    const hx711_gain_t gain,
+    const uint32_t count,
+    const absolute_time_t time) {
+
+        //with interrupts disabled, a reader on this core can
+        //never see the write in progress, and a reader on the
+        //other core only retries for the duration of the write
+        UTIL_INTERRUPTS_OFF_BLOCK(
+
+            const uint32_t seq = hx->_latest_seq;
+
+            hx->_latest_seq = seq + 1;
+            __dmb();
+
+            hx->_latest_value = value;
+            hx->_latest_gain = gain;
+            hx->_latest_count = count;
+            hx->_latest_time_us = to_us_since_boot(time);
+
+            __dmb();
+            hx->_latest_seq = seq + 2;
+
+        );
+
+}
+
+#ifdef HX711_STATS
+void hx711__stats_value(
+    hx711_t* const hx,
+    const uint32_t startUs,
+    const bool full) {
+
+        ++hx->_stats.values;
+
+        if(full) {
+            ++hx->_stats.overflows;
+        }
+
+        hx711_stats_latency_add(
+            &hx->_stats.wait_us,
+            time_us_32() - startUs);
+
+}
+#endif
+
 bool hx711__try_get_value(
     PIO const pio,
     const uint sm,
@@ -523,12 +1803,14 @@ bool hx711__try_get_value(
         assert(util_pio_sm_is_enabled(pio, sm));
         assert(val != NULL);
 
-        static const uint byteThreshold = HX711_READ_BITS / 8;
+        //the RX FIFO level is a count of words and each word is
+        //a whole value, so one is enough
+        static const uint wordThreshold = 1;
 
         return util_pio_sm_try_get(
             pio,
             sm,
             val,
-            byteThreshold);
+            wordThreshold);
 
 }
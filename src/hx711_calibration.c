@@ -0,0 +1,327 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "pico/types.h"
+#include "../include/hx711.h"
+#include "../include/hx711_calibration.h"
+#include "../include/hx711_multi.h"
+
+void hx711_calibration_init(hx711_calibration_t* const cal) {
+
+    assert(cal != NULL);
+
+    for(uint i = 0; i < HX711_CALIBRATION_GAINS; ++i) {
+        cal->_entries[i]._offset = 0;
+        cal->_entries[i]._multiplier = 1;
+        cal->_entries[i]._shift = 0;
+    }
+
+}
+
+void hx711_calibration_set_offset(
+    hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t offset) {
+
+        assert(cal != NULL);
+        assert(hx711_is_gain_valid(gain));
+        assert(hx711_is_value_valid(offset));
+
+        cal->_entries[gain]._offset = offset;
+
+}
+
+int32_t hx711_calibration_get_offset(
+    const hx711_calibration_t* const cal,
+    const hx711_gain_t gain) {
+
+        assert(cal != NULL);
+        assert(hx711_is_gain_valid(gain));
+
+        return cal->_entries[gain]._offset;
+
+}
+
+void hx711_calibration_set_scale(
+    hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t units,
+    const int32_t counts) {
+
+        assert(cal != NULL);
+        assert(hx711_is_gain_valid(gain));
+        assert(counts != 0);
+
+        //the sign goes on the numerator so the divisor is positive
+        const int64_t num = counts < 0 ? -(int64_t)units : units;
+        const int64_t den = counts < 0 ? -(int64_t)counts : counts;
+
+        //this is only done when calibrating, so the 64 bit
+        //division is fine; use the most fractional bits which
+        //still leave the multiplier within 32 bits
+        uint8_t shift = HX711_CALIBRATION_MAX_SHIFT;
+        int64_t multiplier;
+
+        for(;;) {
+            multiplier = hx711_calibration__div_round(
+                num * ((int64_t)1 << shift),
+                den);
+            if((multiplier >= INT32_MIN && multiplier <= INT32_MAX) || shift == 0) {
+                break;
+            }
+            --shift;
+        }
+
+        //only units of INT32_MIN with counts of -1 cannot fit
+        assert(multiplier >= INT32_MIN && multiplier <= INT32_MAX);
+
+        cal->_entries[gain]._multiplier = (int32_t)multiplier;
+        cal->_entries[gain]._shift = shift;
+
+}
+
+void hx711_calibration_set_multiplier(
+    hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t multiplier,
+    const uint8_t shift) {
+
+        assert(cal != NULL);
+        assert(hx711_is_gain_valid(gain));
+        assert(shift <= HX711_CALIBRATION_MAX_SHIFT);
+
+        cal->_entries[gain]._multiplier = multiplier;
+        cal->_entries[gain]._shift = shift;
+
+}
+
+int32_t hx711_calibration_apply(
+    const hx711_calibration_t* const cal,
+    const hx711_gain_t gain,
+    const int32_t raw) {
+
+        assert(cal != NULL);
+        assert(hx711_is_gain_valid(gain));
+        assert(hx711_is_value_valid(raw));
+
+        const hx711_calibration_entry_t* const e = &cal->_entries[gain];
+
+        //the difference is at most 25 bits and the multiplier 32,
+        //so the product cannot overflow; on the M0+ this is a
+        //single 32x32 to 64 bit multiply routine rather than the
+        //soft float subtract, multiply and conversions
+        int64_t val = (int64_t)(raw - e->_offset) * e->_multiplier;
+
+        if(e->_shift > 0) {
+            //round half up, then an arithmetic shift
+            val = (val + ((int64_t)1 << (e->_shift - 1))) >> e->_shift;
+        }
+
+        if(val > INT32_MAX) {
+            return INT32_MAX;
+        }
+
+        if(val < INT32_MIN) {
+            return INT32_MIN;
+        }
+
+        return (int32_t)val;
+
+}
+
+int32_t hx711_calibration_get_value(
+    const hx711_calibration_t* const cal,
+    hx711_t* const hx) {
+
+        assert(cal != NULL);
+
+        hx711_gain_t gain;
+        const int32_t raw = hx711_get_tagged_value(hx, &gain);
+
+        return hx711_calibration_apply(
+            cal,
+            gain,
+            raw);
+
+}
+
+void hx711_calibration_get_values(
+    const hx711_calibration_t* const cal,
+    hx711_t* const hx,
+    int32_t* const values,
+    const size_t len) {
+
+        assert(cal != NULL);
+        assert(values != NULL);
+
+        hx711_gain_t gains[HX711_CALIBRATION_BATCH_LEN];
+
+        for(size_t i = 0; i < len; i += HX711_CALIBRATION_BATCH_LEN) {
+
+            const size_t n = MIN(len - i, (size_t)HX711_CALIBRATION_BATCH_LEN);
+
+            hx711_get_tagged_values(hx, &values[i], gains, n);
+
+            for(size_t j = 0; j < n; ++j) {
+                values[i + j] = hx711_calibration_apply(
+                    cal,
+                    gains[j],
+                    values[i + j]);
+            }
+
+        }
+
+}
+
+void hx711_calibration_multi_get_values(
+    const hx711_calibration_t* const cals,
+    hx711_multi_t* const hxm,
+    int32_t* const values) {
+
+        assert(cals != NULL);
+        assert(hxm != NULL);
+        assert(values != NULL);
+
+        hx711_gain_t gain;
+
+        hx711_multi_get_tagged_values(
+            hxm,
+            values,
+            &gain);
+
+        for(size_t i = 0; i < hxm->_chips_len; ++i) {
+            values[i] = hx711_calibration_apply(
+                &cals[i],
+                gain,
+                values[i]);
+        }
+
+}
+
+void hx711_calibration_tare(
+    hx711_calibration_t* const cal,
+    hx711_t* const hx,
+    const size_t samples) {
+
+        assert(cal != NULL);
+        assert(samples > 0);
+
+        int32_t values[HX711_CALIBRATION_BATCH_LEN];
+        hx711_gain_t gains[HX711_CALIBRATION_BATCH_LEN];
+        hx711_gain_t tareGain = hx711_gain_128;
+        int64_t sum = 0;
+        size_t n = 0;
+
+        while(n < samples) {
+
+            const size_t batch = MIN(samples - n, (size_t)HX711_CALIBRATION_BATCH_LEN);
+
+            hx711_get_tagged_values(hx, values, gains, batch);
+
+            for(size_t i = 0; i < batch; ++i) {
+
+                //the gain was changed, so only the values at the
+                //new gain are used
+                if(n > 0 && gains[i] != tareGain) {
+                    sum = 0;
+                    n = 0;
+                }
+
+                tareGain = gains[i];
+                sum += values[i];
+                ++n;
+
+            }
+
+        }
+
+        hx711_calibration_set_offset(
+            cal,
+            tareGain,
+            (int32_t)hx711_calibration__div_round(sum, (int64_t)samples));
+
+}
+
+void hx711_calibration_multi_tare(
+    hx711_calibration_t* const cals,
+    hx711_multi_t* const hxm,
+    const size_t samples) {
+
+        assert(cals != NULL);
+        assert(hxm != NULL);
+        assert(samples > 0);
+
+        int32_t values[HX711_MULTI_MAX_CHIPS];
+        int64_t sums[HX711_MULTI_MAX_CHIPS] = {0};
+        hx711_gain_t tareGain;
+        hx711_gain_t gain;
+        size_t n = 0;
+
+        while(n < samples) {
+
+            hx711_multi_get_tagged_values(hxm, values, &gain);
+
+            //the gain was changed, so only the values at the
+            //new gain are used
+            if(n > 0 && gain != tareGain) {
+                for(size_t i = 0; i < hxm->_chips_len; ++i) {
+                    sums[i] = 0;
+                }
+                n = 0;
+            }
+
+            tareGain = gain;
+
+            for(size_t i = 0; i < hxm->_chips_len; ++i) {
+                sums[i] += values[i];
+            }
+
+            ++n;
+
+        }
+
+        for(size_t i = 0; i < hxm->_chips_len; ++i) {
+            hx711_calibration_set_offset(
+                &cals[i],
+                tareGain,
+                (int32_t)hx711_calibration__div_round(sums[i], (int64_t)samples));
+        }
+
+}
+
+int64_t hx711_calibration__div_round(
+    const int64_t num,
+    const int64_t den) {
+
+        assert(den > 0);
+
+        //division truncates towards zero, so move the
+        //numerator half a step away from zero first
+        return num >= 0
+            ? (num + (den / 2)) / den
+            : (num - (den / 2)) / den;
+
+}
@@ -0,0 +1,468 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "pico/platform.h"
+#include "pico/types.h"
+#include "../include/hx711.h"
+#include "../include/hx711_filter.h"
+#include "../include/hx711_multi.h"
+
+void hx711_filter_moving_average_init(
+    hx711_filter_stage_t* const stage,
+    int32_t* const window,
+    const size_t len) {
+
+        assert(stage != NULL);
+        assert(window != NULL);
+        assert(len > 0 && len <= HX711_FILTER_MOVING_AVERAGE_MAX_LEN);
+
+        memset(stage, 0, sizeof(*stage));
+
+        stage->_type = hx711_filter_type_moving_average;
+        stage->_window = window;
+        stage->_len = len;
+
+}
+
+void hx711_filter_median_init(
+    hx711_filter_stage_t* const stage,
+    int32_t* const window,
+    const size_t len) {
+
+        assert(stage != NULL);
+        assert(window != NULL);
+        assert(len > 0 && len <= HX711_FILTER_MEDIAN_MAX_LEN);
+
+        memset(stage, 0, sizeof(*stage));
+
+        stage->_type = hx711_filter_type_median;
+        stage->_window = window;
+        stage->_len = len;
+
+}
+
+void hx711_filter_iir_init(
+    hx711_filter_stage_t* const stage,
+    const uint32_t coeff) {
+
+        assert(stage != NULL);
+        assert(coeff > 0 && coeff <= (1u << HX711_FILTER_IIR_COEFF_BITS));
+
+        memset(stage, 0, sizeof(*stage));
+
+        stage->_type = hx711_filter_type_iir;
+        stage->_coeff = coeff;
+
+}
+
+void hx711_filter_outlier_init(
+    hx711_filter_stage_t* const stage,
+    const int32_t threshold,
+    const uint max_rejects) {
+
+        assert(stage != NULL);
+        assert(threshold >= 0);
+
+        memset(stage, 0, sizeof(*stage));
+
+        stage->_type = hx711_filter_type_outlier;
+        stage->_threshold = threshold;
+        stage->_max_rejects = max_rejects;
+
+}
+
+void hx711_filter_init(
+    hx711_filter_t* const filter,
+    hx711_filter_stage_t* const stages,
+    const size_t len) {
+
+        assert(filter != NULL);
+        assert(stages != NULL || len == 0);
+
+        filter->_stages = stages;
+        filter->_len = len;
+
+}
+
+void hx711_filter_reset(hx711_filter_t* const filter) {
+
+    assert(filter != NULL);
+
+    for(size_t i = 0; i < filter->_len; ++i) {
+        hx711_filter_stage_t* const stage = &filter->_stages[i];
+        stage->_count = 0;
+        stage->_index = 0;
+        stage->_sum = 0;
+        stage->_state = 0;
+        stage->_rejects = 0;
+        stage->_last = 0;
+        stage->_primed = false;
+    }
+
+}
+
+int32_t hx711_filter_stage_apply(
+    hx711_filter_stage_t* const stage,
+    const int32_t value) {
+
+        assert(stage != NULL);
+        assert(hx711_is_value_valid(value));
+
+        switch(stage->_type) {
+
+            case hx711_filter_type_moving_average:
+
+                //the window is a ring; once full, the oldest
+                //value leaves the sum as the newest enters
+                if(stage->_count == stage->_len) {
+                    stage->_sum -= stage->_window[stage->_index];
+                }
+                else {
+                    ++stage->_count;
+                }
+
+                stage->_window[stage->_index] = value;
+                stage->_sum += value;
+                stage->_index = (stage->_index + 1) % stage->_len;
+
+                return hx711_filter__div_round(
+                    stage->_sum,
+                    (int32_t)stage->_count);
+
+            case hx711_filter_type_median:
+
+                if(stage->_count < stage->_len) {
+                    ++stage->_count;
+                }
+
+                stage->_window[stage->_index] = value;
+                stage->_index = (stage->_index + 1) % stage->_len;
+
+                return hx711_filter__median(stage);
+
+            case hx711_filter_type_iir: {
+
+                //the state is kept with extra fractional bits
+                //so that small steps are not lost to rounding;
+                //an HX711 value shifted by these bits still
+                //fits in 32 bits
+                const int32_t x = value * (1 << HX711_FILTER_IIR_STATE_BITS);
+
+                if(!stage->_primed) {
+                    stage->_state = x;
+                    stage->_primed = true;
+                }
+                else {
+                    const int64_t diff = (int64_t)x - stage->_state;
+                    stage->_state += (int32_t)(
+                        (diff * stage->_coeff) >> HX711_FILTER_IIR_COEFF_BITS);
+                }
+
+                return (stage->_state + (1 << (HX711_FILTER_IIR_STATE_BITS - 1))) >>
+                    HX711_FILTER_IIR_STATE_BITS;
+
+            }
+
+            case hx711_filter_type_outlier: {
+
+                //values are 24 bits, so the difference cannot
+                //overflow
+                const int32_t diff = value - stage->_last;
+
+                if(stage->_primed &&
+                    (diff > stage->_threshold || diff < -stage->_threshold) &&
+                    stage->_rejects < stage->_max_rejects) {
+                        ++stage->_rejects;
+                        return stage->_last;
+                }
+
+                stage->_last = value;
+                stage->_rejects = 0;
+                stage->_primed = true;
+
+                return value;
+
+            }
+
+            default:
+                assert(false);
+                return value;
+
+        }
+
+}
+
+int32_t hx711_filter_apply(
+    hx711_filter_t* const filter,
+    const int32_t value) {
+
+        assert(filter != NULL);
+
+        int32_t val = value;
+
+        for(size_t i = 0; i < filter->_len; ++i) {
+            val = hx711_filter_stage_apply(
+                &filter->_stages[i],
+                val);
+        }
+
+        return val;
+
+}
+
+int32_t hx711_filter_get_value(
+    hx711_filter_t* const filter,
+    hx711_t* const hx) {
+
+        assert(filter != NULL);
+
+        return hx711_filter_apply(
+            filter,
+            hx711_get_value(hx));
+
+}
+
+void hx711_filter_multi_get_values(
+    hx711_filter_t* const filters,
+    hx711_multi_t* const hxm,
+    int32_t* const values) {
+
+        assert(filters != NULL);
+        assert(hxm != NULL);
+        assert(values != NULL);
+
+        hx711_multi_get_values(hxm, values);
+
+        for(size_t i = 0; i < hxm->_chips_len; ++i) {
+            values[i] = hx711_filter_apply(
+                &filters[i],
+                values[i]);
+        }
+
+}
+
+void hx711_filter_bank_moving_average_init(
+    hx711_filter_bank_t* const bank,
+    const size_t channels,
+    int32_t* const window,
+    const size_t window_len) {
+
+        assert(bank != NULL);
+        assert(channels > 0 && channels <= HX711_FILTER_BANK_MAX_CHANNELS);
+        assert(window != NULL);
+        assert(window_len > 0 && window_len <= HX711_FILTER_MOVING_AVERAGE_MAX_LEN);
+
+        memset(bank, 0, sizeof(*bank));
+
+        bank->_type = hx711_filter_type_moving_average;
+        bank->_channels = channels;
+        bank->_window = window;
+        bank->_window_len = window_len;
+
+}
+
+void hx711_filter_bank_iir_init(
+    hx711_filter_bank_t* const bank,
+    const size_t channels,
+    const uint32_t coeff) {
+
+        assert(bank != NULL);
+        assert(channels > 0 && channels <= HX711_FILTER_BANK_MAX_CHANNELS);
+        assert(coeff > 0 && coeff <= (1u << HX711_FILTER_IIR_COEFF_BITS));
+
+        memset(bank, 0, sizeof(*bank));
+
+        bank->_type = hx711_filter_type_iir;
+        bank->_channels = channels;
+        bank->_coeff = coeff;
+
+}
+
+void hx711_filter_bank_reset(hx711_filter_bank_t* const bank) {
+
+    assert(bank != NULL);
+
+    bank->_count = 0;
+    bank->_index = 0;
+    bank->_primed = false;
+
+    memset(bank->_sum, 0, sizeof(bank->_sum));
+    memset(bank->_state, 0, sizeof(bank->_state));
+
+}
+
+void __not_in_flash_func(hx711_filter_bank_apply)(
+    hx711_filter_bank_t* const bank,
+    const int32_t* const in,
+    int32_t* const out) {
+
+        assert(bank != NULL);
+        assert(in != NULL);
+        assert(out != NULL);
+
+        //decisions which are the same for every channel are
+        //made once, outside of the loops, so each loop body is
+        //straight-line code over contiguous arrays
+        const size_t len = bank->_channels;
+
+        switch(bank->_type) {
+
+            case hx711_filter_type_moving_average: {
+
+                int32_t* const sum = bank->_sum;
+                int32_t* const row = &bank->_window[bank->_index * len];
+
+                if(bank->_count == bank->_window_len) {
+                    for(size_t i = 0; i < len; ++i) {
+                        sum[i] -= row[i];
+                    }
+                }
+                else {
+                    ++bank->_count;
+                }
+
+                bank->_index = (bank->_index + 1) % bank->_window_len;
+
+                const int32_t den = (int32_t)bank->_count;
+                const int32_t half = den / 2;
+
+                for(size_t i = 0; i < len; ++i) {
+
+                    const int32_t val = in[i];
+
+                    row[i] = val;
+                    sum[i] += val;
+
+                    //same rounding as hx711_filter__div_round
+                    //without a branch: the sign is 0 or -1, which
+                    //negates half for a negative sum
+                    const int32_t sign = sum[i] >> 31;
+                    out[i] = (sum[i] + ((half ^ sign) - sign)) / den;
+
+                }
+
+                break;
+
+            }
+
+            case hx711_filter_type_iir: {
+
+                int32_t* const state = bank->_state;
+                const int64_t coeff = bank->_coeff;
+
+                if(!bank->_primed) {
+                    for(size_t i = 0; i < len; ++i) {
+                        state[i] = in[i] * (1 << HX711_FILTER_IIR_STATE_BITS);
+                    }
+                    bank->_primed = true;
+                }
+                else {
+                    for(size_t i = 0; i < len; ++i) {
+                        const int64_t diff =
+                            (int64_t)(in[i] * (1 << HX711_FILTER_IIR_STATE_BITS)) - state[i];
+                        state[i] += (int32_t)((diff * coeff) >> HX711_FILTER_IIR_COEFF_BITS);
+                    }
+                }
+
+                for(size_t i = 0; i < len; ++i) {
+                    out[i] = (state[i] + (1 << (HX711_FILTER_IIR_STATE_BITS - 1))) >>
+                        HX711_FILTER_IIR_STATE_BITS;
+                }
+
+                break;
+
+            }
+
+            default:
+                assert(false);
+                break;
+
+        }
+
+}
+
+void hx711_filter_bank_multi_get_values(
+    hx711_filter_bank_t* const bank,
+    hx711_multi_t* const hxm,
+    int32_t* const values) {
+
+        assert(bank != NULL);
+        assert(hxm != NULL);
+        assert(bank->_channels == hxm->_chips_len);
+
+        hx711_multi_get_values(hxm, values);
+
+        hx711_filter_bank_apply(
+            bank,
+            values,
+            values);
+
+}
+
+int32_t hx711_filter__div_round(
+    const int32_t num,
+    const int32_t den) {
+
+        assert(den > 0);
+
+        //division truncates towards zero, so move the
+        //numerator half a step away from zero first
+        return num >= 0
+            ? (num + (den / 2)) / den
+            : (num - (den / 2)) / den;
+
+}
+
+int32_t hx711_filter__median(
+    const hx711_filter_stage_t* const stage) {
+
+        int32_t sorted[HX711_FILTER_MEDIAN_MAX_LEN];
+        const size_t len = stage->_count;
+
+        //insertion sort; the window is small
+        for(size_t i = 0; i < len; ++i) {
+
+            const int32_t val = stage->_window[i];
+            size_t j = i;
+
+            for(; j > 0 && sorted[j - 1] > val; --j) {
+                sorted[j] = sorted[j - 1];
+            }
+
+            sorted[j] = val;
+
+        }
+
+        if(len % 2 == 1) {
+            return sorted[len / 2];
+        }
+
+        return hx711_filter__div_round(
+            sorted[(len / 2) - 1] + sorted[len / 2],
+            2);
+
+}
@@ -29,15 +29,28 @@
 #include "hardware/gpio.h"
 #include "hardware/irq.h"
 #include "hardware/pio.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
 #include "pico/mutex.h"
 #include "pico/platform.h"
 #include "pico/time.h"
 #include "pico/types.h"
 #include "../include/hx711.h"
 #include "../include/hx711_multi.h"
+#include "../include/hx711_multi_transpose.h"
 #include "../include/util.h"
 
-hx711_multi_t* hx711_multi__async_read_array[] = {
+static_assert(HX711_MULTI_TRANSPOSE_ROWS == HX711_READ_BITS,
+    "transpose must use one row per HX711 bit");
+
+static_assert(HX711_MULTI_TRANSPOSE_COLS >= HX711_MULTI_MAX_CHIPS,
+    "transpose must have a column for every chip");
+
+hx711_multi_t* hx711_multi__async_pio_array[NUM_PIOS][NUM_PIO_STATE_MACHINES] = {
+    NULL, //...
+};
+
+hx711_multi_t* hx711_multi__async_dma_array[NUM_DMA_CHANNELS] = {
     NULL, //...
 };
 
@@ -46,10 +59,16 @@ void hx711_multi__init_asert(
 
         assert(config != NULL);
 
-        assert(util_uint_in_range(
-            config->chips_len,
-            HX711_MULTI_MIN_CHIPS,
-            HX711_MULTI_MAX_CHIPS));
+        if(config->data_pin_mask == 0) {
+            assert(util_uint_in_range(
+                config->chips_len,
+                HX711_MULTI_MIN_CHIPS,
+                HX711_MULTI_MAX_CHIPS));
+        }
+        else {
+            //each pin in the mask must be a GPIO pin
+            assert((config->data_pin_mask >> NUM_BANK0_GPIOS) == 0);
+        }
 
         assert(config->pio != NULL);
         check_pio_param(config->pio);
@@ -63,15 +82,21 @@ void hx711_multi__init_asert(
 
         assert(util_pio_irq_index_is_valid(config->pio_irq_index));
         assert(util_dma_irq_index_is_valid(config->dma_irq_index));
+        assert(hx711_is_pd_sck_hz_valid(config->pd_sck_hz));
 
 #ifndef NDEBUG
-        {
+        if(config->data_pin_mask == 0) {
             //make sure none of the data pins are also the clock pin
             const uint l = config->data_pin_base + config->chips_len - 1;
             for(uint i = config->data_pin_base; i <= l; ++i) {
                 assert(i != config->clock_pin);
             }
         }
+        else {
+            //the clock pin may be between data pins, but must not
+            //be one of them
+            assert((config->data_pin_mask & (UINT32_C(1) << config->clock_pin)) == 0);
+        }
 #endif
 
 }
@@ -80,29 +105,85 @@ void hx711_multi__init_pio(hx711_multi_t* const hxm) {
 
     //adding programs and claiming state machines
     //will panic if unable; this is appropriate.
-    hxm->_awaiter_offset = pio_add_program(
+    //the programs have the layout of the data pins patched
+    //into them, so they are only shared with other instances
+    //reading the same layout. The reader only depends on the
+    //width of the pins, but the awaiter may depend on where
+    //the gaps between them are
+    hxm->_awaiter_offset = util_pio_add_shared_program(
         hxm->_pio,
-        hxm->_awaiter_prog);
+        hxm->_awaiter_prog,
+        hxm->_data_pin_mask >> hxm->_data_pin_base);
 
-    hxm->_reader_offset = pio_add_program(
+    hxm->_reader_offset = util_pio_add_shared_program(
         hxm->_pio,
-        hxm->_reader_prog);
+        hxm->_reader_prog,
+        hxm->_data_pins_width);
 
     /**
-     * Casting pio_claim_unused_sm to uint is OK in this
-     * circumstance. Ordinarily it would return -1 if the
+     * Casting util_pio_claim_unused_sm_pair to uint is OK in
+     * this circumstance. Ordinarily it would return -1 if the
      * claim failed, but since the flag is given to require
-     * a PIO State Machine, panic would be called instead.
+     * a pair of PIO State Machines, panic would be called
+     * instead.
+     * 
+     * The awaiter runs on the State Machine after the reader,
+     * because the programs' IRQs are relative to their own
+     * State Machine numbers. Each hxm then has its own pair of
+     * IRQs, and two can operate within one PIO.
      */
-
-    hxm->_awaiter_sm = (uint)pio_claim_unused_sm(
+    hxm->_reader_sm = (uint)util_pio_claim_unused_sm_pair(
         hxm->_pio,
         true);
 
-    hxm->_reader_sm = (uint)pio_claim_unused_sm(
-        hxm->_pio,
-        true);
+    hxm->_awaiter_sm = (hxm->_reader_sm + 1) % NUM_PIO_STATE_MACHINES;
+
+    hxm->_conversion_done_irq_num =
+        HX711_MULTI_CONVERSION_DONE_IRQ_NUM + hxm->_reader_sm;
+
+    hxm->_data_ready_irq_num =
+        HX711_MULTI_DATA_READY_IRQ_NUM + hxm->_reader_sm;
+
+}
+
+void hx711_multi__init_data_pins(
+    hx711_multi_t* const hxm,
+    const hx711_multi_config_t* const config) {
+
+        assert(hxm != NULL);
+        assert(config != NULL);
+
+        uint32_t mask = config->data_pin_mask;
+
+        if(mask == 0) {
+            mask = (UINT32_C(0xffffffff) >> (32 - config->chips_len)) <<
+                config->data_pin_base;
+        }
 
+        const uint base = (uint)__builtin_ctz(mask);
+
+        hxm->_data_pin_mask = mask;
+        hxm->_data_pin_base = base;
+        hxm->_chips_len = 0;
+
+        for(uint col = 0; base + col < 32; ++col) {
+            if((mask >> (base + col)) & 1) {
+                hxm->_chip_cols[hxm->_chips_len++] = (uint8_t)col;
+                hxm->_data_pins_width = col + 1;
+            }
+        }
+
+        assert(util_uint_in_range(
+            hxm->_chips_len,
+            HX711_MULTI_MIN_CHIPS,
+            HX711_MULTI_MAX_CHIPS));
+
+}
+
+bool hx711_multi__is_contiguous(
+    const hx711_multi_t* const hxm) {
+        assert(hxm != NULL);
+        return hxm->_data_pins_width == hxm->_chips_len;
 }
 
 void hx711_multi__init_dma(hx711_multi_t* const hxm) {
@@ -174,7 +255,7 @@ void hx711_multi__init_dma(hx711_multi_t* const hxm) {
         &cfg,
         NULL,                               //don't set a write address yet
         &hxm->_pio->rxf[hxm->_reader_sm],   //read from reader pio program rx fifo
-        HX711_READ_BITS,                    //24 transfers; one for each HX711 bit
+        hx711_multi__get_buffer_len(hxm),   //one transfer for each push
         false);                             //false = don't start now
 
 }
@@ -191,103 +272,109 @@ void hx711_multi__init_irq(hx711_multi_t* const hxm) {
      */
 
     /**
-     * DMA interrupts can always remain enabled. They will
-     * only trigger following a PIO interrupt.
+     * The handlers are shared by every hxm using the same
+     * IRQs. Each ISR finds the hxm which caused it from the
+     * IRQ sources which are set, so only add the handlers
+     * if no other hxm has already.
      */
-    dma_irqn_set_channel_enabled(
-        hxm->_dma_irq_index,
-        hxm->_dma_channel,
-        true);
+    const bool dmaShared = hx711_multi__async_dma_irq_is_shared(hxm);
+    const bool pioShared = hx711_multi__async_pio_irq_is_shared(hxm);
 
-    irq_set_exclusive_handler(
-        util_dma_get_irqn(hxm->_dma_irq_index),
-        hx711_multi__async_dma_irq_handler);
+    UTIL_INTERRUPTS_OFF_BLOCK(
 
-    irq_set_enabled(
-        util_dma_get_irqn(hxm->_dma_irq_index),
-        true);
+        hx711_multi__async_add_reader(hxm);
 
-    /**
-     * The PIO source interrupt MUST REMAIN DISABLED
-     * until the point at which it is required to listen
-     * to them.
-     */
-    pio_set_irqn_source_enabled(
-        hxm->_pio,
-        hxm->_pio_irq_index,
-        util_pio_get_pis_from_pio_interrupt_num(
-            HX711_MULTI_CONVERSION_DONE_IRQ_NUM),
-        false);
+        /**
+         * DMA interrupts can always remain enabled. They will
+         * only trigger following a PIO interrupt.
+         */
+        dma_irqn_set_channel_enabled(
+            hxm->_dma_irq_index,
+            hxm->_dma_channel,
+            true);
 
-    irq_set_exclusive_handler(
-        util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
-        hx711_multi__async_pio_irq_handler);
+        if(!dmaShared) {
+            irq_add_shared_handler(
+                util_dma_get_irqn(hxm->_dma_irq_index),
+                hx711_multi__async_dma_irq_handler,
+                PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        }
 
-    irq_set_enabled(
-        util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
-        true);
+        irq_set_enabled(
+            util_dma_get_irqn(hxm->_dma_irq_index),
+            true);
 
-}
+        /**
+         * The PIO source interrupt MUST REMAIN DISABLED
+         * until the point at which it is required to listen
+         * to them.
+         */
+        pio_set_irqn_source_enabled(
+            hxm->_pio,
+            hxm->_pio_irq_index,
+            util_pio_get_pis_from_pio_interrupt_num(
+                hxm->_conversion_done_irq_num),
+            false);
 
-bool hx711_multi__async_dma_irq_is_set(
-    hx711_multi_t* const hxm) {
+        if(!pioShared) {
+            irq_add_shared_handler(
+                util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
+                hx711_multi__async_pio_irq_handler,
+                PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        }
 
-        assert(hx711_multi__is_initd(hxm));
+        irq_set_enabled(
+            util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
+            true);
 
-        return dma_irqn_get_channel_status(
-            hxm->_dma_irq_index,
-            hxm->_dma_channel);
+    );
 
 }
 
-bool hx711_multi__async_pio_irq_is_set(
-    hx711_multi_t* const hxm) {
-
-        assert(hx711_multi__is_initd(hxm));
-
-        return pio_interrupt_get(
-            hxm->_pio,
-            HX711_MULTI_CONVERSION_DONE_IRQ_NUM);
+bool hx711_multi__async_pio_irq_is_shared(
+    const hx711_multi_t* const hxm) {
 
-}
+        assert(hxm != NULL);
 
-hx711_multi_t* const hx711_multi__async_get_dma_irq_request() {
+        for(uint p = 0; p < NUM_PIOS; ++p) {
+            for(uint i = 0; i < NUM_PIO_STATE_MACHINES; ++i) {
 
-    assert(hx711_multi__async_read_array != NULL);
+                const hx711_multi_t* const other =
+                    hx711_multi__async_pio_array[p][i];
 
-    for(uint i = 0; i < HX711_MULTI_ASYNC_READ_COUNT; ++i) {
+                if(other != NULL &&
+                    other != hxm &&
+                    other->_pio == hxm->_pio &&
+                    other->_pio_irq_index == hxm->_pio_irq_index) {
+                        return true;
+                }
 
-        if(hx711_multi__async_read_array[i] == NULL) {
-            continue;
-        }
-        
-        if(hx711_multi__async_dma_irq_is_set(hx711_multi__async_read_array[i])) {
-            return hx711_multi__async_read_array[i];
+            }
         }
 
-    }
-
-    return NULL;
+        return false;
 
 }
 
-hx711_multi_t* const hx711_multi__async_get_pio_irq_request() {
+bool hx711_multi__async_dma_irq_is_shared(
+    const hx711_multi_t* const hxm) {
 
-    assert(hx711_multi__async_read_array != NULL);
+        assert(hxm != NULL);
 
-    for(uint i = 0; i < HX711_MULTI_ASYNC_READ_COUNT; ++i) {
+        for(uint i = 0; i < NUM_DMA_CHANNELS; ++i) {
 
-        if(hx711_multi__async_read_array[i] == NULL) {
-            continue;
-        }
+            const hx711_multi_t* const other =
+                hx711_multi__async_dma_array[i];
 
-        if(hx711_multi__async_pio_irq_is_set(hx711_multi__async_read_array[i])) {
-            return hx711_multi__async_read_array[i];
-        }
+            if(other != NULL &&
+                other != hxm &&
+                other->_dma_irq_index == hxm->_dma_irq_index) {
+                    return true;
+            }
 
-    }
+        }
 
-    return NULL;
+        return false;
 
 }
 
@@ -297,9 +384,13 @@ void hx711_multi__async_start_dma(
         assert(hx711_multi__is_state_machines_enabled(hxm));
         assert(hxm->_async_state == HX711_MULTI_ASYNC_STATE_WAITING);
 
-        util_pio_sm_clear_rx_fifo(
-            hxm->_pio,
-            hxm->_reader_sm);
+        /**
+         * The RX FIFO is not cleared here. Callers must clear
+         * it while the conversion done IRQ is known to be set,
+         * otherwise bits from a conversion which has already
+         * begun could be discarded and the DMA transfers would
+         * no longer be aligned to whole conversions.
+         */
 
         //listen for DMA done
         dma_irqn_set_channel_enabled(
@@ -316,6 +407,137 @@ void hx711_multi__async_start_dma(
 
 }
 
+void hx711_multi__async_arm(
+    hx711_multi_t* const hxm) {
+
+        assert(hx711_multi__is_state_machines_enabled(hxm));
+
+        hxm->_async_state = HX711_MULTI_ASYNC_STATE_WAITING;
+
+        //anything in the RX FIFO is from a previous conversion
+        util_pio_sm_clear_rx_fifo(
+            hxm->_pio,
+            hxm->_reader_sm);
+
+        //if pio interrupt is already set, we can bypass the
+        //IRQ handler and immediately trigger dma. Checking
+        //after the RX FIFO is cleared guarantees nothing from
+        //the next conversion was discarded.
+        const bool done = pio_interrupt_get(
+            hxm->_pio,
+            hxm->_conversion_done_irq_num);
+
+        if(done && hxm->_continuous) {
+            hx711_multi__continuous_start_dma(hxm);
+        }
+        else if(done) {
+            hx711_multi__async_start_dma(hxm);
+        }
+
+        //continuous reads are told when each conversion ends
+        if(!done || hxm->_continuous) {
+            pio_set_irqn_source_enabled(
+                hxm->_pio,
+                hxm->_pio_irq_index,
+                util_pio_get_pis_from_pio_interrupt_num(
+                    hxm->_conversion_done_irq_num),
+                true);
+        }
+
+}
+
+void hx711_multi__continuous_start_dma(
+    hx711_multi_t* const hxm) {
+
+        assert(hx711_multi__is_state_machines_enabled(hxm));
+        assert(hxm->_async_state == HX711_MULTI_ASYNC_STATE_WAITING);
+
+        hxm->_frame_remaining = HX711_MULTI_RING_TRANSFER_COUNT;
+        hxm->_async_state = HX711_MULTI_ASYNC_STATE_READING;
+
+        dma_channel_set_trans_count(
+            hxm->_ring_dma_channel,
+            HX711_MULTI_RING_TRANSFER_COUNT,
+            true); //trigger
+
+        //the IRQ stays set until the next conversion begins, so
+        //it is cleared here to be told when this one ends
+        pio_interrupt_clear(
+            hxm->_pio,
+            hxm->_conversion_done_irq_num);
+
+}
+
+void __not_in_flash_func(hx711_multi__continuous_frame_done)(
+    hx711_multi_t* const hxm,
+    const uint64_t timeUs) {
+
+        const uint32_t bufferLen = hx711_multi__get_buffer_len(hxm);
+
+        pio_interrupt_clear(
+            hxm->_pio,
+            hxm->_conversion_done_irq_num);
+
+        /**
+         * Every word the reader has pushed is either still in
+         * the RX FIFO or has been transferred. The level is
+         * only trusted if the DMA channel moved nothing while
+         * it was read, so that the count is exact and the
+         * division gives the number of whole frames, even if
+         * the next conversion has begun.
+         */
+        uint32_t remaining;
+        uint32_t level;
+
+        do {
+            remaining = util_dma_get_transfer_count(
+                hxm->_ring_dma_channel);
+            level = pio_sm_get_rx_fifo_level(
+                hxm->_pio,
+                hxm->_reader_sm);
+        } while(remaining != util_dma_get_transfer_count(
+            hxm->_ring_dma_channel));
+
+        const uint32_t frames =
+            (hxm->_frame_remaining - remaining + level) / bufferLen;
+
+        if(frames == 0) {
+            return;
+        }
+
+        //written before the frame count so a reader which sees
+        //the new frame also sees its time and position
+        hxm->_frame_remaining -= frames * bufferLen;
+        hxm->_buffer_time_us = timeUs;
+        hxm->_frame_count += frames;
+
+        HX711_STATS_ONLY(hxm->_stats.values += frames;)
+
+        /**
+         * Re-trigger the channel well before it runs out. Its
+         * write address carries on from where it stopped, and
+         * anything pushed meanwhile waits in the RX FIFO. Any
+         * words transferred since the latest frame are counted
+         * against the new transfer count.
+         */
+        if(hxm->_frame_remaining < HX711_MULTI_RING_TRANSFER_COUNT / 2) {
+
+            dma_channel_abort(hxm->_ring_dma_channel);
+
+            const uint32_t transferred = hxm->_frame_remaining -
+                util_dma_get_transfer_count(hxm->_ring_dma_channel);
+
+            dma_channel_set_trans_count(
+                hxm->_ring_dma_channel,
+                HX711_MULTI_RING_TRANSFER_COUNT,
+                true); //trigger
+
+            hxm->_frame_remaining = HX711_MULTI_RING_TRANSFER_COUNT + transferred;
+
+        }
+
+}
+
 bool hx711_multi__async_is_running(
     hx711_multi_t* const hxm) {
 
@@ -349,7 +571,7 @@ static void hx711_multi__async_finish(
         pio_set_irqn_source_enabled(
             hxm->_pio,
             hxm->_pio_irq_index,
-            util_pio_get_pis_from_pio_interrupt_num(HX711_MULTI_CONVERSION_DONE_IRQ_NUM),
+            util_pio_get_pis_from_pio_interrupt_num(hxm->_conversion_done_irq_num),
             false);
 
 #ifndef HX711_NO_MUTEX
@@ -358,63 +580,176 @@ static void hx711_multi__async_finish(
 
 }
 
+void __not_in_flash_func(hx711_multi__async_pio_irq)(
+    hx711_multi_t* const hxm) {
+
+        assert(hx711_multi__is_state_machines_enabled(hxm));
+        assert(hxm->_async_state == HX711_MULTI_ASYNC_STATE_WAITING);
+
+        //the conversion period has only just ended, so the
+        //next one cannot have begun yet
+        util_pio_sm_clear_rx_fifo(
+            hxm->_pio,
+            hxm->_reader_sm);
+
+        if(hxm->_continuous) {
+            //the source stays enabled for the frame ISRs
+            hx711_multi__continuous_start_dma(hxm);
+            return;
+        }
+
+        hx711_multi__async_start_dma(hxm);
+
+        //disable listening until required again
+        pio_set_irqn_source_enabled(
+            hxm->_pio,
+            hxm->_pio_irq_index,
+            util_pio_get_pis_from_pio_interrupt_num(hxm->_conversion_done_irq_num),
+            false);
+
+}
+
+void __not_in_flash_func(hx711_multi__async_dma_irq)(
+    hx711_multi_t* const hxm,
+    const uint64_t timeUs) {
+
+        assert(hx711_multi__is_state_machines_enabled(hxm));
+        assert(hxm->_async_state == HX711_MULTI_ASYNC_STATE_READING);
+
+        hxm->_buffer_time_us = timeUs;
+        hxm->_async_state = HX711_MULTI_ASYNC_STATE_DONE;
+
+        HX711_STATS_ONLY(
+            ++hxm->_stats.values;
+            hx711_stats_latency_add(
+                &hxm->_stats.wait_us,
+                time_us_32() - hxm->_stats_start_us);
+        )
+
+        dma_irqn_acknowledge_channel(
+            hxm->_dma_irq_index,
+            hxm->_dma_channel);
+
+        hx711_multi__async_finish(hxm);
+
+        //a reader waiting with __wfe on this core is woken by
+        //the interrupt itself, but one on the other core is not
+        __sev();
+
+}
+
 void __isr __not_in_flash_func(hx711_multi__async_pio_irq_handler)() {
 
-    hx711_multi_t* const hxm = 
-        hx711_multi__async_get_pio_irq_request();
+    //the conversion done IRQ is set as soon as the last value
+    //is pushed
+    const uint64_t nowUs = time_us_64();
 
-    assert(hx711_multi__is_state_machines_enabled(hxm));
-    assert(hxm->_async_state == HX711_MULTI_ASYNC_STATE_WAITING);
+    const uint irqNum = __get_current_exception() - VTABLE_FIRST_IRQ;
+    PIO const pio = util_pio_get_pio_from_irq(irqNum);
+    const int irqIndex = util_pio_get_index_from_irq(irqNum);
 
-    hx711_multi__async_start_dma(hxm);
+    assert(irqIndex >= 0);
 
-    //disable listening until required again
-    pio_set_irqn_source_enabled(
-        hxm->_pio,
-        hxm->_pio_irq_index,
-        util_pio_get_pis_from_pio_interrupt_num(HX711_MULTI_CONVERSION_DONE_IRQ_NUM),
-        false);
+    //one source for each routable PIO interrupt, starting
+    //from interrupt 0
+    static const uint32_t conversionDoneMask =
+        ((1u << NUM_PIO_STATE_MACHINES) - 1) << pis_interrupt0;
 
-    irq_clear(
-        util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index));
+    hx711_multi_t* const* const row =
+        hx711_multi__async_pio_array[pio_get_index(pio)];
+    uint32_t status = (irqIndex == 0 ? pio->ints0 : pio->ints1) & conversionDoneMask;
+
+    //only the sources of hxms waiting for a conversion
+    //period to end, or reading continuously, are enabled, so
+    //each set bit leads directly to one of them
+    while(status != 0) {
+
+        hx711_multi_t* const hxm =
+            row[(uint)__builtin_ctz(status) - pis_interrupt0];
+
+        status &= status - 1;
+
+        //the IRQ may be shared with other code
+        if(hxm == NULL) {
+            continue;
+        }
+
+        HX711_STATS_ONLY(const uint32_t startUs = time_us_32();)
+
+        if(hxm->_continuous &&
+            hxm->_async_state == HX711_MULTI_ASYNC_STATE_READING) {
+                hx711_multi__continuous_frame_done(
+                    hxm,
+                    nowUs - hxm->_read_time_us);
+        }
+        else {
+            hx711_multi__async_pio_irq(hxm);
+        }
+
+        HX711_STATS_ONLY(
+            hx711_stats_latency_add(
+                &hxm->_stats.isr_us,
+                time_us_32() - startUs);
+        )
+
+    }
+
+    irq_clear(irqNum);
 
 }
 
 void __isr __not_in_flash_func(hx711_multi__async_dma_irq_handler)() {
 
-    hx711_multi_t* const hxm =
-        hx711_multi__async_get_dma_irq_request();
+    //the last value is pushed at the end of a read, and the DMA
+    //transfer completes immediately after
+    const uint64_t nowUs = time_us_64();
 
-    assert(hx711_multi__is_state_machines_enabled(hxm));
-    assert(hxm->_async_state == HX711_MULTI_ASYNC_STATE_READING);
+    const uint irqNum = __get_current_exception() - VTABLE_FIRST_IRQ;
+    const int irqIndex = util_dma_get_index_from_irq(irqNum);
 
-    hxm->_async_state = HX711_MULTI_ASYNC_STATE_DONE;
+    assert(irqIndex >= 0);
 
-    dma_irqn_acknowledge_channel(
-        hxm->_dma_irq_index,
-        hxm->_dma_channel);
+    uint32_t status = irqIndex == 0 ? dma_hw->ints0 : dma_hw->ints1;
+
+    while(status != 0) {
+
+        hx711_multi_t* const hxm =
+            hx711_multi__async_dma_array[__builtin_ctz(status)];
+
+        status &= status - 1;
+
+        //the IRQ may be shared with other code
+        if(hxm == NULL) {
+            continue;
+        }
+
+        HX711_STATS_ONLY(const uint32_t startUs = time_us_32();)
 
-    hx711_multi__async_finish(hxm);
+        hx711_multi__async_dma_irq(
+            hxm,
+            nowUs - hxm->_read_time_us);
 
-    irq_clear(
-        util_dma_get_irqn(
-            hxm->_dma_irq_index));
+        HX711_STATS_ONLY(
+            hx711_stats_latency_add(
+                &hxm->_stats.isr_us,
+                time_us_32() - startUs);
+        )
+
+    }
+
+    irq_clear(irqNum);
 
 }
 
-bool hx711_multi__async_add_reader(
+void hx711_multi__async_add_reader(
     hx711_multi_t* const hxm) {
 
-        assert(hx711_multi__async_read_array != NULL);
-
-        for(uint i = 0; i < HX711_MULTI_ASYNC_READ_COUNT; ++i) {
-            if(hx711_multi__async_read_array[i] == NULL) {
-                hx711_multi__async_read_array[i] = hxm;
-                return true;
-            }
-        }
+        assert(hxm != NULL);
+        assert(hx711_multi__async_pio_array[pio_get_index(hxm->_pio)][hxm->_conversion_done_irq_num] == NULL);
+        assert(hx711_multi__async_dma_array[hxm->_dma_channel] == NULL);
 
-        return false;
+        hx711_multi__async_pio_array[pio_get_index(hxm->_pio)][hxm->_conversion_done_irq_num] = hxm;
+        hx711_multi__async_dma_array[hxm->_dma_channel] = hxm;
 
 }
 
@@ -423,16 +758,11 @@ void hx711_multi__async_remove_reader(
 
         //we don't care whether it's initd at this point
         //or whether the SMs are running; just remove it
-        //from the array
+        //from the arrays
         assert(hxm != NULL);
-        assert(hx711_multi__async_read_array != NULL);
 
-        for(uint i = 0; i < HX711_MULTI_ASYNC_READ_COUNT; ++i) {
-            if(hx711_multi__async_read_array[i] == hxm) {
-                hx711_multi__async_read_array[i] = NULL;
-                return;
-            }
-        }
+        hx711_multi__async_pio_array[pio_get_index(hxm->_pio)][hxm->_conversion_done_irq_num] = NULL;
+        hx711_multi__async_dma_array[hxm->_dma_channel] = NULL;
 
 }
 
@@ -445,11 +775,8 @@ static bool hx711_multi__is_initd(hx711_multi_t* const hxm) {
 #ifndef HX711_NO_MUTEX
         mutex_is_initialized(&hxm->_mut) &&
 #endif
-        irq_get_exclusive_handler(util_pio_get_irq_from_index(
-            hxm->_pio,
-            hxm->_pio_irq_index)) == hx711_multi__async_pio_irq_handler &&
-        irq_get_exclusive_handler(util_dma_get_irqn(
-            hxm->_dma_irq_index)) == hx711_multi__async_dma_irq_handler;
+        hx711_multi__async_pio_array[pio_get_index(hxm->_pio)][hxm->_conversion_done_irq_num] == hxm &&
+        hx711_multi__async_dma_array[hxm->_dma_channel] == hxm;
 }
 
 static bool hx711_multi__is_state_machines_enabled(
@@ -459,57 +786,233 @@ static bool hx711_multi__is_state_machines_enabled(
             util_pio_sm_is_enabled(hxm->_pio, hxm->_reader_sm);
 }
 
-void hx711_multi_pinvals_to_values(
-    const uint32_t* const pinvals,
-    int32_t* const values,
-    const size_t len) {
+uint hx711_multi__get_pinvals_per_word(const size_t chips_len) {
 
-        assert(pinvals != NULL);
-        assert(values != NULL);
-        assert(len > 0);
+    assert(util_uint_in_range(
+        chips_len,
+        HX711_MULTI_MIN_CHIPS,
+        HX711_MULTI_MAX_CHIPS));
 
-        //construct an individual chip value by OR-ing
-        //together the bits from the pinvals array.
-        //
-        //each n-th bit of the pinvals array makes up all
-        //the bits for an individual chip. ie.:
-        //
-        //pinvals[0] contains all the 24th bit HX711 values
-        //for each chip, pinvals[1] contains all the 23rd bit
-        //values, and so on...
-        //
-        //(pinvals[0] >> 0) & 1 is the 24th HX711 bit of the 0th chip
-        //(pinvals[1] >> 0) & 1 is the 23rd HX711 bit of the 0th chip
-        //(pinvals[1] >> 2) & 1 is the 23rd HX711 bit of the 3rd chip
-        //(pinvals[23] >> 0) & 1 is the 0th HX711 bit of the 0th chip
-        //
-        //eg.
-        //rawvals[0] = 
-        //    ((pinvals[0] >> 0) & 1) << 24 |
-        //    ((pinvals[1] >> 0) & 1) << 23 |
-        //    ((pinvals[2] >> 0) & 1) << 22 |
-        //...
-        //    ((pinvals[23]) >> 0) & 1) << 0;
+    //each conversion must end on a push, so the number
+    //of pinvals in a word must divide the number of bits
+    for(uint n = HX711_READ_BITS; n > 1; --n) {
+        if(HX711_READ_BITS % n == 0 && chips_len * n <= 32) {
+            return n;
+        }
+    }
 
-        for(size_t chipNum = 0; chipNum < len; ++chipNum) {
+    return 1;
 
-            //reset to 0
-            //this is the raw value for an individual chip
-            uint32_t rawVal = 0;
+}
 
-            //reconstruct an individual twos comp HX711 value from pinbits
-            for(size_t bitPos = 0; bitPos < HX711_READ_BITS; ++bitPos) {
-                const uint shift = HX711_READ_BITS - bitPos - 1;
-                const uint32_t bit = (pinvals[bitPos] >> chipNum) & 1;
-                rawVal |= bit << shift;
-            }
+uint hx711_multi__get_buffer_len(hx711_multi_t* const hxm) {
+    assert(hxm != NULL);
+    assert(hxm->_pinvals_per_word > 0);
+    //the gain is pushed as one more word
+    return (HX711_READ_BITS / hxm->_pinvals_per_word) + 1;
+}
 
-            //then convert to a regular ones comp
-            values[chipNum] = hx711_get_twos_comp(rawVal);
+void hx711_multi__buffer_to_values(
+    hx711_multi_t* const hxm,
+    const uint32_t* const buffer,
+    int32_t* const values) {
 
+        assert(hxm != NULL);
+        assert(buffer != NULL);
+        assert(values != NULL);
+
+        const uint perWord = hxm->_pinvals_per_word;
+        const uint width = hxm->_data_pins_width;
+        const uint32_t* pinvals = buffer;
+        uint32_t unpacked[HX711_READ_BITS];
+
+        if(perWord > 1) {
+
+            //the earliest pinval is in the most significant bits
+            //of each word
+            const uint32_t mask = (UINT32_C(1) << width) - 1;
+            //not including the gain in the last word
+            const uint len = hx711_multi__get_buffer_len(hxm) - 1;
+            uint bitPos = 0;
+
+            for(uint i = 0; i < len; ++i) {
+                for(uint j = perWord; j > 0; --j) {
+                    unpacked[bitPos++] = (buffer[i] >> ((j - 1) * width)) & mask;
+                }
+            }
+
+            pinvals = unpacked;
+
+        }
+
+        if(hx711_multi__is_contiguous(hxm)) {
+            hx711_multi_pinvals_to_values(
+                pinvals,
+                values,
+                hxm->_chips_len);
+            return;
+        }
+
+        //the pinvals include the pins in the gaps between data
+        //pins, so each chip's value is taken from its own column
+        hx711_multi_transpose_cols(
+            pinvals,
+            values,
+            hxm->_chip_cols,
+            hxm->_chips_len);
+
+#ifndef NDEBUG
+        for(size_t chipNum = 0; chipNum < hxm->_chips_len; ++chipNum) {
             assert(hx711_is_value_valid(values[chipNum]));
+        }
+#endif
+
+}
+
+hx711_gain_t hx711_multi__buffer_to_gain(
+    hx711_multi_t* const hxm,
+    const uint32_t* const buffer) {
+
+        assert(hxm != NULL);
+        assert(buffer != NULL);
+
+        return hx711_pio_gain_to_gain(
+            buffer[hx711_multi__get_buffer_len(hxm) - 1]);
+
+}
+
+bool hx711_multi__continuous_get_gain(
+    hx711_multi_t* const hxm,
+    hx711_gain_t* const gain) {
+
+        assert(hxm != NULL);
+        assert(gain != NULL);
+
+        const uint32_t bufferLen = hx711_multi__get_buffer_len(hxm);
+        uint32_t count;
+        uint32_t pioGain;
+
+        //as for hx711_multi_continuous_get_values, but only
+        //the gain at the end of the latest frame is copied
+        while(true) {
+
+            count = hxm->_frame_count;
+
+            if(count == 0) {
+                return false;
+            }
+
+            const uint32_t frameRemaining = hxm->_frame_remaining;
+
+            pioGain = hxm->_ring[(count * bufferLen - 1) & (hxm->_ring_len - 1)];
+
+            const int32_t since = (int32_t)(frameRemaining -
+                util_dma_get_transfer_count(hxm->_ring_dma_channel));
+
+            if(count == hxm->_frame_count &&
+                since >= 0 &&
+                (uint32_t)since <= hxm->_ring_len - bufferLen) {
+                    break;
+            }
+
+        }
+
+        *gain = hx711_pio_gain_to_gain(pioGain);
+
+        return true;
+
+}
+
+void hx711_multi__poll_gain(hx711_multi_t* const hxm) {
+
+    assert(hxm != NULL);
+
+    if(!hxm->_gain_pending || hxm->_continuous) {
+        return;
+    }
+
+    /**
+     * The reader pulls the gain just after a conversion ends,
+     * so every word pushed after the TX FIFO is seen empty is
+     * from a conversion at the new gain. Nothing is waiting
+     * for the RX FIFO between reads; it is cleared as each
+     * one begins. Each conversion clears the conversion done
+     * IRQ before it pushes anything, so once a word has been
+     * pushed, the IRQ being set means that conversion ended.
+     */
+    if(!hxm->_gain_pulled) {
+        if(pio_sm_is_tx_fifo_empty(hxm->_pio, hxm->_reader_sm)) {
+            util_pio_sm_clear_rx_fifo(
+                hxm->_pio,
+                hxm->_reader_sm);
+            hxm->_gain_pulled = true;
+        }
+    }
+    else if(!pio_sm_is_rx_fifo_empty(hxm->_pio, hxm->_reader_sm) &&
+        pio_interrupt_get(hxm->_pio, hxm->_conversion_done_irq_num)) {
+            hxm->_gain_pending = false;
+    }
+
+}
+
+bool hx711_multi__is_superseded(
+    hx711_multi_t* const hxm,
+    const hx711_gain_t gain) {
+
+        assert(hxm != NULL);
+
+        if(!hxm->_gain_pending) {
+            return false;
+        }
+
+        if(gain != hxm->_gain) {
+            return true;
+        }
+
+        hxm->_gain_pending = false;
+
+        return false;
+
+}
+
+void hx711_multi_pinvals_to_values(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const size_t len) {
+
+        assert(pinvals != NULL);
+        assert(values != NULL);
+        assert(len > 0);
+
+        //construct an individual chip value from the bits
+        //in the pinvals array.
+        //
+        //each n-th bit of the pinvals array makes up all
+        //the bits for an individual chip. ie.:
+        //
+        //pinvals[0] contains all the 24th bit HX711 values
+        //for each chip, pinvals[1] contains all the 23rd bit
+        //values, and so on...
+        //
+        //(pinvals[0] >> 0) & 1 is the 24th HX711 bit of the 0th chip
+        //(pinvals[1] >> 0) & 1 is the 23rd HX711 bit of the 0th chip
+        //(pinvals[1] >> 2) & 1 is the 23rd HX711 bit of the 3rd chip
+        //(pinvals[23] >> 0) & 1 is the 0th HX711 bit of the 0th chip
+        //
+        //the pinvals therefore form a bit matrix which is
+        //transposed to obtain each chip's value. See
+        //hx711_multi_transpose for how this is done.
 
+        hx711_multi_transpose(
+            pinvals,
+            values,
+            len);
+
+#ifndef NDEBUG
+        for(size_t chipNum = 0; chipNum < len; ++chipNum) {
+            assert(hx711_is_value_valid(values[chipNum]));
         }
+#endif
 
 }
 
@@ -530,8 +1033,14 @@ void hx711_multi_init(
         HX711_MUTEX_BLOCK(hxm->_mut, 
 
             hxm->_clock_pin = config->clock_pin;
-            hxm->_data_pin_base = config->data_pin_base;
-            hxm->_chips_len = config->chips_len;
+            hxm->_pd_sck_hz = config->pd_sck_hz;
+            hxm->_read_time_us = hx711_multi_pd_sck_hz_to_read_time_us(config->pd_sck_hz);
+
+            hx711_multi__init_data_pins(hxm, config);
+
+            hxm->_pinvals_per_word = config->pack_pinvals
+                ? hx711_multi__get_pinvals_per_word(hxm->_data_pins_width)
+                : 1;
 
             hxm->_pio = config->pio;
             hxm->_awaiter_prog = config->awaiter_prog;
@@ -542,13 +1051,26 @@ void hx711_multi_init(
 
             hxm->_async_state = HX711_MULTI_ASYNC_STATE_NONE;
 
-            hx711_multi__async_add_reader(hxm);
+            hxm->_continuous = false;
+            hxm->_ring = NULL;
+            hxm->_ring_len = 0;
+            hxm->_frame_count = 0;
+            hxm->_frame_remaining = 0;
+            hxm->_buffer_time_us = 0;
+
+            hxm->_gain = hx711_gain_128;
+            hxm->_gain_pending = false;
+            hxm->_gain_pulled = false;
+
+            hxm->_rate = hx711_rate_10;
+            hxm->_rate_detected = false;
+
+            HX711_STATS_ONLY(hx711_stats_reset(&hxm->_stats);)
 
             util_gpio_set_output(hxm->_clock_pin);
 
-            util_gpio_set_contiguous_input_pins(
-                hxm->_data_pin_base,
-                hxm->_chips_len);
+            util_gpio_set_input_pins_mask(
+                hxm->_data_pin_mask);
 
             hx711_multi__init_pio(hxm);
 
@@ -567,6 +1089,10 @@ void hx711_multi_close(hx711_multi_t* const hxm) {
 
     assert(hx711_multi__is_initd(hxm));
 
+    if(hxm->_continuous) {
+        hx711_multi_continuous_stop(hxm);
+    }
+
 #ifndef HX711_NO_MUTEX
     mutex_enter_blocking(&hxm->_mut);
 #endif
@@ -579,18 +1105,10 @@ void hx711_multi_close(hx711_multi_t* const hxm) {
         //async reads
         dma_channel_abort(hxm->_dma_channel);
 
-        irq_set_enabled(
-            util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
-            false);
-
-        irq_set_enabled(
-            util_dma_get_irqn(hxm->_dma_irq_index),
-            false);
-
         pio_set_irqn_source_enabled(
             hxm->_pio,
             hxm->_pio_irq_index,
-            util_pio_get_pis_from_pio_interrupt_num(HX711_MULTI_CONVERSION_DONE_IRQ_NUM),
+            util_pio_get_pis_from_pio_interrupt_num(hxm->_conversion_done_irq_num),
             false);
 
         dma_irqn_set_channel_enabled(
@@ -600,15 +1118,43 @@ void hx711_multi_close(hx711_multi_t* const hxm) {
 
         hxm->_async_state = HX711_MULTI_ASYNC_STATE_NONE;
 
-        hx711_multi__async_remove_reader(hxm);
+        //other hxms may still be using the handlers, and
+        //other code may still have handlers on the IRQs
+        if(!hx711_multi__async_pio_irq_is_shared(hxm)) {
 
-        irq_remove_handler(
-            util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
-            hx711_multi__async_pio_irq_handler);
+            const uint irqNum = util_pio_get_irq_from_index(
+                hxm->_pio,
+                hxm->_pio_irq_index);
 
-        irq_remove_handler(
-            util_dma_get_irqn(hxm->_dma_irq_index),
-            hx711_multi__async_pio_irq_handler);
+            irq_remove_handler(
+                irqNum,
+                hx711_multi__async_pio_irq_handler);
+
+            if(!irq_has_shared_handler(irqNum)) {
+                irq_set_enabled(
+                    irqNum,
+                    false);
+            }
+
+        }
+
+        if(!hx711_multi__async_dma_irq_is_shared(hxm)) {
+
+            const uint irqNum = util_dma_get_irqn(hxm->_dma_irq_index);
+
+            irq_remove_handler(
+                irqNum,
+                hx711_multi__async_dma_irq_handler);
+
+            if(!irq_has_shared_handler(irqNum)) {
+                irq_set_enabled(
+                    irqNum,
+                    false);
+            }
+
+        }
+
+        hx711_multi__async_remove_reader(hxm);
 
     );
 
@@ -636,12 +1182,12 @@ void hx711_multi_close(hx711_multi_t* const hxm) {
         hxm->_pio,
         hxm->_reader_sm);
 
-    pio_remove_program(
+    util_pio_remove_shared_program(
         hxm->_pio,
         hxm->_awaiter_prog,
         hxm->_awaiter_offset);
 
-    pio_remove_program(
+    util_pio_remove_shared_program(
         hxm->_pio,
         hxm->_reader_prog,
         hxm->_reader_offset);
@@ -660,7 +1206,7 @@ void hx711_multi_set_gain(
 
         const uint32_t gainVal = hx711_gain_to_pio_gain(gain);
 
-        assert(hx711_is_pio_gain_valid(gain));
+        assert(hx711_is_pio_gain_valid(gainVal));
 
         pio_sm_drain_tx_fifo(
             hxm->_pio,
@@ -671,11 +1217,51 @@ void hx711_multi_set_gain(
             hxm->_reader_sm,
             gainVal);
 
-        hx711_multi_async_start(hxm);
+        /**
+         * The conversion currently underway, and possibly the
+         * next if the reader has already pulled, are still at
+         * the previous gain. Rather than reading and discarding
+         * one, each conversion carries the gain it was
+         * converted at, and hx711_multi_get_values* skip them
+         * until one at the new gain is seen.
+         * 
+         * Continuous reads may be checking conversions on the
+         * other core, so the new gain must be visible before
+         * it is pending.
+         */
+        hxm->_gain = gain;
+        hxm->_gain_pulled = false;
+        __dmb();
+        hxm->_gain_pending = true;
 
-        while(!hx711_multi_async_done(hxm)) {
-            tight_loop_contents();
+}
+
+bool hx711_multi_is_gain_set(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_initd(hxm));
+
+    if(!hxm->_gain_pending) {
+        return true;
+    }
+
+    //continuous reads do not take frames, so the latest can
+    //be checked
+    if(hxm->_continuous) {
+        hx711_gain_t gain;
+        if(hx711_multi__continuous_get_gain(hxm, &gain)) {
+            hx711_multi__is_superseded(hxm, gain);
         }
+        return !hxm->_gain_pending;
+    }
+
+    //an async read holds the mutex until it is done, and its
+    //gain is checked when its values are taken; the gain is
+    //reported as pending rather than waiting for it
+    HX711_MUTEX_TRY_BLOCK(hxm->_mut, 
+        hx711_multi__poll_gain(hxm);
+    );
+
+    return !hxm->_gain_pending;
 
 }
 
@@ -687,10 +1273,19 @@ void hx711_multi_get_values(
         assert(values != NULL);
         assert(!hx711_multi__async_is_running(hxm));
 
-        hx711_multi_async_start(hxm);
-        while(!hx711_multi_async_done(hxm)) {
-            tight_loop_contents();
-        }
+        do {
+
+            hx711_multi_async_start(hxm);
+
+            //sleep until the read is done rather than polling;
+            //each step of it ends in an interrupt, which wakes
+            //the CPU
+            while(!hx711_multi_async_done(hxm)) {
+                __wfe();
+            }
+
+        } while(!hx711_multi_async_is_gain_current(hxm));
+
         hx711_multi_async_get_values(hxm, values);
 
 }
@@ -707,14 +1302,20 @@ bool hx711_multi_get_values_timeout(
         const absolute_time_t end = make_timeout_time_us(timeout);
         bool success = false;
 
-        hx711_multi_async_start(hxm);
+        do {
+
+            hx711_multi_async_start(hxm);
 
-        while(!time_reached(end)) {
-            if(hx711_multi_async_done(hxm)) {
-                success = true;
-                break;
+            //an alarm wakes the CPU if the read has not finished
+            //by the end
+            while(!(success = hx711_multi_async_done(hxm))) {
+                if(best_effort_wfe_or_timeout(end)) {
+                    success = hx711_multi_async_done(hxm);
+                    break;
+                }
             }
-        }
+
+        } while(success && !hx711_multi_async_is_gain_current(hxm));
 
         if(success) {
             hx711_multi_async_get_values(hxm, values);
@@ -724,6 +1325,9 @@ bool hx711_multi_get_values_timeout(
             //for IRQs and exit mutex. Do this atomically!
             UTIL_INTERRUPTS_OFF_BLOCK(
                 hx711_multi__async_finish(hxm);
+                //otherwise the read is still considered running
+                hxm->_async_state = HX711_MULTI_ASYNC_STATE_NONE;
+                HX711_STATS_ONLY(++hxm->_stats.timeouts;)
             );
         }
 
@@ -731,36 +1335,268 @@ bool hx711_multi_get_values_timeout(
 
 }
 
+void hx711_multi_get_tagged_values(
+    hx711_multi_t* const hxm,
+    int32_t* const values,
+    hx711_gain_t* const gain) {
+
+        assert(hx711_multi__is_state_machines_enabled(hxm));
+        assert(values != NULL);
+        assert(gain != NULL);
+        assert(!hx711_multi__async_is_running(hxm));
+
+        hx711_multi_async_start(hxm);
+
+        while(!hx711_multi_async_done(hxm)) {
+            __wfe();
+        }
+
+        hx711_multi_async_get_values(hxm, values);
+
+        *gain = hx711_multi_async_get_gain(hxm);
+
+}
+
 void hx711_multi_async_start(hx711_multi_t* const hxm) {
 
-    assert(hx711_multi__is_state_machines_enabled(hxm));
-    assert(!hx711_multi__async_is_running(hxm));
+    hx711_multi_async_acquire(hxm);
 
     //if starting the following statements would lead to an
     //immediate interrupt, DMA may not be properly set up,
     //so disable until it is
-    const uint32_t status = save_and_disable_interrupts();
+    UTIL_INTERRUPTS_OFF_BLOCK(
+        hx711_multi_async_start_acquired(hxm);
+    );
+
+}
+
+void hx711_multi_async_acquire(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_state_machines_enabled(hxm));
+    assert(!hxm->_continuous);
 
+    //released by the DMA ISR when a read completes, so this
+    //must not be called with interrupts disabled
 #ifndef HX711_NO_MUTEX
     mutex_enter_blocking(&hxm->_mut);
 #endif
 
-    hxm->_async_state = HX711_MULTI_ASYNC_STATE_WAITING;
+}
 
-    //if pio interrupt is already set, we can bypass the
-    //IRQ handler and immediately trigger dma
-    if(pio_interrupt_get(hxm->_pio, HX711_MULTI_CONVERSION_DONE_IRQ_NUM)) {
-        hx711_multi__async_start_dma(hxm);
-    }
-    else {
-        pio_set_irqn_source_enabled(
-            hxm->_pio,
-            hxm->_pio_irq_index,
-            util_pio_get_irq_from_index(hxm->_pio, hxm->_pio_irq_index),
-            true);
-    }
+void hx711_multi_async_start_acquired(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_state_machines_enabled(hxm));
+    assert(!hx711_multi__async_is_running(hxm));
+    assert(!hxm->_continuous);
+
+    HX711_STATS_ONLY(hxm->_stats_start_us = time_us_32();)
+
+    hx711_multi__async_arm(hxm);
+
+}
+
+void hx711_multi_continuous_start(
+    hx711_multi_t* const hxm,
+    uint32_t* const ring,
+    const size_t len) {
+
+        assert(hx711_multi__is_state_machines_enabled(hxm));
+        assert(!hx711_multi__async_is_running(hxm));
+        assert(!hxm->_continuous);
+        assert(ring != NULL);
+        assert(len >= HX711_MULTI_RING_MIN_LEN && len <= HX711_MULTI_RING_MAX_LEN);
+
+        static_assert(HX711_MULTI_RING_MIN_LEN >= 2 * (HX711_READ_BITS + 1),
+            "the ring must hold at least two frames");
+
+        //ring buffer must be a power of 2 in size and
+        //naturally aligned to that size
+        const uint ringBytes = (uint)(len * sizeof(uint32_t));
+        assert((len & (len - 1)) == 0);
+        assert(((uintptr_t)ring & (ringBytes - 1)) == 0);
+
+        HX711_MUTEX_BLOCK(hxm->_mut, 
+
+            /**
+             * Casting dma_claim_unused_channel to uint is OK in this
+             * circumstance. Ordinarily it would return -1 if the
+             * claim failed, but since the flag is given to require
+             * a DMA channel, panic would be called instead.
+             */
+            hxm->_ring_dma_channel = (uint)dma_claim_unused_channel(true);
+
+            hxm->_ring = ring;
+            hxm->_ring_len = (uint32_t)len;
+
+            //configured the same as the async channel, except that
+            //it wraps around the ring and raises no interrupts; the
+            //frames are counted from the PIO ISR
+            dma_channel_config cfg = dma_get_channel_config(
+                hxm->_dma_channel);
+
+            channel_config_set_chain_to(
+                &cfg,
+                hxm->_ring_dma_channel); //chaining to itself disables chaining
+
+            channel_config_set_ring(
+                &cfg,
+                true,                                   //true = wrap the write address
+                (uint)__builtin_ctz(ringBytes));        //log2 of the ring size in bytes
+
+            channel_config_set_irq_quiet(
+                &cfg,
+                true);
+
+            dma_channel_configure(
+                hxm->_ring_dma_channel,
+                &cfg,
+                hxm->_ring,
+                &hxm->_pio->rxf[hxm->_reader_sm],
+                HX711_MULTI_RING_TRANSFER_COUNT,
+                false); //false = don't start now
+
+            hxm->_frame_count = 0;
+            HX711_STATS_ONLY(hxm->_stats_frame = 0;)
+
+            UTIL_INTERRUPTS_OFF_BLOCK(
+                hxm->_continuous = true;
+                hx711_multi__async_arm(hxm);
+            );
+
+        );
+
+}
+
+void hx711_multi_continuous_stop(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_initd(hxm));
+    assert(hxm->_continuous);
+
+    HX711_MUTEX_BLOCK(hxm->_mut, 
+
+        UTIL_INTERRUPTS_OFF_BLOCK(
+
+            pio_set_irqn_source_enabled(
+                hxm->_pio,
+                hxm->_pio_irq_index,
+                util_pio_get_pis_from_pio_interrupt_num(
+                    hxm->_conversion_done_irq_num),
+                false);
+
+            dma_channel_abort(hxm->_ring_dma_channel);
+
+            hxm->_continuous = false;
+            hxm->_async_state = HX711_MULTI_ASYNC_STATE_NONE;
+
+        );
+
+        dma_channel_unclaim(hxm->_ring_dma_channel);
+
+    );
+
+}
+
+bool hx711_multi_continuous_is_running(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    return hxm->_continuous;
+}
+
+uint32_t hx711_multi_continuous_get_frame_count(
+    hx711_multi_t* const hxm) {
+        assert(hx711_multi__is_initd(hxm));
+        assert(hxm->_continuous);
+        return hxm->_frame_count;
+}
+
+bool hx711_multi_continuous_get_values(
+    hx711_multi_t* const hxm,
+    int32_t* const values,
+    uint32_t* const frame,
+    absolute_time_t* const time,
+    hx711_gain_t* const gain) {
+
+        assert(hx711_multi__is_initd(hxm));
+        assert(hxm->_continuous);
+        assert(values != NULL);
+
+        const uint32_t bufferLen = hx711_multi__get_buffer_len(hxm);
+        uint32_t buffer[HX711_READ_BITS + 1];
+        uint32_t count;
+        uint64_t timeUs;
+
+        /**
+         * Not mutex protected; the frame count is used
+         * instead. The latest frame is copied out of the ring
+         * and is only used if the DMA channel has not since
+         * wrapped around onto it, and no newer frame was
+         * published meanwhile. Otherwise try again with the
+         * newer frame.
+         */
+        while(true) {
+
+            count = hxm->_frame_count;
+
+            if(count == 0) {
+                return false;
+            }
+
+            const uint32_t frameRemaining = hxm->_frame_remaining;
+            timeUs = hxm->_buffer_time_us;
+
+            //wraps with the frame count, which is fine as the
+            //ring length divides 2^32
+            const uint32_t start = (count - 1) * bufferLen;
+
+            for(uint32_t i = 0; i < bufferLen; ++i) {
+                buffer[i] = hxm->_ring[(start + i) & (hxm->_ring_len - 1)];
+            }
+
+            //words transferred since the end of the frame; if
+            //negative, the frame is not yet all in the ring
+            const int32_t since = (int32_t)(frameRemaining -
+                util_dma_get_transfer_count(hxm->_ring_dma_channel));
+
+            if(count == hxm->_frame_count &&
+                since >= 0 &&
+                (uint32_t)since <= hxm->_ring_len - bufferLen) {
+                    break;
+            }
+
+        }
+
+        hx711_multi__buffer_to_values(
+            hxm,
+            buffer,
+            values);
+
+        const hx711_gain_t frameGain = hx711_multi__buffer_to_gain(
+            hxm,
+            buffer);
+
+        if(frame != NULL) {
+            *frame = count;
+        }
+
+        if(time != NULL) {
+            update_us_since_boot(time, timeUs);
+        }
+
+        if(gain != NULL) {
+            *gain = frameGain;
+        }
+
+        hx711_multi__is_superseded(hxm, frameGain);
+
+        //frames between this one and the last one obtained
+        //were never seen
+        HX711_STATS_ONLY(
+            if(count > hxm->_stats_frame + 1) {
+                hxm->_stats.overflows += count - hxm->_stats_frame - 1;
+            }
+            hxm->_stats_frame = MAX(hxm->_stats_frame, count);
+        )
 
-    restore_interrupts(status);
+        return true;
 
 }
 
@@ -774,10 +1610,99 @@ void hx711_multi_async_get_values(
     int32_t* const values) {
         assert(hx711_multi__is_initd(hxm));
         assert(hx711_multi_async_done(hxm));
-        hx711_multi_pinvals_to_values(
+        hx711_multi__buffer_to_values(
+            hxm,
             hxm->_buffer,
-            values,
-            hxm->_chips_len);
+            values);
+        hx711_multi__is_superseded(
+            hxm,
+            hx711_multi_async_get_gain(hxm));
+}
+
+absolute_time_t hx711_multi_async_get_time(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    assert(hx711_multi_async_done(hxm));
+    absolute_time_t time;
+    update_us_since_boot(&time, hxm->_buffer_time_us);
+    return time;
+}
+
+uint32_t hx711_multi_pd_sck_hz_to_read_time_us(const uint32_t hz) {
+    return hx711__pd_sck_hz_to_read_time_us(
+        hz,
+        HX711_MULTI_READ_OVERHEAD_HALVES);
+}
+
+uint32_t hx711_multi_get_read_time_us(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    return hxm->_read_time_us;
+}
+
+hx711_rate_t hx711_multi_detect_rate(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_state_machines_enabled(hxm));
+    assert(!hx711_multi__async_is_running(hxm));
+
+    uint64_t readyUs[2];
+
+    //each read is timed from when its conversion ended, so
+    //only restarting in time for the next conversion matters
+    for(uint i = 0; i < count_of(readyUs); ++i) {
+
+        hx711_multi_async_start(hxm);
+
+        while(!hx711_multi_async_done(hxm)) {
+            __wfe();
+        }
+
+        readyUs[i] = to_us_since_boot(hx711_multi_async_get_time(hxm));
+
+        hx711_multi__is_superseded(
+            hxm,
+            hx711_multi_async_get_gain(hxm));
+
+    }
+
+    hxm->_rate = hx711_interval_us_to_rate(readyUs[1] - readyUs[0]);
+    hxm->_rate_detected = true;
+
+    return hxm->_rate;
+
+}
+
+hx711_rate_t hx711_multi_get_rate(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    return hxm->_rate;
+}
+
+bool hx711_multi_is_rate_detected(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    return hxm->_rate_detected;
+}
+
+void hx711_multi_wait_until_settled(hx711_multi_t* const hxm) {
+    hx711_wait_settle(hx711_multi_get_rate(hxm));
+}
+
+uint hx711_multi_get_timeout_us(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    return 2000000u / hx711_get_rate_sps(hxm->_rate) + hxm->_read_time_us;
+}
+
+hx711_gain_t hx711_multi_async_get_gain(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    assert(hx711_multi_async_done(hxm));
+    return hx711_multi__buffer_to_gain(
+        hxm,
+        hxm->_buffer);
+}
+
+bool hx711_multi_async_is_gain_current(hx711_multi_t* const hxm) {
+    assert(hx711_multi__is_initd(hxm));
+    assert(hx711_multi_async_done(hxm));
+    return !hx711_multi__is_superseded(
+        hxm,
+        hx711_multi_async_get_gain(hxm));
 }
 
 void hx711_multi_power_up(
@@ -792,9 +1717,7 @@ void hx711_multi_power_up(
 
         HX711_MUTEX_BLOCK(hxm->_mut, 
 
-            gpio_put(
-                hxm->_clock_pin,
-                false);
+            hx711_multi_release_clock_pin(hxm);
 
             pio_sm_init(
                 hxm->_pio,
@@ -806,12 +1729,18 @@ void hx711_multi_power_up(
                 hxm->_pio,
                 hxm->_reader_sm);
 
-            //put the gain value into the reader FIFO
+            //put the gain value into the reader FIFO; the
+            //reader pulls it after the first conversion, which
+            //is always at a gain of 128
             pio_sm_put(
                 hxm->_pio,
                 hxm->_reader_sm,
                 pioGainVal);
 
+            hxm->_gain = gain;
+            hxm->_gain_pulled = false;
+            hxm->_gain_pending = true;
+
             pio_sm_init(
                 hxm->_pio,
                 hxm->_awaiter_sm,
@@ -831,10 +1760,31 @@ void hx711_multi_power_down(hx711_multi_t* const hxm) {
 
     assert(hx711_multi__is_initd(hxm));
 
+    if(hxm->_continuous) {
+        hx711_multi_continuous_stop(hxm);
+    }
+
     HX711_MUTEX_BLOCK(hxm->_mut,
 
+        //hx711_multi__async_finish would release the mutex
+        //this block holds, so the read is cancelled here
         UTIL_INTERRUPTS_OFF_BLOCK(
-            hx711_multi__async_finish(hxm);
+
+            dma_channel_abort(hxm->_dma_channel);
+
+            dma_irqn_set_channel_enabled(
+                hxm->_dma_irq_index,
+                hxm->_dma_channel,
+                false);
+
+            pio_set_irqn_source_enabled(
+                hxm->_pio,
+                hxm->_pio_irq_index,
+                util_pio_get_pis_from_pio_interrupt_num(hxm->_conversion_done_irq_num),
+                false);
+
+            hxm->_async_state = HX711_MULTI_ASYNC_STATE_NONE;
+
         );
 
         pio_set_sm_mask_enabled(
@@ -842,14 +1792,30 @@ void hx711_multi_power_down(hx711_multi_t* const hxm) {
             (1 << hxm->_awaiter_sm) | (1 << hxm->_reader_sm),
             false);
 
-        gpio_put(
-            hxm->_clock_pin,
-            true);
+        //the clock pin is driven by the PIO rather than as a
+        //GPIO output, so it is set through the reader
+        pio_sm_set_pins_with_mask(
+            hxm->_pio,
+            hxm->_reader_sm,
+            1u << hxm->_clock_pin,
+            1u << hxm->_clock_pin);
 
     );
 
 }
 
+void hx711_multi_release_clock_pin(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_initd(hxm));
+
+    pio_sm_set_pins_with_mask(
+        hxm->_pio,
+        hxm->_reader_sm,
+        0,
+        1u << hxm->_clock_pin);
+
+}
+
 void hx711_multi_sync(
     hx711_multi_t* const hxm,
     const hx711_gain_t gain) {
@@ -862,7 +1828,20 @@ void hx711_multi_sync(
 uint32_t hx711_multi_get_sync_state(
     hx711_multi_t* const hxm) {
         assert(hx711_multi__is_state_machines_enabled(hxm));
-        return pio_sm_get_blocking(hxm->_pio, hxm->_awaiter_sm);
+
+        if(hx711_multi__is_contiguous(hxm)) {
+            return pio_sm_get_blocking(hxm->_pio, hxm->_awaiter_sm);
+        }
+
+        const uint32_t pins = gpio_get_all() >> hxm->_data_pin_base;
+        uint32_t state = 0;
+
+        for(size_t i = 0; i < hxm->_chips_len; ++i) {
+            state |= ((pins >> hxm->_chip_cols[i]) & 1) << i;
+        }
+
+        return state;
+
 }
 
 bool hx711_multi_is_syncd(
@@ -878,3 +1857,30 @@ bool hx711_multi_is_syncd(
         return state == 0 || state == allReady;
 
 }
+
+#ifdef HX711_STATS
+void hx711_multi_get_stats(
+    hx711_multi_t* const hxm,
+    hx711_stats_t* const stats) {
+
+        assert(hx711_multi__is_initd(hxm));
+        assert(stats != NULL);
+
+        //the interrupt handlers may be part way through
+        //updating them
+        UTIL_INTERRUPTS_OFF_BLOCK(
+            *stats = hxm->_stats;
+        );
+
+}
+
+void hx711_multi_reset_stats(hx711_multi_t* const hxm) {
+
+    assert(hx711_multi__is_initd(hxm));
+
+    UTIL_INTERRUPTS_OFF_BLOCK(
+        hx711_stats_reset(&hxm->_stats);
+    );
+
+}
+#endif
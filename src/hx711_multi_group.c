@@ -0,0 +1,209 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/sync.h"
+#include "pico/platform.h"
+#include "pico/types.h"
+#include "../include/hx711.h"
+#include "../include/hx711_multi.h"
+#include "../include/hx711_multi_group.h"
+#include "../include/util.h"
+
+void hx711_multi_group_init(
+    hx711_multi_group_t* const group,
+    hx711_multi_t* const members,
+    const size_t len) {
+
+        assert(group != NULL);
+        assert(members != NULL);
+        assert(len > 0);
+
+        group->_members = members;
+        group->_len = len;
+        group->_chips_len = 0;
+
+        for(size_t i = 0; i < len; ++i) {
+            group->_chips_len += members[i]._chips_len;
+        }
+
+}
+
+size_t hx711_multi_group_get_chips_len(
+    const hx711_multi_group_t* const group) {
+        assert(group != NULL);
+        return group->_chips_len;
+}
+
+void hx711_multi_group_power_up(
+    hx711_multi_group_t* const group,
+    const hx711_gain_t gain) {
+
+        assert(group != NULL);
+
+        for(size_t i = 0; i < group->_len; ++i) {
+            hx711_multi_power_up(
+                &group->_members[i],
+                gain);
+        }
+
+}
+
+void hx711_multi_group_power_down(hx711_multi_group_t* const group) {
+
+    assert(group != NULL);
+
+    for(size_t i = 0; i < group->_len; ++i) {
+        hx711_multi_power_down(&group->_members[i]);
+    }
+
+}
+
+void hx711_multi_group_sync(
+    hx711_multi_group_t* const group,
+    const hx711_gain_t gain) {
+
+        assert(group != NULL);
+
+        hx711_multi_group_power_down(group);
+        hx711_wait_power_down();
+
+        //each member's chips share a clock pin and so leave
+        //power down together; the members' clock pins are
+        //released back to back so theirs do as well
+        UTIL_INTERRUPTS_OFF_BLOCK(
+            for(size_t i = 0; i < group->_len; ++i) {
+                hx711_multi_release_clock_pin(&group->_members[i]);
+            }
+        );
+
+        hx711_multi_group_power_up(
+            group,
+            gain);
+
+}
+
+void hx711_multi_group_set_gain(
+    hx711_multi_group_t* const group,
+    const hx711_gain_t gain) {
+
+        assert(group != NULL);
+
+        for(size_t i = 0; i < group->_len; ++i) {
+            hx711_multi_set_gain(
+                &group->_members[i],
+                gain);
+        }
+
+}
+
+void hx711_multi_group_async_start(hx711_multi_group_t* const group) {
+
+    assert(group != NULL);
+
+    //acquiring may wait for a member's read in progress to
+    //finish, which needs its interrupt
+    for(size_t i = 0; i < group->_len; ++i) {
+        hx711_multi_async_acquire(&group->_members[i]);
+    }
+
+    //a member's conversion could otherwise end while an
+    //interrupt delays starting the next member, and the
+    //members would read conversions a whole period apart
+    UTIL_INTERRUPTS_OFF_BLOCK(
+        for(size_t i = 0; i < group->_len; ++i) {
+            hx711_multi_async_start_acquired(&group->_members[i]);
+        }
+    );
+
+}
+
+bool hx711_multi_group_async_done(hx711_multi_group_t* const group) {
+
+    assert(group != NULL);
+
+    for(size_t i = 0; i < group->_len; ++i) {
+        if(!hx711_multi_async_done(&group->_members[i])) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+void hx711_multi_group_async_get_values(
+    hx711_multi_group_t* const group,
+    int32_t* const values) {
+
+        assert(group != NULL);
+        assert(values != NULL);
+
+        int32_t* out = values;
+
+        //each member converts straight into its own part of
+        //the array, so the cost is the same as one
+        //hx711_multi_t with every chip
+        for(size_t i = 0; i < group->_len; ++i) {
+            hx711_multi_async_get_values(
+                &group->_members[i],
+                out);
+            out += group->_members[i]._chips_len;
+        }
+
+}
+
+void hx711_multi_group_get_values(
+    hx711_multi_group_t* const group,
+    int32_t* const values) {
+
+        bool current;
+
+        do {
+
+            hx711_multi_group_async_start(group);
+
+            //each member's read ends in an interrupt, which
+            //wakes the CPU
+            while(!hx711_multi_group_async_done(group)) {
+                __wfe();
+            }
+
+            //every member is checked, as each one only stops
+            //skipping once it has seen its new gain
+            current = true;
+
+            for(size_t i = 0; i < group->_len; ++i) {
+                current &= hx711_multi_async_is_gain_current(
+                    &group->_members[i]);
+            }
+
+        } while(!current);
+
+        hx711_multi_group_async_get_values(
+            group,
+            values);
+
+}
@@ -0,0 +1,146 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "pico/types.h"
+#include "../include/hx711_multi_transpose.h"
+
+void __not_in_flash_func(hx711_multi_transpose__matrix)(
+    const uint32_t* const pinvals,
+    uint32_t* const mat,
+    const size_t cols) {
+
+        assert(pinvals != NULL);
+        assert(mat != NULL);
+        assert(cols > 0 && cols <= HX711_MULTI_TRANSPOSE_COLS);
+
+        /**
+         * Row r of the matrix is bit r of every chip's value,
+         * where bit c of a row is chip c. pinvals are MSB
+         * first, so they are copied in reverse. The upper 8
+         * rows are copies of the MSB row so that transposing
+         * also sign-extends each value to 32 bits.
+         */
+
+        for(uint i = 0; i < HX711_MULTI_TRANSPOSE_ROWS; ++i) {
+            mat[i] = pinvals[HX711_MULTI_TRANSPOSE_ROWS - 1 - i];
+        }
+
+        for(uint i = HX711_MULTI_TRANSPOSE_ROWS; i < HX711_MULTI_TRANSPOSE_COLS; ++i) {
+            mat[i] = pinvals[0];
+        }
+
+        //only rows below the next power of 2 from cols are
+        //output
+        uint rows = 1;
+
+        while(rows < cols) {
+            rows <<= 1;
+        }
+
+        /**
+         * At each step, j is the size of the blocks being
+         * swapped and mask selects the low block of each pair.
+         * Within every aligned group of 2j rows, the high
+         * columns of the first j rows are swapped with the low
+         * columns of the last j rows.
+         * 
+         * Later steps only mix rows within groups of j rows. So
+         * while j is at least the number of rows output, the
+         * last j rows are never needed again and only the first
+         * j rows need to be updated.
+         */
+        uint32_t mask = UINT32_C(0x0000ffff);
+
+        for(uint j = HX711_MULTI_TRANSPOSE_COLS / 2; j != 0; j >>= 1, mask ^= mask << j) {
+
+            if(j >= rows) {
+                for(uint k = 0; k < j; ++k) {
+                    mat[k] ^= (((mat[k] >> j) ^ mat[k + j]) & mask) << j;
+                }
+                continue;
+            }
+
+            //visit each row with bit j clear, paired with the
+            //row j below it
+            for(uint k = 0; k < rows; k = (k + j + 1) & ~j) {
+                const uint32_t t = ((mat[k] >> j) ^ mat[k + j]) & mask;
+                mat[k] ^= t << j;
+                mat[k + j] ^= t;
+            }
+
+        }
+
+}
+
+void __not_in_flash_func(hx711_multi_transpose)(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const size_t len) {
+
+        assert(pinvals != NULL);
+        assert(values != NULL);
+        assert(len > 0 && len <= HX711_MULTI_TRANSPOSE_COLS);
+
+        uint32_t mat[HX711_MULTI_TRANSPOSE_COLS];
+
+        hx711_multi_transpose__matrix(
+            pinvals,
+            mat,
+            len);
+
+        for(size_t i = 0; i < len; ++i) {
+            values[i] = (int32_t)mat[i];
+        }
+
+}
+
+void __not_in_flash_func(hx711_multi_transpose_cols)(
+    const uint32_t* const pinvals,
+    int32_t* const values,
+    const uint8_t* const cols,
+    const size_t len) {
+
+        assert(pinvals != NULL);
+        assert(values != NULL);
+        assert(cols != NULL);
+        assert(len > 0 && len <= HX711_MULTI_TRANSPOSE_COLS);
+        assert(cols[len - 1] < HX711_MULTI_TRANSPOSE_COLS);
+
+        uint32_t mat[HX711_MULTI_TRANSPOSE_COLS];
+
+        hx711_multi_transpose__matrix(
+            pinvals,
+            mat,
+            (size_t)cols[len - 1] + 1);
+
+        //gathering the chips' rows is the same cost as copying
+        //the first len rows
+        for(size_t i = 0; i < len; ++i) {
+            assert(i == 0 || cols[i] > cols[i - 1]);
+            values[i] = (int32_t)mat[cols[i]];
+        }
+
+}
@@ -0,0 +1,427 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "pico/types.h"
+#include "../include/hx711.h"
+#include "../include/hx711_multi.h"
+#include "../include/hx711_service.h"
+#include "../include/util.h"
+
+hx711_service_t* hx711_service__instance = NULL;
+
+void hx711_service_init(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frames,
+    const size_t len) {
+
+        assert(svc != NULL);
+        assert(frames != NULL);
+        assert(len > 0);
+
+        //so that the head and tail can wrap around
+        assert((len & (len - 1)) == 0);
+
+        svc->_sources_len = 0;
+        svc->_frames = frames;
+        svc->_frames_len = len;
+        svc->_head = 0;
+        svc->_tail = 0;
+        svc->_dropped = 0;
+        svc->_stopping = false;
+        svc->_running = false;
+
+}
+
+static hx711_service_source_t* hx711_service__add_source(
+    hx711_service_t* const svc,
+    const hx711_gain_t gain) {
+
+        assert(svc != NULL);
+        assert(!svc->_running);
+        assert(svc->_sources_len < HX711_SERVICE_MAX_SOURCES);
+        assert(hx711_is_gain_valid(gain));
+
+        hx711_service_source_t* const source =
+            &svc->_sources[svc->_sources_len];
+
+        source->_svc = svc;
+        source->_index = (uint8_t)svc->_sources_len;
+        source->_hx = NULL;
+        source->_hxm = NULL;
+        source->_ring = NULL;
+        source->_ring_len = 0;
+        source->_gain = gain;
+        source->_count = 0;
+
+        ++svc->_sources_len;
+
+        return source;
+
+}
+
+uint hx711_service_add(
+    hx711_service_t* const svc,
+    hx711_t* const hx,
+    const hx711_config_t* const config,
+    const hx711_gain_t gain) {
+
+        assert(hx != NULL);
+        assert(config != NULL);
+
+        hx711_service_source_t* const source =
+            hx711_service__add_source(svc, gain);
+
+        source->_hx = hx;
+        source->_config = *config;
+
+        return source->_index;
+
+}
+
+uint hx711_service_add_multi(
+    hx711_service_t* const svc,
+    hx711_multi_t* const hxm,
+    const hx711_multi_config_t* const config,
+    const hx711_gain_t gain,
+    uint32_t* const ring,
+    const size_t len) {
+
+        assert(hxm != NULL);
+        assert(config != NULL);
+        assert(ring != NULL);
+
+        hx711_service_source_t* const source =
+            hx711_service__add_source(svc, gain);
+
+        source->_hxm = hxm;
+        source->_multi_config = *config;
+        source->_ring = ring;
+        source->_ring_len = len;
+
+        return source->_index;
+
+}
+
+void hx711_service_start(hx711_service_t* const svc) {
+
+    assert(svc != NULL);
+    assert(svc->_sources_len > 0);
+    assert(!svc->_running);
+    assert(hx711_service__instance == NULL);
+
+    svc->_head = 0;
+    svc->_tail = 0;
+    svc->_dropped = 0;
+    svc->_stopping = false;
+
+    hx711_service__instance = svc;
+
+    multicore_launch_core1(hx711_service__core1_main);
+
+    //core1 signals once its sources are running
+    while(!svc->_running) {
+        __wfe();
+    }
+
+}
+
+void hx711_service_stop(hx711_service_t* const svc) {
+
+    assert(svc != NULL);
+    assert(svc->_running);
+    assert(hx711_service__instance == svc);
+
+    svc->_stopping = true;
+    __sev();
+
+    while(svc->_running) {
+        __wfe();
+    }
+
+    multicore_reset_core1();
+    multicore_fifo_drain();
+
+    hx711_service__instance = NULL;
+
+}
+
+bool hx711_service_pop(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frame) {
+
+        assert(svc != NULL);
+        assert(frame != NULL);
+
+        const uint32_t tail = svc->_tail;
+
+        if(tail == svc->_head) {
+            return false;
+        }
+
+        //the frame must not be read before the head which
+        //published it
+        __dmb();
+
+        *frame = svc->_frames[tail & (svc->_frames_len - 1)];
+
+        //nor may core1 reuse the slot before it has been read
+        __dmb();
+
+        svc->_tail = tail + 1;
+
+        return true;
+
+}
+
+void hx711_service_pop_blocking(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frame) {
+
+        //a word in the FIFO only means that a frame has been
+        //pushed since the last one was taken from it. Words
+        //are not sent while the FIFO is full, so there may be
+        //more frames than words, and there may be words left
+        //over for frames which have already been popped
+        while(!hx711_service_pop(svc, frame)) {
+            multicore_fifo_pop_blocking();
+        }
+
+}
+
+bool hx711_service_pop_timeout(
+    hx711_service_t* const svc,
+    hx711_service_frame_t* const frame,
+    const uint timeout) {
+
+        const absolute_time_t end = make_timeout_time_us(timeout);
+        uint32_t word;
+
+        while(!hx711_service_pop(svc, frame)) {
+
+            const int64_t remaining = absolute_time_diff_us(
+                get_absolute_time(),
+                end);
+
+            if(remaining <= 0 ||
+                !multicore_fifo_pop_timeout_us((uint64_t)remaining, &word)) {
+                    return false;
+            }
+
+        }
+
+        return true;
+
+}
+
+uint32_t hx711_service_get_dropped(hx711_service_t* const svc) {
+    assert(svc != NULL);
+    return svc->_dropped;
+}
+
+void hx711_service__core1_main(void) {
+
+    hx711_service_t* const svc = hx711_service__instance;
+
+    assert(svc != NULL);
+
+    hx711_service__sources_start(svc);
+
+    svc->_running = true;
+    __sev();
+
+    //new values arrive with an interrupt, which wakes core1
+    while(!svc->_stopping) {
+        hx711_service__poll(svc);
+        __wfe();
+    }
+
+    hx711_service__sources_stop(svc);
+
+    svc->_running = false;
+    __sev();
+
+}
+
+void hx711_service__sources_start(hx711_service_t* const svc) {
+
+    assert(svc != NULL);
+
+    for(size_t i = 0; i < svc->_sources_len; ++i) {
+
+        hx711_service_source_t* const source = &svc->_sources[i];
+
+        //initialising on core1 enables the interrupts, and so
+        //runs their handlers, on core1
+        if(source->_hx != NULL) {
+            hx711_init(source->_hx, &source->_config);
+            hx711_power_up(source->_hx, source->_gain);
+            hx711_callback_start(
+                source->_hx,
+                hx711_service__on_value,
+                source);
+        }
+        else {
+            hx711_multi_init(source->_hxm, &source->_multi_config);
+            hx711_multi_power_up(source->_hxm, source->_gain);
+            hx711_multi_continuous_start(
+                source->_hxm,
+                source->_ring,
+                source->_ring_len);
+        }
+
+    }
+
+}
+
+void hx711_service__poll(hx711_service_t* const svc) {
+
+    assert(svc != NULL);
+
+    int32_t values[HX711_SERVICE_MAX_VALUES];
+    uint32_t count;
+    absolute_time_t time;
+    hx711_gain_t gain;
+
+    for(size_t i = 0; i < svc->_sources_len; ++i) {
+
+        hx711_service_source_t* const source = &svc->_sources[i];
+
+        if(source->_hxm == NULL ||
+            hx711_multi_continuous_get_frame_count(source->_hxm) == source->_count) {
+                continue;
+        }
+
+        if(!hx711_multi_continuous_get_values(
+            source->_hxm,
+            values,
+            &count,
+            &time,
+            &gain)) {
+                continue;
+        }
+
+        source->_count = count;
+
+        //hx711_t callbacks push from an interrupt handler
+        UTIL_INTERRUPTS_OFF_BLOCK(
+            hx711_service__push(
+                source,
+                count,
+                time,
+                gain,
+                values,
+                source->_hxm->_chips_len);
+        );
+
+    }
+
+}
+
+void hx711_service__sources_stop(hx711_service_t* const svc) {
+
+    assert(svc != NULL);
+
+    for(size_t i = 0; i < svc->_sources_len; ++i) {
+
+        hx711_service_source_t* const source = &svc->_sources[i];
+
+        if(source->_hx != NULL) {
+            hx711_callback_stop(source->_hx);
+            hx711_close(source->_hx);
+        }
+        else {
+            hx711_multi_continuous_stop(source->_hxm);
+            hx711_multi_close(source->_hxm);
+        }
+
+    }
+
+}
+
+bool __not_in_flash_func(hx711_service__push)(
+    hx711_service_source_t* const source,
+    const uint32_t count,
+    const absolute_time_t time,
+    const hx711_gain_t gain,
+    const int32_t* const values,
+    const size_t len) {
+
+        hx711_service_t* const svc = source->_svc;
+        const uint32_t head = svc->_head;
+
+        //core1 never waits for core0 to make room
+        if(head - svc->_tail == svc->_frames_len) {
+            ++svc->_dropped;
+            return false;
+        }
+
+        hx711_service_frame_t* const frame =
+            &svc->_frames[head & (svc->_frames_len - 1)];
+
+        frame->source = source->_index;
+        frame->len = (uint8_t)len;
+        frame->count = count;
+        frame->time = time;
+        frame->gain = gain;
+
+        for(size_t i = 0; i < len; ++i) {
+            frame->values[i] = values[i];
+        }
+
+        //the frame must be complete before core0 can see it
+        __dmb();
+
+        svc->_head = head + 1;
+
+        //also wakes core0 if it is waiting in __wfe
+        if(multicore_fifo_wready()) {
+            multicore_fifo_push_blocking(source->_index);
+        }
+
+        return true;
+
+}
+
+void __not_in_flash_func(hx711_service__on_value)(
+    const hx711_sample_t* const sample,
+    void* const ctx) {
+
+        hx711_service_source_t* const source =
+            (hx711_service_source_t*)ctx;
+
+        hx711_service__push(
+            source,
+            sample->count,
+            sample->time,
+            sample->gain,
+            &sample->value,
+            1);
+
+}
@@ -0,0 +1,55 @@
+// MIT License
+// 
+// Copyright (c) 2023 Daniel Robertson
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "pico/platform.h"
+#include "pico/types.h"
+#include "../include/hx711_stats.h"
+
+void hx711_stats_reset(hx711_stats_t* const stats) {
+    assert(stats != NULL);
+    memset(stats, 0, sizeof(*stats));
+    stats->wait_us.min = UINT32_MAX;
+    stats->isr_us.min = UINT32_MAX;
+}
+
+void hx711_stats_latency_add(
+    hx711_stats_latency_t* const latency,
+    const uint32_t us) {
+
+        assert(latency != NULL);
+
+        //the bin is the number of significant bits
+        const uint bin = us == 0
+            ? 0
+            : 32 - (uint)__builtin_clz(us);
+
+        ++latency->histogram[MIN(bin, HX711_STATS_HISTOGRAM_LEN - 1)];
+        ++latency->count;
+
+        latency->min = MIN(latency->min, us);
+        latency->max = MAX(latency->max, us);
+
+}
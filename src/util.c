@@ -32,6 +32,7 @@
 #include "hardware/regs/pio.h"
 #include "hardware/structs/dma.h"
 #include "hardware/timer.h"
+#include "pico/mutex.h"
 #include "pico/platform.h"
 #include "pico/time.h"
 #include "pico/types.h"
@@ -57,6 +58,16 @@ const uint8_t util_dma_to_irq_map[] = {
     DMA_IRQ_1
 };
 
+util_pio_shared_program_t util_pio_shared_programs[NUM_PIOS][UTIL_PIO_SHARED_PROGRAMS_MAX];
+
+/**
+ * Guards util_pio_shared_programs. pio_add_program and
+ * pio_remove_program have their own lock, but finding and
+ * counting a shared program must happen under the same lock
+ * as adding or removing it.
+ */
+auto_init_mutex(util__shared_program_mut);
+
 UTIL_DEF_IN_RANGE_FUNC(int32_t)
 UTIL_DEF_IN_RANGE_FUNC(uint32_t)
 UTIL_DEF_IN_RANGE_FUNC(int)
@@ -167,6 +178,16 @@ void util_dma_channel_set_quiet(
         dma_channel_set_config(channel, &cfg, false);
 }
 
+void util_dma_channel_set_chain_to(
+    const uint channel,
+    const uint chain_to) {
+        check_dma_channel_param(channel);
+        check_dma_channel_param(chain_to);
+        dma_channel_config cfg = dma_get_channel_config(channel);
+        channel_config_set_chain_to(&cfg, chain_to);
+        dma_channel_set_config(channel, &cfg, false);
+}
+
 void util_gpio_set_contiguous_input_pins(
     const uint base,
     const uint len) {
@@ -182,6 +203,19 @@ void util_gpio_set_contiguous_input_pins(
 
 }
 
+void util_gpio_set_input_pins_mask(const uint32_t mask) {
+
+    assert(mask != 0);
+
+    for(uint i = 0; i < 32; ++i) {
+        if((mask >> i) & 1) {
+            check_gpio_param(i);
+            gpio_set_input_enabled(i, true);
+        }
+    }
+
+}
+
 void util_gpio_set_output(const uint gpio) {
     check_gpio_param(gpio);
     gpio_init(gpio);
@@ -238,8 +272,9 @@ uint util_pion_get_irqn(
         assert(util_pio_irq_index_is_valid(irq_index));
         assert(util_pio_to_irq_map != NULL);
 
+        //two irqs per pio
         const uint irq_num = util_pio_to_irq_map[
-            pio_get_index(pio) + irq_index];
+            (pio_get_index(pio) * 2) + irq_index];
 
         check_irq_param(irq_num);
 
@@ -255,8 +290,9 @@ uint util_pio_get_irq_from_index(
         assert(util_pio_irq_index_is_valid(idx));
         assert(util_pio_to_irq_map != NULL);
 
+        //two irqs per pio
         const uint irq_num = util_pio_to_irq_map[
-            pio_get_index(pio) + idx];
+            (pio_get_index(pio) * 2) + idx];
 
         check_irq_param(irq_num);
 
@@ -331,6 +367,22 @@ void util_pio_gpio_contiguous_init(
 
 }
 
+void util_pio_gpio_mask_init(
+    PIO const pio,
+    const uint32_t mask) {
+
+        check_pio_param(pio);
+        assert(mask != 0);
+
+        for(uint i = 0; i < 32; ++i) {
+            if((mask >> i) & 1) {
+                check_gpio_param(i);
+                pio_gpio_init(pio, i);
+            }
+        }
+
+}
+
 void util_pio_sm_clear_rx_fifo(
     PIO const pio,
     const uint sm) {
@@ -500,4 +552,115 @@ bool util_pio_sm_try_get(
 
 }
 
+int util_pio_claim_unused_sm_pair(
+    PIO const pio,
+    const bool required) {
+
+        check_pio_param(pio);
+
+        for(uint sm = 0; sm < NUM_PIO_STATE_MACHINES; ++sm) {
+
+            const uint next = (sm + 1) % NUM_PIO_STATE_MACHINES;
+
+            if(!pio_sm_is_claimed(pio, sm) && !pio_sm_is_claimed(pio, next)) {
+                pio_claim_sm_mask(pio, (1u << sm) | (1u << next));
+                return (int)sm;
+            }
+
+        }
+
+        if(required) {
+            panic("No PIO state machine pair is available");
+        }
+
+        return -1;
+
+}
+
+uint util_pio_add_shared_program(
+    PIO const pio,
+    const pio_program_t* const prog,
+    const uint variant) {
+
+        check_pio_param(pio);
+        assert(prog != NULL);
+
+        util_pio_shared_program_t* const progs =
+            util_pio_shared_programs[pio_get_index(pio)];
+        util_pio_shared_program_t* unused = NULL;
+        uint offset = 0;
+        bool found = false;
+
+        UTIL_MUTEX_BLOCK(util__shared_program_mut, 
+
+            for(uint i = 0; i < UTIL_PIO_SHARED_PROGRAMS_MAX; ++i) {
+                if(progs[i].refs == 0) {
+                    if(unused == NULL) {
+                        unused = &progs[i];
+                    }
+                }
+                else if(progs[i].prog == prog && progs[i].variant == variant) {
+                    ++progs[i].refs;
+                    offset = progs[i].offset;
+                    found = true;
+                    break;
+                }
+            }
+
+            if(!found) {
+
+                if(unused == NULL) {
+                    mutex_exit(&util__shared_program_mut);
+                    panic("too many shared PIO programs");
+                }
+
+                //will panic if there is no room
+                unused->offset = pio_add_program(pio, prog);
+                unused->prog = prog;
+                unused->variant = variant;
+                unused->refs = 1;
+                offset = unused->offset;
+
+            }
+
+        );
+
+        return offset;
+
+}
+
+void util_pio_remove_shared_program(
+    PIO const pio,
+    const pio_program_t* const prog,
+    const uint offset) {
+
+        check_pio_param(pio);
+        assert(prog != NULL);
+
+        util_pio_shared_program_t* const progs =
+            util_pio_shared_programs[pio_get_index(pio)];
+
+        UTIL_MUTEX_BLOCK(util__shared_program_mut, 
+
+            for(uint i = 0; i < UTIL_PIO_SHARED_PROGRAMS_MAX; ++i) {
+
+                if(progs[i].refs == 0 ||
+                    progs[i].prog != prog ||
+                    progs[i].offset != offset) {
+                        continue;
+                }
+
+                if(--progs[i].refs == 0) {
+                    pio_remove_program(pio, prog, offset);
+                    progs[i].prog = NULL;
+                }
+
+                break;
+
+            }
+
+        );
+
+}
+
 #undef UTIL_DEF_IN_RANGE_FUNC